@@ -420,7 +420,9 @@ TlsSetVerifyHost (
   Sets a TLS/SSL session ID to be used during TLS/SSL connect.
 
   This function sets a session ID to be used when the TLS/SSL connection is
-  to be established.
+  to be established. If a session with this ID was established earlier on the
+  same TLS context and is still cached, the connection resumes it with an
+  abbreviated handshake.
 
   @param[in]  Tls             Pointer to the TLS object.
   @param[in]  SessionId       Session ID data used for session resumption.
@@ -59,4 +59,43 @@ WrapPkcs7Data (
   OUT UINTN        *WrapDataSize
   );
 
+/**
+  Construct a new X509 Store that trusts the specified DER-encoded certificate
+  and is configured for PKCS#7 / Authenticode signature verification.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the new X509_STORE, or NULL if the certificate could not
+           be parsed or resources are exhausted. The caller must release it
+           with X509_STORE_free().
+
+**/
+VOID *
+Pkcs7CreateTrustedCertStore (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  );
+
+/**
+  Retrieve an X509 Store that trusts the specified DER-encoded certificate.
+
+  Stores built for recently used trusted certificates are kept in a small
+  cache, so verifying many signatures against the same db certificate parses
+  the certificate only once. Cache entries are matched on the full DER
+  encoding, so a changed db certificate never hits a stale entry.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the X509_STORE, or NULL on failure. The caller owns one
+           reference and must release it with X509_STORE_free().
+
+**/
+VOID *
+Pkcs7GetTrustedCertStore (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  );
+
 #endif
@@ -0,0 +1,145 @@
+/** @file
+  Trusted certificate store cache for PKCS#7 SignedData Verification.
+
+  Image verification calls Pkcs7Verify() once per db certificate for every
+  image, so the same handful of trusted certificates are parsed over and over.
+  This module keeps the X509 Store built for the most recently used trusted
+  certificates, keyed by their full DER encoding.
+
+  Caution: This module requires additional review when modified.
+  The trusted certificate comes from the authenticated db variable, but the
+  cache lookup must still never match an entry whose encoding differs in any
+  byte from the requested certificate.
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+
+#include <openssl/x509.h>
+
+#define PKCS7_TRUSTED_CERT_CACHE_SIZE  8
+
+typedef struct {
+  UINT8         *CertData;
+  UINTN         CertLength;
+  X509_STORE    *CertStore;
+  UINT64        LastUsed;
+} PKCS7_TRUSTED_CERT_CACHE_ENTRY;
+
+GLOBAL_REMOVE_IF_UNREFERENCED PKCS7_TRUSTED_CERT_CACHE_ENTRY  mTrustedCertCache[PKCS7_TRUSTED_CERT_CACHE_SIZE];
+GLOBAL_REMOVE_IF_UNREFERENCED UINT64                          mTrustedCertCacheTick = 0;
+
+/**
+  Release the resources held by one trusted certificate cache entry.
+
+  @param[in, out]  Entry  Pointer to the cache entry to release.
+
+**/
+STATIC
+VOID
+Pkcs7FreeTrustedCertCacheEntry (
+  IN OUT PKCS7_TRUSTED_CERT_CACHE_ENTRY  *Entry
+  )
+{
+  if (Entry->CertStore != NULL) {
+    X509_STORE_free (Entry->CertStore);
+  }
+
+  if (Entry->CertData != NULL) {
+    FreePool (Entry->CertData);
+  }
+
+  ZeroMem (Entry, sizeof (*Entry));
+}
+
+/**
+  Retrieve an X509 Store that trusts the specified DER-encoded certificate.
+
+  Stores built for recently used trusted certificates are kept in a small
+  cache, so verifying many signatures against the same db certificate parses
+  the certificate only once. Cache entries are matched on the full DER
+  encoding, so a changed db certificate never hits a stale entry.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the X509_STORE, or NULL on failure. The caller owns one
+           reference and must release it with X509_STORE_free().
+
+**/
+VOID *
+Pkcs7GetTrustedCertStore (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  PKCS7_TRUSTED_CERT_CACHE_ENTRY  *Entry;
+  PKCS7_TRUSTED_CERT_CACHE_ENTRY  *Victim;
+  X509_STORE                      *CertStore;
+  UINT8                           *CertData;
+  UINTN                           Index;
+
+  if ((TrustedCert == NULL) || (CertLength == 0) || (CertLength > INT_MAX)) {
+    return NULL;
+  }
+
+  mTrustedCertCacheTick++;
+
+  //
+  // Look for a store that was built from exactly the same certificate.
+  //
+  Victim = &mTrustedCertCache[0];
+  for (Index = 0; Index < PKCS7_TRUSTED_CERT_CACHE_SIZE; Index++) {
+    Entry = &mTrustedCertCache[Index];
+    if ((Entry->CertStore != NULL) &&
+        (Entry->CertLength == CertLength) &&
+        (CompareMem (Entry->CertData, TrustedCert, CertLength) == 0))
+    {
+      if (X509_STORE_up_ref (Entry->CertStore) == 0) {
+        return NULL;
+      }
+
+      Entry->LastUsed = mTrustedCertCacheTick;
+      return Entry->CertStore;
+    }
+
+    //
+    // Remember the least recently used (or an empty) slot for replacement.
+    //
+    if ((Victim->CertStore != NULL) &&
+        ((Entry->CertStore == NULL) || (Entry->LastUsed < Victim->LastUsed)))
+    {
+      Victim = Entry;
+    }
+  }
+
+  CertStore = Pkcs7CreateTrustedCertStore (TrustedCert, CertLength);
+  if (CertStore == NULL) {
+    return NULL;
+  }
+
+  //
+  // Failing to cache the store is not fatal, the caller simply gets the only
+  // reference to it.
+  //
+  CertData = AllocateCopyPool (CertLength, TrustedCert);
+  if (CertData == NULL) {
+    return CertStore;
+  }
+
+  if (X509_STORE_up_ref (CertStore) == 0) {
+    FreePool (CertData);
+    return CertStore;
+  }
+
+  Pkcs7FreeTrustedCertCacheEntry (Victim);
+  Victim->CertData   = CertData;
+  Victim->CertLength = CertLength;
+  Victim->CertStore  = CertStore;
+  Victim->LastUsed   = mTrustedCertCacheTick;
+
+  return CertStore;
+}
@@ -0,0 +1,35 @@
+/** @file
+  Trusted certificate store retrieval for PKCS#7 SignedData Verification which
+  does not cache anything.
+
+  Used by library instances that cannot keep writable global state across
+  calls (e.g. PEI executing in place) or must not hold on to boot service
+  memory after ExitBootServices() (runtime).
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "InternalCryptLib.h"
+
+/**
+  Retrieve an X509 Store that trusts the specified DER-encoded certificate.
+
+  This instance builds a new store on every call.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the X509_STORE, or NULL on failure. The caller owns one
+           reference and must release it with X509_STORE_free().
+
+**/
+VOID *
+Pkcs7GetTrustedCertStore (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  return Pkcs7CreateTrustedCertStore (TrustedCert, CertLength);
+}
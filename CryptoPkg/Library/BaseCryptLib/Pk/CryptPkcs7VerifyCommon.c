@@ -748,6 +748,80 @@ _Error:
   return Status;
 }
 
+/**
+  Construct a new X509 Store that trusts the specified DER-encoded certificate
+  and is configured for PKCS#7 / Authenticode signature verification.
+
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+
+  @return  Pointer to the new X509_STORE, or NULL if the certificate could not
+           be parsed or resources are exhausted. The caller must release it
+           with X509_STORE_free().
+
+**/
+VOID *
+Pkcs7CreateTrustedCertStore (
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength
+  )
+{
+  X509         *Cert;
+  X509_STORE   *CertStore;
+  CONST UINT8  *Temp;
+
+  if ((TrustedCert == NULL) || (CertLength > INT_MAX)) {
+    return NULL;
+  }
+
+  //
+  // Read DER-encoded root certificate and Construct X509 Certificate
+  //
+  Temp = TrustedCert;
+  Cert = d2i_X509 (NULL, &Temp, (long)CertLength);
+  if (Cert == NULL) {
+    return NULL;
+  }
+
+  //
+  // Setup X509 Store for trusted certificate
+  //
+  CertStore = X509_STORE_new ();
+  if (CertStore == NULL) {
+    X509_free (Cert);
+    return NULL;
+  }
+
+  if (!(X509_STORE_add_cert (CertStore, Cert))) {
+    X509_free (Cert);
+    X509_STORE_free (CertStore);
+    return NULL;
+  }
+
+  //
+  // The store holds its own reference to the certificate now.
+  //
+  X509_free (Cert);
+
+  //
+  // Allow partial certificate chains, terminated by a non-self-signed but
+  // still trusted intermediate certificate. Also disable time checks.
+  //
+  X509_STORE_set_flags (
+    CertStore,
+    X509_V_FLAG_PARTIAL_CHAIN | X509_V_FLAG_NO_CHECK_TIME
+    );
+
+  //
+  // OpenSSL PKCS7 Verification by default checks for SMIME (email signing) and
+  // doesn't support the extended key usage for Authenticode Code Signing.
+  // Bypass the certificate purpose checking by enabling any purposes setting.
+  //
+  X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
+
+  return CertStore;
+}
+
 /**
   Verifies the validity of a PKCS#7 signed data as described in "PKCS #7:
   Cryptographic Message Syntax Standard". The input signed data could be wrapped
@@ -786,7 +860,6 @@ Pkcs7Verify (
   PKCS7        *Pkcs7;
   BIO          *DataBio;
   BOOLEAN      Status;
-  X509         *Cert;
   X509_STORE   *CertStore;
   UINT8        *SignedData;
   CONST UINT8  *Temp;
@@ -804,7 +877,6 @@ Pkcs7Verify (
 
   Pkcs7     = NULL;
   DataBio   = NULL;
-  Cert      = NULL;
   CertStore = NULL;
 
   //
@@ -862,26 +934,15 @@ Pkcs7Verify (
   }
 
   //
-  // Read DER-encoded root certificate and Construct X509 Certificate
-  //
-  Temp = TrustedCert;
-  Cert = d2i_X509 (NULL, &Temp, (long)CertLength);
-  if (Cert == NULL) {
-    goto _Exit;
-  }
-
-  //
-  // Setup X509 Store for trusted certificate
+  // Retrieve the X509 Store holding the trusted certificate. The store may be
+  // shared with earlier verifications against the same certificate, and one
+  // reference is owned by this function.
   //
-  CertStore = X509_STORE_new ();
+  CertStore = Pkcs7GetTrustedCertStore (TrustedCert, CertLength);
   if (CertStore == NULL) {
     goto _Exit;
   }
 
-  if (!(X509_STORE_add_cert (CertStore, Cert))) {
-    goto _Exit;
-  }
-
   //
   // For generic PKCS#7 handling, InData may be NULL if the content is present
   // in PKCS#7 structure. So ignore NULL checking here.
@@ -891,22 +952,6 @@ Pkcs7Verify (
     goto _Exit;
   }
 
-  //
-  // Allow partial certificate chains, terminated by a non-self-signed but
-  // still trusted intermediate certificate. Also disable time checks.
-  //
-  X509_STORE_set_flags (
-    CertStore,
-    X509_V_FLAG_PARTIAL_CHAIN | X509_V_FLAG_NO_CHECK_TIME
-    );
-
-  //
-  // OpenSSL PKCS7 Verification by default checks for SMIME (email signing) and
-  // doesn't support the extended key usage for Authenticode Code Signing.
-  // Bypass the certificate purpose checking by enabling any purposes setting.
-  //
-  X509_STORE_set_purpose (CertStore, X509_PURPOSE_ANY);
-
   //
   // Verifies the PKCS#7 signedData structure
   //
@@ -917,7 +962,6 @@ _Exit:
   // Release Resources
   //
   BIO_free (DataBio);
-  X509_free (Cert);
   X509_STORE_free (CertStore);
   PKCS7_free (Pkcs7);
 
@@ -21,6 +21,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <openssl/bio.h>
 #include <openssl/err.h>
 
+//
+// Maximum number of client sessions kept for resumption per TLS context.
+//
+#define TLS_SESSION_CACHE_SIZE  16
+
 typedef struct {
   //
   // Main SSL Connection which is created by a server or a client
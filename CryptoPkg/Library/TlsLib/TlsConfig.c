@@ -594,11 +594,72 @@ TlsSetVerifyHost (
   return (ParamStatus == 1) ? EFI_SUCCESS : EFI_ABORTED;
 }
 
+/**
+  Look up a resumable session with the given ID in the session cache of the
+  TLS context the connection was created from.
+
+  The session cache compares the protocol version as well as the session ID,
+  so every version the context may have negotiated is tried.
+
+  @param[in]  Ssl             Pointer to the SSL connection.
+  @param[in]  SessionId       Session ID to look up.
+  @param[in]  SessionIdLen    Length of Session ID in bytes.
+
+  @return  The cached session, or NULL if there is none. The session is still
+           owned by the cache.
+
+**/
+STATIC
+SSL_SESSION *
+TlsLookupCachedSession (
+  IN     SSL     *Ssl,
+  IN     UINT8   *SessionId,
+  IN     UINT16  SessionIdLen
+  )
+{
+  STATIC CONST INT32  Versions[] = {
+    TLS1_3_VERSION, TLS1_2_VERSION, TLS1_1_VERSION, TLS1_VERSION
+  };
+  LHASH_OF (SSL_SESSION)  *Cache;
+  SSL_SESSION             *Template;
+  SSL_SESSION             *Session;
+  UINTN                   Index;
+
+  Cache = SSL_CTX_sessions (SSL_get_SSL_CTX (Ssl));
+  if ((Cache == NULL) || (SessionIdLen == 0) || (SessionIdLen > SSL_MAX_SSL_SESSION_ID_LENGTH)) {
+    return NULL;
+  }
+
+  Template = SSL_SESSION_new ();
+  if (Template == NULL) {
+    return NULL;
+  }
+
+  Session = NULL;
+  if (SSL_SESSION_set1_id (Template, (const unsigned char *)SessionId, SessionIdLen) == 1) {
+    for (Index = 0; Index < ARRAY_SIZE (Versions) && Session == NULL; Index++) {
+      if (SSL_SESSION_set_protocol_version (Template, Versions[Index]) == 1) {
+        Session = lh_SSL_SESSION_retrieve (Cache, Template);
+      }
+    }
+  }
+
+  SSL_SESSION_free (Template);
+
+  if ((Session != NULL) && (SSL_SESSION_is_resumable (Session) != 1)) {
+    Session = NULL;
+  }
+
+  return Session;
+}
+
 /**
   Sets a TLS/SSL session ID to be used during TLS/SSL connect.
 
   This function sets a session ID to be used when the TLS/SSL connection is
-  to be established.
+  to be established. If a session with this ID was established earlier on the
+  same TLS context and is still cached, the connection resumes it with an
+  abbreviated handshake.
 
   @param[in]  Tls             Pointer to the TLS object.
   @param[in]  SessionId       Session ID data used for session resumption.
@@ -627,6 +688,17 @@ TlsSetSessionId (
     return EFI_INVALID_PARAMETER;
   }
 
+  //
+  // Prefer resuming a cached session, which carries the master secret and
+  // session ticket the server expects.
+  //
+  Session = TlsLookupCachedSession (TlsConn->Ssl, SessionId, SessionIdLen);
+  if (Session != NULL) {
+    if (SSL_set_session (TlsConn->Ssl, Session) == 1) {
+      return EFI_SUCCESS;
+    }
+  }
+
   Session = SSL_get_session (TlsConn->Ssl);
   if (Session == NULL) {
     return EFI_UNSUPPORTED;
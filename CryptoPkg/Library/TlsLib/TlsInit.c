@@ -106,6 +106,14 @@ TlsCtxNew (
   //
   SSL_CTX_set_min_proto_version (TlsCtx, ProtoVersion);
 
+  //
+  // Keep established client sessions (including their session tickets) in a
+  // small per-context cache, so that TlsSetSessionId() can resume them on
+  // later connections to the same server.
+  //
+  SSL_CTX_set_session_cache_mode (TlsCtx, SSL_SESS_CACHE_CLIENT);
+  SSL_CTX_sess_set_cache_size (TlsCtx, TLS_SESSION_CACHE_SIZE);
+
   return (VOID *)TlsCtx;
 }
 
@@ -992,11 +992,88 @@ TestVerifyAuthenticodeVerify (
   return UNIT_TEST_PASSED;
 }
 
+UNIT_TEST_STATUS
+EFIAPI
+TestVerifyAuthenticodeVerifyCached (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BOOLEAN  Status;
+  UINT8    *RootCertCopy;
+  UINT8    BadHash[SHA256_DIGEST_SIZE];
+  UINTN    Index;
+
+  //
+  // A copy of the trusted certificate at a different address must be treated
+  // exactly like the original one.
+  //
+  RootCertCopy = AllocateCopyPool (sizeof (TestRootCert1), TestRootCert1);
+  UT_ASSERT_NOT_NULL (RootCertCopy);
+
+  CopyMem (BadHash, PeSha256Hash, sizeof (BadHash));
+  BadHash[0] ^= 0xFF;
+
+  //
+  // The first round builds the trusted certificate stores, the second one
+  // verifies against the cached stores.
+  //
+  for (Index = 0; Index < 2; Index++) {
+    Status = AuthenticodeVerify (
+               AuthenticodeWithSha1,
+               sizeof (AuthenticodeWithSha1),
+               (Index == 0) ? TestRootCert1 : RootCertCopy,
+               sizeof (TestRootCert1),
+               PeSha1Hash,
+               SHA1_DIGEST_SIZE
+               );
+    UT_ASSERT_TRUE (Status);
+
+    Status = AuthenticodeVerify (
+               AuthenticodeWithSha256,
+               sizeof (AuthenticodeWithSha256),
+               TestRootCert2,
+               sizeof (TestRootCert2),
+               PeSha256Hash,
+               SHA256_DIGEST_SIZE
+               );
+    UT_ASSERT_TRUE (Status);
+
+    //
+    // Results obtained with one trusted certificate must never leak into a
+    // verification against another one.
+    //
+    Status = AuthenticodeVerify (
+               AuthenticodeWithSha1,
+               sizeof (AuthenticodeWithSha1),
+               TestRootCert2,
+               sizeof (TestRootCert2),
+               PeSha1Hash,
+               SHA1_DIGEST_SIZE
+               );
+    UT_ASSERT_FALSE (Status);
+
+    Status = AuthenticodeVerify (
+               AuthenticodeWithSha256,
+               sizeof (AuthenticodeWithSha256),
+               TestRootCert2,
+               sizeof (TestRootCert2),
+               BadHash,
+               SHA256_DIGEST_SIZE
+               );
+    UT_ASSERT_FALSE (Status);
+  }
+
+  FreePool (RootCertCopy);
+
+  return UNIT_TEST_PASSED;
+}
+
 TEST_DESC  mAuthenticodeTest[] = {
   //
   // -----Description--------------------------------------Class----------------------Function-----------------Pre---Post--Context
   //
   { "TestVerifyAuthenticodeVerify()", "CryptoPkg.BaseCryptLib.Authenticode", TestVerifyAuthenticodeVerify, NULL, NULL, NULL },
+  { "TestVerifyAuthenticodeVerifyCached()", "CryptoPkg.BaseCryptLib.Authenticode", TestVerifyAuthenticodeVerifyCached, NULL, NULL, NULL },
 };
 
 UINTN  mAuthenticodeTestNum = ARRAY_SIZE (mAuthenticodeTest);
@@ -629,6 +629,15 @@ DumpSmiHandler (
         }
 
         Print (L"      </Caller>\n", SmiHandlerStruct->Handler);
+        if ((SmiStruct->Header.Revision >= 0x0002) && (SmiHandlerStruct->DispatchCount != 0)) {
+          Print (
+            L"      <Dispatch Count=\"%ld\" TotalTimeNs=\"%ld\" MaxTimeNs=\"%ld\" />\n",
+            SmiHandlerStruct->DispatchCount,
+            SmiHandlerStruct->TotalTime,
+            SmiHandlerStruct->MaxTime
+            );
+        }
+
         SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
         Print (L"    </SmiHandler>\n");
       }
@@ -2446,6 +2446,788 @@ AhciReadLogExt (
            );
 }
 
+/**
+  Program the command list base address of a port.
+
+  The port must be stopped (PxCMD.ST and PxCMD.CR are clear).
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  Port                The number of port.
+  @param  CmdListPciAddr      The bus master address of the command list.
+
+**/
+STATIC
+VOID
+AhciNcqSetCommandList (
+  IN EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN UINT8                 Port,
+  IN EFI_PHYSICAL_ADDRESS  CmdListPciAddr
+  )
+{
+  DATA_64  Data64;
+  UINT32   Offset;
+
+  Data64.Uint64 = CmdListPciAddr;
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLB;
+  AhciWriteReg (PciIo, Offset, Data64.Uint32.Lower32);
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLBU;
+  AhciWriteReg (PciIo, Offset, Data64.Uint32.Upper32);
+}
+
+/**
+  Check whether native command queuing can be used for an ATA device.
+
+  @param[in]  Instance      The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  DeviceInfo    The EFI_ATA_DEVICE_INFO of the device.
+
+  @retval TRUE    Both the HBA and the device support NCQ.
+  @retval FALSE   NCQ can not be used for the device.
+
+**/
+BOOLEAN
+EFIAPI
+AhciNcqSupported (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN EFI_ATA_DEVICE_INFO           *DeviceInfo
+  )
+{
+  UINT16  SataCapabilities;
+
+  //
+  // Queued commands behind a port multiplier need FIS based switching,
+  // which is not supported.
+  //
+  if ((Instance->Mode != EfiAtaAhciMode) ||
+      (DeviceInfo->Type != EfiIdeHarddisk) ||
+      (DeviceInfo->PortMultiplier != 0xFFFF))
+  {
+    return FALSE;
+  }
+
+  if ((AhciReadReg (Instance->PciIo, EFI_AHCI_CAPABILITY_OFFSET) & EFI_AHCI_CAP_SNCQ) == 0) {
+    return FALSE;
+  }
+
+  //
+  // Word 76 of the IDENTIFY data reports the NCQ support in bit 8. The word
+  // is not valid if it is 0x0000 or 0xFFFF.
+  //
+  SataCapabilities = DeviceInfo->IdentifyData->AtaData.serial_ata_capabilities;
+  if ((SataCapabilities == 0xFFFF) || ((SataCapabilities & BIT8) == 0)) {
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+  Allocate the NCQ command list and command tables of a port.
+
+  @param  Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+
+  @retval EFI_SUCCESS           The NCQ resources of the port are ready.
+  @retval EFI_UNSUPPORTED       No ATA device is attached to the port.
+  @retval EFI_OUT_OF_RESOURCES  The resources can not be allocated.
+  @retval EFI_DEVICE_ERROR      The HBA can not reach the allocated buffer.
+
+**/
+STATIC
+EFI_STATUS
+AhciNcqCreatePort (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN UINT8                         Port
+  )
+{
+  EFI_PCI_IO_PROTOCOL   *PciIo;
+  LIST_ENTRY            *Node;
+  EFI_ATA_DEVICE_INFO   *DeviceInfo;
+  AHCI_NCQ_PORT         *NcqPort;
+  UINT32                Capability;
+  UINT32                QueueDepth;
+  VOID                  *Buffer;
+  UINTN                 Bytes;
+  EFI_PHYSICAL_ADDRESS  CmdListPciAddr;
+  EFI_STATUS            Status;
+
+  if (AhciRegisters->NcqPort[Port] != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Node = SearchDeviceInfoList (Instance, Port, 0xFFFF, EfiIdeHarddisk);
+  if (Node == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The usable tags are limited by both the device queue depth (word 75 of
+  // the IDENTIFY data) and the number of command slots of the HBA.
+  //
+  PciIo      = Instance->PciIo;
+  DeviceInfo = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
+  Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+  QueueDepth = (DeviceInfo->IdentifyData->AtaData.queue_depth & 0x1F) + 1;
+  QueueDepth = MIN (QueueDepth, ((Capability & 0x1F00) >> 8) + 1);
+
+  NcqPort = AllocateZeroPool (sizeof (AHCI_NCQ_PORT));
+  if (NcqPort == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Buffer = NULL;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    EFI_SIZE_TO_PAGES (AHCI_NCQ_BUFFER_SIZE),
+                    &Buffer,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    FreePool (NcqPort);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Buffer, AHCI_NCQ_BUFFER_SIZE);
+
+  Bytes  = AHCI_NCQ_BUFFER_SIZE;
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &CmdListPciAddr,
+                    &NcqPort->MapCmdList
+                    );
+  if (EFI_ERROR (Status) || (Bytes != AHCI_NCQ_BUFFER_SIZE)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ErrorFree;
+  }
+
+  if (((Capability & EFI_AHCI_CAP_S64A) == 0) && (CmdListPciAddr + AHCI_NCQ_BUFFER_SIZE > 0x100000000ULL)) {
+    //
+    // The AHCI HBA doesn't support 64bit addressing, so should not get a >4G pci bus master address.
+    //
+    Status = EFI_DEVICE_ERROR;
+    goto ErrorUnmap;
+  }
+
+  NcqPort->CmdList        = Buffer;
+  NcqPort->CmdListPciAddr = CmdListPciAddr;
+  NcqPort->TagMask        = (QueueDepth >= AHCI_NCQ_MAX_TAGS) ? MAX_UINT32 : (((UINT32)1 << QueueDepth) - 1);
+
+  AhciRegisters->NcqPort[Port] = NcqPort;
+
+  DEBUG ((DEBUG_INFO, "AHCI: Port %d uses NCQ with %d tags\n", Port, QueueDepth));
+  return EFI_SUCCESS;
+
+ErrorUnmap:
+  PciIo->Unmap (PciIo, NcqPort->MapCmdList);
+ErrorFree:
+  PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES (AHCI_NCQ_BUFFER_SIZE), Buffer);
+  FreePool (NcqPort);
+  return Status;
+}
+
+/**
+  Switch a port to its NCQ command list and start it.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+
+  @retval EFI_SUCCESS         The port runs on the NCQ command list.
+  @retval others              The port failed to stop.
+
+**/
+STATIC
+EFI_STATUS
+AhciNcqStartPort (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port
+  )
+{
+  AHCI_NCQ_PORT  *NcqPort;
+  EFI_STATUS     Status;
+  UINT32         Offset;
+
+  NcqPort = AhciRegisters->NcqPort[Port];
+  if (NcqPort->Started) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // PxCLB can only be changed while the port is stopped.
+  //
+  Status = AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  AhciNcqSetCommandList (PciIo, Port, NcqPort->CmdListPciAddr);
+  AhciClearPortStatus (PciIo, Port);
+
+  Status = AhciEnableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
+  AhciAndReg (PciIo, Offset, (UINT32) ~(EFI_AHCI_PORT_CMD_DLAE | EFI_AHCI_PORT_CMD_ATAPI));
+  AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_ST);
+
+  NcqPort->Started = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stop a port running on its NCQ command list and give it back the single
+  slot command list.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+
+  @retval EFI_SUCCESS         The port runs on the single slot command list.
+  @retval others              The port failed to stop.
+
+**/
+STATIC
+EFI_STATUS
+AhciNcqReleasePort (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port
+  )
+{
+  AHCI_NCQ_PORT  *NcqPort;
+  EFI_STATUS     Status;
+
+  NcqPort = AhciRegisters->NcqPort[Port];
+  if ((NcqPort == NULL) || !NcqPort->Started) {
+    return EFI_SUCCESS;
+  }
+
+  Status = AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  AhciNcqSetCommandList (PciIo, Port, (UINTN)AhciRegisters->AhciCmdListPciAddr);
+
+  NcqPort->Started = FALSE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Recover a port after an error of a queued command.
+
+  Clearing PxCMD.ST aborts all the outstanding commands of the port, so all
+  the active tags are marked as failed. The device rejects further queued
+  commands until its NCQ command error log is read, which is done through
+  the single slot command list.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+
+**/
+STATIC
+VOID
+AhciNcqRecoverPort (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port
+  )
+{
+  AHCI_NCQ_PORT  *NcqPort;
+  UINT8          LogBuffer[512];
+  EFI_STATUS     Status;
+
+  NcqPort              = AhciRegisters->NcqPort[Port];
+  NcqPort->FailedTags |= NcqPort->ActiveTags;
+  NcqPort->ActiveTags  = 0;
+
+  AhciRecoverPortError (PciIo, Port);
+  Status = AhciNcqReleasePort (PciIo, AhciRegisters, Port);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AHCI: Failed to stop NCQ on port %d\n", Port));
+    return;
+  }
+
+  AhciClearPortStatus (PciIo, Port);
+
+  Status = AhciReadLogExt (PciIo, AhciRegisters, Port, 0, LogBuffer, ATA_NCQ_COMMAND_ERROR_LOG, 0);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "AHCI: Failed to read the NCQ error log of port %d\n", Port));
+  } else {
+    DEBUG ((DEBUG_ERROR, "AHCI: NCQ error on tag %d, status %x\n", LogBuffer[0] & 0x1F, LogBuffer[2]));
+  }
+}
+
+/**
+  Issue a READ/WRITE FPDMA QUEUED command on a free tag of a port.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+  @param  Read                The transfer direction.
+  @param  AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param  DataPhysicalAddr    The bus master address of the data buffer.
+  @param  DataCount           The data count to be transferred.
+  @param  Tag                 Return the tag used by the command.
+
+  @retval EFI_SUCCESS         The command is issued.
+  @retval EFI_NOT_READY       All the tags of the port are in use.
+  @retval EFI_BAD_BUFFER_SIZE The data needs more PRDT entries than a NCQ
+                              command table has.
+  @retval others              The port failed to start.
+
+**/
+STATIC
+EFI_STATUS
+AhciNcqIssueCommand (
+  IN  EFI_PCI_IO_PROTOCOL    *PciIo,
+  IN  EFI_AHCI_REGISTERS     *AhciRegisters,
+  IN  UINT8                  Port,
+  IN  BOOLEAN                Read,
+  IN  EFI_ATA_COMMAND_BLOCK  *AtaCommandBlock,
+  IN  EFI_PHYSICAL_ADDRESS   DataPhysicalAddr,
+  IN  UINT32                 DataCount,
+  OUT UINT8                  *Tag
+  )
+{
+  AHCI_NCQ_PORT           *NcqPort;
+  EFI_AHCI_COMMAND_FIS    CFis;
+  EFI_AHCI_COMMAND_LIST   *CmdList;
+  EFI_AHCI_COMMAND_TABLE  *CmdTable;
+  EFI_AHCI_COMMAND_PRDT   *Prdt;
+  UINTN                   CmdTableOffset;
+  UINT32                  FreeTags;
+  UINT32                  PrdtNumber;
+  UINT32                  PrdtIndex;
+  UINT32                  RemainedData;
+  DATA_64                 Data64;
+  UINT32                  Offset;
+  EFI_STATUS              Status;
+
+  NcqPort  = AhciRegisters->NcqPort[Port];
+  FreeTags = NcqPort->TagMask & ~(NcqPort->ActiveTags | NcqPort->FailedTags);
+  if (FreeTags == 0) {
+    return EFI_NOT_READY;
+  }
+
+  PrdtNumber = (UINT32)DivU64x32 (((UINT64)DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1), EFI_AHCI_MAX_DATA_PER_PRDT);
+  if (PrdtNumber > AHCI_NCQ_MAX_PRDT) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  Status = AhciNcqStartPort (PciIo, AhciRegisters, Port);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *Tag           = (UINT8)LowBitSet32 (FreeTags);
+  CmdTableOffset = AHCI_NCQ_COMMAND_LIST_SIZE + *Tag * AHCI_NCQ_COMMAND_TABLE_SIZE;
+
+  //
+  // The tag is carried in bits 7:3 of the sector count register, the sector
+  // count itself is in the features registers. Bit 6 of the device register
+  // is always set and bit 7 is FUA.
+  //
+  AhciBuildCommandFis (&CFis, AtaCommandBlock);
+  CFis.AhciCFisSecCount = (UINT8)(*Tag << 3);
+  CFis.AhciCFisDevHead  = (UINT8)((AtaCommandBlock->AtaDeviceHead & BIT7) | BIT6);
+
+  CmdTable = (EFI_AHCI_COMMAND_TABLE *)((UINTN)NcqPort->CmdList + CmdTableOffset);
+  ZeroMem (CmdTable, AHCI_NCQ_COMMAND_TABLE_SIZE);
+  CopyMem (&CmdTable->CommandFis, &CFis, sizeof (EFI_AHCI_COMMAND_FIS));
+
+  RemainedData = DataCount;
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    Prdt               = &CmdTable->PrdtTable[PrdtIndex];
+    Data64.Uint64      = DataPhysicalAddr;
+    Prdt->AhciPrdtDba  = Data64.Uint32.Lower32;
+    Prdt->AhciPrdtDbau = Data64.Uint32.Upper32;
+    Prdt->AhciPrdtDbc  = MIN (RemainedData, EFI_AHCI_MAX_DATA_PER_PRDT) - 1;
+    RemainedData      -= MIN (RemainedData, EFI_AHCI_MAX_DATA_PER_PRDT);
+    DataPhysicalAddr  += EFI_AHCI_MAX_DATA_PER_PRDT;
+  }
+
+  CmdList = &NcqPort->CmdList[*Tag];
+  ZeroMem (CmdList, sizeof (EFI_AHCI_COMMAND_LIST));
+  CmdList->AhciCmdCfl   = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+  CmdList->AhciCmdW     = Read ? 0 : 1;
+  CmdList->AhciCmdPrdtl = PrdtNumber;
+  Data64.Uint64         = NcqPort->CmdListPciAddr + CmdTableOffset;
+  CmdList->AhciCmdCtba  = Data64.Uint32.Lower32;
+  CmdList->AhciCmdCtbau = Data64.Uint32.Upper32;
+
+  NcqPort->ActiveTags |= (UINT32)1 << *Tag;
+
+  //
+  // PxSACT must be set before PxCI. Writing 0 to either register has no
+  // effect, so the other outstanding tags are left untouched.
+  //
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+  AhciWriteReg (PciIo, Offset, (UINT32)1 << *Tag);
+  Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+  AhciWriteReg (PciIo, Offset, (UINT32)1 << *Tag);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a queued command is completed.
+
+  The device completes a queued command by clearing its bit in PxSACT with a
+  Set Device Bits FIS. An error on any tag aborts all the outstanding tags of
+  the port.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+  @param  Tag                 The tag used by the command.
+  @param  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+
+  @retval EFI_SUCCESS         The command is completed successfully.
+  @retval EFI_NOT_READY       The command is still outstanding.
+  @retval EFI_DEVICE_ERROR    The command is aborted with error.
+
+**/
+STATIC
+EFI_STATUS
+AhciNcqCheckCommand (
+  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
+  IN     EFI_AHCI_REGISTERS    *AhciRegisters,
+  IN     UINT8                 Port,
+  IN     UINT8                 Tag,
+  IN OUT EFI_ATA_STATUS_BLOCK  *AtaStatusBlock
+  )
+{
+  AHCI_NCQ_PORT  *NcqPort;
+  UINT32         TagBit;
+  UINT32         PortInterrupt;
+  UINT32         Outstanding;
+  UINT32         PortTfd;
+  UINT32         Offset;
+
+  NcqPort = AhciRegisters->NcqPort[Port];
+  TagBit  = (UINT32)1 << Tag;
+
+  if ((NcqPort->FailedTags & TagBit) == 0) {
+    Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+    PortInterrupt = AhciReadReg (PciIo, Offset);
+    if ((PortInterrupt & EFI_AHCI_PORT_IS_ERROR_MASK) != 0) {
+      DEBUG ((DEBUG_ERROR, "AHCI: NCQ error interrupt reported PxIS: %X\n", PortInterrupt));
+      AhciNcqRecoverPort (PciIo, AhciRegisters, Port);
+    } else {
+      Offset       = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT;
+      Outstanding  = AhciReadReg (PciIo, Offset);
+      Offset       = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI;
+      Outstanding |= AhciReadReg (PciIo, Offset);
+      if ((Outstanding & TagBit) != 0) {
+        return EFI_NOT_READY;
+      }
+
+      NcqPort->ActiveTags &= ~TagBit;
+      if (AtaStatusBlock != NULL) {
+        ZeroMem (AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
+        Offset                    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+        AtaStatusBlock->AtaStatus = (UINT8)(AhciReadReg (PciIo, Offset) & ~EFI_AHCI_PORT_TFD_ERR);
+      }
+
+      return EFI_SUCCESS;
+    }
+  }
+
+  NcqPort->FailedTags &= ~TagBit;
+  if (AtaStatusBlock != NULL) {
+    ZeroMem (AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
+    Offset                    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+    PortTfd                   = AhciReadReg (PciIo, Offset);
+    AtaStatusBlock->AtaStatus = (UINT8)(PortTfd | EFI_AHCI_PORT_TFD_ERR);
+    AtaStatusBlock->AtaError  = (UINT8)(PortTfd >> 8);
+  }
+
+  return EFI_DEVICE_ERROR;
+}
+
+/**
+  Start a READ/WRITE FPDMA QUEUED command on specific port.
+
+  The command is issued on a free tag of the port, so that several commands
+  can be outstanding at the same time. In blocking mode, the function waits
+  for the command to complete. In non-blocking mode, EFI_NOT_READY is returned
+  until the command is completed, including when no tag is free yet.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The queued command is aborted with error.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_NOT_READY       The non-blocking command is not completed yet.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer can not be mapped or described.
+  @retval EFI_SUCCESS         The queued command executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN     EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK          *AtaStatusBlock,
+  IN OUT VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN     UINT64                        Timeout,
+  IN     ATA_NONBLOCK_TASK             *Task OPTIONAL
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_PCI_IO_PROTOCOL            *PciIo;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  VOID                           *Map;
+  UINTN                          MapLength;
+  EFI_PCI_IO_PROTOCOL_OPERATION  Flag;
+  EFI_TPL                        OldTpl;
+  UINT8                          Tag;
+  UINT64                         Delay;
+  BOOLEAN                        InfiniteWait;
+
+  PciIo = Instance->PciIo;
+
+  Status = AhciNcqCreatePort (Instance, AhciRegisters, Port);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // DMA buffer mapping. Needs to be done only once for a non-blocking task,
+  // even if it waits for a free tag.
+  //
+  Map     = NULL;
+  PhyAddr = 0;
+  if ((Task == NULL) || (Task->Map == NULL)) {
+    if (Read) {
+      Flag = EfiPciIoOperationBusMasterWrite;
+    } else {
+      Flag = EfiPciIoOperationBusMasterRead;
+    }
+
+    MapLength = DataCount;
+    Status    = PciIo->Map (
+                         PciIo,
+                         Flag,
+                         MemoryAddr,
+                         &MapLength,
+                         &PhyAddr,
+                         &Map
+                         );
+    if (EFI_ERROR (Status) || (DataCount != MapLength)) {
+      return EFI_BAD_BUFFER_SIZE;
+    }
+
+    if (Task != NULL) {
+      Task->Map         = Map;
+      Task->DataPhyAddr = PhyAddr;
+    }
+  }
+
+  if (Task == NULL) {
+    //
+    // Before starting the Blocking BlockIO operation, push to finish all non-blocking
+    // BlockIO tasks, so that a free tag is guaranteed.
+    // Delay 100us to simulate the blocking time out checking.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    while (!IsListEmpty (&Instance->NonBlockingTaskList)) {
+      AsyncNonBlockingTransferRoutine (NULL, Instance);
+      //
+      // Stall for 100us.
+      //
+      MicroSecondDelay (100);
+    }
+
+    Status = AhciNcqIssueCommand (PciIo, AhciRegisters, Port, Read, AtaCommandBlock, PhyAddr, DataCount, &Tag);
+    gBS->RestoreTPL (OldTpl);
+
+    if (!EFI_ERROR (Status)) {
+      Delay        = DivU64x32 (Timeout, 1000) + 1;
+      InfiniteWait = (BOOLEAN)(Timeout == 0);
+      do {
+        //
+        // The non-blocking tasks may share the port, so check the tag at the
+        // same TPL as AsyncNonBlockingTransferRoutine().
+        //
+        OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+        Status = AhciNcqCheckCommand (PciIo, AhciRegisters, Port, Tag, AtaStatusBlock);
+        gBS->RestoreTPL (OldTpl);
+        if (Status != EFI_NOT_READY) {
+          break;
+        }
+
+        //
+        // Stall for 100 microseconds.
+        //
+        MicroSecondDelay (100);
+        Delay--;
+      } while (InfiniteWait || (Delay > 0));
+
+      if (Status == EFI_NOT_READY) {
+        OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+        AhciNcqRecoverPort (PciIo, AhciRegisters, Port);
+        AhciNcqCheckCommand (PciIo, AhciRegisters, Port, Tag, AtaStatusBlock);
+        gBS->RestoreTPL (OldTpl);
+        Status = EFI_TIMEOUT;
+      }
+    }
+
+    PciIo->Unmap (PciIo, Map);
+  } else {
+    if (!Task->IsStart) {
+      Status = AhciNcqIssueCommand (PciIo, AhciRegisters, Port, Read, AtaCommandBlock, Task->DataPhyAddr, DataCount, &Task->Tag);
+      if (!EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_VERBOSE, "Starting NCQ command on port %d tag %d\n", Port, Task->Tag));
+        Task->IsStart = TRUE;
+      }
+    }
+
+    if (Task->IsStart) {
+      Status = AhciNcqCheckCommand (PciIo, AhciRegisters, Port, Task->Tag, AtaStatusBlock);
+      if (Status == EFI_NOT_READY) {
+        if (!Task->InfiniteWait && (Task->RetryTimes == 0)) {
+          AhciNcqRecoverPort (PciIo, AhciRegisters, Port);
+          AhciNcqCheckCommand (PciIo, AhciRegisters, Port, Task->Tag, AtaStatusBlock);
+          Status = EFI_TIMEOUT;
+        } else {
+          Task->RetryTimes--;
+        }
+      }
+    }
+
+    //
+    // The task keeps its mapping while it waits for a free tag or for the
+    // completion.
+    //
+    if (Status != EFI_NOT_READY) {
+      PciIo->Unmap (PciIo, Task->Map);
+      Task->Map = NULL;
+    }
+  }
+
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_READY)) {
+    if (AtaStatusBlock != NULL) {
+      AtaStatusBlock->AtaStatus |= EFI_AHCI_PORT_TFD_ERR;
+    }
+
+    DEBUG ((DEBUG_ERROR, "Failed to execute NCQ command: %r\n", Status));
+    AhciPrintCommandBlock (AtaCommandBlock, DEBUG_ERROR);
+    AhciPrintStatusBlock (AtaStatusBlock, DEBUG_ERROR);
+  }
+
+  return Status;
+}
+
+/**
+  Take a port out of the NCQ mode, so that the next command runs on the
+  single slot command list shared by all ports.
+
+  In blocking mode, the outstanding queued commands of the port are pushed
+  to finish first.
+
+  @param[in]  Instance      The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  Port          The number of port.
+  @param[in]  Task          Optional. Pointer to the ATA_NONBLOCK_TASK
+                            used by non-blocking mode.
+
+  @retval EFI_SUCCESS       The port is not running queued commands.
+  @retval EFI_NOT_READY     Queued commands are still outstanding on the port.
+  @retval others            The port failed to stop.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqStopPort (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT8                         Port,
+  IN ATA_NONBLOCK_TASK             *Task OPTIONAL
+  )
+{
+  AHCI_NCQ_PORT  *NcqPort;
+  EFI_TPL        OldTpl;
+
+  NcqPort = Instance->AhciRegisters.NcqPort[Port];
+  if ((NcqPort == NULL) || !NcqPort->Started) {
+    return EFI_SUCCESS;
+  }
+
+  if ((NcqPort->ActiveTags != 0) && (Task == NULL)) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    while ((NcqPort->ActiveTags != 0) && !IsListEmpty (&Instance->NonBlockingTaskList)) {
+      AsyncNonBlockingTransferRoutine (NULL, Instance);
+      //
+      // Stall for 100us.
+      //
+      MicroSecondDelay (100);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (NcqPort->ActiveTags != 0) {
+    return EFI_NOT_READY;
+  }
+
+  return AhciNcqReleasePort (Instance->PciIo, &Instance->AhciRegisters, Port);
+}
+
+/**
+  Stop all the ports running queued commands and free the NCQ resources.
+
+  @param[in]       PciIo               The PCI IO protocol instance.
+  @param[in, out]  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+
+**/
+VOID
+EFIAPI
+AhciNcqFreePorts (
+  IN     EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN OUT EFI_AHCI_REGISTERS   *AhciRegisters
+  )
+{
+  AHCI_NCQ_PORT  *NcqPort;
+  UINT8          Port;
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    NcqPort = AhciRegisters->NcqPort[Port];
+    if (NcqPort == NULL) {
+      continue;
+    }
+
+    AhciNcqReleasePort (PciIo, AhciRegisters, Port);
+    PciIo->Unmap (PciIo, NcqPort->MapCmdList);
+    PciIo->FreeBuffer (PciIo, EFI_SIZE_TO_PAGES (AHCI_NCQ_BUFFER_SIZE), NcqPort->CmdList);
+    FreePool (NcqPort);
+    AhciRegisters->NcqPort[Port] = NULL;
+  }
+}
+
 /**
   Enable DEVSLP of the disk if supported.
 
@@ -14,6 +14,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET  0x0000
 #define   EFI_AHCI_CAP_SAM          BIT18
 #define   EFI_AHCI_CAP_SSS          BIT27
+#define   EFI_AHCI_CAP_SNCQ         BIT30
 #define   EFI_AHCI_CAP_S64A         BIT31
 #define EFI_AHCI_GHC_OFFSET         0x0004
 #define   EFI_AHCI_GHC_RESET        BIT0
@@ -311,6 +312,27 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Native command queuing allows up to 32 outstanding commands per port. A port
+// running queued commands switches to its own command list, which is followed
+// by one command table per tag. 64 PRDT entries cover 0x10000 sectors of 4KB.
+//
+#define AHCI_NCQ_MAX_TAGS            32
+#define AHCI_NCQ_MAX_PRDT            64
+#define AHCI_NCQ_COMMAND_LIST_SIZE   (AHCI_NCQ_MAX_TAGS * sizeof (EFI_AHCI_COMMAND_LIST))
+#define AHCI_NCQ_COMMAND_TABLE_SIZE  (OFFSET_OF (EFI_AHCI_COMMAND_TABLE, PrdtTable) + AHCI_NCQ_MAX_PRDT * sizeof (EFI_AHCI_COMMAND_PRDT))
+#define AHCI_NCQ_BUFFER_SIZE         (AHCI_NCQ_COMMAND_LIST_SIZE + AHCI_NCQ_MAX_TAGS * AHCI_NCQ_COMMAND_TABLE_SIZE)
+
+typedef struct {
+  EFI_AHCI_COMMAND_LIST    *CmdList;
+  EFI_PHYSICAL_ADDRESS     CmdListPciAddr;
+  VOID                     *MapCmdList;
+  UINT32                   TagMask;    // Tags usable on the port.
+  UINT32                   ActiveTags; // Tags issued and not completed yet.
+  UINT32                   FailedTags; // Tags aborted by an error recovery.
+  BOOLEAN                  Started;    // The port runs on CmdList.
+} AHCI_NCQ_PORT;
+
 typedef struct {
   EFI_AHCI_RECEIVED_FIS     *AhciRFis;
   EFI_AHCI_COMMAND_LIST     *AhciCmdList;
@@ -324,6 +346,7 @@ typedef struct {
   VOID                      *MapRFis;
   VOID                      *MapCmdList;
   VOID                      *MapCommandTable;
+  AHCI_NCQ_PORT             *NcqPort[EFI_AHCI_MAX_PORTS];
 } EFI_AHCI_REGISTERS;
 
 /**
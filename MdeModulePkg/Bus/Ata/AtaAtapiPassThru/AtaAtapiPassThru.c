@@ -193,6 +193,7 @@ AtaPassThruPassThruExecute (
   EFI_ATA_PASS_THRU_CMD_PROTOCOL  Protocol;
   EFI_ATA_HC_WORK_MODE            Mode;
   EFI_STATUS                      Status;
+  BOOLEAN                         Read;
 
   Protocol = Packet->Protocol;
 
@@ -286,6 +287,17 @@ AtaPassThruPassThruExecute (
         PortMultiplierPort = 0;
       }
 
+      //
+      // Commands that are not queued run on the single slot command list,
+      // so take the port out of the NCQ mode first.
+      //
+      if (Protocol != EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+        Status = AhciNcqStopPort (Instance, (UINT8)Port, Task);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
       switch (Protocol) {
         case EFI_ATA_PASS_THRU_PROTOCOL_ATA_NON_DATA:
           Status = AhciNonDataTransfer (
@@ -369,6 +381,21 @@ AtaPassThruPassThruExecute (
                      Task
                      );
           break;
+        case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
+          Read   = (BOOLEAN)(Packet->InTransferLength != 0);
+          Status = AhciNcqTransfer (
+                     Instance,
+                     &Instance->AhciRegisters,
+                     (UINT8)Port,
+                     Read,
+                     Packet->Acb,
+                     Packet->Asb,
+                     Read ? Packet->InDataBuffer : Packet->OutDataBuffer,
+                     Read ? Packet->InTransferLength : Packet->OutTransferLength,
+                     Packet->Timeout,
+                     Task
+                     );
+          break;
         default:
           return EFI_UNSUPPORTED;
       }
@@ -409,13 +436,17 @@ AsyncNonBlockingTransferRoutine (
   //
   // Get the Tasks from the Tasks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
-  //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
-      return;
+  // Queued (FPDMA) tasks don't keep the device busy, all of them are
+  // issued as long as the port has free tags. Other tasks only run at
+  // the head of the list, and the tasks behind them wait.
+  //
+  Entry = GetFirstNode (EntryHeader);
+  while (!IsNull (EntryHeader, Entry)) {
+    Task = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    if ((Task->Packet->Protocol != EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) &&
+        (Entry != GetFirstNode (EntryHeader)))
+    {
+      break;
     }
 
     Status = AtaPassThruPassThruExecute (
@@ -430,7 +461,17 @@ AsyncNonBlockingTransferRoutine (
     // If the data transfer meet a error, remove all tasks in the list since these tasks are
     // associated with one task from Ata Bus and signal the event with error status.
     //
+    // Queued tasks may come from different tasks of Ata Bus, so only the failed one is
+    // removed. Its status block already reports the error.
+    //
     if ((Status != EFI_NOT_READY) && (Status != EFI_SUCCESS)) {
+      if (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+        Entry = RemoveEntryList (&Task->Link);
+        gBS->SignalEvent (Task->Event);
+        FreePool (Task);
+        continue;
+      }
+
       DestroyAsynTaskList (Instance, TRUE);
       break;
     }
@@ -440,9 +481,13 @@ AsyncNonBlockingTransferRoutine (
     // is not finished yet. Otherwise the operation is successful.
     //
     if (Status == EFI_NOT_READY) {
-      break;
+      if (Task->Packet->Protocol != EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) {
+        break;
+      }
+
+      Entry = GetNextNode (EntryHeader, Entry);
     } else {
-      RemoveEntryList (&Task->Link);
+      Entry = RemoveEntryList (&Task->Link);
       gBS->SignalEvent (Task->Event);
       FreePool (Task);
     }
@@ -936,6 +981,13 @@ AtaAtapiPassThruStop (
 
   PciIo = Instance->PciIo;
 
+  //
+  // Stop the ports running queued commands before the controller is disabled.
+  //
+  if (Instance->Mode == EfiAtaAhciMode) {
+    AhciNcqFreePorts (PciIo, &Instance->AhciRegisters);
+  }
+
   //
   // Disable this ATA host controller.
   //
@@ -1328,6 +1380,16 @@ AtaPassThruPassThru (
   DeviceInfo     = ATA_ATAPI_DEVICE_INFO_FROM_THIS (Node);
   IdentifyData   = DeviceInfo->IdentifyData;
   MaxSectorCount = 0x100;
+
+  //
+  // Native command queuing is only available when both the HBA and the device
+  // support it. Check it before the task is queued, as non-blocking tasks only
+  // report errors through the status block.
+  //
+  if ((Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) && !AhciNcqSupported (Instance, DeviceInfo)) {
+    return EFI_UNSUPPORTED;
+  }
+
   if ((IdentifyData->AtaData.command_set_supported_83 & (BIT10 | BIT15 | BIT14)) == 0x4400) {
     Capacity = *((UINT64 *)IdentifyData->AtaData.maximum_lba_for_48bit_addressing);
     if (Capacity > 0xFFFFFFF) {
@@ -139,6 +139,8 @@ struct _ATA_NONBLOCK_TASK {
   VOID                                *TableMap;       // Pointer to PRD table map.
   EFI_ATA_DMA_PRD                     *MapBaseAddress; //  Pointer to range Base address for Map.
   UINTN                               PageCount;       //  The page numbers used by PCIO freebuffer.
+  EFI_PHYSICAL_ADDRESS                DataPhyAddr;     //  Bus master address of the data buffer for NCQ.
+  UINT8                               Tag;             //  The NCQ tag used by the command.
 };
 
 //
@@ -1150,6 +1152,104 @@ AhciDmaTransfer (
   IN     ATA_NONBLOCK_TASK             *Task
   );
 
+/**
+  Check whether native command queuing can be used for an ATA device.
+
+  @param[in]  Instance      The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  DeviceInfo    The EFI_ATA_DEVICE_INFO of the device.
+
+  @retval TRUE    Both the HBA and the device support NCQ.
+  @retval FALSE   NCQ can not be used for the device.
+
+**/
+BOOLEAN
+EFIAPI
+AhciNcqSupported (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN EFI_ATA_DEVICE_INFO           *DeviceInfo
+  );
+
+/**
+  Start a READ/WRITE FPDMA QUEUED command on specific port.
+
+  The command is issued on a free tag of the port, so that several commands
+  can be outstanding at the same time. In blocking mode, the function waits
+  for the command to complete. In non-blocking mode, EFI_NOT_READY is returned
+  until the command is completed, including when no tag is free yet.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_DEVICE_ERROR    The queued command is aborted with error.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_NOT_READY       The non-blocking command is not completed yet.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer can not be mapped or described.
+  @retval EFI_SUCCESS         The queued command executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN     EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK          *AtaStatusBlock,
+  IN OUT VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN     UINT64                        Timeout,
+  IN     ATA_NONBLOCK_TASK             *Task OPTIONAL
+  );
+
+/**
+  Take a port out of the NCQ mode, so that the next command runs on the
+  single slot command list shared by all ports.
+
+  In blocking mode, the outstanding queued commands of the port are pushed
+  to finish first.
+
+  @param[in]  Instance      The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]  Port          The number of port.
+  @param[in]  Task          Optional. Pointer to the ATA_NONBLOCK_TASK
+                            used by non-blocking mode.
+
+  @retval EFI_SUCCESS       The port is not running queued commands.
+  @retval EFI_NOT_READY     Queued commands are still outstanding on the port.
+  @retval others            The port failed to stop.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciNcqStopPort (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT8                         Port,
+  IN ATA_NONBLOCK_TASK             *Task OPTIONAL
+  );
+
+/**
+  Stop all the ports running queued commands and free the NCQ resources.
+
+  @param[in]       PciIo               The PCI IO protocol instance.
+  @param[in, out]  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+
+**/
+VOID
+EFIAPI
+AhciNcqFreePorts (
+  IN     EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN OUT EFI_AHCI_REGISTERS   *AhciRegisters
+  );
+
 /**
   Start a PIO data transfer on specific port.
 
@@ -80,6 +80,8 @@ ATA_DEVICE  gAtaDeviceTemplate = {
   NULL,                                       // Asb
   FALSE,                                      // UdmaValid
   FALSE,                                      // Lba48Bit
+  FALSE,                                      // NcqValid
+  0,                                          // QueueDepth
   NULL,                                       // IdentifyData
   NULL,                                       // ControllerNameTable
   { L'\0',                                 }, // ModelName
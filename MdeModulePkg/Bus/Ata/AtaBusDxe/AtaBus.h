@@ -115,6 +115,8 @@ typedef struct {
 
   BOOLEAN                                  UdmaValid;
   BOOLEAN                                  Lba48Bit;
+  BOOLEAN                                  NcqValid;
+  UINT32                                   QueueDepth;
 
   //
   // Cached data for ATA identify data
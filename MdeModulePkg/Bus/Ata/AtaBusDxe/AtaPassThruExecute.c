@@ -65,6 +65,14 @@ UINT8  mAtaCommands[][2][2] = {
   }
 };
 
+//
+// Look up table (IsWrite) for the native command queuing ATA_CMD
+//
+UINT8  mAtaFpdmaCommands[2] = {
+  ATA_CMD_READ_FPDMA_QUEUED,          // NCQ read
+  ATA_CMD_WRITE_FPDMA_QUEUED          // NCQ write
+};
+
 //
 // Look up table (UdmaValid, IsTrustSend) for ATA_CMD
 //
@@ -319,6 +327,18 @@ IdentifyAtaDevice (
     }
   }
 
+  //
+  // Check whether native command queuing is supported (WORD 76 bit 8), the
+  // queue depth is reported in WORD 75. WORD 76 is not valid if it is 0xFFFF.
+  //
+  if (AtaDevice->UdmaValid &&
+      (IdentifyData->serial_ata_capabilities != 0xFFFF) &&
+      ((IdentifyData->serial_ata_capabilities & BIT8) != 0))
+  {
+    AtaDevice->NcqValid   = TRUE;
+    AtaDevice->QueueDepth = (IdentifyData->queue_depth & 0x1F) + 1;
+  }
+
   Capacity = GetAtapi6Capacity (AtaDevice);
   if (Capacity > MAX_28BIT_ADDRESSING_CAPACITY) {
     //
@@ -471,6 +491,7 @@ TransferAtaDevice (
 {
   EFI_ATA_COMMAND_BLOCK             *Acb;
   EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+  EFI_STATUS                        Status;
 
   //
   // Ensure AtaDevice->UdmaValid, AtaDevice->Lba48Bit and IsWrite are valid boolean values
@@ -488,7 +509,21 @@ TransferAtaDevice (
   Acb->AtaCylinderHigh = (UINT8)RShiftU64 (StartLba, 16);
   Acb->AtaDeviceHead   = (UINT8)(BIT7 | BIT6 | BIT5 | (AtaDevice->PortMultiplierPort == 0xFFFF ? 0 : (AtaDevice->PortMultiplierPort << 4)));
   Acb->AtaSectorCount  = (UINT8)TransferLength;
-  if (AtaDevice->Lba48Bit) {
+  if (AtaDevice->NcqValid) {
+    //
+    // READ/WRITE FPDMA QUEUED always use 48-bit LBA. The sector count goes to the
+    // features registers, the tag in the sector count register is assigned by the
+    // ATA pass through driver.
+    //
+    Acb->AtaCommand         = mAtaFpdmaCommands[IsWrite];
+    Acb->AtaFeatures        = (UINT8)TransferLength;
+    Acb->AtaFeaturesExp     = (UINT8)(TransferLength >> 8);
+    Acb->AtaSectorCount     = 0;
+    Acb->AtaDeviceHead      = BIT6;
+    Acb->AtaSectorNumberExp = (UINT8)RShiftU64 (StartLba, 24);
+    Acb->AtaCylinderLowExp  = (UINT8)RShiftU64 (StartLba, 32);
+    Acb->AtaCylinderHighExp = (UINT8)RShiftU64 (StartLba, 40);
+  } else if (AtaDevice->Lba48Bit) {
     Acb->AtaSectorNumberExp = (UINT8)RShiftU64 (StartLba, 24);
     Acb->AtaCylinderLowExp  = (UINT8)RShiftU64 (StartLba, 32);
     Acb->AtaCylinderHighExp = (UINT8)RShiftU64 (StartLba, 40);
@@ -514,8 +549,13 @@ TransferAtaDevice (
     Packet->InTransferLength = TransferLength;
   }
 
-  Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
-  Packet->Length   = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
+  if (AtaDevice->NcqValid) {
+    Packet->Protocol = EFI_ATA_PASS_THRU_PROTOCOL_FPDMA;
+  } else {
+    Packet->Protocol = mAtaPassThruCmdProtocols[AtaDevice->UdmaValid][IsWrite];
+  }
+
+  Packet->Length = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
   //
   // |------------------------|-----------------|------------------------|-----------------|
   // | ATA PIO Transfer Mode  |  Transfer Rate  | ATA DMA Transfer Mode  |  Transfer Rate  |
@@ -549,7 +589,25 @@ TransferAtaDevice (
     Packet->Timeout = EFI_TIMER_PERIOD_SECONDS (DivU64x32 (MultU64x32 (TransferLength, AtaDevice->BlockMedia.BlockSize), 3300000) + 31);
   }
 
-  return AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  Status = AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  if ((Status == EFI_UNSUPPORTED) && AtaDevice->NcqValid) {
+    //
+    // The ATA pass through driver can not queue commands to the device,
+    // fall back to the DMA commands.
+    //
+    DEBUG ((DEBUG_INFO, "AtaBus - NCQ is not available on Port %x, use DMA\n", AtaDevice->Port));
+    AtaDevice->NcqValid = FALSE;
+    if (TaskPacket != NULL) {
+      FreeAlignedBuffer (TaskPacket->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+      if (TaskPacket->Acb != NULL) {
+        FreePool (TaskPacket->Acb);
+      }
+    }
+
+    return TransferAtaDevice (AtaDevice, TaskPacket, Buffer, StartLba, TransferLength, IsWrite, Event);
+  }
+
+  return Status;
 }
 
 /**
@@ -632,6 +690,40 @@ AtaTerminateNonBlockingTask (
   gBS->RestoreTPL (OldTpl);
 }
 
+/**
+  Check whether the ATA device is busy with non-blocking requests.
+
+  Without native command queuing, the requests are serialized and the next one
+  is started once all subtasks of the current one are done. With NCQ, requests
+  are started as long as fewer subtasks than the device queue depth are
+  executing, the ATA pass through driver spreads them across its tags.
+
+  @param[in]  AtaDevice     The ATA child device involved for the operation.
+
+  @retval TRUE              A new request must wait in AtaTaskList.
+  @retval FALSE             A new request can be started now.
+
+**/
+BOOLEAN
+IsAtaDeviceBusy (
+  IN ATA_DEVICE  *AtaDevice
+  )
+{
+  LIST_ENTRY  *Entry;
+  UINT32      SubTaskCount;
+
+  if (!AtaDevice->NcqValid) {
+    return (BOOLEAN)!IsListEmpty (&AtaDevice->AtaSubTaskList);
+  }
+
+  SubTaskCount = 0;
+  BASE_LIST_FOR_EACH (Entry, &AtaDevice->AtaSubTaskList) {
+    SubTaskCount++;
+  }
+
+  return (BOOLEAN)(SubTaskCount >= AtaDevice->QueueDepth);
+}
+
 /**
   Call back function when the event is signaled.
 
@@ -700,31 +792,31 @@ AtaNonBlockingCallBack (
 
     FreePool (Task->UnsignalledEventCount);
     FreePool (Task->IsError);
+  }
 
-    //
-    // Finish all subtasks and move to the next task in AtaTaskList.
-    //
-    if (!IsListEmpty (&AtaDevice->AtaTaskList)) {
-      Entry   = GetFirstNode (&AtaDevice->AtaTaskList);
-      AtaTask = ATA_ASYN_TASK_FROM_ENTRY (Entry);
-      DEBUG ((DEBUG_BLKIO, "Start to embark a new Ata Task\n"));
-      DEBUG ((DEBUG_BLKIO, "AtaTask->NumberOfBlocks = %x; AtaTask->Token=%x\n", AtaTask->NumberOfBlocks, AtaTask->Token));
-      Status = AccessAtaDevice (
-                 AtaTask->AtaDevice,
-                 AtaTask->Buffer,
-                 AtaTask->StartLba,
-                 AtaTask->NumberOfBlocks,
-                 AtaTask->IsWrite,
-                 AtaTask->Token
-                 );
-      if (EFI_ERROR (Status)) {
-        AtaTask->Token->TransactionStatus = Status;
-        gBS->SignalEvent (AtaTask->Token->Event);
-      }
-
-      RemoveEntryList (Entry);
-      FreePool (AtaTask);
+  //
+  // Move to the next tasks in AtaTaskList as long as the device is not busy.
+  //
+  while (!IsListEmpty (&AtaDevice->AtaTaskList) && !IsAtaDeviceBusy (AtaDevice)) {
+    Entry   = GetFirstNode (&AtaDevice->AtaTaskList);
+    AtaTask = ATA_ASYN_TASK_FROM_ENTRY (Entry);
+    DEBUG ((DEBUG_BLKIO, "Start to embark a new Ata Task\n"));
+    DEBUG ((DEBUG_BLKIO, "AtaTask->NumberOfBlocks = %x; AtaTask->Token=%x\n", AtaTask->NumberOfBlocks, AtaTask->Token));
+    Status = AccessAtaDevice (
+               AtaTask->AtaDevice,
+               AtaTask->Buffer,
+               AtaTask->StartLba,
+               AtaTask->NumberOfBlocks,
+               AtaTask->IsWrite,
+               AtaTask->Token
+               );
+    if (EFI_ERROR (Status)) {
+      AtaTask->Token->TransactionStatus = Status;
+      gBS->SignalEvent (AtaTask->Token->Event);
     }
+
+    RemoveEntryList (Entry);
+    FreePool (AtaTask);
   }
 
   DEBUG ((
@@ -806,7 +898,7 @@ AccessAtaDevice (
   if ((Token != NULL) && (Token->Event != NULL)) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-    if (!IsListEmpty (&AtaDevice->AtaSubTaskList)) {
+    if (IsAtaDeviceBusy (AtaDevice)) {
       AtaTask = AllocateZeroPool (sizeof (ATA_BUS_ASYN_TASK));
       if (AtaTask == NULL) {
         gBS->RestoreTPL (OldTpl);
@@ -540,22 +540,36 @@ ProcessAsyncTaskList (
   EFI_BLOCK_IO2_TOKEN           *Token;
   BOOLEAN                       HasNewItem;
   EFI_STATUS                    Status;
+  UINT32                        BlockedNsid[NVME_MAX_ASYNC_QUEUES];
+  UINTN                         BlockedNum;
+  UINTN                         Index;
 
   Private    = (NVME_CONTROLLER_PRIVATE_DATA *)Context;
-  QueueId    = 2;
-  Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  HasNewItem = FALSE;
   PciIo      = Private->PciIo;
+  BlockedNum = 0;
 
   //
-  // Submit asynchronous subtasks to the NVMe Submission Queue
+  // Submit asynchronous subtasks to the NVMe Submission Queue. The subtasks
+  // of a namespace whose queues are full stay in the list in order, while the
+  // subtasks of the other namespaces are still submitted to their own queues.
   //
   for (Link = GetFirstNode (&Private->UnsubmittedSubtasks);
        !IsNull (&Private->UnsubmittedSubtasks, Link);
        Link = NextLink)
   {
-    NextLink      = GetNextNode (&Private->UnsubmittedSubtasks, Link);
-    Subtask       = NVME_BLKIO2_SUBTASK_FROM_LINK (Link);
+    NextLink = GetNextNode (&Private->UnsubmittedSubtasks, Link);
+    Subtask  = NVME_BLKIO2_SUBTASK_FROM_LINK (Link);
+
+    for (Index = 0; Index < BlockedNum; Index++) {
+      if (BlockedNsid[Index] == Subtask->NamespaceId) {
+        break;
+      }
+    }
+
+    if (Index < BlockedNum) {
+      continue;
+    }
+
     BlkIo2Request = Subtask->BlockIo2Request;
     Token         = BlkIo2Request->Token;
     RemoveEntryList (Link);
@@ -592,9 +606,13 @@ ProcessAsyncTaskList (
                                  Subtask->Event
                                  );
     if (Status == EFI_NOT_READY) {
-      InsertHeadList (&Private->UnsubmittedSubtasks, Link);
+      InsertTailList (NextLink, Link);
       BlkIo2Request->UnsubmittedSubtaskNum++;
-      break;
+
+      BlockedNsid[BlockedNum++] = Subtask->NamespaceId;
+      if (BlockedNum == NVME_MAX_ASYNC_QUEUES) {
+        break;
+      }
     } else if (EFI_ERROR (Status)) {
       Token->TransactionStatus = EFI_DEVICE_ERROR;
 
@@ -621,85 +639,92 @@ ProcessAsyncTaskList (
     }
   }
 
-  while (Cq->Pt != Private->Pt[QueueId]) {
-    ASSERT (Cq->Sqid == QueueId);
+  for (QueueId = NVME_ASYNC_QUEUE_BASE;
+       QueueId < NVME_ASYNC_QUEUE_BASE + Private->AsyncQueueNum;
+       QueueId++)
+  {
+    Cq         = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    HasNewItem = FALSE;
 
-    HasNewItem = TRUE;
+    while (Cq->Pt != Private->Pt[QueueId]) {
+      ASSERT (Cq->Sqid == QueueId);
 
-    //
-    // Find the command with given Command Id.
-    //
-    for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
-         !IsNull (&Private->AsyncPassThruQueue, Link);
-         Link = NextLink)
-    {
-      NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
-      AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
-      if (AsyncRequest->CommandId == Cq->Cid) {
-        //
-        // Copy the Respose Queue entry for this command to the callers
-        // response buffer.
-        //
-        CopyMem (
-          AsyncRequest->Packet->NvmeCompletion,
-          Cq,
-          sizeof (EFI_NVM_EXPRESS_COMPLETION)
-          );
+      HasNewItem = TRUE;
 
-        //
-        // Free the resources allocated before cmd submission
-        //
-        if (AsyncRequest->MapData != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapData);
+      //
+      // Find the command with given Command Id.
+      //
+      for (Link = GetFirstNode (&Private->AsyncPassThruQueue);
+           !IsNull (&Private->AsyncPassThruQueue, Link);
+           Link = NextLink)
+      {
+        NextLink     = GetNextNode (&Private->AsyncPassThruQueue, Link);
+        AsyncRequest = NVME_PASS_THRU_ASYNC_REQ_FROM_THIS (Link);
+        if ((AsyncRequest->QueueId == QueueId) &&
+            (AsyncRequest->CommandId == Cq->Cid))
+        {
+          //
+          // Copy the Respose Queue entry for this command to the callers
+          // response buffer.
+          //
+          CopyMem (
+            AsyncRequest->Packet->NvmeCompletion,
+            Cq,
+            sizeof (EFI_NVM_EXPRESS_COMPLETION)
+            );
+
+          //
+          // Free the resources allocated before cmd submission
+          //
+          if (AsyncRequest->MapData != NULL) {
+            PciIo->Unmap (PciIo, AsyncRequest->MapData);
+          }
+
+          if (AsyncRequest->MapMeta != NULL) {
+            PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
+          }
+
+          if (AsyncRequest->PrpListHost != NULL) {
+            NvmeFreePrpList (
+              Private,
+              AsyncRequest->PrpListHost,
+              AsyncRequest->PrpListNo,
+              AsyncRequest->MapPrpList
+              );
+          }
+
+          RemoveEntryList (Link);
+          gBS->SignalEvent (AsyncRequest->CallerEvent);
+          FreePool (AsyncRequest);
+
+          //
+          // Update submission queue head.
+          //
+          Private->AsyncSqHead[QueueId] = Cq->Sqhd;
+          break;
         }
+      }
 
-        if (AsyncRequest->MapMeta != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
-        }
+      Private->CqHdbl[QueueId].Cqh++;
+      if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
+        Private->CqHdbl[QueueId].Cqh = 0;
+        Private->Pt[QueueId]        ^= 1;
+      }
 
-        if (AsyncRequest->MapPrpList != NULL) {
-          PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-        }
+      Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
+    }
 
-        if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
+    if (HasNewItem) {
+      Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
+      PciIo->Mem.Write (
                    PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
+                   EfiPciIoWidthUint32,
+                   NVME_BAR,
+                   NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
+                   1,
+                   &Data
                    );
-        }
-
-        RemoveEntryList (Link);
-        gBS->SignalEvent (AsyncRequest->CallerEvent);
-        FreePool (AsyncRequest);
-
-        //
-        // Update submission queue head.
-        //
-        Private->AsyncSqHead = Cq->Sqhd;
-        break;
-      }
-    }
-
-    Private->CqHdbl[QueueId].Cqh++;
-    if (Private->CqHdbl[QueueId].Cqh > MIN (NVME_ASYNC_CCQ_SIZE, Private->Cap.Mqes)) {
-      Private->CqHdbl[QueueId].Cqh = 0;
-      Private->Pt[QueueId]        ^= 1;
     }
-
-    Cq = Private->CqBuffer[QueueId] + Private->CqHdbl[QueueId].Cqh;
-  }
-
-  if (HasNewItem) {
-    Data = ReadUnaligned32 ((UINT32 *)&Private->CqHdbl[QueueId]);
-    PciIo->Mem.Write (
-                 PciIo,
-                 EfiPciIoWidthUint32,
-                 NVME_BAR,
-                 NVME_CQHDBL_OFFSET (QueueId, Private->Cap.Dstrd),
-                 1,
-                 &Data
-                 );
   }
 }
 
@@ -960,29 +985,27 @@ NvmExpressDriverBindingStart (
     }
 
     //
-    // 6 x 4kB aligned buffers will be carved out of this buffer.
-    // 1st 4kB boundary is the start of the admin submission queue.
-    // 2nd 4kB boundary is the start of the admin completion queue.
-    // 3rd 4kB boundary is the start of I/O submission queue #1.
-    // 4th 4kB boundary is the start of I/O completion queue #1.
-    // 5th 4kB boundary is the start of I/O submission queue #2.
-    // 6th 4kB boundary is the start of I/O completion queue #2.
+    // The admin queues, the blocking I/O queues and the asynchronous I/O
+    // queue pairs will be carved out of this buffer.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate the pages for the configured number of asynchronous I/O
+    // queue pairs, then map them for bus master read and write.
     //
-    Status = PciIo->AllocateBuffer (
-                      PciIo,
-                      AllocateAnyPages,
-                      EfiBootServicesData,
-                      6,
-                      (VOID **)&Private->Buffer,
-                      0
-                      );
+    Private->MaxAsyncQueueNum = MIN (MAX (PcdGet8 (PcdNvmeAsyncIoQueuePairs), 1), NVME_MAX_ASYNC_QUEUES);
+    Private->BufferPages      = NVME_QUEUE_BUFFER_PAGES (Private->MaxAsyncQueueNum);
+    Status                    = PciIo->AllocateBuffer (
+                                         PciIo,
+                                         AllocateAnyPages,
+                                         EfiBootServicesData,
+                                         Private->BufferPages,
+                                         (VOID **)&Private->Buffer,
+                                         0
+                                         );
     if (EFI_ERROR (Status)) {
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (Private->BufferPages);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -992,12 +1015,53 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (Private->BufferPages))) {
       goto Exit;
     }
 
     Private->BufferPciAddr = (UINT8 *)(UINTN)MappedAddr;
 
+    //
+    // Allocate the PRP list pool, so the asynchronous transfers do not
+    // allocate and map PRP lists one by one. The transfers fall back to
+    // allocating their own PRP lists if the pool is not available.
+    //
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      NVME_PRP_POOL_PAGES,
+                      (VOID **)&Private->PrpPool,
+                      0
+                      );
+    if (!EFI_ERROR (Status)) {
+      Bytes  = EFI_PAGES_TO_SIZE (NVME_PRP_POOL_PAGES);
+      Status = PciIo->Map (
+                        PciIo,
+                        EfiPciIoOperationBusMasterCommonBuffer,
+                        Private->PrpPool,
+                        &Bytes,
+                        &MappedAddr,
+                        &Private->PrpPoolMapping
+                        );
+      if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (NVME_PRP_POOL_PAGES))) {
+        if (!EFI_ERROR (Status)) {
+          PciIo->Unmap (PciIo, Private->PrpPoolMapping);
+        }
+
+        PciIo->FreeBuffer (PciIo, NVME_PRP_POOL_PAGES, Private->PrpPool);
+        Private->PrpPool        = NULL;
+        Private->PrpPoolMapping = NULL;
+      } else {
+        Private->PrpPoolPciAddr = (UINT8 *)(UINTN)MappedAddr;
+        Private->PrpPoolFree    = MAX_UINT64;
+      }
+    }
+
+    if (Private->PrpPool == NULL) {
+      DEBUG ((DEBUG_WARN, "NvmExpressDriverBindingStart: PRP list pool is not available\n"));
+    }
+
     Private->Signature                 = NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE;
     Private->ControllerHandle          = Controller;
     Private->ImageHandle               = This->DriverBindingHandle;
@@ -1102,7 +1166,15 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, Private->BufferPages, Private->Buffer);
+  }
+
+  if ((Private != NULL) && (Private->PrpPoolMapping != NULL)) {
+    PciIo->Unmap (PciIo, Private->PrpPoolMapping);
+  }
+
+  if ((Private != NULL) && (Private->PrpPool != NULL)) {
+    PciIo->FreeBuffer (PciIo, NVME_PRP_POOL_PAGES, Private->PrpPool);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1224,7 +1296,15 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, Private->BufferPages, Private->Buffer);
+      }
+
+      if (Private->PrpPoolMapping != NULL) {
+        Private->PciIo->Unmap (Private->PciIo, Private->PrpPoolMapping);
+      }
+
+      if (Private->PrpPool != NULL) {
+        Private->PciIo->FreeBuffer (Private->PciIo, NVME_PRP_POOL_PAGES, Private->PrpPool);
       }
 
       FreePool (Private->ControllerData);
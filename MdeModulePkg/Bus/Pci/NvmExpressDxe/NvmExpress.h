@@ -40,6 +40,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/ReportStatusCodeLib.h>
+#include <Library/PcdLib.h>
 
 typedef struct _NVME_CONTROLLER_PRIVATE_DATA  NVME_CONTROLLER_PRIVATE_DATA;
 typedef struct _NVME_DEVICE_PRIVATE_DATA      NVME_DEVICE_PRIVATE_DATA;
@@ -64,16 +65,38 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 
 //
 // Number of asynchronous I/O submission queue entries, which is 0-based.
-// The asynchronous I/O submission queue size is 4kB in total.
+// Each asynchronous I/O submission queue is 16kB in total.
 //
-#define NVME_ASYNC_CSQ_SIZE  63
+#define NVME_ASYNC_CSQ_SIZE  255
 //
 // Number of asynchronous I/O completion queue entries, which is 0-based.
-// The asynchronous I/O completion queue size is 4kB in total.
+// Each asynchronous I/O completion queue is 4kB in total.
 //
 #define NVME_ASYNC_CCQ_SIZE  255
 
-#define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
+#define NVME_ASYNC_SQ_PAGES  EFI_SIZE_TO_PAGES ((NVME_ASYNC_CSQ_SIZE + 1) * sizeof (NVME_SQ))
+#define NVME_ASYNC_CQ_PAGES  EFI_SIZE_TO_PAGES ((NVME_ASYNC_CCQ_SIZE + 1) * sizeof (NVME_CQ))
+
+#define NVME_ASYNC_QUEUE_BASE   2                       // Queue ID of the first asynchronous I/O queue pair
+#define NVME_MAX_ASYNC_QUEUES   8                       // Maximum number of asynchronous I/O queue pairs
+#define NVME_MAX_QUEUES         (NVME_ASYNC_QUEUE_BASE + NVME_MAX_ASYNC_QUEUES)
+
+//
+// Number of pages holding the admin queues, the blocking I/O queues and the
+// given number of asynchronous I/O queue pairs.
+//
+#define NVME_QUEUE_BUFFER_PAGES(AsyncQueues) \
+  (4 + (AsyncQueues) * (NVME_ASYNC_SQ_PAGES + NVME_ASYNC_CQ_PAGES))
+
+//
+// Number of pages in the PRP list pool. The pool is tracked by a 64-bit bitmap.
+//
+#define NVME_PRP_POOL_PAGES  64
+
+//
+// Feature identifier of the Number of Queues feature.
+//
+#define NVME_FEATURE_NUMBER_OF_QUEUES  0x07
 
 #define NVME_CONTROLLER_ID  0
 
@@ -116,16 +139,25 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   NVME_ADMIN_CONTROLLER_DATA            *ControllerData;
 
   //
-  // 6 x 4kB aligned buffers will be carved out of this buffer.
+  // The 4kB aligned queues will be carved out of this buffer.
   // 1st 4kB boundary is the start of the admin submission queue.
   // 2nd 4kB boundary is the start of the admin completion queue.
   // 3rd 4kB boundary is the start of I/O submission queue #1.
   // 4th 4kB boundary is the start of I/O completion queue #1.
-  // 5th 4kB boundary is the start of I/O submission queue #2.
-  // 6th 4kB boundary is the start of I/O completion queue #2.
+  // Then each asynchronous I/O queue pair takes NVME_ASYNC_SQ_PAGES for
+  // the submission queue followed by NVME_ASYNC_CQ_PAGES for the
+  // completion queue.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
+  UINTN          BufferPages;
+
+  //
+  // Number of asynchronous I/O queue pairs the buffer has room for, and
+  // the number of them created on the controller.
+  //
+  UINT16         MaxAsyncQueueNum;
+  UINT16         AsyncQueueNum;
 
   //
   // Pointers to 4kB aligned submission & completion queues.
@@ -140,7 +172,7 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   //
   NVME_SQTDBL    SqTdbl[NVME_MAX_QUEUES];
   NVME_CQHDBL    CqHdbl[NVME_MAX_QUEUES];
-  UINT16         AsyncSqHead;
+  UINT16         AsyncSqHead[NVME_MAX_QUEUES];
 
   //
   // Flag to indicate internal IO queue creation.
@@ -157,6 +189,15 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
 
   VOID           *Mapping;
 
+  //
+  // Pool of mapped pages for PRP lists. A set bit in PrpPoolFree means
+  // the page is free.
+  //
+  UINT8          *PrpPool;
+  UINT8          *PrpPoolPciAddr;
+  VOID           *PrpPoolMapping;
+  UINT64         PrpPoolFree;
+
   //
   // For Non-blocking operations.
   //
@@ -291,6 +332,7 @@ typedef struct {
   LIST_ENTRY                                  Link;
 
   EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET    *Packet;
+  UINT16                                      QueueId;
   UINT16                                      CommandId;
   VOID                                        *MapPrpList;
   UINTN                                       PrpListNo;
@@ -599,6 +641,24 @@ NvmExpressPassThru (
   IN     EFI_EVENT                                 Event OPTIONAL
   );
 
+/**
+  Release the PRP lists created by NvmeCreatePrpList().
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpListHost    The host base address of PRP lists.
+  @param[in] PrpListNo      The number of PRP List.
+  @param[in] Mapping        The mapping value returned from PciIo.Map(), or NULL if
+                            the PRP lists come from the PRP list pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  );
+
 /**
   Used to retrieve the next namespace ID for this NVM Express controller.
 
@@ -558,6 +558,78 @@ NvmeIdentifyNamespace (
   return Status;
 }
 
+/**
+  Request the I/O queues from the controller with the Number of Queues feature,
+  and limit the number of asynchronous I/O queue pairs to the queues allocated
+  by the controller.
+
+  If the feature fails, a single asynchronous I/O queue pair is used, as every
+  controller has room for the blocking and one non-blocking queue pair.
+
+  @param  Private          The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+
+  @return EFI_SUCCESS      Successfully set the number of queues.
+  @return EFI_DEVICE_ERROR Fail to set the number of queues.
+
+**/
+EFI_STATUS
+NvmeSetNumberOfQueues (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  )
+{
+  EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET  CommandPacket;
+  EFI_NVM_EXPRESS_COMMAND                   Command;
+  EFI_NVM_EXPRESS_COMPLETION                Completion;
+  EFI_STATUS                                Status;
+  NVME_ADMIN_SET_FEATURES                   SetFeatures;
+  UINT32                                    IoQueues;
+
+  ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
+  ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
+  ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
+  ZeroMem (&SetFeatures, sizeof (NVME_ADMIN_SET_FEATURES));
+
+  Private->AsyncQueueNum = 1;
+
+  CommandPacket.NvmeCmd        = &Command;
+  CommandPacket.NvmeCompletion = &Completion;
+  CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
+  CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
+
+  //
+  // The number of submission and completion queues are 0-based, and do not
+  // include the admin queues.
+  //
+  IoQueues            = NVME_ASYNC_QUEUE_BASE - 1 + Private->MaxAsyncQueueNum - 1;
+  Command.Cdw0.Opcode = NVME_ADMIN_SET_FEATURES_CMD;
+  SetFeatures.Fid     = NVME_FEATURE_NUMBER_OF_QUEUES;
+  CopyMem (&Command.Cdw10, &SetFeatures, sizeof (NVME_ADMIN_SET_FEATURES));
+  Command.Cdw11 = (IoQueues << 16) | IoQueues;
+  Command.Flags = CDW10_VALID | CDW11_VALID;
+
+  Status = Private->Passthru.PassThru (
+                               &Private->Passthru,
+                               NVME_CONTROLLER_ID,
+                               &CommandPacket,
+                               NULL
+                               );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "NvmeSetNumberOfQueues: failed to set the number of queues (%r)\n", Status));
+    return Status;
+  }
+
+  //
+  // The allocated numbers may be larger or smaller than the requested ones.
+  //
+  IoQueues               = MIN (Completion.DW0 & 0xFFFF, Completion.DW0 >> 16) + 1;
+  IoQueues               = MIN (IoQueues, NVME_ASYNC_QUEUE_BASE - 1 + Private->MaxAsyncQueueNum);
+  Private->AsyncQueueNum = (UINT16)MAX (IoQueues, NVME_ASYNC_QUEUE_BASE) - (NVME_ASYNC_QUEUE_BASE - 1);
+
+  DEBUG ((DEBUG_INFO, "NvmeSetNumberOfQueues: %d asynchronous I/O queue pairs\n", Private->AsyncQueueNum));
+
+  return EFI_SUCCESS;
+}
+
 /**
   Create io completion queue.
 
@@ -583,7 +655,7 @@ NvmeCreateIoCompletionQueue (
   Status                 = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_BASE + Private->AsyncQueueNum; Index++) {
     ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -598,7 +670,7 @@ NvmeCreateIoCompletionQueue (
     CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
-    if (Index == 1) {
+    if (Index < NVME_ASYNC_QUEUE_BASE) {
       QueueSize = NVME_CCQ_SIZE;
     } else {
       if (Private->Cap.Mqes > NVME_ASYNC_CCQ_SIZE) {
@@ -655,7 +727,7 @@ NvmeCreateIoSubmissionQueue (
   Status                 = EFI_SUCCESS;
   Private->CreateIoQueue = TRUE;
 
-  for (Index = 1; Index < NVME_MAX_QUEUES; Index++) {
+  for (Index = 1; Index < NVME_ASYNC_QUEUE_BASE + Private->AsyncQueueNum; Index++) {
     ZeroMem (&CommandPacket, sizeof (EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET));
     ZeroMem (&Command, sizeof (EFI_NVM_EXPRESS_COMMAND));
     ZeroMem (&Completion, sizeof (EFI_NVM_EXPRESS_COMPLETION));
@@ -670,7 +742,7 @@ NvmeCreateIoSubmissionQueue (
     CommandPacket.CommandTimeout = NVME_GENERIC_TIMEOUT;
     CommandPacket.QueueType      = NVME_ADMIN_QUEUE;
 
-    if (Index == 1) {
+    if (Index < NVME_ASYNC_QUEUE_BASE) {
       QueueSize = NVME_CSQ_SIZE;
     } else {
       if (Private->Cap.Mqes > NVME_ASYNC_CSQ_SIZE) {
@@ -726,6 +798,8 @@ NvmeControllerInit (
   NVME_ACQ             Acq;
   UINT8                Sn[21];
   UINT8                Mn[41];
+  UINT16               Index;
+  UINTN                Offset;
 
   //
   // Save original PCI attributes and enable this controller.
@@ -795,19 +869,11 @@ NvmeControllerInit (
   //
   ASSERT ((Private->Cap.Mpsmin + 12) <= EFI_PAGE_SHIFT);
 
-  Private->Cid[0]        = 0;
-  Private->Cid[1]        = 0;
-  Private->Cid[2]        = 0;
-  Private->Pt[0]         = 0;
-  Private->Pt[1]         = 0;
-  Private->Pt[2]         = 0;
-  Private->SqTdbl[0].Sqt = 0;
-  Private->SqTdbl[1].Sqt = 0;
-  Private->SqTdbl[2].Sqt = 0;
-  Private->CqHdbl[0].Cqh = 0;
-  Private->CqHdbl[1].Cqh = 0;
-  Private->CqHdbl[2].Cqh = 0;
-  Private->AsyncSqHead   = 0;
+  ZeroMem (Private->Cid, sizeof (Private->Cid));
+  ZeroMem (Private->Pt, sizeof (Private->Pt));
+  ZeroMem (Private->SqTdbl, sizeof (Private->SqTdbl));
+  ZeroMem (Private->CqHdbl, sizeof (Private->CqHdbl));
+  ZeroMem (Private->AsyncSqHead, sizeof (Private->AsyncSqHead));
 
   Status = NvmeDisableController (Private);
 
@@ -836,7 +902,7 @@ NvmeControllerInit (
   //
   // Address of I/O submission & completion queue.
   //
-  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (6));
+  ZeroMem (Private->Buffer, EFI_PAGES_TO_SIZE (Private->BufferPages));
   Private->SqBuffer[0]        = (NVME_SQ *)(UINTN)(Private->Buffer);
   Private->SqBufferPciAddr[0] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr);
   Private->CqBuffer[0]        = (NVME_CQ *)(UINTN)(Private->Buffer + 1 * EFI_PAGE_SIZE);
@@ -845,10 +911,15 @@ NvmeControllerInit (
   Private->SqBufferPciAddr[1] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 2 * EFI_PAGE_SIZE);
   Private->CqBuffer[1]        = (NVME_CQ *)(UINTN)(Private->Buffer + 3 * EFI_PAGE_SIZE);
   Private->CqBufferPciAddr[1] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 3 * EFI_PAGE_SIZE);
-  Private->SqBuffer[2]        = (NVME_SQ *)(UINTN)(Private->Buffer + 4 * EFI_PAGE_SIZE);
-  Private->SqBufferPciAddr[2] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + 4 * EFI_PAGE_SIZE);
-  Private->CqBuffer[2]        = (NVME_CQ *)(UINTN)(Private->Buffer + 5 * EFI_PAGE_SIZE);
-  Private->CqBufferPciAddr[2] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + 5 * EFI_PAGE_SIZE);
+
+  for (Index = NVME_ASYNC_QUEUE_BASE; Index < NVME_ASYNC_QUEUE_BASE + Private->MaxAsyncQueueNum; Index++) {
+    Offset                          = EFI_PAGES_TO_SIZE (NVME_QUEUE_BUFFER_PAGES (Index - NVME_ASYNC_QUEUE_BASE));
+    Private->SqBuffer[Index]        = (NVME_SQ *)(UINTN)(Private->Buffer + Offset);
+    Private->SqBufferPciAddr[Index] = (NVME_SQ *)(UINTN)(Private->BufferPciAddr + Offset);
+    Offset                         += EFI_PAGES_TO_SIZE (NVME_ASYNC_SQ_PAGES);
+    Private->CqBuffer[Index]        = (NVME_CQ *)(UINTN)(Private->Buffer + Offset);
+    Private->CqBufferPciAddr[Index] = (NVME_CQ *)(UINTN)(Private->BufferPciAddr + Offset);
+  }
 
   DEBUG ((DEBUG_INFO, "Private->Buffer = [%016X]\n", (UINT64)(UINTN)Private->Buffer));
   DEBUG ((DEBUG_INFO, "Admin     Submission Queue size (Aqa.Asqs) = [%08X]\n", Aqa.Asqs));
@@ -857,8 +928,10 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "Admin     Completion Queue (CqBuffer[0]) = [%016X]\n", Private->CqBuffer[0]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Submission Queue (SqBuffer[1]) = [%016X]\n", Private->SqBuffer[1]));
   DEBUG ((DEBUG_INFO, "Sync  I/O Completion Queue (CqBuffer[1]) = [%016X]\n", Private->CqBuffer[1]));
-  DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[2]) = [%016X]\n", Private->SqBuffer[2]));
-  DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[2]) = [%016X]\n", Private->CqBuffer[2]));
+  for (Index = NVME_ASYNC_QUEUE_BASE; Index < NVME_ASYNC_QUEUE_BASE + Private->MaxAsyncQueueNum; Index++) {
+    DEBUG ((DEBUG_INFO, "Async I/O Submission Queue (SqBuffer[%d]) = [%016X]\n", Index, Private->SqBuffer[Index]));
+    DEBUG ((DEBUG_INFO, "Async I/O Completion Queue (CqBuffer[%d]) = [%016X]\n", Index, Private->CqBuffer[Index]));
+  }
 
   //
   // Program admin queue attributes.
@@ -937,8 +1010,14 @@ NvmeControllerInit (
   DEBUG ((DEBUG_INFO, "    NN        : 0x%x\n", Private->ControllerData->Nn));
 
   //
-  // Create two I/O completion queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Request the I/O queues. On failure only one non-blocking I/O queue pair
+  // is created.
+  //
+  NvmeSetNumberOfQueues (Private);
+
+  //
+  // Create the I/O completion queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoCompletionQueue (Private);
   if (EFI_ERROR (Status)) {
@@ -946,8 +1025,8 @@ NvmeControllerInit (
   }
 
   //
-  // Create two I/O Submission queues.
-  // One for blocking I/O, one for non-blocking I/O.
+  // Create the I/O Submission queues.
+  // One for blocking I/O, the others for non-blocking I/O.
   //
   Status = NvmeCreateIoSubmissionQueue (Private);
 
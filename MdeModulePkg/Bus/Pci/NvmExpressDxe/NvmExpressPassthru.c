@@ -195,30 +195,113 @@ NvmeDumpStatus (
   }
 }
 
+/**
+  Take contiguous pages for PRP lists from the PRP list pool.
+
+  @param[in]  Private         The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]  PrpListNo       The number of PRP List.
+  @param[out] PrpListPhyAddr  The device address of the first PRP List.
+
+  @return The host address of the first PRP List, or NULL if the pool does not
+          have enough contiguous free pages.
+
+**/
+STATIC
+VOID *
+NvmeAllocatePrpPool (
+  IN  NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN  UINTN                         PrpListNo,
+  OUT EFI_PHYSICAL_ADDRESS          *PrpListPhyAddr
+  )
+{
+  UINT64   Mask;
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  if ((Private->PrpPool == NULL) || (PrpListNo > NVME_PRP_POOL_PAGES)) {
+    return NULL;
+  }
+
+  Mask   = (PrpListNo == NVME_PRP_POOL_PAGES) ? MAX_UINT64 : LShiftU64 (1, PrpListNo) - 1;
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Index = 0; Index <= NVME_PRP_POOL_PAGES - PrpListNo; Index++) {
+    if ((Private->PrpPoolFree & LShiftU64 (Mask, Index)) == LShiftU64 (Mask, Index)) {
+      Private->PrpPoolFree &= ~LShiftU64 (Mask, Index);
+      gBS->RestoreTPL (OldTpl);
+
+      *PrpListPhyAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)(Private->PrpPoolPciAddr + EFI_PAGES_TO_SIZE (Index));
+      return Private->PrpPool + EFI_PAGES_TO_SIZE (Index);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return NULL;
+}
+
+/**
+  Release the PRP lists created by NvmeCreatePrpList().
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] PrpListHost    The host base address of PRP lists.
+  @param[in] PrpListNo      The number of PRP List.
+  @param[in] Mapping        The mapping value returned from PciIo.Map(), or NULL if
+                            the PRP lists come from the PRP list pool.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo,
+  IN VOID                          *Mapping
+  )
+{
+  UINT64   Mask;
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  if (Mapping != NULL) {
+    Private->PciIo->Unmap (Private->PciIo, Mapping);
+    Private->PciIo->FreeBuffer (Private->PciIo, PrpListNo, PrpListHost);
+    return;
+  }
+
+  Index = ((UINTN)PrpListHost - (UINTN)Private->PrpPool) / EFI_PAGE_SIZE;
+  Mask  = (PrpListNo == NVME_PRP_POOL_PAGES) ? MAX_UINT64 : LShiftU64 (1, PrpListNo) - 1;
+
+  OldTpl                = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->PrpPoolFree |= LShiftU64 (Mask, Index);
+  gBS->RestoreTPL (OldTpl);
+}
+
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
+  The PRP lists are taken from the PRP list pool when it has enough contiguous free
+  pages, otherwise they are allocated and mapped for this transfer only.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
   @param[out]    PrpListHost         The host base address of PRP lists.
   @param[in,out] PrpListNo           The number of PRP List.
-  @param[out]    Mapping             The mapping value returned from PciIo.Map().
+  @param[out]    Mapping             The mapping value returned from PciIo.Map(), or NULL
+                                     if the PRP lists come from the PRP list pool.
 
   @retval The pointer to the first PRP List of the PRP lists.
 
 **/
 VOID *
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
-  IN     EFI_PHYSICAL_ADDRESS  PhysicalAddr,
-  IN     UINTN                 Pages,
-  OUT VOID                     **PrpListHost,
-  IN OUT UINTN                 *PrpListNo,
-  OUT VOID                     **Mapping
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT VOID                             **PrpListHost,
+  IN OUT UINTN                         *PrpListNo,
+  OUT VOID                             **Mapping
   )
 {
+  EFI_PCI_IO_PROTOCOL   *PciIo;
   UINTN                 PrpEntryNo;
   UINT64                PrpListBase;
   UINTN                 PrpListIndex;
@@ -228,6 +311,8 @@ NvmeCreatePrpList (
   UINTN                 Bytes;
   EFI_STATUS            Status;
 
+  PciIo = Private->PciIo;
+
   //
   // The number of Prp Entry in a memory page.
   //
@@ -247,32 +332,42 @@ NvmeCreatePrpList (
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
+  Bytes        = EFI_PAGES_TO_SIZE (*PrpListNo);
+  *Mapping     = NULL;
+  *PrpListHost = NvmeAllocatePrpPool (Private, *PrpListNo, &PrpListPhyAddr);
+  if (*PrpListHost == NULL) {
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      *PrpListNo,
+                      PrpListHost,
+                      0
+                      );
 
-  if (EFI_ERROR (Status)) {
-    return NULL;
-  }
+    if (EFI_ERROR (Status)) {
+      return NULL;
+    }
 
-  Bytes  = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
-
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
+    Status = PciIo->Map (
+                      PciIo,
+                      EfiPciIoOperationBusMasterCommonBuffer,
+                      *PrpListHost,
+                      &Bytes,
+                      &PrpListPhyAddr,
+                      Mapping
+                      );
+
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
+      DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+      if (!EFI_ERROR (Status)) {
+        PciIo->Unmap (PciIo, *Mapping);
+      }
+
+      PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
+      *Mapping = NULL;
+      return NULL;
+    }
   }
 
   //
@@ -280,7 +375,7 @@ NvmeCreatePrpList (
   //
   ZeroMem (*PrpListHost, Bytes);
   for (PrpListIndex = 0; PrpListIndex < *PrpListNo - 1; ++PrpListIndex) {
-    PrpListBase = *(UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+    PrpListBase = (UINTN)*PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
 
     for (PrpEntryIndex = 0; PrpEntryIndex < PrpEntryNo; ++PrpEntryIndex) {
       if (PrpEntryIndex != PrpEntryNo - 1) {
@@ -301,17 +396,67 @@ NvmeCreatePrpList (
   //
   // Fill last PRP list.
   //
-  PrpListBase = *(UINT64 *)PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
+  PrpListBase = (UINTN)*PrpListHost + PrpListIndex * EFI_PAGE_SIZE;
   for (PrpEntryIndex = 0; PrpEntryIndex < Remainder; ++PrpEntryIndex) {
     *((UINT64 *)(UINTN)PrpListBase + PrpEntryIndex) = PhysicalAddr;
     PhysicalAddr                                   += EFI_PAGE_SIZE;
   }
 
   return (VOID *)(UINTN)PrpListPhyAddr;
+}
 
-EXIT:
-  PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
-  return NULL;
+/**
+  Select the asynchronous I/O queue for a command sent to a namespace.
+
+  The namespaces share the asynchronous I/O queue pairs round robin, that is
+  each namespace owns the queues whose index is congruent to its namespace ID
+  modulo the number of namespaces. A namespace that has filled its queues
+  therefore never holds back the requests to another namespace. Among the
+  queues owned by the namespace, the one with the most free entries is used.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in] NamespaceId    The namespace ID the command is sent to.
+
+  @retval 0                 All the queues owned by the namespace are full.
+  @retval Others            The ID of the selected submission queue.
+
+**/
+STATIC
+UINT16
+NvmeSelectAsyncQueue (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN UINT32                        NamespaceId
+  )
+{
+  UINT16  QueueSize;
+  UINT16  Groups;
+  UINT16  Index;
+  UINT16  QueueId;
+  UINT16  Used;
+  UINT16  MinUsed;
+  UINT16  Selected;
+
+  QueueSize = MIN (NVME_ASYNC_CSQ_SIZE, Private->Cap.Mqes) + 1;
+  Groups    = (UINT16)MIN (MAX (Private->ControllerData->Nn, 1), Private->AsyncQueueNum);
+
+  if ((NamespaceId == 0) || (NamespaceId == (UINT32)-1)) {
+    Index = 0;
+  } else {
+    Index = (UINT16)((NamespaceId - 1) % Groups);
+  }
+
+  Selected = 0;
+  MinUsed  = QueueSize - 1;
+  for ( ; Index < Private->AsyncQueueNum; Index += Groups) {
+    QueueId = NVME_ASYNC_QUEUE_BASE + Index;
+    Used    = (Private->SqTdbl[QueueId].Sqt + QueueSize - Private->AsyncSqHead[QueueId]) % QueueSize;
+    if (Used < MinUsed) {
+      MinUsed  = Used;
+      Selected = QueueId;
+    }
+  }
+
+  return Selected;
 }
 
 /**
@@ -384,16 +529,13 @@ AbortAsyncPassThruTasks (
       PciIo->Unmap (PciIo, AsyncRequest->MapMeta);
     }
 
-    if (AsyncRequest->MapPrpList != NULL) {
-      PciIo->Unmap (PciIo, AsyncRequest->MapPrpList);
-    }
-
     if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+      NvmeFreePrpList (
+        Private,
+        AsyncRequest->PrpListHost,
+        AsyncRequest->PrpListNo,
+        AsyncRequest->MapPrpList
+        );
     }
 
     RemoveEntryList (Link);
@@ -561,14 +703,11 @@ NvmExpressPassThru (
     if (Event == NULL) {
       QueueId = 1;
     } else {
-      QueueId = 2;
-
       //
       // Submission queue full check.
       //
-      if ((Private->SqTdbl[QueueId].Sqt + 1) % QueueSize ==
-          Private->AsyncSqHead)
-      {
+      QueueId = NvmeSelectAsyncQueue (Private, NamespaceId);
+      if (QueueId == 0) {
         return EFI_NOT_READY;
       }
     }
@@ -680,7 +819,7 @@ NvmExpressPassThru (
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp     = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -760,6 +899,7 @@ NvmExpressPassThru (
 
     AsyncRequest->Signature   = NVME_PASS_THRU_ASYNC_REQ_SIG;
     AsyncRequest->Packet      = Packet;
+    AsyncRequest->QueueId     = QueueId;
     AsyncRequest->CommandId   = Sq->Cid;
     AsyncRequest->CallerEvent = Event;
     AsyncRequest->MapData     = MapData;
@@ -905,15 +1045,8 @@ EXIT:
              );
   }
 
-  if (MapPrpList != NULL) {
-    PciIo->Unmap (
-             PciIo,
-             MapPrpList
-             );
-  }
-
   if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+    NvmeFreePrpList (Private, PrpListHost, PrpListNo, MapPrpList);
   }
 
   if (TimerEvent != NULL) {
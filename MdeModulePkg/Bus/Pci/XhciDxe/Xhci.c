@@ -85,6 +85,14 @@ EFI_USB2_HC_PROTOCOL  gXhciUsb2HcTemplate = {
   0x0
 };
 
+EDKII_USB_ASYNC_BULK_PROTOCOL  gXhciAsyncBulkTemplate = {
+  EDKII_USB_ASYNC_BULK_PROTOCOL_REVISION,
+  XhcAsyncBulkEnableStreams,
+  XhcAsyncBulkSubmit,
+  XhcAsyncBulkPoll,
+  XhcAsyncBulkCancel
+};
+
 /**
   Retrieves the capability of root hub ports.
 
@@ -766,7 +774,8 @@ XhcTransfer (
           Data,
           *DataLength,
           NULL,
-          NULL
+          NULL,
+          0
           );
 
   if (Urb == NULL) {
@@ -1642,6 +1651,327 @@ XhcAsyncIsochronousTransfer (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Enable the streams of a SuperSpeed bulk endpoint.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DevicePath           The device path of the device, relative to the host controller.
+  @param  EndpointAddress      The address of the bulk endpoint, with the direction in bit 7.
+  @param  StreamNumber         On input, the number of streams requested. On output,
+                               the number of streams enabled.
+
+  @retval EFI_SUCCESS           The streams are enabled.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_FOUND         The device is not attached to the host controller.
+  @retval EFI_UNSUPPORTED       The host controller does not support streams.
+  @retval EFI_OUT_OF_RESOURCES  The stream rings could not be allocated.
+  @retval EFI_DEVICE_ERROR      The host controller failed to configure the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkEnableStreams (
+  IN     EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN     EFI_DEVICE_PATH_PROTOCOL       *DevicePath,
+  IN     UINT8                          EndpointAddress,
+  IN OUT UINT16                         *StreamNumber
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+  UINT8              SlotId;
+  UINT8              Dci;
+
+  if ((DevicePath == NULL) || (StreamNumber == NULL) || ((EndpointAddress & 0x0F) == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_ASYNC_BULK_THIS (This);
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    goto ON_EXIT;
+  }
+
+  SlotId = XhcDevicePathToSlotId (Xhc, DevicePath);
+  if (SlotId == 0) {
+    Status = EFI_NOT_FOUND;
+    goto ON_EXIT;
+  }
+
+  Dci    = XhcEndpointToDci ((UINT8)(EndpointAddress & 0x0F), XHCI_IS_DATAIN (EndpointAddress) ? EfiUsbDataIn : EfiUsbDataOut);
+  Status = XhcEnableEndpointStreams (Xhc, SlotId, Dci, StreamNumber);
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Submit a bulk transfer and return without waiting for its completion.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DevicePath           The device path of the device, relative to the host controller.
+  @param  EndpointAddress      The address of the bulk endpoint, with the direction in bit 7.
+  @param  StreamId             The stream of the endpoint, or 0 if its streams are not enabled.
+  @param  Data                 The data buffer to transfer.
+  @param  DataLength           The length of the data buffer in bytes.
+  @param  Transfer             The token of the submitted transfer.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_FOUND         The device is not attached to the host controller.
+  @retval EFI_OUT_OF_RESOURCES  The transfer ring is full, or the data can't be mapped.
+  @retval EFI_DEVICE_ERROR      The host controller is halted.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkSubmit (
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  EFI_DEVICE_PATH_PROTOCOL       *DevicePath,
+  IN  UINT8                          EndpointAddress,
+  IN  UINT16                         StreamId,
+  IN  VOID                           *Data,
+  IN  UINTN                          DataLength,
+  OUT VOID                           **Transfer
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+  UINT8              SlotId;
+  UINT8              Dci;
+  UINT8              EPType;
+  TRANSFER_RING      *Ring;
+  LIST_ENTRY         *Entry;
+  URB                *Urb;
+  UINTN              TrbNum;
+
+  if ((DevicePath == NULL) || (Data == NULL) || (DataLength == 0) ||
+      (Transfer == NULL) || ((EndpointAddress & 0x0F) == 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc       = XHC_FROM_ASYNC_BULK_THIS (This);
+  *Transfer = NULL;
+  Status    = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcAsyncBulkSubmit: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  SlotId = XhcDevicePathToSlotId (Xhc, DevicePath);
+  if (SlotId == 0) {
+    Status = EFI_NOT_FOUND;
+    goto ON_EXIT;
+  }
+
+  Status = EFI_INVALID_PARAMETER;
+  Dci    = XhcEndpointToDci ((UINT8)(EndpointAddress & 0x0F), XHCI_IS_DATAIN (EndpointAddress) ? EfiUsbDataIn : EfiUsbDataOut);
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    EPType = (UINT8)((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1].EPType;
+  } else {
+    EPType = (UINT8)((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1].EPType;
+  }
+
+  if ((EPType != ED_BULK_IN) && (EPType != ED_BULK_OUT)) {
+    goto ON_EXIT;
+  }
+
+  //
+  // Once the streams are enabled, the transfer ring of the endpoint itself
+  // is no longer used.
+  //
+  if ((Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] != NULL) != (StreamId != 0)) {
+    goto ON_EXIT;
+  }
+
+  Ring = XhcGetTransferRing (Xhc, SlotId, Dci, StreamId);
+  if (Ring == NULL) {
+    goto ON_EXIT;
+  }
+
+  //
+  // Every TRB of a bulk transfer carries up to 64KB. Leave the ring enough
+  // room so that the new TRBs never overwrite the pending ones.
+  //
+  TrbNum = (DataLength + 0xFFFF) / 0x10000;
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ring == Ring) && !Urb->Finished) {
+      TrbNum += Urb->TrbNum;
+    }
+  }
+
+  if (TrbNum >= TR_RING_TRB_NUMBER - 1) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  //
+  // The device speed and the max packet size are not needed by bulk TRBs.
+  //
+  Urb = XhcCreateUrb (
+          Xhc,
+          Xhc->UsbDevContext[SlotId].BusDevAddr,
+          EndpointAddress,
+          0,
+          0,
+          XHC_BULK_TRANSFER,
+          NULL,
+          Data,
+          DataLength,
+          NULL,
+          NULL,
+          StreamId
+          );
+  if (Urb == NULL) {
+    DEBUG ((DEBUG_ERROR, "XhcAsyncBulkSubmit: failed to create URB\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  InsertTailList (&Xhc->AsyncBulkTransfers, &Urb->UrbList);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, StreamId);
+
+  *Transfer = Urb;
+  Status    = EFI_SUCCESS;
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Check whether a submitted bulk transfer is completed, and release it if so.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  Transfer             The token returned by XhcAsyncBulkSubmit().
+  @param  DataLength           The number of bytes transferred.
+  @param  TransferResult       The result of the transfer.
+
+  @retval EFI_SUCCESS           The transfer is completed successfully.
+  @retval EFI_NOT_READY         The transfer is still in progress.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_DEVICE_ERROR      The transfer is completed with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkPoll (
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                           *Transfer,
+  OUT UINTN                          *DataLength,
+  OUT UINT32                         *TransferResult
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+  URB                *Urb;
+
+  Urb = (URB *)Transfer;
+  if ((Urb == NULL) || (Urb->Signature != XHC_URB_SIG) ||
+      (DataLength == NULL) || (TransferResult == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = XHC_FROM_ASYNC_BULK_THIS (This);
+
+  if (!XhcCheckUrbResult (Xhc, Urb)) {
+    Status = EFI_NOT_READY;
+    goto ON_EXIT;
+  }
+
+  RemoveEntryList (&Urb->UrbList);
+
+  *TransferResult = Urb->Result;
+  *DataLength     = Urb->Completed;
+  Status          = (Urb->Result == EFI_USB_NOERROR) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+
+  if ((Urb->Result == EFI_USB_ERR_STALL) || (Urb->Result == EFI_USB_ERR_BABBLE)) {
+    //
+    // The halted endpoint stops all its streams, and the reset discards
+    // the transfers queued behind the failed one.
+    //
+    if (!EFI_ERROR (XhcRecoverHaltedEndpoint (Xhc, Urb))) {
+      XhcResumeAsyncBulkTransfers (Xhc, Urb, TRUE);
+    } else {
+      DEBUG ((DEBUG_ERROR, "XhcAsyncBulkPoll: XhcRecoverHaltedEndpoint failed!\n"));
+    }
+  }
+
+  Xhc->PciIo->Flush (Xhc->PciIo);
+  XhcFreeUrb (Xhc, Urb);
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Abort a submitted bulk transfer and release it.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  Transfer             The token returned by XhcAsyncBulkSubmit().
+
+  @retval EFI_SUCCESS           The transfer is aborted, or it was already completed.
+  @retval EFI_INVALID_PARAMETER Transfer is not a valid token.
+  @retval EFI_DEVICE_ERROR      The endpoint failed to be stopped.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkCancel (
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                           *Transfer
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+  URB                *Urb;
+
+  Urb = (URB *)Transfer;
+  if ((Urb == NULL) || (Urb->Signature != XHC_URB_SIG)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_ASYNC_BULK_THIS (This);
+  Status = EFI_SUCCESS;
+
+  if (!XhcCheckUrbResult (Xhc, Urb)) {
+    Status = XhcDequeueTrbFromEndpoint (Xhc, Urb);
+    if (Status == EFI_ALREADY_STARTED) {
+      XhcResumeAsyncBulkTransfers (Xhc, Urb, FALSE);
+      Status = EFI_SUCCESS;
+    } else if (!EFI_ERROR (Status)) {
+      XhcResumeAsyncBulkTransfers (Xhc, Urb, TRUE);
+    } else {
+      DEBUG ((DEBUG_ERROR, "XhcAsyncBulkCancel: XhcDequeueTrbFromEndpoint failed!\n"));
+    }
+  }
+
+  RemoveEntryList (&Urb->UrbList);
+  XhcFreeUrb (Xhc, Urb);
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
 /**
   Entry point for EFI drivers.
 
@@ -1782,6 +2112,7 @@ XhcCreateUsbHc (
   Xhc->DevicePath            = DevicePath;
   Xhc->OriginalPciAttributes = OriginalPciAttributes;
   CopyMem (&Xhc->Usb2Hc, &gXhciUsb2HcTemplate, sizeof (EFI_USB2_HC_PROTOCOL));
+  CopyMem (&Xhc->AsyncBulk, &gXhciAsyncBulkTemplate, sizeof (EDKII_USB_ASYNC_BULK_PROTOCOL));
 
   Status = PciIo->Pci.Read (
                         PciIo,
@@ -1797,6 +2128,7 @@ XhcCreateUsbHc (
   }
 
   InitializeListHead (&Xhc->AsyncIntTransfers);
+  InitializeListHead (&Xhc->AsyncBulkTransfers);
 
   //
   // Be caution that the Offset passed to XhcReadCapReg() should be Dword align
@@ -2092,11 +2424,13 @@ XhcDriverBindingStart (
     FALSE
     );
 
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &Xhc->Usb2Hc
+                  &Xhc->Usb2Hc,
+                  &gEdkiiUsbAsyncBulkProtocolGuid,
+                  &Xhc->AsyncBulk,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcDriverBindingStart: failed to install USB2_HC Protocol\n"));
@@ -2180,19 +2514,22 @@ XhcDriverBindingStop (
     return Status;
   }
 
-  Status = gBS->UninstallProtocolInterface (
+  Xhc   = XHC_FROM_THIS (Usb2Hc);
+  PciIo = Xhc->PciIo;
+
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  Usb2Hc
+                  Usb2Hc,
+                  &gEdkiiUsbAsyncBulkProtocolGuid,
+                  &Xhc->AsyncBulk,
+                  NULL
                   );
 
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
-  Xhc   = XHC_FROM_THIS (Usb2Hc);
-  PciIo = Xhc->PciIo;
-
   //
   // Stop AsyncRequest Polling timer then stop the XHCI driver
   // and uninstall the XHCI protocl.
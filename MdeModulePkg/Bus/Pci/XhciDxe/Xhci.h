@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Usb2HostController.h>
+#include <Protocol/UsbAsyncBulk.h>
 #include <Protocol/PciIo.h>
 
 #include <Guid/EventGroup.h>
@@ -25,6 +26,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiLib.h>
 #include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
 #include <Library/ReportStatusCodeLib.h>
 
 #include <IndustryStandard/Pci.h>
@@ -96,6 +98,8 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 
 #define XHCI_INSTANCE_SIG  SIGNATURE_32 ('x', 'h', 'c', 'i')
 #define XHC_FROM_THIS(a)  CR(a, USB_XHCI_INSTANCE, Usb2Hc, XHCI_INSTANCE_SIG)
+#define XHC_FROM_ASYNC_BULK_THIS(a) \
+          CR(a, USB_XHCI_INSTANCE, AsyncBulk, XHCI_INSTANCE_SIG)
 
 #define USB_DESC_TYPE_HUB              0x29
 #define USB_DESC_TYPE_HUB_SUPER_SPEED  0x2a
@@ -172,6 +176,10 @@ struct _USB_DEV_CONTEXT {
   //
   VOID                         *EndpointTransferRing[31];
   //
+  // The streams of every bulk endpoint whose streams are enabled.
+  //
+  XHC_ENDPOINT_STREAMS         *EndpointStreams[31];
+  //
   // The device descriptor which is stored to support XHCI's Evaluate_Context cmd.
   //
   EFI_USB_DEVICE_DESCRIPTOR    DevDesc;
@@ -199,7 +207,8 @@ struct _USB_XHCI_INSTANCE {
   UINT64                      OriginalPciAttributes;
   USBHC_MEM_POOL              *MemPool;
 
-  EFI_USB2_HC_PROTOCOL        Usb2Hc;
+  EFI_USB2_HC_PROTOCOL             Usb2Hc;
+  EDKII_USB_ASYNC_BULK_PROTOCOL    AsyncBulk;
 
   EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
 
@@ -210,6 +219,7 @@ struct _USB_XHCI_INSTANCE {
   EFI_EVENT                   ExitBootServiceEvent;
   EFI_EVENT                   PollTimer;
   LIST_ENTRY                  AsyncIntTransfers;
+  LIST_ENTRY                  AsyncBulkTransfers;
 
   UINT8                       CapLength;  ///< Capability Register Length
   XHC_HCSPARAMS1              HcSParams1; ///< Structural Parameters 1
@@ -718,4 +728,101 @@ XhcAsyncIsochronousTransfer (
   IN     VOID                                *Context
   );
 
+/**
+  Enable the streams of a SuperSpeed bulk endpoint.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DevicePath           The device path of the device, relative to the host controller.
+  @param  EndpointAddress      The address of the bulk endpoint, with the direction in bit 7.
+  @param  StreamNumber         On input, the number of streams requested. On output,
+                               the number of streams enabled.
+
+  @retval EFI_SUCCESS           The streams are enabled.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_FOUND         The device is not attached to the host controller.
+  @retval EFI_UNSUPPORTED       The host controller does not support streams.
+  @retval EFI_OUT_OF_RESOURCES  The stream rings could not be allocated.
+  @retval EFI_DEVICE_ERROR      The host controller failed to configure the endpoint.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkEnableStreams (
+  IN     EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN     EFI_DEVICE_PATH_PROTOCOL       *DevicePath,
+  IN     UINT8                          EndpointAddress,
+  IN OUT UINT16                         *StreamNumber
+  );
+
+/**
+  Submit a bulk transfer and return without waiting for its completion.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  DevicePath           The device path of the device, relative to the host controller.
+  @param  EndpointAddress      The address of the bulk endpoint, with the direction in bit 7.
+  @param  StreamId             The stream of the endpoint, or 0 if its streams are not enabled.
+  @param  Data                 The data buffer to transfer.
+  @param  DataLength           The length of the data buffer in bytes.
+  @param  Transfer             The token of the submitted transfer.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_NOT_FOUND         The device is not attached to the host controller.
+  @retval EFI_OUT_OF_RESOURCES  The transfer ring is full, or the data can't be mapped.
+  @retval EFI_DEVICE_ERROR      The host controller is halted.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkSubmit (
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  EFI_DEVICE_PATH_PROTOCOL       *DevicePath,
+  IN  UINT8                          EndpointAddress,
+  IN  UINT16                         StreamId,
+  IN  VOID                           *Data,
+  IN  UINTN                          DataLength,
+  OUT VOID                           **Transfer
+  );
+
+/**
+  Check whether a submitted bulk transfer is completed, and release it if so.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  Transfer             The token returned by XhcAsyncBulkSubmit().
+  @param  DataLength           The number of bytes transferred.
+  @param  TransferResult       The result of the transfer.
+
+  @retval EFI_SUCCESS           The transfer is completed successfully.
+  @retval EFI_NOT_READY         The transfer is still in progress.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_DEVICE_ERROR      The transfer is completed with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkPoll (
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                           *Transfer,
+  OUT UINTN                          *DataLength,
+  OUT UINT32                         *TransferResult
+  );
+
+/**
+  Abort a submitted bulk transfer and release it.
+
+  @param  This                 This EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param  Transfer             The token returned by XhcAsyncBulkSubmit().
+
+  @retval EFI_SUCCESS           The transfer is aborted, or it was already completed.
+  @retval EFI_INVALID_PARAMETER Transfer is not a valid token.
+  @retval EFI_DEVICE_ERROR      The endpoint failed to be stopped.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncBulkCancel (
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                           *Transfer
+  );
+
 #endif
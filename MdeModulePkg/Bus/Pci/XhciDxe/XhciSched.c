@@ -124,6 +124,7 @@ ON_EXIT:
   @param  DataLen   The length of data buffer
   @param  Callback  The function to call when data is transferred
   @param  Context   The context to the callback
+  @param  StreamId  The stream of the bulk endpoint, or 0 if its streams are not enabled
 
   @return Created URB or NULL
 
@@ -140,7 +141,8 @@ XhcCreateUrb (
   IN VOID                             *Data,
   IN UINTN                            DataLen,
   IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
-  IN VOID                             *Context
+  IN VOID                             *Context,
+  IN UINT16                           StreamId
   )
 {
   USB_ENDPOINT  *Ep;
@@ -168,6 +170,7 @@ XhcCreateUrb (
   Urb->DataLen  = DataLen;
   Urb->Callback = Callback;
   Urb->Context  = Context;
+  Urb->StreamId = StreamId;
 
   Status = XhcCreateTransferTrb (Xhc, Urb);
   ASSERT_EFI_ERROR (Status);
@@ -246,7 +249,11 @@ XhcCreateTransferTrb (
 
   Dci = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
   ASSERT (Dci < 32);
-  EPRing        = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1];
+  EPRing = XhcGetTransferRing (Xhc, SlotId, Dci, Urb->StreamId);
+  if (EPRing == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   Urb->Ring     = EPRing;
   OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
   if (Xhc->HcCParams.Data.Csz == 0) {
@@ -694,7 +701,7 @@ XhcRecoverHaltedEndpoint (
   //
   // 3)Ring the doorbell to transit from stop to active
   //
-  XhcRingDoorBell (Xhc, SlotId, Dci);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -767,7 +774,7 @@ XhcDequeueTrbFromEndpoint (
   //
   // 3)Ring the doorbell to transit from stop to active
   //
-  XhcRingDoorBell (Xhc, SlotId, Dci);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -1082,6 +1089,38 @@ IsAsyncIntTrb (
   return FALSE;
 }
 
+/**
+  Check if the Trb is a transaction of the URBs in XHCI's asynchronous bulk transfer list.
+
+  @param Xhc    The XHCI Instance.
+  @param Trb    The TRB to be checked.
+  @param Urb    The pointer to the matched Urb.
+
+  @retval TRUE  The Trb is matched with a transaction of the URBs in the async bulk list.
+  @retval FALSE The Trb is not matched with any URBs in the async bulk list.
+
+**/
+BOOLEAN
+IsAsyncBulkTrb (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  TRB_TEMPLATE       *Trb,
+  OUT URB                **Urb
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *CheckedUrb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    CheckedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!CheckedUrb->Finished && IsTransferRingTrb (Xhc, Trb, CheckedUrb)) {
+      *Urb = CheckedUrb;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 /**
   Check the URB's execution result and update the URB's
   result accordingly.
@@ -1105,6 +1144,7 @@ XhcCheckUrbResult (
   EFI_STATUS            Status;
   URB                   *AsyncUrb;
   URB                   *CheckedUrb;
+  BOOLEAN               Resumable;
   UINT64                XhcDequeue;
   UINT32                High;
   UINT32                Low;
@@ -1158,12 +1198,20 @@ XhcCheckUrbResult (
     // This way is used to avoid that those completed async transfer events don't get
     // handled in time and are flushed by newer coming events.
     //
+    Resumable = FALSE;
     if ((Xhc->PendingUrb != NULL) && IsTransferRingTrb (Xhc, TRBPtr, Xhc->PendingUrb)) {
       CheckedUrb = Xhc->PendingUrb;
     } else if (IsTransferRingTrb (Xhc, TRBPtr, Urb)) {
       CheckedUrb = Urb;
     } else if (IsAsyncIntTrb (Xhc, TRBPtr, &AsyncUrb)) {
       CheckedUrb = AsyncUrb;
+    } else if (IsAsyncBulkTrb (Xhc, TRBPtr, &AsyncUrb)) {
+      //
+      // The asynchronous bulk transfers of an endpoint are stopped together
+      // when one of them is dequeued, and resume when the endpoint restarts.
+      //
+      CheckedUrb = AsyncUrb;
+      Resumable  = TRUE;
     } else {
       continue;
     }
@@ -1195,6 +1243,10 @@ XhcCheckUrbResult (
 
       case TRB_COMPLETION_STOPPED:
       case TRB_COMPLETION_STOPPED_LENGTH_INVALID:
+        if (Resumable) {
+          continue;
+        }
+
         CheckedUrb->Result  |= EFI_USB_ERR_TIMEOUT;
         CheckedUrb->Finished = TRUE;
         //
@@ -1509,7 +1561,8 @@ XhciInsertAsyncIntTransfer (
           Data,
           DataLen,
           Callback,
-          Context
+          Context,
+          0
           );
   if (Urb == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: failed to create URB\n", __FUNCTION__));
@@ -1846,6 +1899,39 @@ XhcEndpointToDci (
   }
 }
 
+/**
+  Get the transfer ring of an endpoint or of one of its streams.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  StreamId      The stream of the endpoint, or 0 if its streams are not enabled.
+
+  @return The transfer ring, or NULL if the stream is not enabled.
+
+**/
+TRANSFER_RING *
+XhcGetTransferRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  )
+{
+  XHC_ENDPOINT_STREAMS  *Streams;
+
+  if (StreamId == 0) {
+    return (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1];
+  }
+
+  Streams = Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1];
+  if ((Streams == NULL) || (StreamId > Streams->StreamNum)) {
+    return NULL;
+  }
+
+  return &Streams->StreamRing[StreamId];
+}
+
 /**
   Find out the actual device address according to the requested device address from UsbBus.
 
@@ -1914,6 +2000,61 @@ XhcRouteStringToSlotId (
   return Xhc->UsbDevContext[Index + 1].SlotId;
 }
 
+/**
+  Find out the slot id according to the device path of the device.
+
+  The first USB node of the device path is the root port, and every following
+  node is the downstream port of a hub, so the device path is converted to the
+  route string the same way XhcPollPortStatusChange() builds it.
+
+  @param  Xhc             The XHCI Instance.
+  @param  DevicePath      The device path of the device, relative to the host controller.
+
+  @return The slot id used by the device, or 0 if the device is not found.
+
+**/
+UINT8
+XhcDevicePathToSlotId (
+  IN USB_XHCI_INSTANCE         *Xhc,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  USB_DEVICE_PATH  *UsbNode;
+  USB_DEV_ROUTE    RouteChart;
+  UINT8            Port;
+
+  RouteChart.Dword = 0;
+
+  while (!IsDevicePathEnd (DevicePath)) {
+    if ((DevicePathType (DevicePath) != MESSAGING_DEVICE_PATH) ||
+        (DevicePathSubType (DevicePath) != MSG_USB_DP) ||
+        (RouteChart.Route.TierNum > 5))
+    {
+      return 0;
+    }
+
+    UsbNode = (USB_DEVICE_PATH *)DevicePath;
+    Port    = (UINT8)(UsbNode->ParentPortNumber + 1);
+
+    if (RouteChart.Route.TierNum == 0) {
+      RouteChart.Route.RootPortNum = Port;
+    } else if (Port < 14) {
+      RouteChart.Route.RouteString |= Port << (4 * (RouteChart.Route.TierNum - 1));
+    } else {
+      RouteChart.Route.RouteString |= 15 << (4 * (RouteChart.Route.TierNum - 1));
+    }
+
+    RouteChart.Route.TierNum++;
+    DevicePath = NextDevicePathNode (DevicePath);
+  }
+
+  if (RouteChart.Route.TierNum == 0) {
+    return 0;
+  }
+
+  return XhcRouteStringToSlotId (Xhc, RouteChart);
+}
+
 /**
   Synchronize the specified event ring to update the enqueue and dequeue pointer.
 
@@ -2093,6 +2234,30 @@ XhcRingDoorBell (
   return EFI_SUCCESS;
 }
 
+/**
+  Ring the door bell of an endpoint to notify XHCI there are transfers to be
+  executed on one of its streams.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  StreamId      The stream of the endpoint, or 0 if its streams are not enabled.
+
+  @retval EFI_SUCCESS   Successfully ring the door bell.
+
+**/
+EFI_STATUS
+XhcRingStreamDoorBell (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  )
+{
+  XhcWriteDoorBellReg (Xhc, SlotId * sizeof (UINT32), Dci | ((UINT32)StreamId << 16));
+  return EFI_SUCCESS;
+}
+
 /**
   Ring the door bell to notify XHCI there is a transaction to be executed through URB.
 
@@ -2620,6 +2785,7 @@ XhcDisableSlotCmd (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
+    XhcFreeEndpointStreams (Xhc, SlotId, (UINT8)(Index + 1));
     if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
       RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
       if (RingSeg != NULL) {
@@ -2731,6 +2897,7 @@ XhcDisableSlotCmd64 (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
+    XhcFreeEndpointStreams (Xhc, SlotId, (UINT8)(Index + 1));
     if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
       RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
       if (RingSeg != NULL) {
@@ -2851,6 +3018,10 @@ XhcInitializeEndpointContext (
         }
 
         InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
+        //
+        // The endpoint is configured without streams.
+        //
+        XhcFreeEndpointStreams (Xhc, SlotId, Dci);
         if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
           EndpointTransferRing                                   = AllocateZeroPool (sizeof (TRANSFER_RING));
           Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *)EndpointTransferRing;
@@ -3050,6 +3221,10 @@ XhcInitializeEndpointContext64 (
         }
 
         InputContext->EP[Dci-1].AverageTRBLength = 0x1000;
+        //
+        // The endpoint is configured without streams.
+        //
+        XhcFreeEndpointStreams (Xhc, SlotId, Dci);
         if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
           EndpointTransferRing                                   = AllocateZeroPool (sizeof (TRANSFER_RING));
           Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *)EndpointTransferRing;
@@ -3506,6 +3681,11 @@ XhcSetTrDequeuePointer (
   PhyAddr              = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Urb->Ring->RingEnqueue, sizeof (CMD_SET_TR_DEQ_POINTER));
   CmdSetTRDeq.PtrLo    = XHC_LOW_32BIT (PhyAddr) | Urb->Ring->RingPCS;
   CmdSetTRDeq.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  if (Urb->StreamId != 0) {
+    CmdSetTRDeq.PtrLo   |= XHC_STREAM_CONTEXT_TYPE_PRIMARY << 1;
+    CmdSetTRDeq.StreamID = Urb->StreamId;
+  }
+
   CmdSetTRDeq.CycleBit = 1;
   CmdSetTRDeq.Type     = TRB_TYPE_SET_TR_DEQUE;
   CmdSetTRDeq.Endpoint = Dci;
@@ -3658,6 +3838,7 @@ XhcSetInterface (
       // XHCI 4.3.6 - Setting Alternate Interfaces
       // 2) Free Transfer Rings of all endpoints that will be affected by the Alternate Interface setting.
       //
+      XhcFreeEndpointStreams (Xhc, SlotId, Dci);
       if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] != NULL) {
         RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->RingSeg0;
         if (RingSeg != NULL) {
@@ -3864,6 +4045,7 @@ XhcSetInterface64 (
       // XHCI 4.3.6 - Setting Alternate Interfaces
       // 2) Free Transfer Rings of all endpoints that will be affected by the Alternate Interface setting.
       //
+      XhcFreeEndpointStreams (Xhc, SlotId, Dci);
       if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] != NULL) {
         RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->RingSeg0;
         if (RingSeg != NULL) {
@@ -4184,3 +4366,313 @@ XhcConfigHubContext64 (
 
   return Status;
 }
+
+/**
+  Free the resources of the streams of an endpoint.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Streams         The streams to free.
+
+**/
+VOID
+XhcFreeStreams (
+  IN USB_XHCI_INSTANCE     *Xhc,
+  IN XHC_ENDPOINT_STREAMS  *Streams
+  )
+{
+  UINTN  Index;
+
+  for (Index = 1; Index <= Streams->StreamNum; Index++) {
+    if (Streams->StreamRing[Index].RingSeg0 != NULL) {
+      UsbHcFreeMem (Xhc->MemPool, Streams->StreamRing[Index].RingSeg0, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
+    }
+  }
+
+  if (Streams->StreamContextArray != NULL) {
+    UsbHcFreeMem (Xhc->MemPool, Streams->StreamContextArray, sizeof (STREAM_CONTEXT) * Streams->StreamContextNum);
+  }
+
+  FreePool (Streams);
+}
+
+/**
+  Enable the streams of a bulk endpoint through XHCI's Configure_Endpoint cmd.
+
+  @param  Xhc             The XHCI Instance.
+  @param  SlotId          The slot id of the device.
+  @param  Dci             The device context index of the bulk endpoint.
+  @param  StreamNumber    On input, the number of streams requested. On output,
+                          the number of streams enabled.
+
+  @retval EFI_SUCCESS           The streams are enabled.
+  @retval EFI_UNSUPPORTED       The XHCI doesn't support streams.
+  @retval EFI_INVALID_PARAMETER The endpoint is not a bulk endpoint.
+  @retval EFI_OUT_OF_RESOURCES  The stream context array can't be allocated.
+  @retval Others                Failed to configure the endpoint.
+
+**/
+EFI_STATUS
+XhcEnableEndpointStreams (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     UINT8              SlotId,
+  IN     UINT8              Dci,
+  IN OUT UINT16             *StreamNumber
+  )
+{
+  EFI_STATUS                  Status;
+  XHC_ENDPOINT_STREAMS        *Streams;
+  VOID                        *InputContext;
+  UINTN                       InputContextSize;
+  INPUT_CONTRL_CONTEXT        *InputControlContext;
+  ENDPOINT_CONTEXT            *EpContext;
+  CMD_TRB_CONFIG_ENDPOINT     CmdTrbCfgEP;
+  EVT_TRB_COMMAND_COMPLETION  *EvtTrb;
+  EFI_PHYSICAL_ADDRESS        PhyAddr;
+  UINT8                       EPType;
+  UINT8                       MaxPStreams;
+  UINTN                       Index;
+
+  if (Xhc->HcCParams.Data.MaxPsaSize == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((*StreamNumber < 2) || (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    EPType = (UINT8)((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1].EPType;
+  } else {
+    EPType = (UINT8)((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1].EPType;
+  }
+
+  if ((EPType != ED_BULK_IN) && (EPType != ED_BULK_OUT)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] != NULL) {
+    *StreamNumber = Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1]->StreamNum;
+    return EFI_SUCCESS;
+  }
+
+  //
+  // The Primary Stream Array holds 2^(MaxPStreams + 1) entries, the first
+  // one is reserved. MaxPStreams is limited by the MaxPSASize of HCCPARAMS.
+  //
+  *StreamNumber = MIN (*StreamNumber, XHC_MAX_STREAMS - 1);
+  MaxPStreams   = (UINT8)MIN ((UINT32)HighBitSet32 (*StreamNumber), Xhc->HcCParams.Data.MaxPsaSize);
+  *StreamNumber = (UINT16)MIN (*StreamNumber, (1 << (MaxPStreams + 1)) - 1);
+
+  Streams = AllocateZeroPool (sizeof (XHC_ENDPOINT_STREAMS));
+  if (Streams == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Streams->StreamContextNum   = (UINTN)1 << (MaxPStreams + 1);
+  Streams->StreamNum          = *StreamNumber;
+  Streams->StreamContextArray = UsbHcAllocateMem (Xhc->MemPool, sizeof (STREAM_CONTEXT) * Streams->StreamContextNum);
+  if (Streams->StreamContextArray == NULL) {
+    FreePool (Streams);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Streams->StreamContextArray, sizeof (STREAM_CONTEXT) * Streams->StreamContextNum);
+
+  for (Index = 1; Index <= Streams->StreamNum; Index++) {
+    CreateTransferRing (Xhc, TR_RING_TRB_NUMBER, &Streams->StreamRing[Index]);
+    PhyAddr = UsbHcGetPciAddrForHostAddr (
+                Xhc->MemPool,
+                Streams->StreamRing[Index].RingSeg0,
+                sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER
+                );
+    Streams->StreamContextArray[Index].PtrLo = XHC_LOW_32BIT (PhyAddr) |
+                                               (XHC_STREAM_CONTEXT_TYPE_PRIMARY << 1) |
+                                               Streams->StreamRing[Index].RingPCS;
+    Streams->StreamContextArray[Index].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+  }
+
+  //
+  // XHCI 4.12.2 Stream Context Arrays
+  // The endpoint is dropped and added again, with the Primary Stream Array
+  // replacing the transfer ring in the endpoint context.
+  //
+  Status = XhcStopEndpoint (Xhc, SlotId, Dci, NULL);
+  if (EFI_ERROR (Status)) {
+    XhcFreeStreams (Xhc, Streams);
+    return Status;
+  }
+
+  InputContext = Xhc->UsbDevContext[SlotId].InputContext;
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    InputContextSize = sizeof (INPUT_CONTEXT);
+    ZeroMem (InputContext, InputContextSize);
+    CopyMem (
+      &((INPUT_CONTEXT *)InputContext)->Slot,
+      &((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->Slot,
+      sizeof (SLOT_CONTEXT)
+      );
+    CopyMem (
+      &((INPUT_CONTEXT *)InputContext)->EP[Dci - 1],
+      &((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1],
+      sizeof (ENDPOINT_CONTEXT)
+      );
+    InputControlContext = &((INPUT_CONTEXT *)InputContext)->InputControlContext;
+    EpContext           = &((INPUT_CONTEXT *)InputContext)->EP[Dci - 1];
+  } else {
+    InputContextSize = sizeof (INPUT_CONTEXT_64);
+    ZeroMem (InputContext, InputContextSize);
+    CopyMem (
+      &((INPUT_CONTEXT_64 *)InputContext)->Slot,
+      &((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->Slot,
+      sizeof (SLOT_CONTEXT_64)
+      );
+    CopyMem (
+      &((INPUT_CONTEXT_64 *)InputContext)->EP[Dci - 1],
+      &((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1],
+      sizeof (ENDPOINT_CONTEXT_64)
+      );
+    //
+    // The 64-byte contexts start with the same fields as the 32-byte ones.
+    //
+    InputControlContext = (INPUT_CONTRL_CONTEXT *)&((INPUT_CONTEXT_64 *)InputContext)->InputControlContext;
+    EpContext           = (ENDPOINT_CONTEXT *)&((INPUT_CONTEXT_64 *)InputContext)->EP[Dci - 1];
+  }
+
+  PhyAddr = UsbHcGetPciAddrForHostAddr (
+              Xhc->MemPool,
+              Streams->StreamContextArray,
+              sizeof (STREAM_CONTEXT) * Streams->StreamContextNum
+              );
+  EpContext->EPState          = 0;
+  EpContext->MaxPStreams      = MaxPStreams;
+  EpContext->LSA              = 1;
+  EpContext->HID              = 0;
+  EpContext->PtrLo            = XHC_LOW_32BIT (PhyAddr);
+  EpContext->PtrHi            = XHC_HIGH_32BIT (PhyAddr);
+  InputControlContext->Dword1 = BIT0 << Dci;
+  InputControlContext->Dword2 = BIT0 | (BIT0 << Dci);
+
+  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
+  PhyAddr              = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, InputContextSize);
+  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
+  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  CmdTrbCfgEP.CycleBit = 1;
+  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
+  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
+  DEBUG ((DEBUG_INFO, "XhcEnableEndpointStreams: Slot = 0x%x, Dci = 0x%x, Streams = %d\n", SlotId, Dci, Streams->StreamNum));
+  Status = XhcCmdTransfer (
+             Xhc,
+             (TRB_TEMPLATE *)(UINTN)&CmdTrbCfgEP,
+             XHC_GENERIC_TIMEOUT,
+             (TRB_TEMPLATE **)(UINTN)&EvtTrb
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "XhcEnableEndpointStreams: Config Endpoint Failed, Status = %r\n", Status));
+    XhcFreeStreams (Xhc, Streams);
+    return Status;
+  }
+
+  Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] = Streams;
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the streams of an endpoint, and abort the asynchronous bulk transfers
+  still queued on it. It's called whenever the transfer rings of the endpoint
+  are freed or replaced.
+
+  @param  Xhc             The XHCI Instance.
+  @param  SlotId          The slot id of the device.
+  @param  Dci             The device context index of the endpoint.
+
+**/
+VOID
+XhcFreeEndpointStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci
+  )
+{
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *Next;
+  URB         *Urb;
+
+  //
+  // The TRBs of the aborted transfers are gone with their transfer ring.
+  // They are completed here, and the owners release them by polling.
+  //
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr != Xhc->UsbDevContext[SlotId].BusDevAddr) ||
+        (XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction)) != Dci))
+    {
+      continue;
+    }
+
+    RemoveEntryList (&Urb->UrbList);
+    InitializeListHead (&Urb->UrbList);
+    if (!Urb->Finished) {
+      Urb->Result  |= EFI_USB_ERR_NOTEXECUTE;
+      Urb->Finished = TRUE;
+    }
+  }
+
+  if (Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] != NULL) {
+    XhcFreeStreams (Xhc, Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1]);
+    Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] = NULL;
+  }
+}
+
+/**
+  Restart the other asynchronous bulk transfers of an endpoint, after the
+  endpoint is stopped or reset to remove the TDs of a URB.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Urb             The URB whose TDs were removed.
+  @param  Discarded       TRUE if the transfer ring of the URB was emptied,
+                          which discards the other URBs queued on it.
+
+**/
+VOID
+XhcResumeAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb,
+  IN BOOLEAN            Discarded
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *CheckedUrb;
+  UINT8       SlotId;
+  UINT8       Dci;
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
+  if (SlotId == 0) {
+    return;
+  }
+
+  Dci = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    CheckedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((CheckedUrb == Urb) || CheckedUrb->Finished ||
+        (CheckedUrb->Ep.BusAddr != Urb->Ep.BusAddr) ||
+        (XhcEndpointToDci (CheckedUrb->Ep.EpAddr, (UINT8)(CheckedUrb->Ep.Direction)) != Dci))
+    {
+      continue;
+    }
+
+    if (CheckedUrb->Ring == Urb->Ring) {
+      //
+      // The door bell of this ring has been rung by the caller.
+      //
+      if (Discarded) {
+        CheckedUrb->Result  |= EFI_USB_ERR_NOTEXECUTE;
+        CheckedUrb->Finished = TRUE;
+      }
+
+      continue;
+    }
+
+    XhcRingStreamDoorBell (Xhc, SlotId, Dci, CheckedUrb->StreamId);
+  }
+}
@@ -155,6 +155,40 @@ typedef struct _EVENT_RING {
   UINT32          EventRingCCS;
 } EVENT_RING;
 
+//
+// The maximum number of streams of a bulk endpoint, including the reserved
+// stream 0. It's the Primary Stream Array size when MaxPStreams is 3.
+//
+#define XHC_MAX_STREAMS  16
+
+//
+// 6.2.4.1 Stream Context Type: Primary Transfer Ring
+//
+#define XHC_STREAM_CONTEXT_TYPE_PRIMARY  1
+
+//
+// 6.2.4 Stream Context
+// The DCS and SCT fields are in the low bits of PtrLo.
+//
+typedef struct _STREAM_CONTEXT {
+  UINT32    PtrLo;
+  UINT32    PtrHi;
+  UINT32    StoppedEdtla : 24;
+  UINT32    RsvdZ1       : 8;
+  UINT32    RsvdZ2;
+} STREAM_CONTEXT;
+
+//
+// The streams of a bulk endpoint. Every stream has its own transfer ring
+// referred by an entry of the Primary Stream Array, and stream 0 is reserved.
+//
+typedef struct _XHC_ENDPOINT_STREAMS {
+  STREAM_CONTEXT    *StreamContextArray;
+  UINTN             StreamContextNum;
+  UINT16            StreamNum;
+  TRANSFER_RING     StreamRing[XHC_MAX_STREAMS];
+} XHC_ENDPOINT_STREAMS;
+
 //
 // URB (Usb Request Block) contains information for all kinds of
 // usb requests.
@@ -166,6 +200,7 @@ typedef struct _URB {
   // Usb Device URB related information
   //
   USB_ENDPOINT                       Ep;
+  UINT16                             StreamId;
   EFI_USB_DEVICE_REQUEST             *Request;
   VOID                               *Data;
   UINTN                              DataLen;
@@ -791,6 +826,22 @@ RingIntTransferDoorBell (
   IN  URB                *Urb
   );
 
+/**
+  Check the URB's execution result and update the URB's
+  result accordingly.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Urb             The URB to check result.
+
+  @return Whether the result of URB transfer is finialized.
+
+**/
+BOOLEAN
+XhcCheckUrbResult (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                *Urb
+  );
+
 /**
   Execute the transfer by polling the URB. This is a synchronous operation.
 
@@ -1426,6 +1477,7 @@ XhcSetTrDequeuePointer (
   @param  DataLen   The length of data buffer
   @param  Callback  The function to call when data is transferred
   @param  Context   The context to the callback
+  @param  StreamId  The stream of the bulk endpoint, or 0 if its streams are not enabled
 
   @return Created URB or NULL
 
@@ -1442,7 +1494,8 @@ XhcCreateUrb (
   IN VOID                             *Data,
   IN UINTN                            DataLen,
   IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
-  IN VOID                             *Context
+  IN VOID                             *Context,
+  IN UINT16                           StreamId
   );
 
 /**
@@ -1473,4 +1526,116 @@ XhcCreateTransferTrb (
   IN URB                *Urb
   );
 
+/**
+  Get the transfer ring of an endpoint or of one of its streams.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  StreamId      The stream of the endpoint, or 0 if its streams are not enabled.
+
+  @return The transfer ring, or NULL if the stream is not enabled.
+
+**/
+TRANSFER_RING *
+XhcGetTransferRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  );
+
+/**
+  Ring the door bell of an endpoint to notify XHCI there are transfers to be
+  executed on one of its streams.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  StreamId      The stream of the endpoint, or 0 if its streams are not enabled.
+
+  @retval EFI_SUCCESS   Successfully ring the door bell.
+
+**/
+EFI_STATUS
+XhcRingStreamDoorBell (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  );
+
+/**
+  Find out the slot id according to the device path of the device.
+
+  @param  Xhc             The XHCI Instance.
+  @param  DevicePath      The device path of the device, relative to the host controller.
+
+  @return The slot id used by the device, or 0 if the device is not found.
+
+**/
+UINT8
+XhcDevicePathToSlotId (
+  IN USB_XHCI_INSTANCE         *Xhc,
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+/**
+  Enable the streams of a bulk endpoint through XHCI's Configure_Endpoint cmd.
+
+  @param  Xhc             The XHCI Instance.
+  @param  SlotId          The slot id of the device.
+  @param  Dci             The device context index of the bulk endpoint.
+  @param  StreamNumber    On input, the number of streams requested. On output,
+                          the number of streams enabled.
+
+  @retval EFI_SUCCESS           The streams are enabled.
+  @retval EFI_UNSUPPORTED       The XHCI doesn't support streams.
+  @retval EFI_INVALID_PARAMETER The endpoint is not a bulk endpoint.
+  @retval EFI_OUT_OF_RESOURCES  The stream context array can't be allocated.
+  @retval Others                Failed to configure the endpoint.
+
+**/
+EFI_STATUS
+XhcEnableEndpointStreams (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     UINT8              SlotId,
+  IN     UINT8              Dci,
+  IN OUT UINT16             *StreamNumber
+  );
+
+/**
+  Free the streams of an endpoint, and abort the asynchronous bulk transfers
+  still queued on it. It's called whenever the transfer rings of the endpoint
+  are freed or replaced.
+
+  @param  Xhc             The XHCI Instance.
+  @param  SlotId          The slot id of the device.
+  @param  Dci             The device context index of the endpoint.
+
+**/
+VOID
+XhcFreeEndpointStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci
+  );
+
+/**
+  Restart the other asynchronous bulk transfers of an endpoint, after the
+  endpoint is stopped or reset to remove the TDs of a URB.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Urb             The URB whose TDs were removed.
+  @param  Discarded       TRUE if the transfer ring of the URB was emptied,
+                          which discards the other URBs queued on it.
+
+**/
+VOID
+XhcResumeAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb,
+  IN BOOLEAN            Discarded
+  );
+
 #endif
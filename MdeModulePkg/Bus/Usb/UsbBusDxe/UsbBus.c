@@ -25,6 +25,15 @@ EFI_USB_IO_PROTOCOL  mUsbIoProtocol = {
   UsbIoPortReset
 };
 
+EDKII_USB_IO_ASYNC_BULK_PROTOCOL  mUsbIoAsyncBulkProtocol = {
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL_REVISION,
+  UsbIoAsyncBulkSelectSetting,
+  UsbIoAsyncBulkEnableStreams,
+  UsbIoAsyncBulkSubmit,
+  UsbIoAsyncBulkPoll,
+  UsbIoAsyncBulkCancel
+};
+
 EFI_DRIVER_BINDING_PROTOCOL  mUsbBusDriverBinding = {
   UsbBusControllerDriverSupported,
   UsbBusControllerDriverStart,
@@ -899,6 +908,253 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Get the device path of the USB interface, relative to its host controller.
+
+  @param  UsbIf                  The USB interface.
+
+  @return The part of the interface's device path that follows the device
+          path of the host controller.
+
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+UsbGetRelativeDevicePath (
+  IN USB_INTERFACE  *UsbIf
+  )
+{
+  USB_BUS  *Bus;
+
+  Bus = UsbIf->Device->Bus;
+  return (EFI_DEVICE_PATH_PROTOCOL *)((UINT8 *)UsbIf->DevicePath +
+                                      GetDevicePathSize (Bus->DevicePath) - END_DEVICE_PATH_LENGTH);
+}
+
+/**
+  Select an alternate setting of the USB interface. The SET_INTERFACE
+  request goes through the USB IO control transfer, which records the
+  new active setting of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  AlternateSetting       The alternate setting to select.
+
+  @retval EFI_SUCCESS            The alternate setting is selected.
+  @retval EFI_NOT_FOUND          The interface has no such alternate setting.
+  @retval EFI_DEVICE_ERROR       Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkSelectSetting (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             AlternateSetting
+  )
+{
+  USB_INTERFACE           *UsbIf;
+  USB_INTERFACE_DESC      *IfDesc;
+  EFI_USB_DEVICE_REQUEST  Request;
+  UINT32                  UsbStatus;
+  UINTN                   Index;
+  EFI_STATUS              Status;
+
+  UsbIf  = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  IfDesc = UsbIf->IfDesc;
+
+  for (Index = 0; Index < IfDesc->NumOfSetting; Index++) {
+    if (IfDesc->Settings[Index]->Desc.AlternateSetting == AlternateSetting) {
+      break;
+    }
+  }
+
+  if (Index == IfDesc->NumOfSetting) {
+    return EFI_NOT_FOUND;
+  }
+
+  Request.RequestType = USB_REQUEST_TYPE (EfiUsbNoData, USB_REQ_TYPE_STANDARD, USB_TARGET_INTERFACE);
+  Request.Request     = USB_REQ_SET_INTERFACE;
+  Request.Value       = AlternateSetting;
+  Request.Index       = UsbIf->IfSetting->Desc.InterfaceNumber;
+  Request.Length      = 0;
+
+  Status = UsbIoControlTransfer (
+             &UsbIf->UsbIo,
+             &Request,
+             EfiUsbNoData,
+             USB_GENERAL_DEVICE_REQUEST_TIMEOUT,
+             NULL,
+             0,
+             &UsbStatus
+             );
+
+  if (EFI_ERROR (Status) || (UsbIf->IfSetting->Desc.AlternateSetting != AlternateSetting)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Enable the streams of a SuperSpeed bulk endpoint of the USB interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamNumber           On input, the number of streams requested. On
+                                 output, the number of streams enabled.
+
+  @retval EFI_SUCCESS            The streams are enabled.
+  @retval EFI_INVALID_PARAMETER  The endpoint isn't a bulk endpoint of the
+                                 active setting.
+  @retval Others                 Failed to enable the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkEnableStreams (
+  IN     EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                             Endpoint,
+  IN OUT UINT16                            *StreamNumber
+  )
+{
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf  = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = UsbIf->Device->Bus->AsyncBulk->EnableStreams (
+                                            UsbIf->Device->Bus->AsyncBulk,
+                                            UsbGetRelativeDevicePath (UsbIf),
+                                            Endpoint,
+                                            StreamNumber
+                                            );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Submit a bulk transfer to an endpoint of the USB interface, and return
+  without waiting for its completion.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamId               The stream of the endpoint, or 0.
+  @param  Data                   The data to transfer.
+  @param  DataLength             The length of the data to transfer.
+  @param  Transfer               Return the token of the transfer.
+
+  @retval EFI_SUCCESS            The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER  The endpoint isn't a bulk endpoint of the
+                                 active setting.
+  @retval Others                 Failed to submit the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkSubmit (
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  UINT8                             Endpoint,
+  IN  UINT16                            StreamId,
+  IN  VOID                              *Data,
+  IN  UINTN                             DataLength,
+  OUT VOID                              **Transfer
+  )
+{
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf  = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = UsbIf->Device->Bus->AsyncBulk->Submit (
+                                            UsbIf->Device->Bus->AsyncBulk,
+                                            UsbGetRelativeDevicePath (UsbIf),
+                                            Endpoint,
+                                            StreamId,
+                                            Data,
+                                            DataLength,
+                                            Transfer
+                                            );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Check whether a submitted bulk transfer is completed.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Transfer               The token of the transfer.
+  @param  DataLength             Return the number of bytes transferred.
+  @param  UsbStatus              Return the result of the transfer.
+
+  @retval EFI_SUCCESS            The transfer is completed successfully.
+  @retval EFI_NOT_READY          The transfer is still in progress.
+  @retval Others                 The transfer is completed with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkPoll (
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                              *Transfer,
+  OUT UINTN                             *DataLength,
+  OUT UINT32                            *UsbStatus
+  )
+{
+  USB_INTERFACE  *UsbIf;
+
+  UsbIf = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  return UsbIf->Device->Bus->AsyncBulk->Poll (
+                                          UsbIf->Device->Bus->AsyncBulk,
+                                          Transfer,
+                                          DataLength,
+                                          UsbStatus
+                                          );
+}
+
+/**
+  Abort a submitted bulk transfer.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Transfer               The token of the transfer.
+
+  @retval EFI_SUCCESS            The transfer is aborted.
+  @retval Others                 Failed to abort the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkCancel (
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                              *Transfer
+  )
+{
+  USB_INTERFACE  *UsbIf;
+
+  UsbIf = USB_INTERFACE_FROM_ASYNC_BULK (This);
+  return UsbIf->Device->Bus->AsyncBulk->Cancel (UsbIf->Device->Bus->AsyncBulk, Transfer);
+}
+
 /**
   Install Usb Bus Protocol on host controller, and start the Usb bus.
 
@@ -995,6 +1251,24 @@ UsbBusBuildProtocol (
     }
   }
 
+  //
+  // The host controller may also keep several bulk transfers outstanding.
+  // It's optional, and exposed to the class drivers on the handle of each
+  // USB interface by EDKII_USB_IO_ASYNC_BULK_PROTOCOL.
+  //
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEdkiiUsbAsyncBulkProtocolGuid,
+                  (VOID **)&UsbBus->AsyncBulk,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+
+  if (EFI_ERROR (Status)) {
+    UsbBus->AsyncBulk = NULL;
+  }
+
   //
   // Install an EFI_USB_BUS_PROTOCOL to host controller to identify it.
   //
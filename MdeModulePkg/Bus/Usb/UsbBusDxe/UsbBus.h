@@ -16,6 +16,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/UsbHostController.h>
 #include <Protocol/UsbIo.h>
 #include <Protocol/DevicePath.h>
+#include <Protocol/UsbAsyncBulk.h>
+#include <Protocol/UsbIoAsyncBulk.h>
 
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
@@ -141,6 +143,9 @@ typedef struct _USB_HUB_API    USB_HUB_API;
 #define USB_INTERFACE_FROM_USBIO(a) \
           CR(a, USB_INTERFACE, UsbIo, USB_INTERFACE_SIGNATURE)
 
+#define USB_INTERFACE_FROM_ASYNC_BULK(a) \
+          CR(a, USB_INTERFACE, AsyncBulk, USB_INTERFACE_SIGNATURE)
+
 #define USB_BUS_FROM_THIS(a) \
           CR(a, USB_BUS, BusId, USB_BUS_SIGNATURE)
 
@@ -195,67 +200,69 @@ struct _USB_DEVICE {
 // Stands for different functions of USB device
 //
 struct _USB_INTERFACE {
-  UINTN                       Signature;
-  USB_DEVICE                  *Device;
-  USB_INTERFACE_DESC          *IfDesc;
-  USB_INTERFACE_SETTING       *IfSetting;
+  UINTN                               Signature;
+  USB_DEVICE                          *Device;
+  USB_INTERFACE_DESC                  *IfDesc;
+  USB_INTERFACE_SETTING               *IfSetting;
 
   //
   // Handles and protocols
   //
-  EFI_HANDLE                  Handle;
-  EFI_USB_IO_PROTOCOL         UsbIo;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  BOOLEAN                     IsManaged;
+  EFI_HANDLE                          Handle;
+  EFI_USB_IO_PROTOCOL                 UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    AsyncBulk;
+  EFI_DEVICE_PATH_PROTOCOL            *DevicePath;
+  BOOLEAN                             IsManaged;
 
   //
   // Hub device special data
   //
-  BOOLEAN                     IsHub;
-  USB_HUB_API                 *HubApi;
-  UINT8                       NumOfPort;
-  EFI_EVENT                   HubNotify;
+  BOOLEAN                             IsHub;
+  USB_HUB_API                         *HubApi;
+  UINT8                               NumOfPort;
+  EFI_EVENT                           HubNotify;
 
   //
   // Data used only by normal hub devices
   //
-  USB_ENDPOINT_DESC           *HubEp;
-  UINT8                       *ChangeMap;
+  USB_ENDPOINT_DESC                   *HubEp;
+  UINT8                               *ChangeMap;
 
   //
   // Data used only by root hub to hand over device to
   // companion UHCI driver if low/full speed devices are
   // connected to EHCI.
   //
-  UINT8                       MaxSpeed;
+  UINT8                               MaxSpeed;
 };
 
 //
 // Stands for the current USB Bus
 //
 struct _USB_BUS {
-  UINTN                       Signature;
-  EFI_USB_BUS_PROTOCOL        BusId;
+  UINTN                            Signature;
+  EFI_USB_BUS_PROTOCOL             BusId;
 
   //
   // Managed USB host controller
   //
-  EFI_HANDLE                  HostHandle;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  EFI_USB2_HC_PROTOCOL        *Usb2Hc;
-  EFI_USB_HC_PROTOCOL         *UsbHc;
+  EFI_HANDLE                       HostHandle;
+  EFI_DEVICE_PATH_PROTOCOL         *DevicePath;
+  EFI_USB2_HC_PROTOCOL             *Usb2Hc;
+  EFI_USB_HC_PROTOCOL              *UsbHc;
+  EDKII_USB_ASYNC_BULK_PROTOCOL    *AsyncBulk;
 
   //
   // Recorded the max supported usb devices.
   // XHCI can support up to 255 devices.
   // EHCI/UHCI/OHCI supports up to 127 devices.
   //
-  UINT32                      MaxDevices;
+  UINT32                           MaxDevices;
   //
   // An array of device that is on the bus. Devices[0] is
   // for root hub. Device with address i is at Devices[i].
   //
-  USB_DEVICE                  *Devices[256];
+  USB_DEVICE                       *Devices[256];
 
   //
   // USB Bus driver need to control the recursive connect policy of the bus, only those wanted
@@ -652,6 +659,115 @@ UsbIoPortReset (
   IN EFI_USB_IO_PROTOCOL  *This
   );
 
+/**
+  Select an alternate setting of the USB interface. The SET_INTERFACE
+  request goes through the USB IO control transfer, which records the
+  new active setting of the interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  AlternateSetting       The alternate setting to select.
+
+  @retval EFI_SUCCESS            The alternate setting is selected.
+  @retval EFI_NOT_FOUND          The interface has no such alternate setting.
+  @retval EFI_DEVICE_ERROR       Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkSelectSetting (
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             AlternateSetting
+  );
+
+/**
+  Enable the streams of a SuperSpeed bulk endpoint of the USB interface.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamNumber           On input, the number of streams requested. On
+                                 output, the number of streams enabled.
+
+  @retval EFI_SUCCESS            The streams are enabled.
+  @retval EFI_INVALID_PARAMETER  The endpoint isn't a bulk endpoint of the
+                                 active setting.
+  @retval Others                 Failed to enable the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkEnableStreams (
+  IN     EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                             Endpoint,
+  IN OUT UINT16                            *StreamNumber
+  );
+
+/**
+  Submit a bulk transfer to an endpoint of the USB interface, and return
+  without waiting for its completion.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Endpoint               The device endpoint.
+  @param  StreamId               The stream of the endpoint, or 0.
+  @param  Data                   The data to transfer.
+  @param  DataLength             The length of the data to transfer.
+  @param  Transfer               Return the token of the transfer.
+
+  @retval EFI_SUCCESS            The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER  The endpoint isn't a bulk endpoint of the
+                                 active setting.
+  @retval Others                 Failed to submit the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkSubmit (
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  UINT8                             Endpoint,
+  IN  UINT16                            StreamId,
+  IN  VOID                              *Data,
+  IN  UINTN                             DataLength,
+  OUT VOID                              **Transfer
+  );
+
+/**
+  Check whether a submitted bulk transfer is completed.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Transfer               The token of the transfer.
+  @param  DataLength             Return the number of bytes transferred.
+  @param  UsbStatus              Return the result of the transfer.
+
+  @retval EFI_SUCCESS            The transfer is completed successfully.
+  @retval EFI_NOT_READY          The transfer is still in progress.
+  @retval Others                 The transfer is completed with an error.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkPoll (
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                              *Transfer,
+  OUT UINTN                             *DataLength,
+  OUT UINT32                            *UsbStatus
+  );
+
+/**
+  Abort a submitted bulk transfer.
+
+  @param  This                   The USB IO async bulk instance.
+  @param  Transfer               The token of the transfer.
+
+  @retval EFI_SUCCESS            The transfer is aborted.
+  @retval Others                 Failed to abort the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbIoAsyncBulkCancel (
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                              *Transfer
+  );
+
 /**
   Install Usb Bus Protocol on host controller, and start the Usb bus.
 
@@ -751,9 +867,10 @@ UsbBusControllerDriverStop (
   IN EFI_HANDLE                   *ChildHandleBuffer
   );
 
-extern EFI_USB_IO_PROTOCOL           mUsbIoProtocol;
-extern EFI_DRIVER_BINDING_PROTOCOL   mUsbBusDriverBinding;
-extern EFI_COMPONENT_NAME_PROTOCOL   mUsbBusComponentName;
-extern EFI_COMPONENT_NAME2_PROTOCOL  mUsbBusComponentName2;
+extern EFI_USB_IO_PROTOCOL               mUsbIoProtocol;
+extern EDKII_USB_IO_ASYNC_BULK_PROTOCOL  mUsbIoAsyncBulkProtocol;
+extern EFI_DRIVER_BINDING_PROTOCOL       mUsbBusDriverBinding;
+extern EFI_COMPONENT_NAME_PROTOCOL       mUsbBusComponentName;
+extern EFI_COMPONENT_NAME2_PROTOCOL      mUsbBusComponentName2;
 
 #endif
@@ -42,30 +42,96 @@ UsbGetEndpointDesc (
 }
 
 /**
-  Free the resource used by USB interface.
+  Install the device path and USB IO protocols of the USB interface, and
+  the USB IO async bulk protocol if the host controller supports it.
 
-  @param  UsbIf                 The USB interface to free.
+  @param  UsbIf                 The USB interface.
+
+  @return The install protocol return.
 
-  @retval EFI_ACCESS_DENIED     The interface is still occupied.
-  @retval EFI_SUCCESS           The interface is freed.
 **/
 EFI_STATUS
-UsbFreeInterface (
+UsbInstallInterfaceProtocols (
   IN USB_INTERFACE  *UsbIf
   )
 {
-  EFI_STATUS  Status;
+  if (UsbIf->Device->Bus->AsyncBulk != NULL) {
+    return gBS->InstallMultipleProtocolInterfaces (
+                  &UsbIf->Handle,
+                  &gEfiDevicePathProtocolGuid,
+                  UsbIf->DevicePath,
+                  &gEfiUsbIoProtocolGuid,
+                  &UsbIf->UsbIo,
+                  &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                  &UsbIf->AsyncBulk,
+                  NULL
+                  );
+  }
 
-  UsbCloseHostProtoByChild (UsbIf->Device->Bus, UsbIf->Handle);
+  return gBS->InstallMultipleProtocolInterfaces (
+                &UsbIf->Handle,
+                &gEfiDevicePathProtocolGuid,
+                UsbIf->DevicePath,
+                &gEfiUsbIoProtocolGuid,
+                &UsbIf->UsbIo,
+                NULL
+                );
+}
+
+/**
+  Uninstall the protocols installed by UsbInstallInterfaceProtocols().
 
-  Status = gBS->UninstallMultipleProtocolInterfaces (
+  @param  UsbIf                 The USB interface.
+
+  @return The uninstall protocol return.
+
+**/
+EFI_STATUS
+UsbUninstallInterfaceProtocols (
+  IN USB_INTERFACE  *UsbIf
+  )
+{
+  if (UsbIf->Device->Bus->AsyncBulk != NULL) {
+    return gBS->UninstallMultipleProtocolInterfaces (
                   UsbIf->Handle,
                   &gEfiDevicePathProtocolGuid,
                   UsbIf->DevicePath,
                   &gEfiUsbIoProtocolGuid,
                   &UsbIf->UsbIo,
+                  &gEdkiiUsbIoAsyncBulkProtocolGuid,
+                  &UsbIf->AsyncBulk,
                   NULL
                   );
+  }
+
+  return gBS->UninstallMultipleProtocolInterfaces (
+                UsbIf->Handle,
+                &gEfiDevicePathProtocolGuid,
+                UsbIf->DevicePath,
+                &gEfiUsbIoProtocolGuid,
+                &UsbIf->UsbIo,
+                NULL
+                );
+}
+
+/**
+  Free the resource used by USB interface.
+
+  @param  UsbIf                 The USB interface to free.
+
+  @retval EFI_ACCESS_DENIED     The interface is still occupied.
+  @retval EFI_SUCCESS           The interface is freed.
+**/
+EFI_STATUS
+UsbFreeInterface (
+  IN USB_INTERFACE  *UsbIf
+  )
+{
+  EFI_STATUS  Status;
+
+  UsbCloseHostProtoByChild (UsbIf->Device->Bus, UsbIf->Handle);
+
+  Status = UsbUninstallInterfaceProtocols (UsbIf);
   if (!EFI_ERROR (Status)) {
     if (UsbIf->DevicePath != NULL) {
       FreePool (UsbIf->DevicePath);
@@ -118,6 +184,12 @@ UsbCreateInterface (
     sizeof (EFI_USB_IO_PROTOCOL)
     );
 
+  CopyMem (
+    &(UsbIf->AsyncBulk),
+    &mUsbIoAsyncBulkProtocol,
+    sizeof (EDKII_USB_IO_ASYNC_BULK_PROTOCOL)
+    );
+
   //
   // Install protocols for USBIO and device path
   //
@@ -140,14 +212,7 @@ UsbCreateInterface (
     goto ON_ERROR;
   }
 
-  Status = gBS->InstallMultipleProtocolInterfaces (
-                  &UsbIf->Handle,
-                  &gEfiDevicePathProtocolGuid,
-                  UsbIf->DevicePath,
-                  &gEfiUsbIoProtocolGuid,
-                  &UsbIf->UsbIo,
-                  NULL
-                  );
+  Status = UsbInstallInterfaceProtocols (UsbIf);
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "UsbCreateInterface: failed to install UsbIo - %r\n", Status));
@@ -160,14 +225,7 @@ UsbCreateInterface (
   Status = UsbOpenHostProtoByChild (Device->Bus, UsbIf->Handle);
 
   if (EFI_ERROR (Status)) {
-    gBS->UninstallMultipleProtocolInterfaces (
-           UsbIf->Handle,
-           &gEfiDevicePathProtocolGuid,
-           UsbIf->DevicePath,
-           &gEfiUsbIoProtocolGuid,
-           &UsbIf->UsbIo,
-           NULL
-           );
+    UsbUninstallInterfaceProtocols (UsbIf);
 
     DEBUG ((DEBUG_ERROR, "UsbCreateInterface: failed to open host for child - %r\n", Status));
     goto ON_ERROR;
@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/UsbIo.h>
 #include <Protocol/DevicePath.h>
 #include <Protocol/DiskInfo.h>
+#include <Protocol/UsbIoAsyncBulk.h>
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
@@ -28,8 +29,21 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct _USB_MASS_TRANSPORT  USB_MASS_TRANSPORT;
 typedef struct _USB_MASS_DEVICE     USB_MASS_DEVICE;
 
+///
+/// One command of the list executed by USB_MASS_TRANSPORT.ExecCommandList().
+///
+typedef struct {
+  VOID                      *Cmd;       ///< The command to transfer to device
+  UINT8                     CmdLen;     ///< The length of the command
+  EFI_USB_DATA_DIRECTION    DataDir;    ///< The direction of data transfer
+  VOID                      *Data;      ///< The buffer to hold the data
+  UINT32                    DataLen;    ///< The length of the buffer
+  UINT32                    CmdStatus;  ///< The result of the command execution
+} USB_MASS_COMMAND;
+
 #include "UsbMassBot.h"
 #include "UsbMassCbi.h"
+#include "UsbMassUas.h"
 #include "UsbMassBoot.h"
 #include "UsbMassDiskInfo.h"
 #include "UsbMassImpl.h"
@@ -99,6 +113,35 @@ EFI_STATUS
   OUT UINT32                  *CmdStatus
   );
 
+/**
+  Execute several USB mass storage commands through the transport protocol.
+
+  The transport may keep several of the commands outstanding on the device
+  at a time, so the commands must not depend on each other.
+
+  @param  Context               The USB Transport Protocol.
+  @param  Commands              The commands to execute. CmdStatus of each
+                                command returns its result.
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are transported.
+  @retval Other                 Failed to transport some of the commands.
+                                The commands which are not executed have
+                                USB_MASS_CMD_FAIL in CmdStatus.
+
+**/
+typedef
+EFI_STATUS
+(*USB_MASS_EXEC_COMMAND_LIST) (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  );
+
 /**
   Reset the USB mass storage device by Transport protocol.
 
@@ -152,18 +195,19 @@ EFI_STATUS
 ///
 /// This structure contains information necessary to select the
 /// proper transport protocol. The mass storage class defines
-/// two transport protocols. One is the CBI, and the other is BOT.
-/// CBI is being obseleted. The design is made modular by this
-/// structure so that the CBI protocol can be easily removed when
-/// it is no longer necessary.
+/// three transport protocols: CBI, BOT and UAS. CBI is being
+/// obseleted. The design is made modular by this structure so
+/// that the CBI protocol can be easily removed when it is no
+/// longer necessary.
 ///
 struct _USB_MASS_TRANSPORT {
-  UINT8                      Protocol;
-  USB_MASS_INIT_TRANSPORT    Init;        ///< Initialize the mass storage transport protocol
-  USB_MASS_EXEC_COMMAND      ExecCommand; ///< Transport command to the device then get result
-  USB_MASS_RESET             Reset;       ///< Reset the device
-  USB_MASS_GET_MAX_LUN       GetMaxLun;   ///< Get max lun, only for bot
-  USB_MASS_CLEAN_UP          CleanUp;     ///< Clean up the resources.
+  UINT8                         Protocol;
+  USB_MASS_INIT_TRANSPORT       Init;            ///< Initialize the mass storage transport protocol
+  USB_MASS_EXEC_COMMAND         ExecCommand;     ///< Transport command to the device then get result
+  USB_MASS_RESET                Reset;           ///< Reset the device
+  USB_MASS_GET_MAX_LUN          GetMaxLun;       ///< Get max lun, only for bot
+  USB_MASS_CLEAN_UP             CleanUp;         ///< Clean up the resources.
+  USB_MASS_EXEC_COMMAND_LIST    ExecCommandList; ///< Transport several commands at once, optional
 };
 
 struct _USB_MASS_DEVICE {
@@ -793,6 +793,111 @@ UsbBootDetectMedia (
   return Status;
 }
 
+/**
+  Read or write some blocks with several commands outstanding on the device.
+
+  The blocks are split into commands of USB_BOOT_MAX_CARRY_SIZE, which are
+  handed to the transport in lists of USB_BOOT_MAX_QUEUED_CMD. This stops at
+  the first command that fails, or when the transport can't take the list,
+  and leaves it to the caller to execute the remaining blocks one command at
+  a time with the retry and sense handling.
+
+  @param  UsbMass                The USB mass storage device to access
+  @param  Write                  TRUE for write operation.
+  @param  Lba                    The start block number
+  @param  TotalBlock             Total block number to read or write
+  @param  Buffer                 The buffer to read to or write from
+
+  @return The number of blocks read or written from Lba on.
+
+**/
+UINTN
+UsbBootReadWriteQueued (
+  IN  USB_MASS_DEVICE  *UsbMass,
+  IN  BOOLEAN          Write,
+  IN  UINT64           Lba,
+  IN  UINTN            TotalBlock,
+  IN OUT UINT8         *Buffer
+  )
+{
+  USB_MASS_COMMAND  Commands[USB_BOOT_MAX_QUEUED_CMD];
+  UINT8             Cmd[USB_BOOT_MAX_QUEUED_CMD][16];
+  UINT32            Count[USB_BOOT_MAX_QUEUED_CMD];
+  EFI_STATUS        Status;
+  UINT32            CountMax;
+  UINT32            BlockSize;
+  UINTN             Done;
+  UINTN             Queued;
+  UINTN             Number;
+  UINTN             Index;
+
+  BlockSize = UsbMass->BlockIoMedia.BlockSize;
+  CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
+  Done      = 0;
+
+  //
+  // A single command gains nothing from the command list.
+  //
+  while (TotalBlock - Done > CountMax) {
+    Queued = 0;
+    for (Number = 0; (Number < USB_BOOT_MAX_QUEUED_CMD) && (Done + Queued < TotalBlock); Number++) {
+      Count[Number] = (UINT32)MIN (TotalBlock - Done - Queued, CountMax);
+
+      ZeroMem (Cmd[Number], sizeof (Cmd[Number]));
+      if (UsbMass->Cdb16Byte) {
+        Cmd[Number][0] = Write ? EFI_SCSI_OP_WRITE16 : EFI_SCSI_OP_READ16;
+        Cmd[Number][1] = (UINT8)((USB_BOOT_LUN (UsbMass->Lun) & 0xE0));
+        WriteUnaligned64 ((UINT64 *)&Cmd[Number][2], SwapBytes64 (Lba + Done + Queued));
+        WriteUnaligned32 ((UINT32 *)&Cmd[Number][10], SwapBytes32 (Count[Number]));
+        Commands[Number].CmdLen = 16;
+      } else {
+        Cmd[Number][0] = Write ? USB_BOOT_WRITE10_OPCODE : USB_BOOT_READ10_OPCODE;
+        Cmd[Number][1] = (UINT8)(USB_BOOT_LUN (UsbMass->Lun));
+        WriteUnaligned32 ((UINT32 *)&Cmd[Number][2], SwapBytes32 ((UINT32)(Lba + Done + Queued)));
+        WriteUnaligned16 ((UINT16 *)&Cmd[Number][7], SwapBytes16 ((UINT16)Count[Number]));
+        Commands[Number].CmdLen = (UINT8)sizeof (USB_BOOT_READ_WRITE_10_CMD);
+      }
+
+      Commands[Number].Cmd     = Cmd[Number];
+      Commands[Number].DataDir = Write ? EfiUsbDataOut : EfiUsbDataIn;
+      Commands[Number].Data    = Buffer + (Done + Queued) * BlockSize;
+      Commands[Number].DataLen = Count[Number] * BlockSize;
+
+      Queued += Count[Number];
+    }
+
+    Status = UsbMass->Transport->ExecCommandList (
+                                   UsbMass->Context,
+                                   Commands,
+                                   Number,
+                                   UsbMass->Lun,
+                                   (UINT32)USB_BOOT_GENERAL_CMD_TIMEOUT
+                                   );
+    if (Status == EFI_UNSUPPORTED) {
+      return Done;
+    }
+
+    for (Index = 0; Index < Number; Index++) {
+      if (Commands[Index].CmdStatus != USB_MASS_CMD_SUCCESS) {
+        DEBUG ((DEBUG_INFO, "UsbBootReadWriteQueued: %r, command %d of %d failed\n", Status, (UINT32)Index, (UINT32)Number));
+        return Done;
+      }
+
+      Done += Count[Index];
+    }
+
+    DEBUG ((
+      DEBUG_BLKIO,
+      "UsbBoot%sQueued: LBA (0x%lx), Blk (0x%x)\n",
+      Write ? L"Write" : L"Read",
+      Lba + Done - Queued,
+      (UINT32)Queued
+      ));
+  }
+
+  return Done;
+}
+
 /**
   Read or write some blocks from the device.
 
@@ -822,11 +927,22 @@ UsbBootReadWriteBlocks (
   UINT32                      BlockSize;
   UINT32                      ByteSize;
   UINT32                      Timeout;
+  UINTN                       Done;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
   CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
   Status    = EFI_SUCCESS;
 
+  //
+  // Let the transport keep several commands outstanding if it can.
+  //
+  if (UsbMass->Transport->ExecCommandList != NULL) {
+    Done        = UsbBootReadWriteQueued (UsbMass, Write, Lba, TotalBlock, Buffer);
+    Lba        += (UINT32)Done;
+    Buffer     += Done * BlockSize;
+    TotalBlock -= Done;
+  }
+
   while (TotalBlock > 0) {
     //
     // Split the total blocks into smaller pieces to ease the pressure
@@ -908,11 +1024,22 @@ UsbBootReadWriteBlocks16 (
   UINT32      BlockSize;
   UINT32      ByteSize;
   UINT32      Timeout;
+  UINTN       Done;
 
   BlockSize = UsbMass->BlockIoMedia.BlockSize;
   CountMax  = USB_BOOT_MAX_CARRY_SIZE / BlockSize;
   Status    = EFI_SUCCESS;
 
+  //
+  // Let the transport keep several commands outstanding if it can.
+  //
+  if (UsbMass->Transport->ExecCommandList != NULL) {
+    Done        = UsbBootReadWriteQueued (UsbMass, Write, Lba, TotalBlock, Buffer);
+    Lba        += Done;
+    Buffer     += Done * BlockSize;
+    TotalBlock -= Done;
+  }
+
   while (TotalBlock > 0) {
     //
     // Split the total blocks into smaller pieces.
@@ -1003,3 +1130,64 @@ UsbClearEndpointStall (
 
   return Status;
 }
+
+/**
+  Locate the USB I/O async bulk protocol installed by the USB bus driver
+  next to the USB I/O Protocol instance.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  AsyncBulk             Return the USB I/O async bulk protocol
+
+  @retval EFI_SUCCESS           The async bulk protocol is found.
+  @retval EFI_UNSUPPORTED       The host controller doesn't support it.
+
+**/
+EFI_STATUS
+UsbLocateAsyncBulk (
+  IN  EFI_USB_IO_PROTOCOL               *UsbIo,
+  OUT EDKII_USB_IO_ASYNC_BULK_PROTOCOL  **AsyncBulk
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_HANDLE                        *HandleBuffer;
+  UINTN                             HandleCount;
+  UINTN                             Index;
+  EFI_USB_IO_PROTOCOL               *Instance;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *Found;
+
+  //
+  // Find the handle of the USB I/O instance.
+  //
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gEfiUsbIoProtocolGuid,
+                  NULL,
+                  &HandleCount,
+                  &HandleBuffer
+                  );
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Found = NULL;
+  for (Index = 0; Index < HandleCount; Index++) {
+    Status = gBS->HandleProtocol (HandleBuffer[Index], &gEfiUsbIoProtocolGuid, (VOID **)&Instance);
+    if (!EFI_ERROR (Status) && (Instance == UsbIo)) {
+      Status = gBS->HandleProtocol (HandleBuffer[Index], &gEdkiiUsbIoAsyncBulkProtocolGuid, (VOID **)&Found);
+      if (EFI_ERROR (Status)) {
+        Found = NULL;
+      }
+
+      break;
+    }
+  }
+
+  FreePool (HandleBuffer);
+
+  if (Found == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *AsyncBulk = Found;
+  return EFI_SUCCESS;
+}
@@ -63,6 +63,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define USB_BOOT_MAX_CARRY_SIZE  SIZE_64KB
 
+//
+// Max commands handed to the transport at once by a read or write, if it
+// can keep several commands outstanding.
+//
+#define USB_BOOT_MAX_QUEUED_CMD  16
+
 //
 // Retry mass command times, set by experience
 //
@@ -334,4 +340,21 @@ UsbClearEndpointStall (
   IN UINT8                EndpointAddr
   );
 
+/**
+  Locate the USB I/O async bulk protocol installed by the USB bus driver
+  next to the USB I/O Protocol instance.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  AsyncBulk             Return the USB I/O async bulk protocol
+
+  @retval EFI_SUCCESS           The async bulk protocol is found.
+  @retval EFI_UNSUPPORTED       The host controller doesn't support it.
+
+**/
+EFI_STATUS
+UsbLocateAsyncBulk (
+  IN  EFI_USB_IO_PROTOCOL               *UsbIo,
+  OUT EDKII_USB_IO_ASYNC_BULK_PROTOCOL  **AsyncBulk
+  );
+
 #endif
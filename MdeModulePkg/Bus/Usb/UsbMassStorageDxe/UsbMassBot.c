@@ -18,7 +18,8 @@ USB_MASS_TRANSPORT  mUsbBotTransport = {
   UsbBotExecCommand,
   UsbBotResetDevice,
   UsbBotGetMaxLun,
-  UsbBotCleanUp
+  UsbBotCleanUp,
+  UsbBotExecCommandList
 };
 
 /**
@@ -112,6 +113,15 @@ UsbBotInit (
   UsbBot->CbwTag = 0x01;
 
   if (Context != NULL) {
+    //
+    // Queue several read commands at a time if the host controller
+    // supports asynchronous bulk transfers.
+    //
+    Status = UsbLocateAsyncBulk (UsbIo, &UsbBot->AsyncBulk);
+    if (EFI_ERROR (Status)) {
+      UsbBot->AsyncBulk = NULL;
+    }
+
     *Context = UsbBot;
   } else {
     FreePool (UsbBot);
@@ -444,6 +454,282 @@ UsbBotExecCommand (
   return EFI_SUCCESS;
 }
 
+/**
+  Queue the command, data and status transfers of a read command on the
+  bulk endpoints.
+
+  @param  UsbBot                The USB BOT device
+  @param  Queued                The queue entry of the command
+  @param  Command               The command to queue
+  @param  Lun                   The number of logic unit
+
+  @retval EFI_SUCCESS           The transfers of the command are queued.
+  @retval Others                Failed to queue the transfers.
+
+**/
+EFI_STATUS
+UsbBotQueueCommand (
+  IN USB_BOT_PROTOCOL        *UsbBot,
+  IN USB_BOT_QUEUED_COMMAND  *Queued,
+  IN USB_MASS_COMMAND        *Command,
+  IN UINT8                   Lun
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT ((Command->CmdLen > 0) && (Command->CmdLen <= USB_BOT_MAX_CMDLEN));
+
+  ZeroMem (Queued, sizeof (USB_BOT_QUEUED_COMMAND));
+
+  Queued->Cbw.Signature = USB_BOT_CBW_SIGNATURE;
+  Queued->Cbw.Tag       = UsbBot->CbwTag++;
+  Queued->Cbw.DataLen   = Command->DataLen;
+  Queued->Cbw.Flag      = BIT7;
+  Queued->Cbw.Lun       = Lun;
+  Queued->Cbw.CmdLen    = Command->CmdLen;
+  CopyMem (Queued->Cbw.CmdBlock, Command->Cmd, Command->CmdLen);
+
+  Status = UsbBot->AsyncBulk->Submit (
+                                UsbBot->AsyncBulk,
+                                UsbBot->BulkOutEndpoint->EndpointAddress,
+                                0,
+                                &Queued->Cbw,
+                                sizeof (USB_BOT_CBW),
+                                &Queued->CbwXfer
+                                );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Command->DataLen != 0) {
+    Status = UsbBot->AsyncBulk->Submit (
+                                  UsbBot->AsyncBulk,
+                                  UsbBot->BulkInEndpoint->EndpointAddress,
+                                  0,
+                                  Command->Data,
+                                  Command->DataLen,
+                                  &Queued->DataXfer
+                                  );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return UsbBot->AsyncBulk->Submit (
+                              UsbBot->AsyncBulk,
+                              UsbBot->BulkInEndpoint->EndpointAddress,
+                              0,
+                              &Queued->Csw,
+                              sizeof (USB_BOT_CSW),
+                              &Queued->CswXfer
+                              );
+}
+
+/**
+  Check whether the transfers of a queued command are completed, in the
+  order the device executes them.
+
+  @param  UsbBot                The USB BOT device
+  @param  Queued                The queue entry of the command
+  @param  Command               The command
+
+  @retval EFI_SUCCESS           The command is completed, its result is in CmdStatus.
+  @retval EFI_NOT_READY         The command is still in progress.
+  @retval EFI_DEVICE_ERROR      A transfer failed or the CSW is invalid, which
+                                needs a reset recovery.
+
+**/
+EFI_STATUS
+UsbBotCheckQueuedCommand (
+  IN USB_BOT_PROTOCOL        *UsbBot,
+  IN USB_BOT_QUEUED_COMMAND  *Queued,
+  IN USB_MASS_COMMAND        *Command
+  )
+{
+  VOID        **Xfer[3];
+  EFI_STATUS  Status;
+  UINTN       Length;
+  UINT32      Result;
+  UINTN       Index;
+
+  Xfer[0] = &Queued->CbwXfer;
+  Xfer[1] = &Queued->DataXfer;
+  Xfer[2] = &Queued->CswXfer;
+
+  for (Index = 0; Index < ARRAY_SIZE (Xfer); Index++) {
+    if (*Xfer[Index] == NULL) {
+      continue;
+    }
+
+    Status = UsbBot->AsyncBulk->Poll (UsbBot->AsyncBulk, *Xfer[Index], &Length, &Result);
+    if (Status == EFI_NOT_READY) {
+      return EFI_NOT_READY;
+    }
+
+    *Xfer[Index] = NULL;
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "UsbBotCheckQueuedCommand: transfer %d of tag %x - %x\n", (UINT32)Index, Queued->Cbw.Tag, Result));
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  if ((Queued->Csw.Signature != USB_BOT_CSW_SIGNATURE) ||
+      (Queued->Csw.Tag != Queued->Cbw.Tag) ||
+      (Queued->Csw.CmdStatus == USB_BOT_COMMAND_ERROR))
+  {
+    DEBUG ((DEBUG_ERROR, "UsbBotCheckQueuedCommand: invalid CSW of tag %x\n", Queued->Cbw.Tag));
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (Queued->Csw.CmdStatus == USB_BOT_COMMAND_OK) {
+    Command->CmdStatus = USB_MASS_CMD_SUCCESS;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Abort the transfers of a queued command which are still in progress.
+
+  @param  UsbBot                The USB BOT device
+  @param  Queued                The queue entry of the command
+
+**/
+VOID
+UsbBotCancelQueuedCommand (
+  IN USB_BOT_PROTOCOL        *UsbBot,
+  IN USB_BOT_QUEUED_COMMAND  *Queued
+  )
+{
+  if (Queued->CbwXfer != NULL) {
+    UsbBot->AsyncBulk->Cancel (UsbBot->AsyncBulk, Queued->CbwXfer);
+  }
+
+  if (Queued->DataXfer != NULL) {
+    UsbBot->AsyncBulk->Cancel (UsbBot->AsyncBulk, Queued->DataXfer);
+  }
+
+  if (Queued->CswXfer != NULL) {
+    UsbBot->AsyncBulk->Cancel (UsbBot->AsyncBulk, Queued->CswXfer);
+  }
+
+  Queued->CbwXfer  = NULL;
+  Queued->DataXfer = NULL;
+  Queued->CswXfer  = NULL;
+}
+
+/**
+  Execute several read commands through the USB Mass Storage Class BOT
+  protocol, with the command, data and status transfers of up to
+  USB_BOT_MAX_PIPELINE commands queued on the bulk endpoints at a time.
+
+  The device still executes the commands one after another, but the host
+  controller moves from one transfer to the next without waiting for the
+  driver.
+
+  @param  Context               The context of the BOT protocol, that is,
+                                USB_BOT_PROTOCOL
+  @param  Commands              The commands to execute
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are transported, and their results
+                                are in the CmdStatus of each command.
+  @retval EFI_UNSUPPORTED       The host controller doesn't support asynchronous
+                                bulk transfers, or some command isn't a read.
+                                None of the commands is executed.
+  @retval Other                 Failed to transport some of the commands.
+
+**/
+EFI_STATUS
+UsbBotExecCommandList (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  )
+{
+  USB_BOT_PROTOCOL  *UsbBot;
+  EFI_STATUS        Status;
+  UINTN             Head;
+  UINTN             Next;
+  UINTN             Index;
+  UINT32            Elapsed;
+
+  UsbBot = (USB_BOT_PROTOCOL *)Context;
+
+  for (Index = 0; Index < Count; Index++) {
+    Commands[Index].CmdStatus = USB_MASS_CMD_FAIL;
+  }
+
+  if (UsbBot->AsyncBulk == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Only reads are queued. A stalled write would leave the next CBW queued
+  // behind the data on the Bulk-Out endpoint.
+  //
+  for (Index = 0; Index < Count; Index++) {
+    if (Commands[Index].DataDir != EfiUsbDataIn) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  Head    = 0;
+  Next    = 0;
+  Elapsed = 0;
+
+  while (Head < Count) {
+    //
+    // Keep the queue full, the device takes the next CBW
+    // as soon as it has sent the CSW of the previous command.
+    //
+    while ((Next < Count) && (Next - Head < USB_BOT_MAX_PIPELINE)) {
+      Status = UsbBotQueueCommand (UsbBot, &UsbBot->Queue[Next % USB_BOT_MAX_PIPELINE], &Commands[Next], Lun);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "UsbBotExecCommandList: UsbBotQueueCommand (%r)\n", Status));
+        Next++;
+        goto ON_ERROR;
+      }
+
+      Next++;
+    }
+
+    Status = UsbBotCheckQueuedCommand (UsbBot, &UsbBot->Queue[Head % USB_BOT_MAX_PIPELINE], &Commands[Head]);
+    if (Status == EFI_NOT_READY) {
+      if (Elapsed >= Timeout) {
+        Status = EFI_TIMEOUT;
+        goto ON_ERROR;
+      }
+
+      gBS->Stall (USB_BOT_POLL_INTERVAL);
+      Elapsed += USB_BOT_POLL_INTERVAL;
+      continue;
+    }
+
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+
+    Head++;
+    Elapsed = 0;
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  for (Index = Head; Index < Next; Index++) {
+    Commands[Index].CmdStatus = USB_MASS_CMD_FAIL;
+    UsbBotCancelQueuedCommand (UsbBot, &UsbBot->Queue[Index % USB_BOT_MAX_PIPELINE]);
+  }
+
+  UsbBotResetDevice (UsbBot, FALSE);
+  return Status;
+}
+
 /**
   Reset the USB mass storage device by BOT protocol.
 
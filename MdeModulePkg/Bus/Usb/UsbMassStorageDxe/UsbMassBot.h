@@ -47,6 +47,14 @@ extern USB_MASS_TRANSPORT  mUsbBotTransport;
 #define USB_BOT_RECV_CSW_TIMEOUT      (3 * USB_MASS_1_SECOND)
 #define USB_BOT_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
 
+//
+// Number of read commands queued on the bulk endpoints at a time when the
+// host controller supports asynchronous bulk transfers, and the interval to
+// poll them.
+//
+#define USB_BOT_MAX_PIPELINE   8
+#define USB_BOT_POLL_INTERVAL  10
+
 #pragma pack(1)
 ///
 /// The CBW (Command Block Wrapper) structures used by the USB BOT protocol.
@@ -72,15 +80,28 @@ typedef struct {
 } USB_BOT_CSW;
 #pragma pack()
 
+///
+/// A command queued on the bulk endpoints, with its three transfers.
+///
+typedef struct {
+  USB_BOT_CBW    Cbw;
+  USB_BOT_CSW    Csw;
+  VOID           *CbwXfer;
+  VOID           *DataXfer;
+  VOID           *CswXfer;
+} USB_BOT_QUEUED_COMMAND;
+
 typedef struct {
   //
   // Put Interface at the first field to make it easy to distinguish BOT/CBI Protocol instance
   //
-  EFI_USB_INTERFACE_DESCRIPTOR    Interface;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkInEndpoint;
-  EFI_USB_ENDPOINT_DESCRIPTOR     *BulkOutEndpoint;
-  UINT32                          CbwTag;
-  EFI_USB_IO_PROTOCOL             *UsbIo;
+  EFI_USB_INTERFACE_DESCRIPTOR        Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkInEndpoint;
+  EFI_USB_ENDPOINT_DESCRIPTOR         *BulkOutEndpoint;
+  UINT32                              CbwTag;
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    *AsyncBulk; ///< NULL if the host controller doesn't support it
+  USB_BOT_QUEUED_COMMAND              Queue[USB_BOT_MAX_PIPELINE];
 } USB_BOT_PROTOCOL;
 
 /**
@@ -136,6 +157,39 @@ UsbBotExecCommand (
   OUT UINT32                  *CmdStatus
   );
 
+/**
+  Execute several read commands through the USB Mass Storage Class BOT
+  protocol, with the command, data and status transfers of up to
+  USB_BOT_MAX_PIPELINE commands queued on the bulk endpoints at a time.
+
+  The device still executes the commands one after another, but the host
+  controller moves from one transfer to the next without waiting for the
+  driver.
+
+  @param  Context               The context of the BOT protocol, that is,
+                                USB_BOT_PROTOCOL
+  @param  Commands              The commands to execute
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are transported, and their results
+                                are in the CmdStatus of each command.
+  @retval EFI_UNSUPPORTED       The host controller doesn't support asynchronous
+                                bulk transfers, or some command isn't a read.
+                                None of the commands is executed.
+  @retval Other                 Failed to transport some of the commands.
+
+**/
+EFI_STATUS
+UsbBotExecCommandList (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  );
+
 /**
   Reset the USB mass storage device by BOT protocol.
 
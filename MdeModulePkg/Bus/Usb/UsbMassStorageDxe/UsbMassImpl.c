@@ -8,11 +8,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "UsbMass.h"
 
-#define USB_MASS_TRANSPORT_COUNT  3
+#define USB_MASS_TRANSPORT_COUNT  4
 //
-// Array of USB transport interfaces.
+// Array of USB transport interfaces. UAS is tried before BOT, because
+// a UAS device usually exposes BOT in its default alternate setting.
 //
 USB_MASS_TRANSPORT  *mUsbMassTransport[USB_MASS_TRANSPORT_COUNT] = {
+  &mUsbUasTransport,
   &mUsbCbi0Transport,
   &mUsbCbi1Transport,
   &mUsbBotTransport,
@@ -422,13 +424,27 @@ UsbMassInitTransport (
   // matching transport protocol.
   // If not found, return EFI_UNSUPPORTED.
   // If found, execute USB_MASS_TRANSPORT.Init() to initialize the transport context.
+  // UAS may live in another alternate setting, so it checks the interface itself.
   //
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     *Transport = mUsbMassTransport[Index];
 
-    if (Interface.InterfaceProtocol == (*Transport)->Protocol) {
+    if ((Interface.InterfaceProtocol == (*Transport)->Protocol) ||
+        ((*Transport)->Protocol == USB_MASS_STORE_UAS))
+    {
       Status = (*Transport)->Init (UsbIo, Context);
-      break;
+
+      //
+      // UAS leaves the interface in its BOT setting when it fails, so any
+      // UAS error falls back to the next transport.
+      //
+      if (EFI_ERROR (Status) && ((*Transport)->Protocol == USB_MASS_STORE_UAS)) {
+        Status = EFI_UNSUPPORTED;
+      }
+
+      if (Status != EFI_UNSUPPORTED) {
+        break;
+      }
     }
   }
 
@@ -751,9 +767,17 @@ USBMassDriverBindingSupported (
   //
   for (Index = 0; Index < USB_MASS_TRANSPORT_COUNT; Index++) {
     Transport = mUsbMassTransport[Index];
-    if (Interface.InterfaceProtocol == Transport->Protocol) {
+    if ((Interface.InterfaceProtocol == Transport->Protocol) ||
+        (Transport->Protocol == USB_MASS_STORE_UAS))
+    {
       Status = Transport->Init (UsbIo, NULL);
-      break;
+      if (EFI_ERROR (Status) && (Transport->Protocol == USB_MASS_STORE_UAS)) {
+        Status = EFI_UNSUPPORTED;
+      }
+
+      if (Status != EFI_UNSUPPORTED) {
+        break;
+      }
     }
   }
 
@@ -0,0 +1,1086 @@
+/** @file
+  Implementation of the USB Attached SCSI transport protocol, according to
+  USB Mass Storage Class - USB Attached SCSI Protocol, Revision 1.0.
+
+  EFI_USB_IO_PROTOCOL only executes one bulk transfer at a time, while UAS
+  needs several transfers outstanding on different pipes, and the streams of
+  the bulk endpoints on SuperSpeed. So the transfers are submitted through the
+  EDKII_USB_ASYNC_BULK_PROTOCOL of the host controller. If the host controller
+  doesn't produce it, the device is driven by its BOT alternate setting.
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbMass.h"
+
+//
+// Definition of USB UAS Transport Protocol
+//
+USB_MASS_TRANSPORT  mUsbUasTransport = {
+  USB_MASS_STORE_UAS,
+  UsbUasInit,
+  UsbUasExecCommand,
+  UsbUasResetDevice,
+  UsbUasGetMaxLun,
+  UsbUasCleanUp,
+  UsbUasExecCommandList
+};
+
+/**
+  Read the active configuration descriptor of the device together with
+  all the interface, endpoint and class specific descriptors in it.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Config                Return the configuration descriptors, which
+                                the caller must free
+  @param  Length                Return the length of the configuration descriptors
+
+  @retval EFI_SUCCESS           The configuration descriptors are read.
+  @retval Others                Failed to read the configuration descriptors.
+
+**/
+EFI_STATUS
+UsbUasGetConfigDescriptor (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  OUT UINT8                **Config,
+  OUT UINTN                *Length
+  )
+{
+  EFI_USB_DEVICE_DESCRIPTOR  DevDesc;
+  EFI_USB_CONFIG_DESCRIPTOR  ActiveDesc;
+  EFI_USB_CONFIG_DESCRIPTOR  CfgDesc;
+  EFI_USB_DEVICE_REQUEST     Request;
+  EFI_STATUS                 Status;
+  UINT32                     Result;
+  UINT8                      Index;
+  UINT8                      *Buffer;
+
+  Status = UsbIo->UsbGetDeviceDescriptor (UsbIo, &DevDesc);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = UsbIo->UsbGetConfigDescriptor (UsbIo, &ActiveDesc);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Request.RequestType = 0x80;
+  Request.Request     = USB_REQ_GET_DESCRIPTOR;
+  Request.Index       = 0;
+
+  //
+  // The descriptor index may differ from the configuration value,
+  // so look for the index of the active configuration.
+  //
+  for (Index = 0; Index < DevDesc.NumConfigurations; Index++) {
+    Request.Value  = (UINT16)((USB_DESC_TYPE_CONFIG << 8) | Index);
+    Request.Length = (UINT16)sizeof (CfgDesc);
+
+    Status = UsbIo->UsbControlTransfer (
+                      UsbIo,
+                      &Request,
+                      EfiUsbDataIn,
+                      USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND,
+                      &CfgDesc,
+                      sizeof (CfgDesc),
+                      &Result
+                      );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (CfgDesc.ConfigurationValue != ActiveDesc.ConfigurationValue) {
+      continue;
+    }
+
+    if (CfgDesc.TotalLength < sizeof (CfgDesc)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    Buffer = AllocatePool (CfgDesc.TotalLength);
+    if (Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Request.Length = CfgDesc.TotalLength;
+    Status         = UsbIo->UsbControlTransfer (
+                              UsbIo,
+                              &Request,
+                              EfiUsbDataIn,
+                              USB_UAS_RESET_DEVICE_TIMEOUT / USB_MASS_1_MILLISECOND,
+                              Buffer,
+                              CfgDesc.TotalLength,
+                              &Result
+                              );
+    if (EFI_ERROR (Status)) {
+      FreePool (Buffer);
+      return Status;
+    }
+
+    *Config = Buffer;
+    *Length = CfgDesc.TotalLength;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Look for the UAS alternate setting of the interface in the configuration
+  descriptors, and the four pipes of it identified by the Pipe Usage
+  descriptors.
+
+  @param  UsbUas                The USB UAS device, the interface number of which
+                                is set. Return the UAS alternate setting and its pipes.
+  @param  Config                The configuration descriptors
+  @param  Length                The length of the configuration descriptors
+
+  @retval EFI_SUCCESS           The UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no valid UAS alternate setting.
+
+**/
+EFI_STATUS
+UsbUasParseInterface (
+  IN OUT USB_UAS_PROTOCOL  *UsbUas,
+  IN     UINT8             *Config,
+  IN     UINTN             Length
+  )
+{
+  EFI_USB_INTERFACE_DESCRIPTOR  *Interface;
+  EFI_USB_ENDPOINT_DESCRIPTOR   *Endpoint;
+  UINT8                         Pipe[USB_UAS_PIPE_ID_DATA_OUT + 1];
+  UINT16                        Streams[USB_UAS_PIPE_ID_DATA_OUT + 1];
+  UINT16                        LastStreams;
+  BOOLEAN                       InUas;
+  BOOLEAN                       SuperSpeed;
+  UINTN                         Offset;
+  UINT8                         Id;
+
+  Endpoint    = NULL;
+  LastStreams = 0;
+  InUas       = FALSE;
+  SuperSpeed  = FALSE;
+  Offset      = 0;
+
+  while (Offset + 2 <= Length) {
+    if ((Config[Offset] < 2) || (Offset + Config[Offset] > Length)) {
+      break;
+    }
+
+    switch (Config[Offset + 1]) {
+      case USB_DESC_TYPE_INTERFACE:
+        if (InUas) {
+          //
+          // The previous UAS alternate setting is complete.
+          //
+          goto ON_DONE;
+        }
+
+        Interface = (EFI_USB_INTERFACE_DESCRIPTOR *)&Config[Offset];
+        if ((Config[Offset] >= sizeof (EFI_USB_INTERFACE_DESCRIPTOR)) &&
+            (Interface->InterfaceNumber == UsbUas->Interface.InterfaceNumber) &&
+            (Interface->InterfaceClass == USB_MASS_STORE_CLASS) &&
+            (Interface->InterfaceProtocol == USB_MASS_STORE_UAS))
+        {
+          InUas = TRUE;
+          CopyMem (&UsbUas->Interface, Interface, sizeof (EFI_USB_INTERFACE_DESCRIPTOR));
+          ZeroMem (Pipe, sizeof (Pipe));
+          ZeroMem (Streams, sizeof (Streams));
+        }
+
+        Endpoint = NULL;
+        break;
+
+      case USB_DESC_TYPE_ENDPOINT:
+        Endpoint    = NULL;
+        LastStreams = 0;
+        if (InUas && (Config[Offset] >= sizeof (EFI_USB_ENDPOINT_DESCRIPTOR))) {
+          Endpoint = (EFI_USB_ENDPOINT_DESCRIPTOR *)&Config[Offset];
+          if (!USB_IS_BULK_ENDPOINT (Endpoint->Attributes)) {
+            Endpoint = NULL;
+          }
+        }
+
+        break;
+
+      case USB_UAS_DESC_TYPE_SS_EP_COMPANION:
+        //
+        // The companion descriptor follows the endpoint descriptor of
+        // a SuperSpeed device, and tells how many streams it supports.
+        //
+        if ((Endpoint != NULL) && (Config[Offset] >= 4)) {
+          SuperSpeed = TRUE;
+          Id         = (UINT8)(Config[Offset + 3] & USB_UAS_SS_EP_COMPANION_STREAMS);
+          if (Id != 0) {
+            LastStreams = (UINT16)(1 << MIN (Id, 15));
+          }
+        }
+
+        break;
+
+      case USB_UAS_DESC_TYPE_PIPE_USAGE:
+        if ((Endpoint != NULL) && (Config[Offset] >= 3)) {
+          Id = Config[Offset + 2];
+          if ((Id >= USB_UAS_PIPE_ID_COMMAND) && (Id <= USB_UAS_PIPE_ID_DATA_OUT)) {
+            Pipe[Id]    = Endpoint->EndpointAddress;
+            Streams[Id] = LastStreams;
+          }
+        }
+
+        break;
+
+      default:
+        break;
+    }
+
+    Offset += Config[Offset];
+  }
+
+ON_DONE:
+  if (!InUas ||
+      (Pipe[USB_UAS_PIPE_ID_COMMAND] == 0) || !USB_IS_OUT_ENDPOINT (Pipe[USB_UAS_PIPE_ID_COMMAND]) ||
+      (Pipe[USB_UAS_PIPE_ID_STATUS] == 0) || !USB_IS_IN_ENDPOINT (Pipe[USB_UAS_PIPE_ID_STATUS]) ||
+      (Pipe[USB_UAS_PIPE_ID_DATA_IN] == 0) || !USB_IS_IN_ENDPOINT (Pipe[USB_UAS_PIPE_ID_DATA_IN]) ||
+      (Pipe[USB_UAS_PIPE_ID_DATA_OUT] == 0) || !USB_IS_OUT_ENDPOINT (Pipe[USB_UAS_PIPE_ID_DATA_OUT]))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  UsbUas->CommandEndpoint = Pipe[USB_UAS_PIPE_ID_COMMAND];
+  UsbUas->StatusEndpoint  = Pipe[USB_UAS_PIPE_ID_STATUS];
+  UsbUas->DataInEndpoint  = Pipe[USB_UAS_PIPE_ID_DATA_IN];
+  UsbUas->DataOutEndpoint = Pipe[USB_UAS_PIPE_ID_DATA_OUT];
+  UsbUas->MaxStreams      = 0;
+
+  if (SuperSpeed) {
+    //
+    // UAS on SuperSpeed always uses the streams of the status and data pipes.
+    //
+    UsbUas->MaxStreams = MIN (Streams[USB_UAS_PIPE_ID_STATUS], Streams[USB_UAS_PIPE_ID_DATA_IN]);
+    UsbUas->MaxStreams = MIN (UsbUas->MaxStreams, Streams[USB_UAS_PIPE_ID_DATA_OUT]);
+    if (UsbUas->MaxStreams < 2) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Select an alternate setting of the mass storage interface.
+
+  The setting is selected by the USB bus driver, so that it and the host
+  controller switch to the endpoints of the new setting.
+
+  @param  UsbUas                The USB UAS device
+  @param  AlternateSetting      The alternate setting to select
+
+  @retval EFI_SUCCESS           The alternate setting is selected.
+  @retval Others                Failed to select the alternate setting.
+
+**/
+EFI_STATUS
+UsbUasSetInterface (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT8             AlternateSetting
+  )
+{
+  return UsbUas->AsyncBulk->SelectSetting (UsbUas->AsyncBulk, AlternateSetting);
+}
+
+/**
+  Select the UAS alternate setting, and enable the streams of the status
+  and data pipes on SuperSpeed. The queue depth is set by the number of
+  streams the host controller supports.
+
+  @param  UsbUas                The USB UAS device
+
+  @retval EFI_SUCCESS           The UAS alternate setting is ready to use.
+  @retval Others                Failed to select the UAS alternate setting.
+
+**/
+EFI_STATUS
+UsbUasSelectSetting (
+  IN USB_UAS_PROTOCOL  *UsbUas
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Endpoint[3];
+  UINT16      StreamNumber;
+  UINTN       Index;
+
+  Status = UsbUasSetInterface (UsbUas, UsbUas->Interface.AlternateSetting);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Without streams, the commands are matched to the data transfers by the
+  // Read Ready and Write Ready IUs, so only one command is outstanding.
+  //
+  UsbUas->QueueDepth = 1;
+  if (UsbUas->MaxStreams == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Endpoint[0] = UsbUas->StatusEndpoint;
+  Endpoint[1] = UsbUas->DataInEndpoint;
+  Endpoint[2] = UsbUas->DataOutEndpoint;
+
+  UsbUas->QueueDepth = MIN (UsbUas->MaxStreams, USB_UAS_MAX_QUEUE_DEPTH);
+
+  for (Index = 0; Index < ARRAY_SIZE (Endpoint); Index++) {
+    StreamNumber = UsbUas->QueueDepth;
+    Status       = UsbUas->AsyncBulk->EnableStreams (
+                                        UsbUas->AsyncBulk,
+                                        Endpoint[Index],
+                                        &StreamNumber
+                                        );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "UsbUasSelectSetting: failed to enable streams of EP %x - %r\n", Endpoint[Index], Status));
+      return Status;
+    }
+
+    UsbUas->QueueDepth = MIN (UsbUas->QueueDepth, StreamNumber);
+  }
+
+  DEBUG ((DEBUG_INFO, "UsbUasSelectSetting: %d commands outstanding\n", UsbUas->QueueDepth));
+  return EFI_SUCCESS;
+}
+
+/**
+  Initializes USB UAS protocol.
+
+  This function selects the UAS alternate setting of the mass storage
+  interface, and enables the streams of its bulk endpoints on SuperSpeed.
+  It will save its context which is a USB_UAS_PROTOCOL structure
+  in the Context if Context isn't NULL. If Context is NULL, the device
+  is only checked and left untouched.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The device or its host controller doesn't support UAS.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  OUT VOID                 **Context OPTIONAL
+  )
+{
+  USB_UAS_PROTOCOL                  *UsbUas;
+  EFI_USB_INTERFACE_DESCRIPTOR      Interface;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *AsyncBulk;
+  EFI_STATUS                        Status;
+  UINT8                             *Config;
+  UINTN                             Length;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &Interface);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Interface.InterfaceClass != USB_MASS_STORE_CLASS) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Check the host controller first, as it is much cheaper than
+  // reading the descriptors from the device.
+  //
+  Status = UsbLocateAsyncBulk (UsbIo, &AsyncBulk);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  UsbUas = AllocateZeroPool (sizeof (USB_UAS_PROTOCOL));
+  if (UsbUas == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  UsbUas->UsbIo                     = UsbIo;
+  UsbUas->AsyncBulk                 = AsyncBulk;
+  UsbUas->Interface.InterfaceNumber = Interface.InterfaceNumber;
+
+  Status = UsbUasGetConfigDescriptor (UsbIo, &Config, &Length);
+  if (EFI_ERROR (Status)) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_ERROR;
+  }
+
+  Status = UsbUasParseInterface (UsbUas, Config, Length);
+  FreePool (Config);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  if (Context == NULL) {
+    FreePool (UsbUas);
+    return EFI_SUCCESS;
+  }
+
+  Status = UsbUasSelectSetting (UsbUas);
+  if (EFI_ERROR (Status)) {
+    //
+    // Leave the device in its BOT setting so that it can be driven by the
+    // BOT transport.
+    //
+    UsbUasSetInterface (UsbUas, USB_UAS_BOT_SETTING);
+    Status = EFI_UNSUPPORTED;
+    goto ON_ERROR;
+  }
+
+  *Context = UsbUas;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  FreePool (UsbUas);
+  return Status;
+}
+
+/**
+  Release the transfers of a command.
+
+  The transfers which are still in progress are aborted.
+
+  @param  UsbUas                The USB UAS device
+  @param  Task                  The command
+
+**/
+VOID
+UsbUasAbortTask (
+  IN     USB_UAS_PROTOCOL  *UsbUas,
+  IN OUT USB_UAS_TASK      *Task
+  )
+{
+  if (Task->CommandXfer != NULL) {
+    UsbUas->AsyncBulk->Cancel (UsbUas->AsyncBulk, Task->CommandXfer);
+  }
+
+  if (Task->DataXfer != NULL) {
+    UsbUas->AsyncBulk->Cancel (UsbUas->AsyncBulk, Task->DataXfer);
+  }
+
+  if (Task->StatusXfer != NULL) {
+    UsbUas->AsyncBulk->Cancel (UsbUas->AsyncBulk, Task->StatusXfer);
+  }
+
+  ZeroMem (Task, sizeof (USB_UAS_TASK));
+}
+
+/**
+  Get the stream of a command. The stream is the tag on SuperSpeed,
+  and streams aren't used otherwise.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The tag of the command
+
+  @return The stream ID of the status and data transfers of the command.
+
+**/
+UINT16
+UsbUasStreamId (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT16            Tag
+  )
+{
+  return (UINT16)((UsbUas->MaxStreams != 0) ? Tag : 0);
+}
+
+/**
+  Submit the data transfer of a command.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The tag of the command
+
+  @retval EFI_SUCCESS           The data transfer is submitted, or there is no data.
+  @retval Others                Failed to submit the data transfer.
+
+**/
+EFI_STATUS
+UsbUasQueueData (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT16            Tag
+  )
+{
+  USB_UAS_TASK      *Task;
+  USB_MASS_COMMAND  *Command;
+
+  Task             = &UsbUas->Task[Tag - 1];
+  Command          = Task->Command;
+  Task->DataQueued = TRUE;
+
+  if ((Command->DataDir == EfiUsbNoData) || (Command->DataLen == 0)) {
+    return EFI_SUCCESS;
+  }
+
+  return UsbUas->AsyncBulk->Submit (
+                              UsbUas->AsyncBulk,
+                              (Command->DataDir == EfiUsbDataIn) ? UsbUas->DataInEndpoint : UsbUas->DataOutEndpoint,
+                              UsbUasStreamId (UsbUas, Tag),
+                              Command->Data,
+                              Command->DataLen,
+                              &Task->DataXfer
+                              );
+}
+
+/**
+  Submit the status transfer of a command, which receives the next IU
+  the device sends for the command.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The tag of the command
+
+  @retval EFI_SUCCESS           The status transfer is submitted.
+  @retval Others                Failed to submit the status transfer.
+
+**/
+EFI_STATUS
+UsbUasQueueStatus (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT16            Tag
+  )
+{
+  ZeroMem (&UsbUas->StatusIu[Tag - 1], sizeof (USB_UAS_STATUS_IU));
+
+  return UsbUas->AsyncBulk->Submit (
+                              UsbUas->AsyncBulk,
+                              UsbUas->StatusEndpoint,
+                              UsbUasStreamId (UsbUas, Tag),
+                              &UsbUas->StatusIu[Tag - 1],
+                              sizeof (USB_UAS_STATUS_IU),
+                              &UsbUas->Task[Tag - 1].StatusXfer
+                              );
+}
+
+/**
+  Start a command: queue the status and data transfers of its stream,
+  then send the Command IU.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The free tag to use for the command
+  @param  Command               The command to start
+  @param  Lun                   The number of logic unit
+
+  @retval EFI_SUCCESS           The command is started.
+  @retval Others                Failed to start the command.
+
+**/
+EFI_STATUS
+UsbUasStartTask (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT16            Tag,
+  IN USB_MASS_COMMAND  *Command,
+  IN UINT8             Lun
+  )
+{
+  USB_UAS_TASK        *Task;
+  USB_UAS_COMMAND_IU  *Iu;
+  EFI_STATUS          Status;
+
+  ASSERT ((Command->CmdLen > 0) && (Command->CmdLen <= USB_UAS_MAX_CMDLEN));
+
+  Task               = &UsbUas->Task[Tag - 1];
+  Task->Command      = Command;
+  Command->CmdStatus = USB_MASS_CMD_FAIL;
+
+  Iu = &UsbUas->CommandIu[Tag - 1];
+  ZeroMem (Iu, sizeof (USB_UAS_COMMAND_IU));
+  Iu->IuId          = USB_UAS_IU_COMMAND;
+  Iu->Tag[0]        = (UINT8)(Tag >> 8);
+  Iu->Tag[1]        = (UINT8)Tag;
+  Iu->TaskAttribute = USB_UAS_TASK_ATTR_SIMPLE;
+  Iu->Lun[1]        = Lun;
+  CopyMem (Iu->Cdb, Command->Cmd, Command->CmdLen);
+
+  Status = UsbUasQueueStatus (UsbUas, Tag);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // On SuperSpeed the device selects the stream of the command when it is
+  // ready to move the data, so the data transfer is queued right away.
+  // Otherwise it waits for the Read Ready or Write Ready IU.
+  //
+  if (UsbUas->MaxStreams != 0) {
+    Status = UsbUasQueueData (UsbUas, Tag);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return UsbUas->AsyncBulk->Submit (
+                              UsbUas->AsyncBulk,
+                              UsbUas->CommandEndpoint,
+                              0,
+                              Iu,
+                              sizeof (USB_UAS_COMMAND_IU),
+                              &Task->CommandXfer
+                              );
+}
+
+/**
+  Check the progress of a command.
+
+  @param  UsbUas                The USB UAS device
+  @param  Tag                   The tag of the command
+
+  @retval EFI_SUCCESS           The command is completed, its result is in CmdStatus.
+  @retval EFI_NOT_READY         The command is still in progress.
+  @retval EFI_DEVICE_ERROR      The command failed at the transport level.
+
+**/
+EFI_STATUS
+UsbUasCheckTask (
+  IN USB_UAS_PROTOCOL  *UsbUas,
+  IN UINT16            Tag
+  )
+{
+  USB_UAS_TASK       *Task;
+  USB_UAS_STATUS_IU  *StatusIu;
+  EFI_STATUS         Status;
+  BOOLEAN            Pending;
+  UINTN              Length;
+  UINT32             Result;
+  UINT16             SenseLength;
+
+  Task     = &UsbUas->Task[Tag - 1];
+  StatusIu = &UsbUas->StatusIu[Tag - 1];
+  Pending  = FALSE;
+
+  if (Task->CommandXfer != NULL) {
+    Status = UsbUas->AsyncBulk->Poll (UsbUas->AsyncBulk, Task->CommandXfer, &Length, &Result);
+    if (Status == EFI_NOT_READY) {
+      Pending = TRUE;
+    } else {
+      Task->CommandXfer = NULL;
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "UsbUasCheckTask: failed to send Command IU %d - %x\n", Tag, Result));
+        return EFI_DEVICE_ERROR;
+      }
+    }
+  }
+
+  if (Task->DataXfer != NULL) {
+    Status = UsbUas->AsyncBulk->Poll (UsbUas->AsyncBulk, Task->DataXfer, &Length, &Result);
+    if (Status == EFI_NOT_READY) {
+      Pending = TRUE;
+    } else {
+      Task->DataXfer = NULL;
+      if (EFI_ERROR (Status)) {
+        //
+        // The device reports the failure in the Sense IU as well.
+        //
+        DEBUG ((DEBUG_INFO, "UsbUasCheckTask: data transfer of tag %d - %x\n", Tag, Result));
+        Task->DataFailed = TRUE;
+      }
+    }
+  }
+
+  if (Task->StatusXfer != NULL) {
+    Status = UsbUas->AsyncBulk->Poll (UsbUas->AsyncBulk, Task->StatusXfer, &Length, &Result);
+    if (Status == EFI_NOT_READY) {
+      return EFI_NOT_READY;
+    }
+
+    Task->StatusXfer = NULL;
+    if (EFI_ERROR (Status) || (Length < 4) ||
+        (StatusIu->Tag[0] != (UINT8)(Tag >> 8)) || (StatusIu->Tag[1] != (UINT8)Tag))
+    {
+      DEBUG ((DEBUG_ERROR, "UsbUasCheckTask: failed to receive IU of tag %d - %x\n", Tag, Result));
+      return EFI_DEVICE_ERROR;
+    }
+
+    switch (StatusIu->IuId) {
+      case USB_UAS_IU_READ_READY:
+      case USB_UAS_IU_WRITE_READY:
+        if (!Task->DataQueued) {
+          Status = UsbUasQueueData (UsbUas, Tag);
+          if (EFI_ERROR (Status)) {
+            return EFI_DEVICE_ERROR;
+          }
+        }
+
+        Status = UsbUasQueueStatus (UsbUas, Tag);
+        if (EFI_ERROR (Status)) {
+          return EFI_DEVICE_ERROR;
+        }
+
+        return EFI_NOT_READY;
+
+      case USB_UAS_IU_SENSE:
+        Task->Completed = TRUE;
+
+        //
+        // A command which fails early has its data transfer left on the
+        // stream, which is aborted.
+        //
+        if (Task->DataXfer != NULL) {
+          Status = UsbUas->AsyncBulk->Poll (UsbUas->AsyncBulk, Task->DataXfer, &Length, &Result);
+          if (Status == EFI_NOT_READY) {
+            UsbUas->AsyncBulk->Cancel (UsbUas->AsyncBulk, Task->DataXfer);
+          }
+
+          if (Status != EFI_SUCCESS) {
+            Task->DataFailed = TRUE;
+          }
+
+          Task->DataXfer = NULL;
+          Pending        = (BOOLEAN)(Task->CommandXfer != NULL);
+        }
+
+        if ((StatusIu->u.Sense.Status == 0) && !Task->DataFailed) {
+          Task->Command->CmdStatus = USB_MASS_CMD_SUCCESS;
+        } else if (StatusIu->u.Sense.Status != 0) {
+          //
+          // Keep the sense data for the REQUEST SENSE command that follows,
+          // because the device has already reported it.
+          //
+          SenseLength = (UINT16)((StatusIu->u.Sense.SenseLength[0] << 8) | StatusIu->u.Sense.SenseLength[1]);
+          if (Length > OFFSET_OF (USB_UAS_STATUS_IU, u.Sense.SenseData)) {
+            SenseLength = (UINT16)MIN (SenseLength, Length - OFFSET_OF (USB_UAS_STATUS_IU, u.Sense.SenseData));
+          } else {
+            SenseLength = 0;
+          }
+
+          UsbUas->SenseLength = (UINT8)MIN (SenseLength, USB_UAS_MAX_SENSE_LEN);
+          CopyMem (UsbUas->SenseData, StatusIu->u.Sense.SenseData, UsbUas->SenseLength);
+        }
+
+        break;
+
+      default:
+        DEBUG ((DEBUG_ERROR, "UsbUasCheckTask: unexpected IU %x of tag %d\n", StatusIu->IuId, Tag));
+        return EFI_DEVICE_ERROR;
+    }
+  }
+
+  if (Pending || !Task->Completed) {
+    return EFI_NOT_READY;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Execute several commands through the USB UAS protocol, keeping up to
+  the queue depth of the device outstanding at a time.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Commands              The commands to execute
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are transported, and their results
+                                are in the CmdStatus of each command.
+  @retval Other                 Failed to transport some of the commands.
+
+**/
+EFI_STATUS
+UsbUasExecCommandList (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+  EFI_STATUS        Status;
+  UINTN             Next;
+  UINTN             Done;
+  UINTN             Index;
+  UINT16            Tag;
+  UINT32            Elapsed;
+  BOOLEAN           Progress;
+
+  UsbUas = (USB_UAS_PROTOCOL *)Context;
+
+  for (Index = 0; Index < Count; Index++) {
+    Commands[Index].CmdStatus = USB_MASS_CMD_FAIL;
+  }
+
+  UsbUas->SenseLength = 0;
+  Next                = 0;
+  Done                = 0;
+  Elapsed             = 0;
+
+  while (Done < Count) {
+    //
+    // Start the next commands on the free tags.
+    //
+    for (Tag = 1; (Tag <= UsbUas->QueueDepth) && (Next < Count); Tag++) {
+      if (UsbUas->Task[Tag - 1].Command == NULL) {
+        Status = UsbUasStartTask (UsbUas, Tag, &Commands[Next], Lun);
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "UsbUasExecCommandList: UsbUasStartTask (%r)\n", Status));
+          goto ON_ERROR;
+        }
+
+        Next++;
+      }
+    }
+
+    Progress = FALSE;
+    for (Tag = 1; Tag <= UsbUas->QueueDepth; Tag++) {
+      if (UsbUas->Task[Tag - 1].Command == NULL) {
+        continue;
+      }
+
+      Status = UsbUasCheckTask (UsbUas, Tag);
+      if (Status == EFI_NOT_READY) {
+        continue;
+      }
+
+      if (EFI_ERROR (Status)) {
+        goto ON_ERROR;
+      }
+
+      ZeroMem (&UsbUas->Task[Tag - 1], sizeof (USB_UAS_TASK));
+      Progress = TRUE;
+      Done++;
+    }
+
+    //
+    // The timeout applies to each command, so it restarts whenever
+    // a command is completed.
+    //
+    if (Progress) {
+      Elapsed = 0;
+    } else if (Elapsed >= Timeout) {
+      Status = EFI_TIMEOUT;
+      goto ON_ERROR;
+    } else {
+      gBS->Stall (USB_UAS_POLL_INTERVAL);
+      Elapsed += USB_UAS_POLL_INTERVAL;
+    }
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  for (Tag = 1; Tag <= UsbUas->QueueDepth; Tag++) {
+    if (UsbUas->Task[Tag - 1].Command != NULL) {
+      UsbUas->Task[Tag - 1].Command->CmdStatus = USB_MASS_CMD_FAIL;
+      UsbUasAbortTask (UsbUas, &UsbUas->Task[Tag - 1]);
+    }
+  }
+
+  UsbUasResetDevice (UsbUas, FALSE);
+  return Status;
+}
+
+/**
+  Execute one command through the USB UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+  USB_MASS_COMMAND  Command;
+  EFI_STATUS        Status;
+
+  UsbUas = (USB_UAS_PROTOCOL *)Context;
+
+  //
+  // The device has already returned the sense data of the last failed
+  // command in its Sense IU, so the REQUEST SENSE is answered here.
+  //
+  if ((*(UINT8 *)Cmd == EFI_SCSI_OP_REQUEST_SENSE) && (UsbUas->SenseLength != 0)) {
+    ZeroMem (Data, DataLen);
+    CopyMem (Data, UsbUas->SenseData, MIN (DataLen, UsbUas->SenseLength));
+    UsbUas->SenseLength = 0;
+    *CmdStatus          = USB_MASS_CMD_SUCCESS;
+    return EFI_SUCCESS;
+  }
+
+  Command.Cmd     = Cmd;
+  Command.CmdLen  = CmdLen;
+  Command.DataDir = DataDir;
+  Command.Data    = Data;
+  Command.DataLen = DataLen;
+
+  Status     = UsbUasExecCommandList (UsbUas, &Command, 1, Lun, Timeout);
+  *CmdStatus = Command.CmdStatus;
+
+  return Status;
+}
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue a LOGICAL UNIT RESET task management request.
+                                If TRUE, additionally reset parent hub port.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID     *Context,
+  IN  BOOLEAN  ExtendedVerification
+  )
+{
+  USB_UAS_PROTOCOL      *UsbUas;
+  USB_UAS_TASK_MGMT_IU  Iu;
+  USB_UAS_TASK          *Task;
+  EFI_STATUS            Status;
+  UINTN                 Length;
+  UINT32                Result;
+  UINT32                Elapsed;
+
+  UsbUas = (USB_UAS_PROTOCOL *)Context;
+
+  if (!ExtendedVerification) {
+    //
+    // Issue a LOGICAL UNIT RESET on the first tag, which is free
+    // because the commands are aborted before the reset.
+    //
+    ZeroMem (&Iu, sizeof (Iu));
+    Iu.IuId     = USB_UAS_IU_TASK_MGMT;
+    Iu.Tag[1]   = 1;
+    Iu.Function = USB_UAS_TMF_LOGICAL_UNIT_RST;
+
+    Task   = &UsbUas->Task[0];
+    Status = UsbUasQueueStatus (UsbUas, 1);
+    if (!EFI_ERROR (Status)) {
+      Status = UsbUas->AsyncBulk->Submit (
+                                    UsbUas->AsyncBulk,
+                                    UsbUas->CommandEndpoint,
+                                    0,
+                                    &Iu,
+                                    sizeof (Iu),
+                                    &Task->CommandXfer
+                                    );
+    }
+
+    Elapsed = 0;
+    while (!EFI_ERROR (Status) && (Task->StatusXfer != NULL) && (Elapsed < USB_UAS_RESET_DEVICE_TIMEOUT)) {
+      Status = UsbUas->AsyncBulk->Poll (UsbUas->AsyncBulk, Task->StatusXfer, &Length, &Result);
+      if (Status == EFI_NOT_READY) {
+        gBS->Stall (USB_UAS_POLL_INTERVAL);
+        Elapsed += USB_UAS_POLL_INTERVAL;
+        Status   = EFI_SUCCESS;
+        continue;
+      }
+
+      Task->StatusXfer = NULL;
+      if (!EFI_ERROR (Status) &&
+          ((UsbUas->StatusIu[0].IuId != USB_UAS_IU_RESPONSE) ||
+           ((UsbUas->StatusIu[0].u.Response.ResponseCode != USB_UAS_RESPONSE_COMPLETE) &&
+            (UsbUas->StatusIu[0].u.Response.ResponseCode != USB_UAS_RESPONSE_SUCCEEDED))))
+      {
+        Status = EFI_DEVICE_ERROR;
+      }
+    }
+
+    if (!EFI_ERROR (Status) && (Task->StatusXfer != NULL)) {
+      Status = EFI_TIMEOUT;
+    }
+
+    UsbUasAbortTask (UsbUas, Task);
+    UsbUas->SenseLength = 0;
+
+    if (!EFI_ERROR (Status)) {
+      return EFI_SUCCESS;
+    }
+
+    DEBUG ((DEBUG_ERROR, "UsbUasResetDevice: LOGICAL UNIT RESET (%r)\n", Status));
+  }
+
+  //
+  // Reset the parent hub port. The device comes back in its default
+  // setting, so the UAS setting and the streams are selected again.
+  //
+  Status = UsbUas->UsbIo->UsbPortReset (UsbUas->UsbIo);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = UsbUasSelectSetting (UsbUas);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+  Only the first logical unit is supported over UAS.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN.
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID   *Context,
+  OUT UINT8  *MaxLun
+  )
+{
+  *MaxLun = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+  Clean up the resource used by this UAS protocol, and switch the
+  interface back to its BOT alternate setting.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID  *Context
+  )
+{
+  USB_UAS_PROTOCOL  *UsbUas;
+
+  UsbUas = (USB_UAS_PROTOCOL *)Context;
+
+  UsbUasSetInterface (UsbUas, USB_UAS_BOT_SETTING);
+  FreePool (UsbUas);
+  return EFI_SUCCESS;
+}
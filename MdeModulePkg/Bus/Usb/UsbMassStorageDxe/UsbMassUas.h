@@ -0,0 +1,276 @@
+/** @file
+  Definition for the USB Attached SCSI transport protocol, based on
+  "Universal Serial Bus Mass Storage Class - USB Attached SCSI Protocol (UASP)"
+  Revision 1.0, June 24, 2009.
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _EFI_USBMASS_UAS_H_
+#define _EFI_USBMASS_UAS_H_
+
+extern USB_MASS_TRANSPORT  mUsbUasTransport;
+
+#define USB_MASS_STORE_UAS  0x62        ///< USB Attached SCSI
+
+//
+// Class specific descriptors of the UAS interface
+//
+#define USB_UAS_DESC_TYPE_PIPE_USAGE       0x24 ///< Pipe Usage descriptor
+#define USB_UAS_DESC_TYPE_SS_EP_COMPANION  0x30 ///< SuperSpeed Endpoint Companion descriptor
+#define USB_UAS_SS_EP_COMPANION_STREAMS    0x1F ///< bmAttributes bits 0~4, log2 of the max streams
+#define USB_UAS_PIPE_ID_COMMAND            0x01
+#define USB_UAS_PIPE_ID_STATUS             0x02
+#define USB_UAS_PIPE_ID_DATA_IN            0x03
+#define USB_UAS_PIPE_ID_DATA_OUT           0x04
+
+//
+// Information Unit IDs
+//
+#define USB_UAS_IU_COMMAND      0x01
+#define USB_UAS_IU_SENSE        0x03
+#define USB_UAS_IU_RESPONSE     0x04
+#define USB_UAS_IU_TASK_MGMT    0x05
+#define USB_UAS_IU_READ_READY   0x06
+#define USB_UAS_IU_WRITE_READY  0x07
+
+#define USB_UAS_TASK_ATTR_SIMPLE      0x00
+#define USB_UAS_TMF_LOGICAL_UNIT_RST  0x08
+#define USB_UAS_RESPONSE_COMPLETE     0x00
+#define USB_UAS_RESPONSE_SUCCEEDED    0x08
+#define USB_UAS_MAX_CMDLEN            16
+#define USB_UAS_MAX_SENSE_LEN         18
+
+//
+// The number of commands kept outstanding on the device. The command tags
+// run from 1 to the queue depth, and are also the stream IDs on SuperSpeed.
+//
+#define USB_UAS_MAX_QUEUE_DEPTH  8
+
+//
+// The alternate setting of a UAS capable interface that carries BOT, which
+// the interface is switched back to when UAS is not used.
+//
+#define USB_UAS_BOT_SETTING  0
+
+//
+// Usb UAS transport timeout and poll interval, set by experience
+//
+#define USB_UAS_RESET_DEVICE_TIMEOUT  (3 * USB_MASS_1_SECOND)
+#define USB_UAS_POLL_INTERVAL         10
+
+#pragma pack(1)
+///
+/// The Command IU, with a CDB of up to 16 bytes.
+///
+typedef struct {
+  UINT8    IuId;
+  UINT8    Reserved0;
+  UINT8    Tag[2];              ///< Big endian
+  UINT8    TaskAttribute;       ///< Bits 0~2 are the task attribute
+  UINT8    Reserved1;
+  UINT8    AddCdbLen;           ///< Bits 2~7, length of the CDB beyond 16 bytes in dwords
+  UINT8    Reserved2;
+  UINT8    Lun[8];
+  UINT8    Cdb[USB_UAS_MAX_CMDLEN];
+} USB_UAS_COMMAND_IU;
+
+///
+/// The Task Management IU.
+///
+typedef struct {
+  UINT8    IuId;
+  UINT8    Reserved0;
+  UINT8    Tag[2];
+  UINT8    Function;
+  UINT8    Reserved1;
+  UINT8    TaskTag[2];
+  UINT8    Lun[8];
+} USB_UAS_TASK_MGMT_IU;
+
+///
+/// The IUs received on the status pipe. The Sense IU is the longest one.
+///
+typedef struct {
+  UINT8    IuId;
+  UINT8    Reserved0;
+  UINT8    Tag[2];
+  union {
+    struct {
+      UINT8    StatusQualifier[2];
+      UINT8    Status;
+      UINT8    Reserved1[7];
+      UINT8    SenseLength[2];
+      UINT8    SenseData[USB_UAS_MAX_SENSE_LEN];
+    } Sense;
+    struct {
+      UINT8    AdditionalInfo[3];
+      UINT8    ResponseCode;
+    } Response;
+  } u;
+} USB_UAS_STATUS_IU;
+#pragma pack()
+
+///
+/// The state of one outstanding command, the tag of which is its index plus one.
+///
+typedef struct {
+  USB_MASS_COMMAND    *Command;     ///< NULL if the tag is free
+  VOID                *CommandXfer; ///< Token of the Command IU transfer
+  VOID                *DataXfer;    ///< Token of the data transfer
+  VOID                *StatusXfer;  ///< Token of the status IU transfer
+  BOOLEAN             DataQueued;
+  BOOLEAN             DataFailed;
+  BOOLEAN             Completed;    ///< The Sense IU is received
+} USB_UAS_TASK;
+
+typedef struct {
+  //
+  // Put Interface at the first field to make it easy to distinguish BOT/CBI/UAS Protocol instance
+  //
+  EFI_USB_INTERFACE_DESCRIPTOR        Interface;   ///< The UAS alternate setting
+  EFI_USB_IO_PROTOCOL                 *UsbIo;
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL    *AsyncBulk;
+  UINT8                               CommandEndpoint;
+  UINT8                               StatusEndpoint;
+  UINT8                               DataInEndpoint;
+  UINT8                               DataOutEndpoint;
+  UINT16                              MaxStreams;  ///< Streams of the bulk endpoints, 0 if not SuperSpeed
+  UINT16                              QueueDepth;
+  UINT8                               SenseLength; ///< Length of the sense data saved from the last Sense IU
+  UINT8                               SenseData[USB_UAS_MAX_SENSE_LEN];
+  USB_UAS_TASK                        Task[USB_UAS_MAX_QUEUE_DEPTH];
+  USB_UAS_COMMAND_IU                  CommandIu[USB_UAS_MAX_QUEUE_DEPTH];
+  USB_UAS_STATUS_IU                   StatusIu[USB_UAS_MAX_QUEUE_DEPTH];
+} USB_UAS_PROTOCOL;
+
+/**
+  Initializes USB UAS protocol.
+
+  This function selects the UAS alternate setting of the mass storage
+  interface, and enables the streams of its bulk endpoints on SuperSpeed.
+  It will save its context which is a USB_UAS_PROTOCOL structure
+  in the Context if Context isn't NULL. If Context is NULL, the device
+  is only checked and left untouched.
+
+  @param  UsbIo                 The USB I/O Protocol instance
+  @param  Context               The buffer to save the context to
+
+  @retval EFI_SUCCESS           The device is successfully initialized.
+  @retval EFI_UNSUPPORTED       The device or its host controller doesn't support UAS.
+  @retval Other                 The USB UAS initialization fails.
+
+**/
+EFI_STATUS
+UsbUasInit (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  OUT VOID                 **Context OPTIONAL
+  );
+
+/**
+  Execute one command through the USB UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Cmd                   The high level command
+  @param  CmdLen                The command length
+  @param  DataDir               The direction of the data transfer
+  @param  Data                  The buffer to hold data
+  @param  DataLen               The length of the data
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait command
+  @param  CmdStatus             The result of high level command execution
+
+  @retval EFI_SUCCESS           The command is executed successfully.
+  @retval Other                 Failed to execute command
+
+**/
+EFI_STATUS
+UsbUasExecCommand (
+  IN  VOID                    *Context,
+  IN  VOID                    *Cmd,
+  IN  UINT8                   CmdLen,
+  IN  EFI_USB_DATA_DIRECTION  DataDir,
+  IN  VOID                    *Data,
+  IN  UINT32                  DataLen,
+  IN  UINT8                   Lun,
+  IN  UINT32                  Timeout,
+  OUT UINT32                  *CmdStatus
+  );
+
+/**
+  Execute several commands through the USB UAS protocol, keeping up to
+  the queue depth of the device outstanding at a time.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL
+  @param  Commands              The commands to execute
+  @param  Count                 The number of commands
+  @param  Lun                   The number of logic unit
+  @param  Timeout               The time to wait each command
+
+  @retval EFI_SUCCESS           All the commands are transported, and their results
+                                are in the CmdStatus of each command.
+  @retval Other                 Failed to transport some of the commands.
+
+**/
+EFI_STATUS
+UsbUasExecCommandList (
+  IN     VOID              *Context,
+  IN OUT USB_MASS_COMMAND  *Commands,
+  IN     UINTN             Count,
+  IN     UINT8             Lun,
+  IN     UINT32            Timeout
+  );
+
+/**
+  Reset the USB mass storage device by UAS protocol.
+
+  @param  Context               The context of the UAS protocol, that is,
+                                USB_UAS_PROTOCOL.
+  @param  ExtendedVerification  If FALSE, just issue a LOGICAL UNIT RESET task management request.
+                                If TRUE, additionally reset parent hub port.
+
+  @retval EFI_SUCCESS           The device is reset.
+  @retval Others                Failed to reset the device.
+
+**/
+EFI_STATUS
+UsbUasResetDevice (
+  IN  VOID     *Context,
+  IN  BOOLEAN  ExtendedVerification
+  );
+
+/**
+  Get the max LUN (Logical Unit Number) of USB mass storage device.
+  Only the first logical unit is supported over UAS.
+
+  @param  Context          The context of the UAS protocol, that is, USB_UAS_PROTOCOL
+  @param  MaxLun           Return pointer to the max number of LUN.
+
+  @retval EFI_SUCCESS      Max LUN is got successfully.
+
+**/
+EFI_STATUS
+UsbUasGetMaxLun (
+  IN  VOID   *Context,
+  OUT UINT8  *MaxLun
+  );
+
+/**
+  Clean up the resource used by this UAS protocol, and switch the
+  interface back to its default alternate setting.
+
+  @param  Context         The context of the UAS protocol, that is, USB_UAS_PROTOCOL.
+
+  @retval EFI_SUCCESS     The resource is cleaned up.
+
+**/
+EFI_STATUS
+UsbUasCleanUp (
+  IN  VOID  *Context
+  );
+
+#endif
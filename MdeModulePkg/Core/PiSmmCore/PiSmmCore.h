@@ -53,6 +53,7 @@
 #include <Library/SmmCorePlatformHookLib.h>
 #include <Library/PerformanceLib.h>
 #include <Library/HobLib.h>
+#include <Library/TimerLib.h>
 #include <Library/SmmMemLib.h>
 
 #include "PiSmmCorePrivateData.h"
@@ -74,12 +75,18 @@ typedef struct {
 
 #define SMI_ENTRY_SIGNATURE  SIGNATURE_32('s','m','i','e')
 
+//
+// The number of buckets of the SMI entry hash table, must be a power of 2.
+//
+#define SMI_ENTRY_HASH_BUCKET_COUNT  32
+
 typedef struct {
   UINTN         Signature;
   LIST_ENTRY    AllEntries; // All entries
 
   EFI_GUID      HandlerType; // Type of interrupt
   LIST_ENTRY    SmiHandlers; // All handlers
+  LIST_ENTRY    HashLink;    // Link on the bucket of HandlerType in mSmiEntryHash
 } SMI_ENTRY;
 
 #define SMI_HANDLER_SIGNATURE  SIGNATURE_32('s','m','i','h')
@@ -92,6 +99,9 @@ typedef struct {
   SMI_ENTRY                       *SmiEntry;
   VOID                            *Context;    // for profile
   UINTN                           ContextSize; // for profile
+  UINT64                          DispatchCount; // for profile
+  UINT64                          TotalTicks;    // for profile, performance counter ticks spent in Handler
+  UINT64                          MaxTicks;      // for profile
 } SMI_HANDLER;
 
 //
@@ -1148,6 +1158,16 @@ SmmCoreInitializeSmiHandlerProfile (
   VOID
   );
 
+/**
+  Enable recording the dispatch count and time of each SMI handler for the
+  SMI handler profile.
+
+**/
+VOID
+SmmCoreEnableSmiHandlerDispatchProfile (
+  VOID
+  );
+
 /**
   This function is called by SmmChildDispatcher module to report
   a new SMI handler is registered, to SmmCore.
@@ -15,8 +15,67 @@ SMI_ENTRY  mRootSmiEntry = {
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.AllEntries),
   { 0 },
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.SmiHandlers),
+  INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.HashLink),
 };
 
+//
+// The non-root SMI entries hashed by their handler type, so that SmiManage()
+// finds the entry without walking all of them.
+//
+LIST_ENTRY  mSmiEntryHash[SMI_ENTRY_HASH_BUCKET_COUNT];
+BOOLEAN     mSmiEntryHashInitialized = FALSE;
+
+//
+// The entry found by the last lookup. Most of the GUID-specific SMIs come
+// through the SMM Communication buffer of the same handler, e.g. the
+// variable service, so this saves hashing and comparing against the others.
+//
+SMI_ENTRY  *mLastSmiEntry = NULL;
+
+//
+// Whether to record the dispatch count and time of each handler for the SMI
+// handler profile, and the properties of the performance counter to time them.
+// They are set by SmmCoreEnableSmiHandlerDispatchProfile().
+//
+BOOLEAN      mSmiHandlerDispatchProfileEnabled = FALSE;
+UINT64       mSmiPerformanceCounterStart       = 0;
+UINT64       mSmiPerformanceCounterEnd         = 0;
+SMI_HANDLER  *mDispatchingSmiHandler           = NULL;
+
+/**
+  Get the bucket of the SMI entry hash table for the handler type.
+
+  @param  HandlerType            The type of the interrupt
+
+  @return The list head of the bucket.
+
+**/
+LIST_ENTRY *
+GetSmiEntryHashBucket (
+  IN CONST EFI_GUID  *HandlerType
+  )
+{
+  UINT32  Hash;
+  UINTN   Index;
+
+  if (!mSmiEntryHashInitialized) {
+    for (Index = 0; Index < SMI_ENTRY_HASH_BUCKET_COUNT; Index++) {
+      InitializeListHead (&mSmiEntryHash[Index]);
+    }
+
+    mSmiEntryHashInitialized = TRUE;
+  }
+
+  Hash = ReadUnaligned32 ((CONST UINT32 *)HandlerType) ^
+         ReadUnaligned32 ((CONST UINT32 *)HandlerType + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)HandlerType + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)HandlerType + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return &mSmiEntryHash[Hash & (SMI_ENTRY_HASH_BUCKET_COUNT - 1)];
+}
+
 /**
   Finds the SMI entry for the requested handler type.
 
@@ -33,19 +92,25 @@ SmmCoreFindSmiEntry (
   IN BOOLEAN   Create
   )
 {
+  LIST_ENTRY  *Bucket;
   LIST_ENTRY  *Link;
   SMI_ENTRY   *Item;
   SMI_ENTRY   *SmiEntry;
 
+  if ((mLastSmiEntry != NULL) && CompareGuid (&mLastSmiEntry->HandlerType, HandlerType)) {
+    return mLastSmiEntry;
+  }
+
   //
-  // Search the SMI entry list for the matching GUID
+  // Search the bucket of the SMI entry hash table for the matching GUID
   //
   SmiEntry = NULL;
-  for (Link = mSmiEntryList.ForwardLink;
-       Link != &mSmiEntryList;
+  Bucket   = GetSmiEntryHashBucket (HandlerType);
+  for (Link = Bucket->ForwardLink;
+       Link != Bucket;
        Link = Link->ForwardLink)
   {
-    Item = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+    Item = CR (Link, SMI_ENTRY, HashLink, SMI_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->HandlerType, HandlerType)) {
       //
       // This is the SMI entry
@@ -70,15 +135,134 @@ SmmCoreFindSmiEntry (
       InitializeListHead (&SmiEntry->SmiHandlers);
 
       //
-      // Add it to SMI entry list
+      // Add it to SMI entry list and hash table
       //
       InsertTailList (&mSmiEntryList, &SmiEntry->AllEntries);
+      InsertTailList (Bucket, &SmiEntry->HashLink);
     }
   }
 
+  if (SmiEntry != NULL) {
+    mLastSmiEntry = SmiEntry;
+  }
+
   return SmiEntry;
 }
 
+/**
+  Enable recording the dispatch count and time of each SMI handler for the
+  SMI handler profile.
+
+**/
+VOID
+SmmCoreEnableSmiHandlerDispatchProfile (
+  VOID
+  )
+{
+  GetPerformanceCounterProperties (&mSmiPerformanceCounterStart, &mSmiPerformanceCounterEnd);
+  mSmiHandlerDispatchProfileEnabled = TRUE;
+}
+
+/**
+  Get the performance counter ticks elapsed between two counter values,
+  taking the counter wrapping around into account.
+
+  @param  Begin                  The counter value at the beginning.
+  @param  End                    The counter value at the end.
+
+  @return The ticks elapsed.
+
+**/
+UINT64
+GetSmiHandlerElapsedTicks (
+  IN UINT64  Begin,
+  IN UINT64  End
+  )
+{
+  if (mSmiPerformanceCounterStart < mSmiPerformanceCounterEnd) {
+    //
+    // The counter counts up
+    //
+    if (End >= Begin) {
+      return End - Begin;
+    }
+
+    return (mSmiPerformanceCounterEnd - Begin) + (End - mSmiPerformanceCounterStart);
+  }
+
+  //
+  // The counter counts down
+  //
+  if (Begin >= End) {
+    return Begin - End;
+  }
+
+  return (Begin - mSmiPerformanceCounterEnd) + (mSmiPerformanceCounterStart - End);
+}
+
+/**
+  Call an SMI handler, and record its dispatch count and time for the SMI
+  handler profile if it is enabled.
+
+  @param  SmiHandler     The SMI handler to call.
+  @param  Context        Points to an optional context buffer.
+  @param  CommBuffer     Points to the optional communication buffer.
+  @param  CommBufferSize Points to the size of the optional communication buffer.
+
+  @return The status returned by the SMI handler.
+
+**/
+EFI_STATUS
+DispatchSmiHandler (
+  IN     SMI_HANDLER  *SmiHandler,
+  IN     CONST VOID   *Context         OPTIONAL,
+  IN OUT VOID         *CommBuffer      OPTIONAL,
+  IN OUT UINTN        *CommBufferSize  OPTIONAL
+  )
+{
+  EFI_STATUS   Status;
+  SMI_HANDLER  *PreviousSmiHandler;
+  UINT64       Begin;
+  UINT64       Ticks;
+
+  if (!mSmiHandlerDispatchProfileEnabled) {
+    return SmiHandler->Handler (
+                         (EFI_HANDLE)SmiHandler,
+                         Context,
+                         CommBuffer,
+                         CommBufferSize
+                         );
+  }
+
+  //
+  // The handler may unregister itself, in which case mDispatchingSmiHandler
+  // is cleared and the freed handler must not be touched afterwards.
+  //
+  PreviousSmiHandler     = mDispatchingSmiHandler;
+  mDispatchingSmiHandler = SmiHandler;
+
+  Begin  = GetPerformanceCounter ();
+  Status = SmiHandler->Handler (
+                         (EFI_HANDLE)SmiHandler,
+                         Context,
+                         CommBuffer,
+                         CommBufferSize
+                         );
+  Ticks = GetSmiHandlerElapsedTicks (Begin, GetPerformanceCounter ());
+
+  if (mDispatchingSmiHandler == SmiHandler) {
+    SmiHandler->DispatchCount++;
+    SmiHandler->TotalTicks += Ticks;
+    if (Ticks > SmiHandler->MaxTicks) {
+      SmiHandler->MaxTicks = Ticks;
+    }
+  }
+
+  mDispatchingSmiHandler = PreviousSmiHandler;
+
+  return Status;
+}
+
 /**
   Manage SMI of a particular type.
 
@@ -134,12 +318,7 @@ SmiManage (
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
 
-    Status = SmiHandler->Handler (
-                           (EFI_HANDLE)SmiHandler,
-                           Context,
-                           CommBuffer,
-                           CommBufferSize
-                           );
+    Status = DispatchSmiHandler (SmiHandler, Context, CommBuffer, CommBufferSize);
 
     switch (Status) {
       case EFI_INTERRUPT_PENDING:
@@ -318,10 +497,14 @@ SmiHandlerUnRegister (
 
   SmiEntry = SmiHandler->SmiEntry;
 
+  if (mDispatchingSmiHandler == SmiHandler) {
+    mDispatchingSmiHandler = NULL;
+  }
+
   RemoveEntryList (&SmiHandler->Link);
   FreePool (SmiHandler);
 
-  if (SmiEntry == NULL) {
+  if ((SmiEntry == NULL) || (SmiEntry == &mRootSmiEntry)) {
     //
     // This is root SMI handler
     //
@@ -333,6 +516,10 @@ SmiHandlerUnRegister (
     // No handler registered for this interrupt now, remove the SMI_ENTRY
     //
     RemoveEntryList (&SmiEntry->AllEntries);
+    RemoveEntryList (&SmiEntry->HashLink);
+    if (mLastSmiEntry == SmiEntry) {
+      mLastSmiEntry = NULL;
+    }
 
     FreePool (SmiEntry);
   }
@@ -737,6 +737,9 @@ GetSmmSmiHandlerDataOnSmiEntry (
     SmiHandlerStruct->Handler           = (UINTN)SmiHandler->Handler;
     SmiHandlerStruct->ImageRef          = AddressToImageRef ((UINTN)SmiHandler->Handler);
     SmiHandlerStruct->ContextBufferSize = (UINT32)SmiHandler->ContextSize;
+    SmiHandlerStruct->DispatchCount     = SmiHandler->DispatchCount;
+    SmiHandlerStruct->TotalTime         = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+    SmiHandlerStruct->MaxTime           = GetTimeInNanoSecond (SmiHandler->MaxTicks);
     if (SmiHandler->ContextSize != 0) {
       SmiHandlerStruct->ContextBufferOffset = sizeof (SMM_CORE_SMI_HANDLER_STRUCTURE);
       CopyMem ((UINT8 *)SmiHandlerStruct + SmiHandlerStruct->ContextBufferOffset, SmiHandler->Context, SmiHandler->ContextSize);
@@ -928,10 +931,27 @@ SmiHandlerProfileHandlerGetInfo (
   )
 {
   BOOLEAN  SmiHandlerProfileRecordingStatus;
+  VOID     *Database;
+  UINTN    DatabaseSize;
 
   SmiHandlerProfileRecordingStatus  = mSmiHandlerProfileRecordingStatus;
   mSmiHandlerProfileRecordingStatus = FALSE;
 
+  //
+  // Rebuild the database to carry the dispatch statistics collected so far.
+  // The data is then read by offset from this snapshot. Keep the previous
+  // database if the new one cannot be built.
+  //
+  Database     = mSmiHandlerProfileDatabase;
+  DatabaseSize = mSmiHandlerProfileDatabaseSize;
+  BuildSmiHandlerProfileDatabase ();
+  if (mSmiHandlerProfileDatabase == NULL) {
+    mSmiHandlerProfileDatabase     = Database;
+    mSmiHandlerProfileDatabaseSize = DatabaseSize;
+  } else {
+    FreePool (Database);
+  }
+
   SmiHandlerProfileParameterGetInfo->DataSize            = mSmiHandlerProfileDatabaseSize;
   SmiHandlerProfileParameterGetInfo->Header.ReturnStatus = 0;
 
@@ -1400,6 +1420,8 @@ SmmCoreInitializeSmiHandlerProfile (
   if ((PcdGet8 (PcdSmiHandlerProfilePropertyMask) & 0x1) != 0) {
     InsertTailList (&mRootSmiEntryList, &mRootSmiEntry.AllEntries);
 
+    SmmCoreEnableSmiHandlerDispatchProfile ();
+
     Status = gSmst->SmmRegisterProtocolNotify (
                       &gEfiSmmReadyToLockProtocolGuid,
                       SmmReadyToLockInSmiHandlerProfile,
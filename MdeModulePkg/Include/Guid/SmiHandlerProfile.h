@@ -42,7 +42,7 @@ typedef struct {
 } SMM_CORE_IMAGE_DATABASE_STRUCTURE;
 
 #define SMM_CORE_SMI_DATABASE_SIGNATURE  SIGNATURE_32 ('S','C','S','D')
-#define SMM_CORE_SMI_DATABASE_REVISION   0x0001
+#define SMM_CORE_SMI_DATABASE_REVISION   0x0002
 
 typedef enum {
   SmmCoreSmiHandlerCategoryRootHandler,
@@ -85,6 +85,13 @@ typedef struct {
   UINT16              ContextBufferOffset;
   UINT8               Reserved[2];
   UINT32              ContextBufferSize;
+  //
+  // The fields below are added in revision 0x0002. They are zero for the
+  // hardware handlers, which are dispatched by the SMM child dispatchers.
+  //
+  UINT64              DispatchCount; // The number of times the handler is called
+  UINT64              TotalTime;     // The time spent in the handler, in nanoseconds
+  UINT64              MaxTime;       // The longest time spent in one call, in nanoseconds
   // UINT8                 ContextBuffer[];
 } SMM_CORE_SMI_HANDLER_STRUCTURE;
 
@@ -0,0 +1,80 @@
+/** @file
+  Block Cache protocol is produced by the Disk I/O driver on the handle of a
+  physical block device whose blocks it caches.
+
+  The cache is write-through, so the data written through Disk I/O or the
+  partitions above it is always on the device. The agents that write to the
+  device through Block I/O directly must call Invalidate() afterwards, so that
+  the following reads do not return the data cached before.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __BLOCK_CACHE_H__
+#define __BLOCK_CACHE_H__
+
+#define EDKII_BLOCK_CACHE_PROTOCOL_GUID \
+  { \
+    0x8d5ee4c2, 0x5d39, 0x4b4f, { 0xa6, 0x3e, 0x5e, 0x0f, 0x9a, 0x7b, 0x31, 0xc4 } \
+  }
+
+#define EDKII_BLOCK_CACHE_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_BLOCK_CACHE_PROTOCOL EDKII_BLOCK_CACHE_PROTOCOL;
+
+///
+/// Statistics of the block cache. The blocks are cached in lines of LineSize
+/// bytes, and the counters are in lines.
+///
+typedef struct {
+  UINT64    CacheSize;        ///< The size of the cache in bytes
+  UINT32    LineSize;         ///< The size of a cache line in bytes
+  UINT64    Hits;             ///< Lines found in the cache, not counting ReadAheadHits
+  UINT64    Misses;           ///< Lines read from the device on request
+  UINT64    ReadAheads;       ///< Lines read from the device ahead of request
+  UINT64    ReadAheadHits;    ///< Lines read ahead, and requested later for the first time
+  UINT64    Evictions;        ///< Lines dropped to make room for others
+} EDKII_BLOCK_CACHE_STATISTICS;
+
+/**
+  Drop all the blocks in the cache.
+
+  @param[in]  This              Pointer to the EDKII_BLOCK_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The cache is invalidated.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_BLOCK_CACHE_INVALIDATE)(
+  IN EDKII_BLOCK_CACHE_PROTOCOL  *This
+  );
+
+/**
+  Get the statistics of the cache.
+
+  @param[in]  This              Pointer to the EDKII_BLOCK_CACHE_PROTOCOL instance.
+  @param[out] Statistics        The statistics of the cache.
+
+  @retval EFI_SUCCESS           The statistics are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_BLOCK_CACHE_GET_STATISTICS)(
+  IN  EDKII_BLOCK_CACHE_PROTOCOL    *This,
+  OUT EDKII_BLOCK_CACHE_STATISTICS  *Statistics
+  );
+
+struct _EDKII_BLOCK_CACHE_PROTOCOL {
+  UINT32                              Revision;
+  EDKII_BLOCK_CACHE_INVALIDATE        Invalidate;
+  EDKII_BLOCK_CACHE_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiBlockCacheProtocolGuid;
+
+#endif
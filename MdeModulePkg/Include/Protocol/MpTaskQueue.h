@@ -0,0 +1,112 @@
+/** @file
+  MP Task Queue protocol is produced by the CPU driver and runs many small
+  tasks on all the enabled processors.
+
+  EFI_MP_SERVICES_PROTOCOL runs one procedure per processor and wakes up the
+  APs for each call. With this protocol the caller posts a number of tasks
+  of the same procedure, e.g. one per chunk of a buffer to hash or to clear.
+  The APs are woken up once, and every processor, including the BSP, takes
+  the next task until all of them are done. The tasks are spread over the
+  processors in contiguous shares, and a processor that finishes its share
+  takes the remaining tasks of the others.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __MP_TASK_QUEUE_H__
+#define __MP_TASK_QUEUE_H__
+
+#define EDKII_MP_TASK_QUEUE_PROTOCOL_GUID \
+  { \
+    0xcc686d8b, 0xb493, 0x4c4f, { 0x90, 0x42, 0x64, 0xba, 0xcb, 0x61, 0xdc, 0x1d } \
+  }
+
+#define EDKII_MP_TASK_QUEUE_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_MP_TASK_QUEUE_PROTOCOL EDKII_MP_TASK_QUEUE_PROTOCOL;
+
+/**
+  The procedure of a task. It may run on any processor, in parallel with the
+  other tasks, so it must not call the services that are only available to
+  the BSP.
+
+  @param[in]  TaskIndex         The index of the task, from 0 to the number of tasks minus 1.
+  @param[in]  Context           The context passed to RunTasks().
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_MP_TASK_PROCEDURE)(
+  IN UINTN  TaskIndex,
+  IN VOID   *Context
+  );
+
+///
+/// The utilization of a processor by the tasks, accumulated over all the
+/// calls of RunTasks().
+///
+typedef struct {
+  UINT64    TaskCount;        ///< The number of tasks run by the processor
+  UINT64    StolenTaskCount;  ///< The tasks taken from the share of other processors
+  UINT64    BusyTime;         ///< The time spent in the tasks, in nanoseconds
+  UINT64    TotalTime;        ///< The time spent in RunTasks(), in nanoseconds
+} EDKII_MP_TASK_STATISTICS;
+
+/**
+  Run the tasks on all the enabled processors and wait for them to finish.
+
+  This service may only be called from the BSP, and fails if any enabled AP
+  is busy with a procedure of EFI_MP_SERVICES_PROTOCOL.
+
+  @param[in]  This              Pointer to the EDKII_MP_TASK_QUEUE_PROTOCOL instance.
+  @param[in]  Procedure         The procedure of the tasks.
+  @param[in]  TaskCount         The number of tasks.
+  @param[in]  Context           The context passed to each task.
+
+  @retval EFI_SUCCESS           All the tasks are done.
+  @retval EFI_INVALID_PARAMETER Procedure is NULL, or TaskCount is 0 or greater than MAX_UINT32.
+  @retval EFI_DEVICE_ERROR      The caller is an AP.
+  @retval EFI_NOT_READY         Some enabled APs are busy.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_QUEUE_RUN_TASKS)(
+  IN EDKII_MP_TASK_QUEUE_PROTOCOL  *This,
+  IN EDKII_MP_TASK_PROCEDURE       Procedure,
+  IN UINTN                         TaskCount,
+  IN VOID                          *Context OPTIONAL
+  );
+
+/**
+  Get the utilization of a processor by the tasks.
+
+  @param[in]  This              Pointer to the EDKII_MP_TASK_QUEUE_PROTOCOL instance.
+  @param[in]  ProcessorNumber   The handle number of the processor, as used by
+                                EFI_MP_SERVICES_PROTOCOL.
+  @param[out] Statistics        The utilization of the processor.
+
+  @retval EFI_SUCCESS           The statistics are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+  @retval EFI_NOT_FOUND         The processor does not exist.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_QUEUE_GET_STATISTICS)(
+  IN  EDKII_MP_TASK_QUEUE_PROTOCOL  *This,
+  IN  UINTN                         ProcessorNumber,
+  OUT EDKII_MP_TASK_STATISTICS      *Statistics
+  );
+
+struct _EDKII_MP_TASK_QUEUE_PROTOCOL {
+  UINT32                                Revision;
+  EDKII_MP_TASK_QUEUE_RUN_TASKS         RunTasks;
+  EDKII_MP_TASK_QUEUE_GET_STATISTICS    GetStatistics;
+};
+
+extern EFI_GUID  gEdkiiMpTaskQueueProtocolGuid;
+
+#endif
@@ -0,0 +1,159 @@
+/** @file
+  USB Async Bulk protocol is produced by a USB host controller driver and lets
+  the USB bus driver keep several bulk transfers outstanding on a device.
+
+  EFI_USB_IO_PROTOCOL.UsbBulkTransfer() queues one transfer and waits for it
+  to complete. With this protocol the caller submits transfers, which the host
+  controller executes in the background, and polls them for completion. On a
+  host controller that supports bulk streams, the transfers can also be spread
+  over the streams of a SuperSpeed bulk endpoint, as required by the USB
+  Attached SCSI protocol.
+
+  The device is identified by the part of its device path that follows the
+  device path of the host controller. The USB bus driver consumes this
+  protocol and exposes it to the driver of each USB interface through
+  EDKII_USB_IO_ASYNC_BULK_PROTOCOL, so class drivers do not use it directly.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __USB_ASYNC_BULK_H__
+#define __USB_ASYNC_BULK_H__
+
+#include <Protocol/DevicePath.h>
+
+#define EDKII_USB_ASYNC_BULK_PROTOCOL_GUID \
+  { \
+    0x4b32c66d, 0x631d, 0x4645, { 0x90, 0xd8, 0x1c, 0xb0, 0x3e, 0x3c, 0x2d, 0x3d } \
+  }
+
+#define EDKII_USB_ASYNC_BULK_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_USB_ASYNC_BULK_PROTOCOL EDKII_USB_ASYNC_BULK_PROTOCOL;
+
+/**
+  Enable the streams of a SuperSpeed bulk endpoint.
+
+  Once the streams are enabled, every transfer submitted to the endpoint must
+  specify a stream. The streams stay enabled until the endpoint is configured
+  again, e.g. by a SET_CONFIGURATION or SET_INTERFACE request.
+
+  @param[in]      This              Pointer to the EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param[in]      DevicePath        The device path of the device, relative to the host controller.
+  @param[in]      EndpointAddress   The address of the bulk endpoint, with the direction in bit 7.
+  @param[in, out] StreamNumber      On input, the number of streams requested. On output, the
+                                    number of streams enabled. The streams are numbered from 1.
+
+  @retval EFI_SUCCESS               The streams are enabled.
+  @retval EFI_INVALID_PARAMETER     The endpoint is not a bulk endpoint of the device, or
+                                    StreamNumber is less than 2.
+  @retval EFI_NOT_FOUND             The device is not attached to the host controller.
+  @retval EFI_UNSUPPORTED           The host controller does not support streams.
+  @retval EFI_OUT_OF_RESOURCES      The stream rings could not be allocated.
+  @retval EFI_DEVICE_ERROR          The host controller failed to configure the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_ASYNC_BULK_ENABLE_STREAMS)(
+  IN     EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN     EFI_DEVICE_PATH_PROTOCOL       *DevicePath,
+  IN     UINT8                          EndpointAddress,
+  IN OUT UINT16                         *StreamNumber
+  );
+
+/**
+  Submit a bulk transfer and return without waiting for its completion.
+
+  The transfers submitted to the same endpoint and stream are executed in
+  order. The data buffer must not be accessed by the caller until the transfer
+  is completed by Poll() or aborted by Cancel().
+
+  @param[in]  This              Pointer to the EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  DevicePath        The device path of the device, relative to the host controller.
+  @param[in]  EndpointAddress   The address of the bulk endpoint, with the direction in bit 7.
+  @param[in]  StreamId          The stream of the endpoint, or 0 if its streams are not enabled.
+  @param[in]  Data              The data buffer to transfer.
+  @param[in]  DataLength        The length of the data buffer in bytes.
+  @param[out] Transfer          The token of the submitted transfer.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER A parameter is invalid, or the stream is not enabled.
+  @retval EFI_NOT_FOUND         The device is not attached to the host controller.
+  @retval EFI_OUT_OF_RESOURCES  The transfer ring of the endpoint is full, or the data
+                                buffer could not be mapped.
+  @retval EFI_DEVICE_ERROR      The host controller is halted.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_ASYNC_BULK_SUBMIT)(
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  EFI_DEVICE_PATH_PROTOCOL       *DevicePath,
+  IN  UINT8                          EndpointAddress,
+  IN  UINT16                         StreamId,
+  IN  VOID                           *Data,
+  IN  UINTN                          DataLength,
+  OUT VOID                           **Transfer
+  );
+
+/**
+  Check whether a submitted bulk transfer is completed.
+
+  The transfer token is released when the transfer is completed, and must not
+  be used again.
+
+  @param[in]  This              Pointer to the EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  Transfer          The token returned by Submit().
+  @param[out] DataLength        The number of bytes transferred.
+  @param[out] TransferResult    The result of the transfer, as defined by EFI_USB_IO_PROTOCOL.
+
+  @retval EFI_SUCCESS           The transfer is completed successfully.
+  @retval EFI_NOT_READY         The transfer is still in progress.
+  @retval EFI_INVALID_PARAMETER Transfer is not a valid token.
+  @retval EFI_DEVICE_ERROR      The transfer is completed with an error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_ASYNC_BULK_POLL)(
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                           *Transfer,
+  OUT UINTN                          *DataLength,
+  OUT UINT32                         *TransferResult
+  );
+
+/**
+  Abort a submitted bulk transfer and release its token.
+
+  The transfers queued behind it on the same endpoint and stream are aborted
+  as well, and are reported by Poll() with EFI_USB_ERR_NOTEXECUTE.
+
+  @param[in]  This              Pointer to the EDKII_USB_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  Transfer          The token returned by Submit().
+
+  @retval EFI_SUCCESS           The transfer is aborted, or it was already completed.
+  @retval EFI_INVALID_PARAMETER Transfer is not a valid token.
+  @retval EFI_DEVICE_ERROR      The host controller failed to stop the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_ASYNC_BULK_CANCEL)(
+  IN  EDKII_USB_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                           *Transfer
+  );
+
+struct _EDKII_USB_ASYNC_BULK_PROTOCOL {
+  UINT32                                 Revision;
+  EDKII_USB_ASYNC_BULK_ENABLE_STREAMS    EnableStreams;
+  EDKII_USB_ASYNC_BULK_SUBMIT            Submit;
+  EDKII_USB_ASYNC_BULK_POLL              Poll;
+  EDKII_USB_ASYNC_BULK_CANCEL            Cancel;
+};
+
+extern EFI_GUID  gEdkiiUsbAsyncBulkProtocolGuid;
+
+#endif
@@ -0,0 +1,172 @@
+/** @file
+  USB I/O Async Bulk protocol is produced by the USB bus driver on the handle
+  of a USB interface, next to EFI_USB_IO_PROTOCOL, when the host controller of
+  the interface produces EDKII_USB_ASYNC_BULK_PROTOCOL.
+
+  It lets the driver of the interface keep several bulk transfers outstanding
+  on the endpoints of the interface, and spread them over the streams of a
+  SuperSpeed bulk endpoint, as required by the USB Attached SCSI protocol.
+  The alternate setting of the interface is also selected through it, so that
+  the USB bus driver and the host controller switch to the endpoints of the
+  new setting together.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __USB_IO_ASYNC_BULK_H__
+#define __USB_IO_ASYNC_BULK_H__
+
+#define EDKII_USB_IO_ASYNC_BULK_PROTOCOL_GUID \
+  { \
+    0x18027665, 0xf86f, 0x4def, { 0xae, 0x7d, 0xf5, 0xb4, 0xa2, 0x21, 0x15, 0xf5 } \
+  }
+
+#define EDKII_USB_IO_ASYNC_BULK_PROTOCOL_REVISION  0x00010000
+
+typedef struct _EDKII_USB_IO_ASYNC_BULK_PROTOCOL EDKII_USB_IO_ASYNC_BULK_PROTOCOL;
+
+/**
+  Select an alternate setting of the USB interface.
+
+  The SET_INTERFACE request is sent to the device, and the endpoints of the
+  new setting are used by EFI_USB_IO_PROTOCOL and by this protocol from then
+  on. The streams enabled on the endpoints of the previous setting are
+  disabled.
+
+  @param[in]  This              Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  AlternateSetting  The alternate setting to select.
+
+  @retval EFI_SUCCESS           The alternate setting is selected.
+  @retval EFI_NOT_FOUND         The interface has no such alternate setting.
+  @retval EFI_DEVICE_ERROR      The device failed to select the alternate setting.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_SELECT_SETTING)(
+  IN EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN UINT8                             AlternateSetting
+  );
+
+/**
+  Enable the streams of a SuperSpeed bulk endpoint of the interface.
+
+  Once the streams are enabled, every transfer submitted to the endpoint must
+  specify a stream. The streams stay enabled until an alternate setting is
+  selected again.
+
+  @param[in]      This              Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]      EndpointAddress   The address of the bulk endpoint, with the direction in bit 7.
+  @param[in, out] StreamNumber      On input, the number of streams requested. On output, the
+                                    number of streams enabled. The streams are numbered from 1.
+
+  @retval EFI_SUCCESS               The streams are enabled.
+  @retval EFI_INVALID_PARAMETER     The endpoint is not a bulk endpoint of the active setting,
+                                    or StreamNumber is less than 2.
+  @retval EFI_UNSUPPORTED           The host controller does not support streams.
+  @retval EFI_OUT_OF_RESOURCES      The stream rings could not be allocated.
+  @retval EFI_DEVICE_ERROR          The host controller failed to configure the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_ENABLE_STREAMS)(
+  IN     EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN     UINT8                             EndpointAddress,
+  IN OUT UINT16                            *StreamNumber
+  );
+
+/**
+  Submit a bulk transfer and return without waiting for its completion.
+
+  The transfers submitted to the same endpoint and stream are executed in
+  order. The data buffer must not be accessed by the caller until the transfer
+  is completed by Poll() or aborted by Cancel().
+
+  @param[in]  This              Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  EndpointAddress   The address of the bulk endpoint, with the direction in bit 7.
+  @param[in]  StreamId          The stream of the endpoint, or 0 if its streams are not enabled.
+  @param[in]  Data              The data buffer to transfer.
+  @param[in]  DataLength        The length of the data buffer in bytes.
+  @param[out] Transfer          The token of the submitted transfer.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER The endpoint is not a bulk endpoint of the active setting,
+                                or the stream is not enabled.
+  @retval EFI_OUT_OF_RESOURCES  The transfer ring of the endpoint is full, or the data
+                                buffer could not be mapped.
+  @retval EFI_DEVICE_ERROR      The host controller is halted.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_SUBMIT)(
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  UINT8                             EndpointAddress,
+  IN  UINT16                            StreamId,
+  IN  VOID                              *Data,
+  IN  UINTN                             DataLength,
+  OUT VOID                              **Transfer
+  );
+
+/**
+  Check whether a submitted bulk transfer is completed.
+
+  The transfer token is released when the transfer is completed, and must not
+  be used again.
+
+  @param[in]  This              Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  Transfer          The token returned by Submit().
+  @param[out] DataLength        The number of bytes transferred.
+  @param[out] TransferResult    The result of the transfer, as defined by EFI_USB_IO_PROTOCOL.
+
+  @retval EFI_SUCCESS           The transfer is completed successfully.
+  @retval EFI_NOT_READY         The transfer is still in progress.
+  @retval EFI_INVALID_PARAMETER Transfer is not a valid token.
+  @retval EFI_DEVICE_ERROR      The transfer is completed with an error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_POLL)(
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                              *Transfer,
+  OUT UINTN                             *DataLength,
+  OUT UINT32                            *TransferResult
+  );
+
+/**
+  Abort a submitted bulk transfer and release its token.
+
+  The transfers queued behind it on the same endpoint and stream are aborted
+  as well, and are reported by Poll() with EFI_USB_ERR_NOTEXECUTE.
+
+  @param[in]  This              Pointer to the EDKII_USB_IO_ASYNC_BULK_PROTOCOL instance.
+  @param[in]  Transfer          The token returned by Submit().
+
+  @retval EFI_SUCCESS           The transfer is aborted, or it was already completed.
+  @retval EFI_INVALID_PARAMETER Transfer is not a valid token.
+  @retval EFI_DEVICE_ERROR      The host controller failed to stop the endpoint.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_IO_ASYNC_BULK_CANCEL)(
+  IN  EDKII_USB_IO_ASYNC_BULK_PROTOCOL  *This,
+  IN  VOID                              *Transfer
+  );
+
+struct _EDKII_USB_IO_ASYNC_BULK_PROTOCOL {
+  UINT32                                    Revision;
+  EDKII_USB_IO_ASYNC_BULK_SELECT_SETTING    SelectSetting;
+  EDKII_USB_IO_ASYNC_BULK_ENABLE_STREAMS    EnableStreams;
+  EDKII_USB_IO_ASYNC_BULK_SUBMIT            Submit;
+  EDKII_USB_IO_ASYNC_BULK_POLL              Poll;
+  EDKII_USB_IO_ASYNC_BULK_CANCEL            Cancel;
+};
+
+extern EFI_GUID  gEdkiiUsbIoAsyncBulkProtocolGuid;
+
+#endif
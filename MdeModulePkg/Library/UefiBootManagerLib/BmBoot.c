@@ -1918,6 +1918,11 @@ EfiBootManagerBoot (
 
   DEBUG_CODE_END ();
 
+  //
+  // Only the boot path of the boot option booted last time may be connected so far.
+  //
+  BmConnectDeferredControllers (OptionNumber);
+
   ImageHandle       = NULL;
   RamDiskDevicePath = NULL;
   if (DevicePathType (BootOption->FilePath) != BBS_DEVICE_PATH) {
@@ -1925,6 +1930,14 @@ EfiBootManagerBoot (
     FilePath = NULL;
     EfiBootManagerConnectDevicePath (BootOption->FilePath, NULL);
     FileBuffer = BmGetNextLoadOptionBuffer (LoadOptionTypeBoot, BootOption->FilePath, &FilePath, &FileSize);
+    if ((FileBuffer == NULL) && BmConnectDeferredControllers (LoadOptionNumberUnassigned)) {
+      //
+      // The cached boot path is stale, try again with all the controllers connected.
+      //
+      EfiBootManagerConnectDevicePath (BootOption->FilePath, NULL);
+      FileBuffer = BmGetNextLoadOptionBuffer (LoadOptionTypeBoot, BootOption->FilePath, &FilePath, &FileSize);
+    }
+
     if (FileBuffer != NULL) {
       RamDiskDevicePath = BmGetRamDiskDevicePath (FilePath);
 
@@ -1937,6 +1950,9 @@ EfiBootManagerBoot (
                       FileSize,
                       &ImageHandle
                       );
+      if (!EFI_ERROR (Status) && !BmIsBootManagerMenuFilePath (BootOption->FilePath)) {
+        BmSaveBootPath (OptionNumber, FilePath);
+      }
     }
 
     if (FileBuffer != NULL) {
@@ -2362,6 +2378,13 @@ EfiBootManagerRefreshAllBootOption (
   UINTN                                 Index;
   EDKII_PLATFORM_BOOT_MANAGER_PROTOCOL  *PlatformBootManager;
 
+  //
+  // Keep the boot options of the devices not connected yet.
+  //
+  if (BmDeferRefreshAllBootOption ()) {
+    return;
+  }
+
   //
   // Optionally refresh the legacy boot option
   //
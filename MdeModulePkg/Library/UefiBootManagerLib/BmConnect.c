@@ -9,40 +9,234 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "InternalBm.h"
 
 /**
-  Connect all the drivers to all the controllers.
+  Compare two handles by their values, for sorting the handles.
 
-  This function makes sure all the current system drivers manage the correspoinding
-  controllers if have. And at the same time, makes sure all the system controllers
-  have driver to manage it if have.
+  @param Left    Pointer to the first handle.
+  @param Right   Pointer to the second handle.
+
+  @retval <0   Left is smaller than Right.
+  @retval 0    Left equals to Right.
+  @retval >0   Left is larger than Right.
+**/
+INTN
+EFIAPI
+BmCompareHandle (
+  IN CONST VOID  *Left,
+  IN CONST VOID  *Right
+  )
+{
+  UINTN  LeftValue;
+  UINTN  RightValue;
+
+  LeftValue  = (UINTN)*(CONST EFI_HANDLE *)Left;
+  RightValue = (UINTN)*(CONST EFI_HANDLE *)Right;
+
+  if (LeftValue < RightValue) {
+    return -1;
+  }
+
+  return (LeftValue > RightValue) ? 1 : 0;
+}
+
+/**
+  Check whether the handle is in the sorted handle buffer.
+
+  @param HandleBuffer  The handles sorted by BmCompareHandle().
+  @param HandleCount   The number of handles.
+  @param Handle        The handle to look for.
+
+  @retval TRUE   The handle is in the buffer.
+  @retval FALSE  The handle is not in the buffer.
+**/
+BOOLEAN
+BmIsHandleInSortedBuffer (
+  IN EFI_HANDLE  *HandleBuffer,
+  IN UINTN       HandleCount,
+  IN EFI_HANDLE  Handle
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+  INTN   Result;
+
+  Low  = 0;
+  High = HandleCount;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    Result = BmCompareHandle (&HandleBuffer[Middle], &Handle);
+    if (Result == 0) {
+      return TRUE;
+    } else if (Result < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Connect all the drivers to all the controllers recursively.
 **/
 VOID
-BmConnectAllDriversToAllControllers (
+BmConnectAllControllersRecursively (
   VOID
   )
 {
-  EFI_STATUS  Status;
   UINTN       HandleCount;
   EFI_HANDLE  *HandleBuffer;
   UINTN       Index;
 
-  do {
+  //
+  // Connect All EFI 1.10 drivers following EFI 1.10 algorithm
+  //
+  gBS->LocateHandleBuffer (
+         AllHandles,
+         NULL,
+         NULL,
+         &HandleCount,
+         &HandleBuffer
+         );
+
+  for (Index = 0; Index < HandleCount; Index++) {
+    gBS->ConnectController (HandleBuffer[Index], NULL, NULL, TRUE);
+  }
+
+  if (HandleBuffer != NULL) {
+    FreePool (HandleBuffer);
+  }
+}
+
+/**
+  Connect all the drivers to all the controllers, one level of the device
+  tree at a time.
+
+  The recursive connect visits a controller once more from each of its
+  ancestors, asking all the drivers whether they support it every time.
+  Here each stage connects the controllers created by the previous stage
+  non-recursively, so that a controller is connected once, after all its
+  parents are. When no more controllers are created, all the controllers
+  are swept, i.e. connected once more, to catch the drivers which only
+  manage them after their siblings are started. The controllers created
+  by a sweep are connected in stages as well, and then swept again, until
+  a sweep creates no controller.
+
+  The time taken to connect every controller is logged in the performance
+  records with the token "BdsConnect" and the stage as the identifier.
+
+  @retval TRUE   All the controllers are connected.
+  @retval FALSE  Out of resources before all the controllers are connected.
+**/
+BOOLEAN
+BmConnectAllControllersInStages (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  EFI_HANDLE  *Connected;
+  UINTN       ConnectedCount;
+  EFI_HANDLE  *HandleBuffer;
+  UINTN       HandleCount;
+  UINTN       NewCount;
+  UINTN       Index;
+  UINT32      Stage;
+  BOOLEAN     Swept;
+  BOOLEAN     Completed;
+  EFI_HANDLE  *NewConnected;
+
+  Connected      = NULL;
+  ConnectedCount = 0;
+  Swept          = FALSE;
+  Completed      = FALSE;
+
+  for (Stage = 0; ; Stage++) {
+    Status = gBS->LocateHandleBuffer (AllHandles, NULL, NULL, &HandleCount, &HandleBuffer);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
     //
-    // Connect All EFI 1.10 drivers following EFI 1.10 algorithm
+    // Pick out the handles created since the last stage.
     //
-    gBS->LocateHandleBuffer (
-           AllHandles,
-           NULL,
-           NULL,
-           &HandleCount,
-           &HandleBuffer
-           );
-
+    NewCount = 0;
     for (Index = 0; Index < HandleCount; Index++) {
-      gBS->ConnectController (HandleBuffer[Index], NULL, NULL, TRUE);
+      if (!BmIsHandleInSortedBuffer (Connected, ConnectedCount, HandleBuffer[Index])) {
+        HandleBuffer[NewCount++] = HandleBuffer[Index];
+      }
     }
 
-    if (HandleBuffer != NULL) {
+    if (NewCount == 0) {
+      if (Swept) {
+        FreePool (HandleBuffer);
+        Completed = TRUE;
+        break;
+      }
+
+      Swept = TRUE;
+      for (Index = 0; Index < HandleCount; Index++) {
+        gBS->ConnectController (HandleBuffer[Index], NULL, NULL, FALSE);
+      }
+
       FreePool (HandleBuffer);
+      continue;
+    }
+
+    //
+    // New controllers need another sweep once they are connected.
+    //
+    Swept = FALSE;
+
+    DEBUG ((DEBUG_INFO, "[Bds]Connect stage %d: %d controllers\n", Stage, NewCount));
+    for (Index = 0; Index < NewCount; Index++) {
+      PERF_START_EX (HandleBuffer[Index], "BdsConnect", NULL, 0, Stage);
+      gBS->ConnectController (HandleBuffer[Index], NULL, NULL, FALSE);
+      PERF_END_EX (HandleBuffer[Index], "BdsConnect", NULL, 0, Stage);
+    }
+
+    NewConnected = ReallocatePool (
+                     ConnectedCount * sizeof (EFI_HANDLE),
+                     (ConnectedCount + NewCount) * sizeof (EFI_HANDLE),
+                     Connected
+                     );
+    if (NewConnected == NULL) {
+      FreePool (HandleBuffer);
+      break;
+    }
+
+    Connected = NewConnected;
+    CopyMem (&Connected[ConnectedCount], HandleBuffer, NewCount * sizeof (EFI_HANDLE));
+    ConnectedCount += NewCount;
+    PerformQuickSort (Connected, ConnectedCount, sizeof (EFI_HANDLE), BmCompareHandle);
+
+    FreePool (HandleBuffer);
+  }
+
+  if (Connected != NULL) {
+    FreePool (Connected);
+  }
+
+  return Completed;
+}
+
+/**
+  Connect all the drivers to all the controllers.
+
+  This function makes sure all the current system drivers manage the correspoinding
+  controllers if have. And at the same time, makes sure all the system controllers
+  have driver to manage it if have.
+**/
+VOID
+BmConnectAllDriversToAllControllers (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  do {
+    if (!PcdGetBool (PcdBootManagerStagedConnect) || !BmConnectAllControllersInStages ()) {
+      BmConnectAllControllersRecursively ();
     }
 
     //
@@ -55,6 +249,322 @@ BmConnectAllDriversToAllControllers (
   } while (!EFI_ERROR (Status));
 }
 
+///
+/// This GUID is used for an EFI Variable that caches the device path of the
+/// last boot option booted.
+///
+EFI_GUID  mBmBootPathVariableGuid = {
+  0x2b0c9a51, 0x7d6e, 0x4c3f, { 0x9e, 0x14, 0x6a, 0x83, 0xd2, 0x5f, 0x0b, 0x97 }
+};
+
+//
+// TRUE until the first EfiBootManagerConnectAll() or boot attempt.
+//
+BOOLEAN  mBmFirstConnectAll = TRUE;
+
+//
+// Set when the first EfiBootManagerConnectAll() only connected the cached boot path
+// of mBmBootPathOptionNumber, and the other controllers are still to be connected.
+//
+BOOLEAN  mBmConnectAllDeferred   = FALSE;
+BOOLEAN  mBmRefreshDeferred      = FALSE;
+UINTN    mBmBootPathOptionNumber = LoadOptionNumberUnassigned;
+
+//
+// Ticks taken to connect all the controllers in this boot, and in the boot
+// which cached the boot path.
+//
+UINT64  mBmConnectAllTime       = 0;
+UINT64  mBmCachedConnectAllTime = 0;
+
+/**
+  Return the performance counter ticks elapsed since StartTicks.
+
+  @param StartTicks  The value of the performance counter at the start.
+
+  @return The ticks elapsed.
+**/
+UINT64
+BmGetElapsedTicks (
+  IN UINT64  StartTicks
+  )
+{
+  UINT64  EndTicks;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+
+  EndTicks = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterStart < CounterEnd) {
+    return EndTicks - StartTicks;
+  } else {
+    return StartTicks - EndTicks;
+  }
+}
+
+/**
+  Return the number of the boot option to be booted first, that is the
+  BootNext, or the first one in BootOrder.
+
+  @param OptionNumber  Return the number of the boot option.
+
+  @retval TRUE   The boot option number is returned.
+  @retval FALSE  There is no boot option to boot.
+**/
+BOOLEAN
+BmGetTopBootOption (
+  OUT UINTN  *OptionNumber
+  )
+{
+  UINT16  *Variable;
+  UINTN   VariableSize;
+
+  GetEfiGlobalVariable2 (EFI_BOOT_NEXT_VARIABLE_NAME, (VOID **)&Variable, &VariableSize);
+  if ((Variable == NULL) || (VariableSize != sizeof (UINT16))) {
+    if (Variable != NULL) {
+      FreePool (Variable);
+    }
+
+    GetEfiGlobalVariable2 (EFI_BOOT_ORDER_VARIABLE_NAME, (VOID **)&Variable, &VariableSize);
+    if ((Variable == NULL) || (VariableSize < sizeof (UINT16))) {
+      if (Variable != NULL) {
+        FreePool (Variable);
+      }
+
+      return FALSE;
+    }
+  }
+
+  *OptionNumber = Variable[0];
+  FreePool (Variable);
+  return TRUE;
+}
+
+/**
+  Connect the controllers on the device path cached for the top boot option
+  in the last boot.
+
+  @retval TRUE   The controllers on the cached path are connected.
+  @retval FALSE  There is no usable cached path, or it failed to connect.
+**/
+BOOLEAN
+BmConnectBootPath (
+  VOID
+  )
+{
+  EFI_STATUS                Status;
+  BM_BOOT_PATH              *BootPath;
+  UINTN                     BootPathSize;
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+  UINTN                     OptionNumber;
+  BOOLEAN                   Connected;
+
+  if (!PcdGetBool (PcdBootManagerBootPathCache) || !BmGetTopBootOption (&OptionNumber)) {
+    return FALSE;
+  }
+
+  GetVariable2 (BM_BOOT_PATH_VARIABLE_NAME, &mBmBootPathVariableGuid, (VOID **)&BootPath, &BootPathSize);
+  if (BootPath == NULL) {
+    return FALSE;
+  }
+
+  Connected  = FALSE;
+  DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)(BootPath + 1);
+  if ((BootPathSize > sizeof (BM_BOOT_PATH)) &&
+      IsDevicePathValid (DevicePath, BootPathSize - sizeof (BM_BOOT_PATH)) &&
+      (BootPath->OptionNumber == OptionNumber))
+  {
+    Status = EfiBootManagerConnectDevicePath (DevicePath, NULL);
+    DEBUG ((DEBUG_INFO, "[Bds]Connect boot path of Boot%04x - %r\n", (UINT32)OptionNumber, Status));
+    if (!EFI_ERROR (Status)) {
+      mBmBootPathOptionNumber = OptionNumber;
+      mBmCachedConnectAllTime = BootPath->ConnectAllTime;
+      Connected               = TRUE;
+    }
+  }
+
+  FreePool (BootPath);
+  return Connected;
+}
+
+/**
+  Report the time saved by connecting only the cached boot path, compared to
+  connecting all the controllers in the boot which cached the path.
+
+  The saving is logged as a performance record with the token "BdsConnectSaved",
+  the duration of which is the time saved, and the boot option number as the
+  identifier.
+
+  @param StartTicks  The value of the performance counter when the connect started.
+**/
+VOID
+BmReportConnectTimeSaved (
+  IN UINT64  StartTicks
+  )
+{
+  UINT64  Ticks;
+  UINT64  SavedTicks;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+
+  Ticks      = BmGetElapsedTicks (StartTicks);
+  SavedTicks = (mBmCachedConnectAllTime > Ticks) ? mBmCachedConnectAllTime - Ticks : 0;
+  DEBUG ((
+    DEBUG_INFO,
+    "[Bds]Connected the boot path in %ld us, %ld us saved\n",
+    DivU64x32 (GetTimeInNanoSecond (Ticks), 1000),
+    DivU64x32 (GetTimeInNanoSecond (SavedTicks), 1000)
+    ));
+
+  PERF_CODE (
+    GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+    StartTicks = GetPerformanceCounter ();
+    PERF_START_EX (gImageHandle, "BdsConnectSaved", NULL, StartTicks, (UINT32)mBmBootPathOptionNumber);
+    PERF_END_EX (
+      gImageHandle,
+      "BdsConnectSaved",
+      NULL,
+      (CounterStart < CounterEnd) ? StartTicks + SavedTicks : StartTicks - SavedTicks,
+      (UINT32)mBmBootPathOptionNumber
+      );
+    );
+}
+
+/**
+  Cache the device path of the boot option being booted, so that the first
+  EfiBootManagerConnectAll() in the next boot only connects the controllers
+  on the path.
+
+  @param OptionNumber  The number of the boot option.
+  @param FilePath      The full device path the boot option is loaded from.
+**/
+VOID
+BmSaveBootPath (
+  IN UINTN                     OptionNumber,
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  )
+{
+  EFI_STATUS                Status;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+  UINTN                     DevicePathSize;
+  BM_BOOT_PATH              *BootPath;
+  BM_BOOT_PATH              *CachedBootPath;
+  UINTN                     CachedBootPathSize;
+
+  if (!PcdGetBool (PcdBootManagerBootPathCache)) {
+    return;
+  }
+
+  //
+  // Only cache the controllers, not the file on the media.
+  //
+  for (Node = FilePath; !IsDevicePathEnd (Node); Node = NextDevicePathNode (Node)) {
+    if ((DevicePathType (Node) == MEDIA_DEVICE_PATH) && (DevicePathSubType (Node) == MEDIA_FILEPATH_DP)) {
+      break;
+    }
+  }
+
+  DevicePathSize = (UINTN)Node - (UINTN)FilePath;
+  if (DevicePathSize == 0) {
+    return;
+  }
+
+  BootPath = AllocateZeroPool (sizeof (BM_BOOT_PATH) + DevicePathSize + END_DEVICE_PATH_LENGTH);
+  if (BootPath == NULL) {
+    return;
+  }
+
+  //
+  // Keep the connect time measured when the path was cached, as the boots
+  // using the path do not connect all the controllers.
+  //
+  BootPath->ConnectAllTime = (mBmConnectAllTime != 0) ? mBmConnectAllTime : mBmCachedConnectAllTime;
+  BootPath->OptionNumber   = (UINT16)OptionNumber;
+  CopyMem (BootPath + 1, FilePath, DevicePathSize);
+  SetDevicePathEndNode ((UINT8 *)(BootPath + 1) + DevicePathSize);
+
+  //
+  // Avoid wearing the flash when the boot path doesn't change.
+  //
+  GetVariable2 (BM_BOOT_PATH_VARIABLE_NAME, &mBmBootPathVariableGuid, (VOID **)&CachedBootPath, &CachedBootPathSize);
+  if ((CachedBootPath == NULL) ||
+      (CachedBootPathSize != sizeof (BM_BOOT_PATH) + DevicePathSize + END_DEVICE_PATH_LENGTH) ||
+      (CompareMem (CachedBootPath, BootPath, CachedBootPathSize) != 0))
+  {
+    Status = gRT->SetVariable (
+                    BM_BOOT_PATH_VARIABLE_NAME,
+                    &mBmBootPathVariableGuid,
+                    EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_NON_VOLATILE,
+                    sizeof (BM_BOOT_PATH) + DevicePathSize + END_DEVICE_PATH_LENGTH,
+                    BootPath
+                    );
+    DEBUG ((DEBUG_INFO, "[Bds]Cache boot path of Boot%04x - %r\n", (UINT32)OptionNumber, Status));
+  }
+
+  if (CachedBootPath != NULL) {
+    FreePool (CachedBootPath);
+  }
+
+  FreePool (BootPath);
+}
+
+/**
+  Connect all the controllers if the first EfiBootManagerConnectAll() only
+  connected the controllers on the cached boot path, unless the boot option
+  to boot is the cached one.
+
+  @param OptionNumber  The number of the boot option to boot, or
+                       LoadOptionNumberUnassigned to connect all anyway.
+
+  @retval TRUE   All the controllers were connected by this call.
+  @retval FALSE  Nothing was done.
+**/
+BOOLEAN
+BmConnectDeferredControllers (
+  IN UINTN  OptionNumber
+  )
+{
+  UINT64  StartTicks;
+
+  mBmFirstConnectAll = FALSE;
+  if (!mBmConnectAllDeferred || (OptionNumber == mBmBootPathOptionNumber)) {
+    return FALSE;
+  }
+
+  DEBUG ((DEBUG_INFO, "[Bds]Connect the controllers not on the boot path\n"));
+  mBmConnectAllDeferred = FALSE;
+  StartTicks            = GetPerformanceCounter ();
+  BmConnectAllDriversToAllControllers ();
+  mBmConnectAllTime = BmGetElapsedTicks (StartTicks);
+  EfiBootManagerConnectAllDefaultConsoles ();
+
+  if (mBmRefreshDeferred) {
+    mBmRefreshDeferred = FALSE;
+    EfiBootManagerRefreshAllBootOption ();
+  }
+
+  return TRUE;
+}
+
+/**
+  Check whether the boot options should be refreshed after all the controllers
+  are connected, rather than now.
+
+  @retval TRUE   The refresh is deferred.
+  @retval FALSE  The boot options should be refreshed now.
+**/
+BOOLEAN
+BmDeferRefreshAllBootOption (
+  VOID
+  )
+{
+  if (mBmConnectAllDeferred) {
+    mBmRefreshDeferred = TRUE;
+  }
+
+  return mBmConnectAllDeferred;
+}
+
 /**
   This function will connect all the system driver to controller
   first, and then special connect the default console, this make
@@ -68,15 +578,39 @@ EfiBootManagerConnectAll (
   VOID
   )
 {
+  UINT64  StartTicks;
+
   //
   // Connect the platform console first
   //
   EfiBootManagerConnectAllDefaultConsoles ();
 
+  //
+  // The first connect only connects the boot path cached in the last boot
+  // when it's still there. The other controllers are connected before
+  // booting any other boot option, or when this is called again.
+  //
+  StartTicks = GetPerformanceCounter ();
+  if (mBmFirstConnectAll) {
+    mBmFirstConnectAll = FALSE;
+    if (BmConnectBootPath ()) {
+      mBmConnectAllDeferred = TRUE;
+      BmReportConnectTimeSaved (StartTicks);
+      return;
+    }
+  }
+
+  if (BmConnectDeferredControllers (LoadOptionNumberUnassigned)) {
+    return;
+  }
+
   //
   // Generic way to connect all the drivers
   //
   BmConnectAllDriversToAllControllers ();
+  if (mBmConnectAllTime == 0) {
+    mBmConnectAllTime = BmGetElapsedTicks (StartTicks);
+  }
 
   //
   // Here we have the assumption that we have already had
@@ -70,6 +70,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/CapsuleLib.h>
 #include <Library/PerformanceLib.h>
 #include <Library/HiiLib.h>
+#include <Library/TimerLib.h>
 
 #if !defined (EFI_REMOVABLE_MEDIA_FILE_NAME)
   #if defined (MDE_CPU_EBC)
@@ -111,6 +112,22 @@ extern CHAR16  *mBmLoadOptionName[];
 //
 #define MAX_RECONNECT_REPAIR  10
 
+//
+// The variable that caches the device path of the last boot option booted,
+// so that only the controllers on the path are connected in the next boot.
+//
+#define BM_BOOT_PATH_VARIABLE_NAME  L"BootPath"
+extern EFI_GUID  mBmBootPathVariableGuid;
+
+///
+/// The content of the boot path variable. The device path of the controller
+/// that the boot option was loaded from follows the structure.
+///
+typedef struct {
+  UINT64    ConnectAllTime;       ///< Ticks taken to connect all the controllers, 0 if unknown
+  UINT16    OptionNumber;         ///< The Boot#### that was booted
+} BM_BOOT_PATH;
+
 /**
   Visitor function to be called by BmForEachVariable for each variable
   in variable storage.
@@ -466,4 +483,46 @@ BmGetNextLoadOptionBuffer (
   OUT UINTN                              *FileSize
   );
 
+/**
+  Cache the device path of the boot option being booted, so that the first
+  EfiBootManagerConnectAll() in the next boot only connects the controllers
+  on the path.
+
+  @param OptionNumber  The number of the boot option.
+  @param FilePath      The full device path the boot option is loaded from.
+**/
+VOID
+BmSaveBootPath (
+  IN UINTN                     OptionNumber,
+  IN EFI_DEVICE_PATH_PROTOCOL  *FilePath
+  );
+
+/**
+  Connect all the controllers if the first EfiBootManagerConnectAll() only
+  connected the controllers on the cached boot path, unless the boot option
+  to boot is the cached one.
+
+  @param OptionNumber  The number of the boot option to boot, or
+                       LoadOptionNumberUnassigned to connect all anyway.
+
+  @retval TRUE   All the controllers were connected by this call.
+  @retval FALSE  Nothing was done.
+**/
+BOOLEAN
+BmConnectDeferredControllers (
+  IN UINTN  OptionNumber
+  );
+
+/**
+  Check whether the boot options should be refreshed after all the controllers
+  are connected, rather than now.
+
+  @retval TRUE   The refresh is deferred.
+  @retval FALSE  The boot options should be refreshed now.
+**/
+BOOLEAN
+BmDeferRefreshAllBootOption (
+  VOID
+  );
+
 #endif // _INTERNAL_BM_H_
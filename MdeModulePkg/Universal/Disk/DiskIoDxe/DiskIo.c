@@ -45,6 +45,11 @@ DISK_IO_PRIVATE_DATA  gDiskIoPrivateDataTemplate = {
     DiskIo2ReadDiskEx,
     DiskIo2WriteDiskEx,
     DiskIo2FlushDiskEx
+  },
+  {
+    EDKII_BLOCK_CACHE_PROTOCOL_REVISION,
+    DiskIoBlockCacheInvalidate,
+    DiskIoBlockCacheGetStatistics
   }
 };
 
@@ -177,6 +182,13 @@ DiskIoDriverBindingStart (
 
   InitializeListHead (&Instance->TaskQueue);
   EfiInitializeLock (&Instance->TaskQueueLock, TPL_NOTIFY);
+  InitializeListHead (&Instance->PendingQueue);
+  EfiInitializeLock (&Instance->PendingQueueLock, TPL_NOTIFY);
+  Instance->QueueDepth = PcdGet32 (PcdDiskIoQueueDepth);
+  if (Instance->QueueDepth == 0) {
+    Instance->QueueDepth = MAX_UINT32;
+  }
+
   Instance->SharedWorkingBuffer = AllocateAlignedPages (
                                     EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize),
                                     Instance->BlockIo->Media->IoAlign
@@ -186,6 +198,30 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  if (Instance->BlockIo2 != NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    DiskIoOnDispatch,
+                    Instance,
+                    &Instance->DispatchEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      goto ErrorExit;
+    }
+  }
+
+  //
+  // Only the blocks of the physical device are cached. The partitions
+  // access the device through its Disk IO, so they share the cache.
+  //
+  if ((PcdGet32 (PcdDiskIoCacheSize) != 0) && !Instance->BlockIo->Media->LogicalPartition) {
+    Status = DiskIoCacheCreate (Instance, PcdGet32 (PcdDiskIoCacheSize));
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "DiskIo: Failed to create the block cache - %r\n", Status));
+    }
+  }
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -207,6 +243,20 @@ DiskIoDriverBindingStart (
                     );
   }
 
+  if (!EFI_ERROR (Status) && (Instance->Cache != NULL)) {
+    if (EFI_ERROR (
+          gBS->InstallProtocolInterface (
+                 &ControllerHandle,
+                 &gEdkiiBlockCacheProtocolGuid,
+                 EFI_NATIVE_INTERFACE,
+                 &Instance->BlockCache
+                 )
+          ))
+    {
+      DiskIoCacheDestroy (Instance);
+    }
+  }
+
 ErrorExit:
   if (EFI_ERROR (Status)) {
     if ((Instance != NULL) && (Instance->SharedWorkingBuffer != NULL)) {
@@ -216,6 +266,14 @@ ErrorExit:
         );
     }
 
+    if ((Instance != NULL) && (Instance->DispatchEvent != NULL)) {
+      gBS->CloseEvent (Instance->DispatchEvent);
+    }
+
+    if (Instance != NULL) {
+      DiskIoCacheDestroy (Instance);
+    }
+
     if (Instance != NULL) {
       FreePool (Instance);
     }
@@ -301,6 +359,11 @@ DiskIoDriverBindingStop (
       return Status;
     }
 
+    //
+    // The requests not issued yet won't be issued any more
+    //
+    DiskIoAbortPendingSubtasks (Instance);
+
     Status = gBS->UninstallMultipleProtocolInterfaces (
                     ControllerHandle,
                     &gEfiDiskIoProtocolGuid,
@@ -325,6 +388,41 @@ DiskIoDriverBindingStop (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!AllTaskDone);
 
+    if (Instance->Cache != NULL) {
+      DEBUG ((
+        DEBUG_INFO,
+        "DiskIo: Cache statistics of %p: Hits/Misses/ReadAheads/ReadAheadHits/Evictions = %ld/%ld/%ld/%ld/%ld\n",
+        ControllerHandle,
+        Instance->Cache->Statistics.Hits,
+        Instance->Cache->Statistics.Misses,
+        Instance->Cache->Statistics.ReadAheads,
+        Instance->Cache->Statistics.ReadAheadHits,
+        Instance->Cache->Statistics.Evictions
+        ));
+      Status = gBS->UninstallProtocolInterface (
+                      ControllerHandle,
+                      &gEdkiiBlockCacheProtocolGuid,
+                      &Instance->BlockCache
+                      );
+      ASSERT_EFI_ERROR (Status);
+      DiskIoCacheDestroy (Instance);
+    }
+
+    if (Instance->DispatchEvent != NULL) {
+      DEBUG ((
+        DEBUG_INFO,
+        "DiskIo: Queue statistics of %p: Queued/Issued/Merged/Dropped = %ld/%ld/%ld/%ld, MaxPending/MaxInFlight = %d/%d\n",
+        ControllerHandle,
+        Instance->Statistics.Queued,
+        Instance->Statistics.Issued,
+        Instance->Statistics.Merged,
+        Instance->Statistics.Dropped,
+        Instance->Statistics.MaxPending,
+        Instance->Statistics.MaxInFlight
+        ));
+      gBS->CloseEvent (Instance->DispatchEvent);
+    }
+
     FreeAlignedPages (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
@@ -388,6 +486,10 @@ DiskIoDestroySubtask (
         );
     }
 
+    if (Subtask->MergeBuffer != NULL) {
+      FreeAlignedPages (Subtask->MergeBuffer, EFI_SIZE_TO_PAGES (Subtask->MergeLength));
+    }
+
     if (Subtask->BlockIo2Token.Event != NULL) {
       gBS->CloseEvent (Subtask->BlockIo2Token.Event);
     }
@@ -398,6 +500,102 @@ DiskIoDestroySubtask (
   return Link;
 }
 
+/**
+  Finish the subtask, and signal the token of its task once the subtask fails
+  or is the last subtask of the task.
+
+  @param Instance           Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Subtask            Subtask.
+  @param Data               The buffer holding the block(s) the subtask read, or
+                            NULL if the data was read into Subtask->Buffer directly.
+  @param TransactionStatus  The status of the subtask.
+**/
+VOID
+DiskIo2FinishSubtask (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN DISK_IO_SUBTASK       *Subtask,
+  IN UINT8                 *Data OPTIONAL,
+  IN EFI_STATUS            TransactionStatus
+  )
+{
+  DISK_IO2_TASK  *Task;
+
+  Task = Subtask->Task;
+  ASSERT (Task->Signature == DISK_IO2_TASK_SIGNATURE);
+
+  if ((Data != NULL) && !EFI_ERROR (TransactionStatus) &&
+      (Task->Token != NULL) && !Subtask->Write
+      )
+  {
+    CopyMem (Subtask->Buffer, Data + Subtask->Offset, Subtask->Length);
+  }
+
+  DiskIoDestroySubtask (Instance, Subtask);
+
+  if (EFI_ERROR (TransactionStatus) || IsListEmpty (&Task->Subtasks)) {
+    if (Task->Token != NULL) {
+      //
+      // Signal error status once the subtask is failed.
+      // Or signal the last status once the last subtask is finished.
+      //
+      Task->Token->TransactionStatus = TransactionStatus;
+      gBS->SignalEvent (Task->Token->Event);
+
+      //
+      // Mark token to NULL indicating the Task is a dead task.
+      //
+      Task->Token = NULL;
+    }
+  }
+}
+
+/**
+  Finish the BlockIo2 request issued for the subtask, as well as the subtasks
+  merged into it, and kick the dispatcher to issue the pending subtasks.
+
+  @param Instance           Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Subtask            The subtask the BlockIo2 request was issued for.
+  @param TransactionStatus  The status of the BlockIo2 request.
+**/
+VOID
+DiskIo2FinishRequest (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN DISK_IO_SUBTASK       *Subtask,
+  IN EFI_STATUS            TransactionStatus
+  )
+{
+  LIST_ENTRY       *Link;
+  DISK_IO_SUBTASK  *Merged;
+  UINT32           BlockSize;
+
+  EfiAcquireLock (&Instance->PendingQueueLock);
+  Instance->InFlight--;
+  EfiReleaseLock (&Instance->PendingQueueLock);
+
+  DiskIoCacheCheckMedia (Instance, TransactionStatus);
+
+  if (Subtask->MergeBuffer != NULL) {
+    BlockSize = Instance->BlockIo->Media->BlockSize;
+    while (!IsListEmpty (&Subtask->MergedSubtasks)) {
+      Link   = GetFirstNode (&Subtask->MergedSubtasks);
+      Merged = CR (Link, DISK_IO_SUBTASK, QueueLink, DISK_IO_SUBTASK_SIGNATURE);
+      RemoveEntryList (Link);
+      DiskIo2FinishSubtask (
+        Instance,
+        Merged,
+        Subtask->MergeBuffer + (UINTN)(Merged->Lba - Subtask->Lba) * BlockSize,
+        TransactionStatus
+        );
+    }
+
+    DiskIo2FinishSubtask (Instance, Subtask, Subtask->MergeBuffer, TransactionStatus);
+  } else {
+    DiskIo2FinishSubtask (Instance, Subtask, Subtask->WorkingBuffer, TransactionStatus);
+  }
+
+  gBS->SignalEvent (Instance->DispatchEvent);
+}
+
 /**
   The callback for the BlockIo2 ReadBlocksEx/WriteBlocksEx.
   @param  Event                 Event whose notification function is being invoked.
@@ -413,41 +611,389 @@ DiskIo2OnReadWriteComplete (
 {
   DISK_IO_SUBTASK       *Subtask;
   DISK_IO2_TASK         *Task;
-  EFI_STATUS            TransactionStatus;
   DISK_IO_PRIVATE_DATA  *Instance;
 
-  Subtask           = (DISK_IO_SUBTASK *)Context;
-  TransactionStatus = Subtask->BlockIo2Token.TransactionStatus;
-  Task              = Subtask->Task;
-  Instance          = Task->Instance;
+  Subtask  = (DISK_IO_SUBTASK *)Context;
+  Task     = Subtask->Task;
+  Instance = Task->Instance;
 
   ASSERT (Subtask->Signature  == DISK_IO_SUBTASK_SIGNATURE);
   ASSERT (Instance->Signature == DISK_IO_PRIVATE_DATA_SIGNATURE);
   ASSERT (Task->Signature     == DISK_IO2_TASK_SIGNATURE);
 
-  if ((Subtask->WorkingBuffer != NULL) && !EFI_ERROR (TransactionStatus) &&
-      (Task->Token != NULL) && !Subtask->Write
-      )
-  {
-    CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
+  DiskIo2FinishRequest (Instance, Subtask, Subtask->BlockIo2Token.TransactionStatus);
+}
+
+/**
+  Get the number of bytes the subtask transfers from/to the device.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Subtask      Subtask.
+
+  @return The number of bytes, a multiple of the block size.
+**/
+UINTN
+DiskIoSubtaskIoSize (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN DISK_IO_SUBTASK       *Subtask
+  )
+{
+  UINT32  BlockSize;
+
+  BlockSize = Instance->BlockIo->Media->BlockSize;
+  return (Subtask->Length % BlockSize == 0) ? Subtask->Length : BlockSize;
+}
+
+/**
+  Queue the non-blocking subtask for the dispatcher.
+
+  Reads are kept sorted by LBA behind the last queued write. Writes are never
+  reordered, and no request is moved across a write, so the reads and writes
+  to the same blocks reach the device in the order they were requested.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Subtask      Subtask.
+**/
+VOID
+DiskIoQueueSubtask (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN DISK_IO_SUBTASK       *Subtask
+  )
+{
+  LIST_ENTRY       *Link;
+  DISK_IO_SUBTASK  *Queued;
+
+  EfiAcquireLock (&Instance->PendingQueueLock);
+
+  Link = GetPreviousNode (&Instance->PendingQueue, &Instance->PendingQueue);
+  if (!Subtask->Write) {
+    for ( ; !IsNull (&Instance->PendingQueue, Link); Link = GetPreviousNode (&Instance->PendingQueue, Link)) {
+      Queued = CR (Link, DISK_IO_SUBTASK, QueueLink, DISK_IO_SUBTASK_SIGNATURE);
+      if (Queued->Write || (Queued->Lba <= Subtask->Lba)) {
+        break;
+      }
+    }
   }
 
-  DiskIoDestroySubtask (Instance, Subtask);
+  //
+  // Insert the subtask right after Link.
+  //
+  InsertHeadList (Link, &Subtask->QueueLink);
 
-  if (EFI_ERROR (TransactionStatus) || IsListEmpty (&Task->Subtasks)) {
-    if (Task->Token != NULL) {
+  Instance->Pending++;
+  Instance->Statistics.Queued++;
+  Instance->Statistics.MaxPending = MAX (Instance->Statistics.MaxPending, Instance->Pending);
+
+  EfiReleaseLock (&Instance->PendingQueueLock);
+}
+
+/**
+  Pick the next pending subtask to issue.
+
+  The reads ahead of the first pending write are swept in the ascending order
+  of LBA, starting from the end of the last issued request and wrapping around
+  to the lowest LBA. The write is picked once all the reads ahead of it are issued.
+  The caller must hold the PendingQueueLock, and the pending queue must not be empty.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+
+  @return The subtask to issue. It is left in the pending queue.
+**/
+DISK_IO_SUBTASK *
+DiskIoPickSubtask (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  LIST_ENTRY       *Link;
+  DISK_IO_SUBTASK  *First;
+  DISK_IO_SUBTASK  *Subtask;
+
+  Link  = GetFirstNode (&Instance->PendingQueue);
+  First = CR (Link, DISK_IO_SUBTASK, QueueLink, DISK_IO_SUBTASK_SIGNATURE);
+  if (First->Write) {
+    return First;
+  }
+
+  for ( ; !IsNull (&Instance->PendingQueue, Link); Link = GetNextNode (&Instance->PendingQueue, Link)) {
+    Subtask = CR (Link, DISK_IO_SUBTASK, QueueLink, DISK_IO_SUBTASK_SIGNATURE);
+    if (Subtask->Write) {
+      break;
+    }
+
+    if (Subtask->Lba >= Instance->NextLba) {
+      return Subtask;
+    }
+  }
+
+  return First;
+}
+
+/**
+  Move the pending reads which are adjacent to or overlap with the read of the
+  subtask to its MergedSubtasks, so that they are read by one BlockIo2 request.
+  The caller must hold the PendingQueueLock.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Subtask      The pending read subtask picked to issue.
+**/
+VOID
+DiskIoMergeSubtasks (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN DISK_IO_SUBTASK       *Subtask
+  )
+{
+  LIST_ENTRY       *Link;
+  DISK_IO_SUBTASK  *Next;
+  UINT32           BlockSize;
+  UINT64           EndLba;
+  UINT64           NextEndLba;
+
+  BlockSize = Instance->BlockIo->Media->BlockSize;
+  EndLba    = Subtask->Lba + DiskIoSubtaskIoSize (Instance, Subtask) / BlockSize;
+
+  Link = GetNextNode (&Instance->PendingQueue, &Subtask->QueueLink);
+  while (!IsNull (&Instance->PendingQueue, Link)) {
+    Next = CR (Link, DISK_IO_SUBTASK, QueueLink, DISK_IO_SUBTASK_SIGNATURE);
+    if (Next->Write || (Next->Length == 0) || (Next->MediaId != Subtask->MediaId) || (Next->Lba > EndLba)) {
+      break;
+    }
+
+    NextEndLba = MAX (EndLba, Next->Lba + DiskIoSubtaskIoSize (Instance, Next) / BlockSize);
+    if (MultU64x32 (NextEndLba - Subtask->Lba, BlockSize) > DISK_IO_MAX_MERGE_SIZE) {
+      break;
+    }
+
+    EndLba = NextEndLba;
+    Link   = RemoveEntryList (&Next->QueueLink);
+    InsertTailList (&Subtask->MergedSubtasks, &Next->QueueLink);
+    Instance->Pending--;
+    Instance->Statistics.Merged++;
+  }
+
+  if (!IsListEmpty (&Subtask->MergedSubtasks)) {
+    Subtask->MergeLength = (UINTN)MultU64x32 (EndLba - Subtask->Lba, BlockSize);
+  }
+}
+
+/**
+  Issue the BlockIo2 request for the subtask.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Subtask      Subtask.
+
+  @return The status returned by BlockIo2 ReadBlocksEx/WriteBlocksEx.
+**/
+EFI_STATUS
+DiskIoIssueSubtask (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN DISK_IO_SUBTASK       *Subtask
+  )
+{
+  EFI_BLOCK_IO2_PROTOCOL  *BlockIo2;
+
+  BlockIo2 = Instance->BlockIo2;
+
+  if (Subtask->MergeBuffer != NULL) {
+    return BlockIo2->ReadBlocksEx (
+                       BlockIo2,
+                       Subtask->MediaId,
+                       Subtask->Lba,
+                       &Subtask->BlockIo2Token,
+                       Subtask->MergeLength,
+                       Subtask->MergeBuffer
+                       );
+  }
+
+  if (Subtask->Write) {
+    return BlockIo2->WriteBlocksEx (
+                       BlockIo2,
+                       Subtask->MediaId,
+                       Subtask->Lba,
+                       &Subtask->BlockIo2Token,
+                       DiskIoSubtaskIoSize (Instance, Subtask),
+                       (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
+                       );
+  }
+
+  return BlockIo2->ReadBlocksEx (
+                     BlockIo2,
+                     Subtask->MediaId,
+                     Subtask->Lba,
+                     &Subtask->BlockIo2Token,
+                     DiskIoSubtaskIoSize (Instance, Subtask),
+                     (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
+                     );
+}
+
+/**
+  Issue the pending subtasks to BlockIo2 until the queue depth is reached.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoDispatchSubtasks (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  EFI_STATUS       Status;
+  EFI_TPL          OldTpl;
+  LIST_ENTRY       *Link;
+  DISK_IO_SUBTASK  *Subtask;
+  UINT32           IoAlign;
+
+  IoAlign = Instance->BlockIo->Media->IoAlign;
+  if (IoAlign == 0) {
+    IoAlign = 1;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  while (TRUE) {
+    EfiAcquireLock (&Instance->PendingQueueLock);
+    if (IsListEmpty (&Instance->PendingQueue) || (Instance->InFlight >= Instance->QueueDepth)) {
+      EfiReleaseLock (&Instance->PendingQueueLock);
+      break;
+    }
+
+    Subtask = DiskIoPickSubtask (Instance);
+    if (Subtask->Task->Token == NULL) {
       //
-      // Signal error status once the subtask is failed.
-      // Or signal the last status once the last subtask is finished.
+      // The task was cancelled or one of its subtasks failed, no need to bother the device.
       //
-      Task->Token->TransactionStatus = TransactionStatus;
-      gBS->SignalEvent (Task->Token->Event);
+      RemoveEntryList (&Subtask->QueueLink);
+      Instance->Pending--;
+      Instance->Statistics.Dropped++;
+      EfiReleaseLock (&Instance->PendingQueueLock);
+
+      DiskIoDestroySubtask (Instance, Subtask);
+      continue;
+    }
+
+    if (!Subtask->Write && (Subtask->Length != 0)) {
+      DiskIoMergeSubtasks (Instance, Subtask);
+    }
+
+    RemoveEntryList (&Subtask->QueueLink);
+    Instance->Pending--;
+    Instance->InFlight++;
+    Instance->Statistics.Issued++;
+    Instance->Statistics.MaxInFlight = MAX (Instance->Statistics.MaxInFlight, Instance->InFlight);
+    if (Subtask->MergeLength != 0) {
+      Instance->NextLba = Subtask->Lba + Subtask->MergeLength / Instance->BlockIo->Media->BlockSize;
+    } else {
+      Instance->NextLba = Subtask->Lba + DiskIoSubtaskIoSize (Instance, Subtask) / Instance->BlockIo->Media->BlockSize;
+    }
+
+    EfiReleaseLock (&Instance->PendingQueueLock);
+
+    if (!IsListEmpty (&Subtask->MergedSubtasks)) {
+      Subtask->MergeBuffer = AllocateAlignedPages (EFI_SIZE_TO_PAGES (Subtask->MergeLength), IoAlign);
+      if (Subtask->MergeBuffer == NULL) {
+        //
+        // Put the merged subtasks back to the head of the queue, in their original order.
+        //
+        DEBUG ((DEBUG_VERBOSE, "DiskIo: No enough memory so issue the subtasks without merging\n"));
+        EfiAcquireLock (&Instance->PendingQueueLock);
+        while (!IsListEmpty (&Subtask->MergedSubtasks)) {
+          Link = GetPreviousNode (&Subtask->MergedSubtasks, &Subtask->MergedSubtasks);
+          RemoveEntryList (Link);
+          InsertHeadList (&Instance->PendingQueue, Link);
+          Instance->Pending++;
+          Instance->Statistics.Merged--;
+        }
 
+        Subtask->MergeLength = 0;
+        Instance->NextLba    = Subtask->Lba + DiskIoSubtaskIoSize (Instance, Subtask) / Instance->BlockIo->Media->BlockSize;
+        EfiReleaseLock (&Instance->PendingQueueLock);
+      }
+    }
+
+    Status = DiskIoIssueSubtask (Instance, Subtask);
+    if (EFI_ERROR (Status)) {
       //
-      // Mark token to NULL indicating the Task is a dead task.
+      // The callback won't be called for the failed request.
       //
-      Task->Token = NULL;
+      DiskIo2FinishRequest (Instance, Subtask, Status);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  The notification function of the DispatchEvent, which is signaled when a
+  BlockIo2 request completes.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               The pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+EFIAPI
+DiskIoOnDispatch (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  DiskIoDispatchSubtasks ((DISK_IO_PRIVATE_DATA *)Context);
+}
+
+/**
+  Issue all the pending subtasks, waiting for the in-flight requests to
+  complete when the queue depth is reached.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoDrainPendingQueue (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  BOOLEAN  QueueEmpty;
+
+  while (TRUE) {
+    EfiAcquireLock (&Instance->PendingQueueLock);
+    QueueEmpty = IsListEmpty (&Instance->PendingQueue);
+    EfiReleaseLock (&Instance->PendingQueueLock);
+    if (QueueEmpty) {
+      break;
     }
+
+    DiskIoDispatchSubtasks (Instance);
+  }
+}
+
+/**
+  Abort all the pending subtasks, signaling their tokens with EFI_ABORTED.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoAbortPendingSubtasks (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  LIST_ENTRY       Aborted;
+  LIST_ENTRY       *Link;
+  DISK_IO_SUBTASK  *Subtask;
+
+  InitializeListHead (&Aborted);
+
+  EfiAcquireLock (&Instance->PendingQueueLock);
+  while (!IsListEmpty (&Instance->PendingQueue)) {
+    Link = GetFirstNode (&Instance->PendingQueue);
+    RemoveEntryList (Link);
+    InsertTailList (&Aborted, Link);
+    Instance->Statistics.Dropped++;
+  }
+
+  Instance->Pending = 0;
+  EfiReleaseLock (&Instance->PendingQueueLock);
+
+  while (!IsListEmpty (&Aborted)) {
+    Link    = GetFirstNode (&Aborted);
+    Subtask = CR (Link, DISK_IO_SUBTASK, QueueLink, DISK_IO_SUBTASK_SIGNATURE);
+    RemoveEntryList (Link);
+    DiskIo2FinishSubtask (Instance, Subtask, NULL, EFI_ABORTED);
   }
 }
 
@@ -491,6 +1037,7 @@ DiskIoCreateSubtask (
   Subtask->WorkingBuffer = WorkingBuffer;
   Subtask->Buffer        = Buffer;
   Subtask->Blocking      = Blocking;
+  InitializeListHead (&Subtask->MergedSubtasks);
   if (!Blocking) {
     Status = gBS->CreateEvent (
                     EVT_NOTIFY_SIGNAL,
@@ -838,22 +1385,19 @@ DiskIo2ReadWriteDisk (
   )
 {
   EFI_STATUS              Status;
-  EFI_BLOCK_IO_PROTOCOL   *BlockIo;
-  EFI_BLOCK_IO2_PROTOCOL  *BlockIo2;
-  EFI_BLOCK_IO_MEDIA      *Media;
-  LIST_ENTRY              *Link;
-  LIST_ENTRY              *NextLink;
-  LIST_ENTRY              Subtasks;
-  DISK_IO_SUBTASK         *Subtask;
-  DISK_IO2_TASK           *Task;
-  EFI_TPL                 OldTpl;
-  BOOLEAN                 Blocking;
-  BOOLEAN                 SubtaskBlocking;
-  LIST_ENTRY              *SubtasksPtr;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  EFI_BLOCK_IO_MEDIA     *Media;
+  LIST_ENTRY             *Link;
+  LIST_ENTRY             *NextLink;
+  LIST_ENTRY             Subtasks;
+  DISK_IO_SUBTASK        *Subtask;
+  DISK_IO2_TASK          *Task;
+  EFI_TPL                OldTpl;
+  BOOLEAN                Blocking;
+  LIST_ENTRY             *SubtasksPtr;
 
   Task     = NULL;
   BlockIo  = Instance->BlockIo;
-  BlockIo2 = Instance->BlockIo2;
   Media    = BlockIo->Media;
   Status   = EFI_SUCCESS;
   Blocking = (BOOLEAN)((Token == NULL) || (Token->Event == NULL));
@@ -861,8 +1405,11 @@ DiskIo2ReadWriteDisk (
   if (Blocking) {
     //
     // Wait till pending async task is completed.
+    // The queued subtasks are issued here because the dispatcher
+    // doesn't run when the caller is at TPL_CALLBACK.
     //
     while (!DiskIo2RemoveCompletedTask (Instance)) {
+      DiskIoDispatchSubtasks (Instance);
     }
 
     SubtasksPtr = &Subtasks;
@@ -902,81 +1449,81 @@ DiskIo2ReadWriteDisk (
         ; Link = NextLink, NextLink = GetNextNode (SubtasksPtr, NextLink)
         )
   {
-    Subtask         = CR (Link, DISK_IO_SUBTASK, Link, DISK_IO_SUBTASK_SIGNATURE);
-    Subtask->Task   = Task;
-    SubtaskBlocking = Subtask->Blocking;
+    Subtask          = CR (Link, DISK_IO_SUBTASK, Link, DISK_IO_SUBTASK_SIGNATURE);
+    Subtask->Task    = Task;
+    Subtask->MediaId = MediaId;
 
     ASSERT ((Subtask->Length % Media->BlockSize == 0) || (Subtask->Length < Media->BlockSize));
 
-    if (Subtask->Write) {
+    if (Subtask->Write && (Subtask->WorkingBuffer != NULL)) {
       //
-      // Write
+      // A sub task before this one should be a block read operation, causing the WorkingBuffer filled with the entire one block data.
       //
-      if (Subtask->WorkingBuffer != NULL) {
+      CopyMem (Subtask->WorkingBuffer + Subtask->Offset, Subtask->Buffer, Subtask->Length);
+    }
+
+    if (!Subtask->Blocking) {
+      if (Subtask->Write) {
+        DiskIoCacheUpdate (Instance, Subtask->Lba, DiskIoSubtaskIoSize (Instance, Subtask), NULL);
+      } else if ((Subtask->Length != 0) &&
+                 DiskIoCacheLookup (
+                   Instance,
+                   MediaId,
+                   Subtask->Lba,
+                   DiskIoSubtaskIoSize (Instance, Subtask),
+                   (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
+                   ))
+      {
         //
-        // A sub task before this one should be a block read operation, causing the WorkingBuffer filled with the entire one block data.
+        // All the blocks are cached, no need to go to the device.
         //
-        CopyMem (Subtask->WorkingBuffer + Subtask->Offset, Subtask->Buffer, Subtask->Length);
+        DiskIo2FinishSubtask (Instance, Subtask, Subtask->WorkingBuffer, EFI_SUCCESS);
+        continue;
       }
 
-      if (SubtaskBlocking) {
-        Status = BlockIo->WriteBlocks (
-                            BlockIo,
-                            MediaId,
-                            Subtask->Lba,
-                            (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
-                            (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
-                            );
-      } else {
-        Status = BlockIo2->WriteBlocksEx (
-                             BlockIo2,
-                             MediaId,
-                             Subtask->Lba,
-                             &Subtask->BlockIo2Token,
-                             (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
-                             (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
-                             );
-      }
-    } else {
       //
-      // Read
+      // Leave the non-blocking subtask to the dispatcher, which may merge it
+      // with the adjacent ones and holds it while the device is busy.
       //
-      if (SubtaskBlocking) {
-        Status = BlockIo->ReadBlocks (
-                            BlockIo,
-                            MediaId,
-                            Subtask->Lba,
-                            (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
-                            (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
-                            );
-        if (!EFI_ERROR (Status) && (Subtask->WorkingBuffer != NULL)) {
-          CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
-        }
-      } else {
-        Status = BlockIo2->ReadBlocksEx (
-                             BlockIo2,
-                             MediaId,
-                             Subtask->Lba,
-                             &Subtask->BlockIo2Token,
-                             (Subtask->Length % Media->BlockSize == 0) ? Subtask->Length : Media->BlockSize,
-                             (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
-                             );
-      }
+      DiskIoQueueSubtask (Instance, Subtask);
+      continue;
     }
 
-    if (SubtaskBlocking || EFI_ERROR (Status)) {
-      //
-      // Make sure the subtask list only contains non-blocking subtasks.
-      // Remove failed non-blocking subtasks as well because the callback won't be called.
-      //
-      DiskIoDestroySubtask (Instance, Subtask);
+    if (Subtask->Write) {
+      Status = DiskIoCacheWriteBlocks (
+                 Instance,
+                 MediaId,
+                 Subtask->Lba,
+                 DiskIoSubtaskIoSize (Instance, Subtask),
+                 (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
+                 );
+    } else {
+      Status = DiskIoCacheReadBlocks (
+                 Instance,
+                 MediaId,
+                 Subtask->Lba,
+                 DiskIoSubtaskIoSize (Instance, Subtask),
+                 (Subtask->WorkingBuffer != NULL) ? Subtask->WorkingBuffer : Subtask->Buffer
+                 );
+      if (!EFI_ERROR (Status) && (Subtask->WorkingBuffer != NULL)) {
+        CopyMem (Subtask->Buffer, Subtask->WorkingBuffer + Subtask->Offset, Subtask->Length);
+      }
     }
 
+    //
+    // Make sure the subtask list only contains non-blocking subtasks.
+    //
+    DiskIoDestroySubtask (Instance, Subtask);
+
     if (EFI_ERROR (Status)) {
       break;
     }
   }
 
+  if (!Blocking) {
+    DiskIoDispatchSubtasks (Instance);
+  }
+
   gBS->RaiseTPL (TPL_NOTIFY);
 
   //
@@ -1158,6 +1705,11 @@ DiskIo2FlushDiskEx (
 
   Private = DISK_IO_PRIVATE_DATA_FROM_DISK_IO2 (This);
 
+  //
+  // Issue the queued writes first so that they are covered by the flush.
+  //
+  DiskIoDrainPendingQueue (Private);
+
   if ((Token != NULL) && (Token->Event != NULL)) {
     Task = AllocatePool (sizeof (DISK_IO2_FLUSH_TASK));
     if (Task == NULL) {
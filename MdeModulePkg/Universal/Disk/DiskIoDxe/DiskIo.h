@@ -16,6 +16,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/DiskIo.h>
+#include <Protocol/BlockCache.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiLib.h>
@@ -24,22 +25,90 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// The largest BlockIo2 read that adjacent queued reads are merged into.
+//
+#define DISK_IO_MAX_MERGE_SIZE  SIZE_1MB
+
+///
+/// Statistics of the queue of the non-blocking requests to a device.
+///
+typedef struct {
+  UINT64    Queued;                             /// < non-blocking subtasks queued
+  UINT64    Issued;                             /// < BlockIo2 requests issued
+  UINT64    Merged;                             /// < subtasks merged into the read of another one
+  UINT64    Dropped;                            /// < subtasks of aborted tasks never issued
+  UINT32    MaxPending;
+  UINT32    MaxInFlight;
+} DISK_IO_QUEUE_STATISTICS;
+
+//
+// The blocks are cached in lines of 32KB, or of one block if the block is larger.
+// The sequential reads are read ahead by 4 lines, and the reads larger than
+// that bypass the cache.
+//
+#define DISK_IO_CACHE_LINE_SIZE         SIZE_32KB
+#define DISK_IO_CACHE_READ_AHEAD_LINES  4
+#define DISK_IO_CACHE_HASH_SIZE         64
+
+typedef struct {
+  LIST_ENTRY    HashLink;
+  LIST_ENTRY    LruLink;
+  UINT64        Line;                           /// < LBA of the first block divided by the blocks per line
+  UINT32        Blocks;                         /// < number of cached blocks, 0 if the line is free
+  BOOLEAN       ReadAhead;                      /// < read ahead, and not requested since
+  UINT8         *Data;
+} DISK_IO_CACHE_LINE;
+
+typedef struct {
+  UINT32                          MediaId;
+  UINT32                          BlockSize;
+  UINT32                          LineBlocks;
+  UINTN                           LineSize;
+  UINTN                           LineCount;
+  UINTN                           ReadAheadLines;
+  UINT8                           *Buffer;      /// < data of all the lines
+  UINT8                           *ReadAheadBuffer;
+  DISK_IO_CACHE_LINE              *Lines;
+  LIST_ENTRY                      Lru;          /// < lines in the order of use, the most recent first
+  LIST_ENTRY                      Hash[DISK_IO_CACHE_HASH_SIZE];
+  UINT64                          NextLine;     /// < the line following the last read, to detect sequential reads
+  BOOLEAN                         MediaChanged; /// < the device reported the medium changed or removed
+  EDKII_BLOCK_CACHE_STATISTICS    Statistics;
+} DISK_IO_CACHE;
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
-  UINT32                    Signature;
+  UINT32                        Signature;
 
-  EFI_DISK_IO_PROTOCOL      DiskIo;
-  EFI_DISK_IO2_PROTOCOL     DiskIo2;
-  EFI_BLOCK_IO_PROTOCOL     *BlockIo;
-  EFI_BLOCK_IO2_PROTOCOL    *BlockIo2;
+  EFI_DISK_IO_PROTOCOL          DiskIo;
+  EFI_DISK_IO2_PROTOCOL         DiskIo2;
+  EDKII_BLOCK_CACHE_PROTOCOL    BlockCache;
+  EFI_BLOCK_IO_PROTOCOL         *BlockIo;
+  EFI_BLOCK_IO2_PROTOCOL        *BlockIo2;
 
-  UINT8                     *SharedWorkingBuffer;
+  UINT8                         *SharedWorkingBuffer;
 
-  EFI_LOCK                  TaskQueueLock;
-  LIST_ENTRY                TaskQueue;
+  EFI_LOCK                      TaskQueueLock;
+  LIST_ENTRY                    TaskQueue;
+
+  //
+  // Non-blocking subtasks waiting for BlockIo2, see DiskIoQueueSubtask()
+  //
+  EFI_LOCK                      PendingQueueLock;
+  LIST_ENTRY                    PendingQueue;
+  UINT32                        Pending;
+  UINT32                        InFlight;
+  UINT32                        QueueDepth;       /// < max BlockIo2 requests in flight
+  UINT64                        NextLba;          /// < the LBA following the last issued request
+  EFI_EVENT                     DispatchEvent;
+  DISK_IO_QUEUE_STATISTICS      Statistics;
+
+  DISK_IO_CACHE                 *Cache;           /// < NULL if the blocks are not cached
 } DISK_IO_PRIVATE_DATA;
-#define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
-#define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
+#define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)      CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
+#define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)     CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
+#define DISK_IO_PRIVATE_DATA_FROM_BLOCK_CACHE(a)  CR (a, DISK_IO_PRIVATE_DATA, BlockCache, DISK_IO_PRIVATE_DATA_SIGNATURE)
 
 #define DISK_IO2_TASK_SIGNATURE  SIGNATURE_32 ('d', 'i', 'a', 't')
 typedef struct {
@@ -80,6 +149,11 @@ typedef struct {
   //
   DISK_IO2_TASK          *Task;
   EFI_BLOCK_IO2_TOKEN    BlockIo2Token;
+  UINT32                 MediaId;
+  LIST_ENTRY             QueueLink;               /// < link in the pending queue, or in MergedSubtasks of another subtask
+  LIST_ENTRY             MergedSubtasks;          /// < subtasks whose data come along with the read of this one
+  UINT8                  *MergeBuffer;            /// < the buffer of the merged read, NULL if not merged
+  UINTN                  MergeLength;
 } DISK_IO_SUBTASK;
 
 //
@@ -335,6 +409,181 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN  *Token
   );
 
+/**
+  The notification function of the DispatchEvent, which is signaled when a
+  BlockIo2 request completes.
+
+  @param  Event                 Event whose notification function is being invoked.
+  @param  Context               The pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+EFIAPI
+DiskIoOnDispatch (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Abort all the pending subtasks, signaling their tokens with EFI_ABORTED.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoAbortPendingSubtasks (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+//
+// Block cache functions
+//
+
+/**
+  Create the block cache of the device.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param CacheSize    The size of the cache in bytes.
+
+  @retval EFI_SUCCESS           The cache is created.
+  @retval EFI_UNSUPPORTED       The cache is too small for the device.
+  @retval EFI_OUT_OF_RESOURCES  The cache could not be allocated.
+**/
+EFI_STATUS
+DiskIoCacheCreate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINTN                 CacheSize
+  );
+
+/**
+  Destroy the block cache of the device.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  );
+
+/**
+  Read the blocks through the cache. This replaces BlockIo ReadBlocks.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to read.
+  @param Lba          The LBA of the first block to read.
+  @param BufferSize   The size of Buffer in bytes, a multiple of the block size.
+  @param Buffer       The buffer to read the blocks into.
+
+  @return The status returned by BlockIo ReadBlocks.
+**/
+EFI_STATUS
+DiskIoCacheReadBlocks (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Lba,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  );
+
+/**
+  Write the blocks through the cache. This replaces BlockIo WriteBlocks.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to write.
+  @param Lba          The LBA of the first block to write.
+  @param BufferSize   The size of Buffer in bytes, a multiple of the block size.
+  @param Buffer       The data to write.
+
+  @return The status returned by BlockIo WriteBlocks.
+**/
+EFI_STATUS
+DiskIoCacheWriteBlocks (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId,
+  IN UINT64                Lba,
+  IN UINTN                 BufferSize,
+  IN VOID                  *Buffer
+  );
+
+/**
+  Read the blocks from the cache if they are all cached.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to read.
+  @param Lba          The LBA of the first block to read.
+  @param BufferSize   The size of Buffer in bytes, a multiple of the block size.
+  @param Buffer       The buffer to read the blocks into.
+
+  @retval TRUE        The blocks are read from the cache.
+  @retval FALSE       Some of the blocks are not cached, and nothing is read.
+**/
+BOOLEAN
+DiskIoCacheLookup (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Lba,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  );
+
+/**
+  Note that the medium is changed or removed, if the device says so. The cache
+  is dropped on the next access.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Status       The status returned by the device.
+**/
+VOID
+DiskIoCacheCheckMedia (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN EFI_STATUS            Status
+  );
+
+/**
+  Update or drop the cached lines overlapping the written blocks.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Lba          The LBA of the first block written.
+  @param BufferSize   The size of Buffer in bytes.
+  @param Buffer       The data written, or NULL to drop the lines.
+**/
+VOID
+DiskIoCacheUpdate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Lba,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer OPTIONAL
+  );
+
+/**
+  Drop all the blocks in the cache.
+
+  @param[in]  This              Pointer to the EDKII_BLOCK_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The cache is invalidated.
+
+**/
+EFI_STATUS
+EFIAPI
+DiskIoBlockCacheInvalidate (
+  IN EDKII_BLOCK_CACHE_PROTOCOL  *This
+  );
+
+/**
+  Get the statistics of the cache.
+
+  @param[in]  This              Pointer to the EDKII_BLOCK_CACHE_PROTOCOL instance.
+  @param[out] Statistics        The statistics of the cache.
+
+  @retval EFI_SUCCESS           The statistics are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+DiskIoBlockCacheGetStatistics (
+  IN  EDKII_BLOCK_CACHE_PROTOCOL    *This,
+  OUT EDKII_BLOCK_CACHE_STATISTICS  *Statistics
+  );
+
 //
 // EFI Component Name Functions
 //
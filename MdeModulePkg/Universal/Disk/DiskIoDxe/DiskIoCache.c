@@ -0,0 +1,702 @@
+/** @file
+  Block cache of the DiskIo driver.
+
+  The blocks of a physical block device are cached in lines of a fixed number
+  of blocks, which are looked up by a hash of the line number and evicted in
+  the least recently used order. A miss of a sequential read reads the lines
+  ahead of the request along with it, in one Block I/O request.
+
+  The cache is dropped when the MediaId of the medium changes, or the device
+  returns EFI_MEDIA_CHANGED or EFI_NO_MEDIA, so removable media are cached as
+  well.
+
+  The cache is filled by the blocking reads only. All the blocking reads wait
+  for the non-blocking requests to complete, and the non-blocking writes drop
+  the lines they overlap when they are queued, so the cache never holds data
+  older than the device. The blocking writes are written through.
+
+  All the accesses to the cache are made at TPL_CALLBACK.
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DiskIo.h"
+
+/**
+  Find the cached line.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param Line         The number of the line.
+
+  @return The cached line, or NULL if the line is not cached.
+**/
+DISK_IO_CACHE_LINE *
+DiskIoCacheFindLine (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Line
+  )
+{
+  LIST_ENTRY          *Bucket;
+  LIST_ENTRY          *Link;
+  DISK_IO_CACHE_LINE  *CacheLine;
+
+  Bucket = &Cache->Hash[(UINTN)Line % DISK_IO_CACHE_HASH_SIZE];
+  for (Link = GetFirstNode (Bucket); !IsNull (Bucket, Link); Link = GetNextNode (Bucket, Link)) {
+    CacheLine = BASE_CR (Link, DISK_IO_CACHE_LINE, HashLink);
+    if (CacheLine->Line == Line) {
+      return CacheLine;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop the cached line, and move it to the end of the LRU list to be reused first.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param CacheLine    The cached line.
+**/
+VOID
+DiskIoCacheDropLine (
+  IN DISK_IO_CACHE       *Cache,
+  IN DISK_IO_CACHE_LINE  *CacheLine
+  )
+{
+  if (CacheLine->Blocks != 0) {
+    RemoveEntryList (&CacheLine->HashLink);
+    CacheLine->Blocks = 0;
+  }
+
+  RemoveEntryList (&CacheLine->LruLink);
+  InsertTailList (&Cache->Lru, &CacheLine->LruLink);
+}
+
+/**
+  Drop all the cached lines.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+**/
+VOID
+DiskIoCacheDropAll (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Cache->LineCount; Index++) {
+    DiskIoCacheDropLine (Cache, &Cache->Lines[Index]);
+  }
+}
+
+/**
+  Note that the medium is changed or removed, if the device says so. The cache
+  is dropped on the next access.
+
+  This may be called from the completion of a non-blocking request, so only
+  the flag is set here.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Status       The status returned by the device.
+**/
+VOID
+DiskIoCacheCheckMedia (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN EFI_STATUS            Status
+  )
+{
+  if ((Instance->Cache != NULL) && ((Status == EFI_MEDIA_CHANGED) || (Status == EFI_NO_MEDIA))) {
+    Instance->Cache->MediaChanged = TRUE;
+  }
+}
+
+/**
+  Check whether the cache can be used for the access to the medium.
+  The cache is dropped when the MediaId is changed, or the device reported
+  the medium changed or removed.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to access.
+
+  @retval TRUE        The cache can be used.
+  @retval FALSE       The cache can't be used, and the access should go to the device.
+**/
+BOOLEAN
+DiskIoCacheUsable (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+
+  Cache = Instance->Cache;
+  Media = Instance->BlockIo->Media;
+  if (Cache == NULL) {
+    return FALSE;
+  }
+
+  if (Cache->MediaChanged || !Media->MediaPresent || (Media->MediaId != Cache->MediaId)) {
+    Cache->MediaChanged = FALSE;
+    DiskIoCacheDropAll (Cache);
+    Cache->MediaId  = Media->MediaId;
+    Cache->NextLine = MAX_UINT64;
+  }
+
+  return (BOOLEAN)(Media->MediaPresent && (Media->MediaId == MediaId) && (Media->BlockSize == Cache->BlockSize));
+}
+
+/**
+  Read the lines from the device into the cache, evicting the least recently
+  used lines. The lines must not be cached.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to read.
+  @param Line         The number of the first line to read.
+  @param Count        The number of lines to read, not more than ReadAheadLines.
+  @param Requested    The number of lines requested, the others are read ahead.
+
+  @return The status returned by BlockIo ReadBlocks.
+**/
+EFI_STATUS
+DiskIoCacheFill (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId,
+  IN UINT64                Line,
+  IN UINTN                 Count,
+  IN UINTN                 Requested
+  )
+{
+  EFI_STATUS          Status;
+  DISK_IO_CACHE       *Cache;
+  DISK_IO_CACHE_LINE  *CacheLine;
+  UINT64              Lba;
+  UINT64              Blocks;
+  UINTN               Index;
+
+  Cache = Instance->Cache;
+  ASSERT (Count <= Cache->ReadAheadLines);
+
+  //
+  // The last line of the medium may be partial.
+  //
+  Lba    = MultU64x32 (Line, Cache->LineBlocks);
+  Blocks = MIN (MultU64x32 (Count, Cache->LineBlocks), Instance->BlockIo->Media->LastBlock + 1 - Lba);
+
+  Status = Instance->BlockIo->ReadBlocks (
+                                Instance->BlockIo,
+                                MediaId,
+                                Lba,
+                                (UINTN)Blocks * Cache->BlockSize,
+                                Cache->ReadAheadBuffer
+                                );
+  if (EFI_ERROR (Status)) {
+    DiskIoCacheCheckMedia (Instance, Status);
+    return Status;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    CacheLine = BASE_CR (GetPreviousNode (&Cache->Lru, &Cache->Lru), DISK_IO_CACHE_LINE, LruLink);
+    if (CacheLine->Blocks != 0) {
+      Cache->Statistics.Evictions++;
+    }
+
+    DiskIoCacheDropLine (Cache, CacheLine);
+
+    CacheLine->Line      = Line + Index;
+    CacheLine->Blocks    = (UINT32)MIN (Blocks - MultU64x32 (Index, Cache->LineBlocks), Cache->LineBlocks);
+    CacheLine->ReadAhead = (BOOLEAN)(Index >= Requested);
+    CopyMem (CacheLine->Data, Cache->ReadAheadBuffer + Index * Cache->LineSize, CacheLine->Blocks * Cache->BlockSize);
+
+    InsertHeadList (&Cache->Hash[(UINTN)CacheLine->Line % DISK_IO_CACHE_HASH_SIZE], &CacheLine->HashLink);
+    RemoveEntryList (&CacheLine->LruLink);
+    InsertHeadList (&Cache->Lru, &CacheLine->LruLink);
+  }
+
+  Cache->Statistics.Misses     += MIN (Count, Requested);
+  Cache->Statistics.ReadAheads += Count - MIN (Count, Requested);
+  return EFI_SUCCESS;
+}
+
+/**
+  Count a request of a cached line. The first request of a line read ahead
+  is counted apart from the hits, as the line was read with a miss before.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param CacheLine    The cached line.
+**/
+VOID
+DiskIoCacheCountHit (
+  IN DISK_IO_CACHE       *Cache,
+  IN DISK_IO_CACHE_LINE  *CacheLine
+  )
+{
+  if (CacheLine->ReadAhead) {
+    CacheLine->ReadAhead = FALSE;
+    Cache->Statistics.ReadAheadHits++;
+  } else {
+    Cache->Statistics.Hits++;
+  }
+}
+
+/**
+  Copy the blocks of the request held by the cached line to the buffer, and
+  mark the line most recently used.
+
+  @param Cache        Pointer to the DISK_IO_CACHE.
+  @param CacheLine    The cached line.
+  @param Lba          The LBA of the first block of the request.
+  @param Blocks       The number of blocks of the request.
+  @param Buffer       The buffer of the request.
+**/
+VOID
+DiskIoCacheCopyFromLine (
+  IN  DISK_IO_CACHE       *Cache,
+  IN  DISK_IO_CACHE_LINE  *CacheLine,
+  IN  UINT64              Lba,
+  IN  UINTN               Blocks,
+  OUT UINT8               *Buffer
+  )
+{
+  UINT64  LineLba;
+  UINT64  Start;
+  UINT64  End;
+
+  LineLba = MultU64x32 (CacheLine->Line, Cache->LineBlocks);
+  Start   = MAX (Lba, LineLba);
+  End     = MIN (Lba + Blocks, LineLba + CacheLine->Blocks);
+  if (End > Start) {
+    CopyMem (
+      Buffer + (UINTN)(Start - Lba) * Cache->BlockSize,
+      CacheLine->Data + (UINTN)(Start - LineLba) * Cache->BlockSize,
+      (UINTN)(End - Start) * Cache->BlockSize
+      );
+  }
+
+  RemoveEntryList (&CacheLine->LruLink);
+  InsertHeadList (&Cache->Lru, &CacheLine->LruLink);
+}
+
+/**
+  Check whether the blocks are in range of the medium and the size of the
+  request is small enough to go through the cache.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Lba          The LBA of the first block.
+  @param BufferSize   The size of the request in bytes.
+
+  @retval TRUE        The request can go through the cache.
+  @retval FALSE       The request should go to the device.
+**/
+BOOLEAN
+DiskIoCacheCoverable (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Lba,
+  IN UINTN                 BufferSize
+  )
+{
+  DISK_IO_CACHE  *Cache;
+
+  Cache = Instance->Cache;
+  return (BOOLEAN)((BufferSize != 0) &&
+                   (BufferSize % Cache->BlockSize == 0) &&
+                   (BufferSize <= Cache->ReadAheadLines * Cache->LineSize) &&
+                   (Lba + BufferSize / Cache->BlockSize - 1 <= Instance->BlockIo->Media->LastBlock)
+                   );
+}
+
+/**
+  Read the blocks through the cache. This replaces BlockIo ReadBlocks.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to read.
+  @param Lba          The LBA of the first block to read.
+  @param BufferSize   The size of Buffer in bytes, a multiple of the block size.
+  @param Buffer       The buffer to read the blocks into.
+
+  @return The status returned by BlockIo ReadBlocks.
+**/
+EFI_STATUS
+DiskIoCacheReadBlocks (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Lba,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  )
+{
+  EFI_STATUS          Status;
+  DISK_IO_CACHE       *Cache;
+  DISK_IO_CACHE_LINE  *CacheLine;
+  UINTN               Blocks;
+  UINT64              Line;
+  UINT64              FirstLine;
+  UINT64              LastLine;
+  UINT64              MediaLastLine;
+  UINTN               Count;
+  BOOLEAN             Sequential;
+
+  Cache = Instance->Cache;
+  if (!DiskIoCacheUsable (Instance, MediaId) || !DiskIoCacheCoverable (Instance, Lba, BufferSize)) {
+    Status = Instance->BlockIo->ReadBlocks (Instance->BlockIo, MediaId, Lba, BufferSize, Buffer);
+    DiskIoCacheCheckMedia (Instance, Status);
+    return Status;
+  }
+
+  Blocks        = BufferSize / Cache->BlockSize;
+  FirstLine     = DivU64x32 (Lba, Cache->LineBlocks);
+  LastLine      = DivU64x32 (Lba + Blocks - 1, Cache->LineBlocks);
+  MediaLastLine = DivU64x32 (Instance->BlockIo->Media->LastBlock, Cache->LineBlocks);
+
+  //
+  // A read is sequential when it starts in the line the last read ended in,
+  // or in the one following it.
+  //
+  Sequential = (BOOLEAN)((FirstLine == Cache->NextLine) || (FirstLine + 1 == Cache->NextLine));
+
+  for (Line = FirstLine; Line <= LastLine; Line++) {
+    CacheLine = DiskIoCacheFindLine (Cache, Line);
+    if (CacheLine != NULL) {
+      DiskIoCacheCountHit (Cache, CacheLine);
+    } else {
+      //
+      // Read the missing lines of the request in one go, and the lines
+      // following them as well if the read is sequential.
+      //
+      for (Count = 1; Count < Cache->ReadAheadLines; Count++) {
+        if ((Line + Count > MediaLastLine) ||
+            ((Line + Count > LastLine) && !Sequential) ||
+            (DiskIoCacheFindLine (Cache, Line + Count) != NULL))
+        {
+          break;
+        }
+      }
+
+      Status = DiskIoCacheFill (Instance, MediaId, Line, Count, (UINTN)(LastLine - Line + 1));
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+
+      CacheLine = DiskIoCacheFindLine (Cache, Line);
+      ASSERT (CacheLine != NULL);
+    }
+
+    DiskIoCacheCopyFromLine (Cache, CacheLine, Lba, Blocks, Buffer);
+  }
+
+  Cache->NextLine = LastLine + 1;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the blocks from the cache if they are all cached.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to read.
+  @param Lba          The LBA of the first block to read.
+  @param BufferSize   The size of Buffer in bytes, a multiple of the block size.
+  @param Buffer       The buffer to read the blocks into.
+
+  @retval TRUE        The blocks are read from the cache.
+  @retval FALSE       Some of the blocks are not cached, and nothing is read.
+**/
+BOOLEAN
+DiskIoCacheLookup (
+  IN  DISK_IO_PRIVATE_DATA  *Instance,
+  IN  UINT32                MediaId,
+  IN  UINT64                Lba,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  DISK_IO_CACHE_LINE  *CacheLine;
+  UINTN               Blocks;
+  UINT64              Line;
+  UINT64              FirstLine;
+  UINT64              LastLine;
+
+  Cache = Instance->Cache;
+  if (!DiskIoCacheUsable (Instance, MediaId) || !DiskIoCacheCoverable (Instance, Lba, BufferSize)) {
+    return FALSE;
+  }
+
+  Blocks    = BufferSize / Cache->BlockSize;
+  FirstLine = DivU64x32 (Lba, Cache->LineBlocks);
+  LastLine  = DivU64x32 (Lba + Blocks - 1, Cache->LineBlocks);
+
+  for (Line = FirstLine; Line <= LastLine; Line++) {
+    if (DiskIoCacheFindLine (Cache, Line) == NULL) {
+      return FALSE;
+    }
+  }
+
+  for (Line = FirstLine; Line <= LastLine; Line++) {
+    CacheLine = DiskIoCacheFindLine (Cache, Line);
+    DiskIoCacheCountHit (Cache, CacheLine);
+    DiskIoCacheCopyFromLine (Cache, CacheLine, Lba, Blocks, Buffer);
+  }
+
+  Cache->NextLine = LastLine + 1;
+  return TRUE;
+}
+
+/**
+  Update or drop the cached lines overlapping the written blocks.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param Lba          The LBA of the first block written.
+  @param BufferSize   The size of Buffer in bytes.
+  @param Buffer       The data written, or NULL to drop the lines.
+**/
+VOID
+DiskIoCacheUpdate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT64                Lba,
+  IN UINTN                 BufferSize,
+  IN UINT8                 *Buffer OPTIONAL
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  DISK_IO_CACHE_LINE  *CacheLine;
+  UINTN               Index;
+  UINT64              LineLba;
+  UINT64              Start;
+  UINT64              End;
+
+  Cache = Instance->Cache;
+  if ((Cache == NULL) || (BufferSize == 0)) {
+    return;
+  }
+
+  End = Lba + (BufferSize + Cache->BlockSize - 1) / Cache->BlockSize;
+
+  //
+  // Go through the lines rather than the LBAs, which may be many more.
+  //
+  for (Index = 0; Index < Cache->LineCount; Index++) {
+    CacheLine = &Cache->Lines[Index];
+    if (CacheLine->Blocks == 0) {
+      continue;
+    }
+
+    LineLba = MultU64x32 (CacheLine->Line, Cache->LineBlocks);
+    if ((LineLba + CacheLine->Blocks <= Lba) || (LineLba >= End)) {
+      continue;
+    }
+
+    if ((Buffer == NULL) || (BufferSize % Cache->BlockSize != 0)) {
+      DiskIoCacheDropLine (Cache, CacheLine);
+    } else {
+      Start = MAX (Lba, LineLba);
+      CopyMem (
+        CacheLine->Data + (UINTN)(Start - LineLba) * Cache->BlockSize,
+        Buffer + (UINTN)(Start - Lba) * Cache->BlockSize,
+        (UINTN)(MIN (End, LineLba + CacheLine->Blocks) - Start) * Cache->BlockSize
+        );
+    }
+  }
+}
+
+/**
+  Write the blocks through the cache. This replaces BlockIo WriteBlocks.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param MediaId      ID of the medium to write.
+  @param Lba          The LBA of the first block to write.
+  @param BufferSize   The size of Buffer in bytes, a multiple of the block size.
+  @param Buffer       The data to write.
+
+  @return The status returned by BlockIo WriteBlocks.
+**/
+EFI_STATUS
+DiskIoCacheWriteBlocks (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINT32                MediaId,
+  IN UINT64                Lba,
+  IN UINTN                 BufferSize,
+  IN VOID                  *Buffer
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = Instance->BlockIo->WriteBlocks (Instance->BlockIo, MediaId, Lba, BufferSize, Buffer);
+  DiskIoCacheCheckMedia (Instance, Status);
+  if (DiskIoCacheUsable (Instance, MediaId)) {
+    //
+    // The blocks may be partially written on failure.
+    //
+    DiskIoCacheUpdate (Instance, Lba, BufferSize, EFI_ERROR (Status) ? NULL : Buffer);
+  }
+
+  return Status;
+}
+
+/**
+  Create the block cache of the device.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+  @param CacheSize    The size of the cache in bytes.
+
+  @retval EFI_SUCCESS           The cache is created.
+  @retval EFI_UNSUPPORTED       The cache is too small for the device.
+  @retval EFI_OUT_OF_RESOURCES  The cache could not be allocated.
+**/
+EFI_STATUS
+DiskIoCacheCreate (
+  IN DISK_IO_PRIVATE_DATA  *Instance,
+  IN UINTN                 CacheSize
+  )
+{
+  DISK_IO_CACHE       *Cache;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  UINT32              IoAlign;
+  UINTN               Index;
+
+  Media   = Instance->BlockIo->Media;
+  IoAlign = MAX (Media->IoAlign, 1);
+
+  Cache = AllocateZeroPool (sizeof (DISK_IO_CACHE));
+  if (Cache == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cache->MediaId        = Media->MediaId;
+  Cache->BlockSize      = Media->BlockSize;
+  Cache->LineBlocks     = MAX (DISK_IO_CACHE_LINE_SIZE / Media->BlockSize, 1);
+  Cache->LineSize       = Cache->LineBlocks * Media->BlockSize;
+  Cache->LineCount      = CacheSize / Cache->LineSize;
+  Cache->ReadAheadLines = DISK_IO_CACHE_READ_AHEAD_LINES;
+  if (Cache->LineCount < Cache->ReadAheadLines) {
+    FreePool (Cache);
+    return EFI_UNSUPPORTED;
+  }
+
+  Cache->Buffer          = AllocateAlignedPages (EFI_SIZE_TO_PAGES (Cache->LineCount * Cache->LineSize), IoAlign);
+  Cache->ReadAheadBuffer = AllocateAlignedPages (EFI_SIZE_TO_PAGES (Cache->ReadAheadLines * Cache->LineSize), IoAlign);
+  Cache->Lines           = AllocateZeroPool (Cache->LineCount * sizeof (DISK_IO_CACHE_LINE));
+  if ((Cache->Buffer == NULL) || (Cache->ReadAheadBuffer == NULL) || (Cache->Lines == NULL)) {
+    Instance->Cache = Cache;
+    DiskIoCacheDestroy (Instance);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  InitializeListHead (&Cache->Lru);
+  for (Index = 0; Index < DISK_IO_CACHE_HASH_SIZE; Index++) {
+    InitializeListHead (&Cache->Hash[Index]);
+  }
+
+  for (Index = 0; Index < Cache->LineCount; Index++) {
+    Cache->Lines[Index].Data = Cache->Buffer + Index * Cache->LineSize;
+    InsertTailList (&Cache->Lru, &Cache->Lines[Index].LruLink);
+  }
+
+  Cache->NextLine             = MAX_UINT64;
+  Cache->Statistics.CacheSize = Cache->LineCount * Cache->LineSize;
+  Cache->Statistics.LineSize  = (UINT32)Cache->LineSize;
+
+  Instance->Cache = Cache;
+  return EFI_SUCCESS;
+}
+
+/**
+  Destroy the block cache of the device.
+
+  @param Instance     Pointer to the DISK_IO_PRIVATE_DATA.
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_PRIVATE_DATA  *Instance
+  )
+{
+  DISK_IO_CACHE  *Cache;
+
+  Cache = Instance->Cache;
+  if (Cache == NULL) {
+    return;
+  }
+
+  if (Cache->Buffer != NULL) {
+    FreeAlignedPages (Cache->Buffer, EFI_SIZE_TO_PAGES (Cache->LineCount * Cache->LineSize));
+  }
+
+  if (Cache->ReadAheadBuffer != NULL) {
+    FreeAlignedPages (Cache->ReadAheadBuffer, EFI_SIZE_TO_PAGES (Cache->ReadAheadLines * Cache->LineSize));
+  }
+
+  if (Cache->Lines != NULL) {
+    FreePool (Cache->Lines);
+  }
+
+  FreePool (Cache);
+  Instance->Cache = NULL;
+}
+
+/**
+  Drop all the blocks in the cache.
+
+  @param[in]  This              Pointer to the EDKII_BLOCK_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The cache is invalidated.
+
+**/
+EFI_STATUS
+EFIAPI
+DiskIoBlockCacheInvalidate (
+  IN EDKII_BLOCK_CACHE_PROTOCOL  *This
+  )
+{
+  DISK_IO_PRIVATE_DATA  *Instance;
+  EFI_TPL               OldTpl;
+
+  Instance = DISK_IO_PRIVATE_DATA_FROM_BLOCK_CACHE (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Instance->Cache != NULL) {
+    DiskIoCacheDropAll (Instance->Cache);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the statistics of the cache.
+
+  @param[in]  This              Pointer to the EDKII_BLOCK_CACHE_PROTOCOL instance.
+  @param[out] Statistics        The statistics of the cache.
+
+  @retval EFI_SUCCESS           The statistics are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+DiskIoBlockCacheGetStatistics (
+  IN  EDKII_BLOCK_CACHE_PROTOCOL    *This,
+  OUT EDKII_BLOCK_CACHE_STATISTICS  *Statistics
+  )
+{
+  DISK_IO_PRIVATE_DATA  *Instance;
+  EFI_TPL               OldTpl;
+
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Instance = DISK_IO_PRIVATE_DATA_FROM_BLOCK_CACHE (This);
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  if (Instance->Cache != NULL) {
+    CopyMem (Statistics, &Instance->Cache->Statistics, sizeof (EDKII_BLOCK_CACHE_STATISTICS));
+  } else {
+    ZeroMem (Statistics, sizeof (EDKII_BLOCK_CACHE_STATISTICS));
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
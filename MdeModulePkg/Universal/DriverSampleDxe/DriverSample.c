@@ -1727,6 +1727,63 @@ DriverCallback (
   return Status;
 }
 
+/**
+  Measure the HII ConfigRouting ExtractConfig() and RouteConfig() of the whole
+  configuration in MyIfrNVData, for the boot performance log.
+
+  They are measured twice. The first ExtractConfig() parses the IFR of the
+  forms to get the full request and the default values, the second one finds
+  them kept by the HII database.
+
+  @param  HiiConfigRouting       The HII ConfigRouting protocol.
+
+**/
+VOID
+DriverSampleMeasureConfigRouting (
+  IN EFI_HII_CONFIG_ROUTING_PROTOCOL  *HiiConfigRouting
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STRING  ConfigRequestHdr;
+  EFI_STRING  Results;
+  EFI_STRING  Progress;
+  EFI_STRING  StringPtr;
+
+  ConfigRequestHdr = HiiConstructConfigHdr (&gDriverSampleFormSetGuid, VariableName, DriverHandle[0]);
+  if (ConfigRequestHdr == NULL) {
+    return;
+  }
+
+  PERF_INMODULE_BEGIN ("ExtractConfig");
+  Status = HiiConfigRouting->ExtractConfig (HiiConfigRouting, ConfigRequestHdr, &Progress, &Results);
+  PERF_INMODULE_END ("ExtractConfig");
+  if (!EFI_ERROR (Status)) {
+    FreePool (Results);
+  }
+
+  PERF_INMODULE_BEGIN ("ExtractConfigAgain");
+  Status = HiiConfigRouting->ExtractConfig (HiiConfigRouting, ConfigRequestHdr, &Progress, &Results);
+  PERF_INMODULE_END ("ExtractConfigAgain");
+  FreePool (ConfigRequestHdr);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  //
+  // Route the current setting back without the default values. The setting
+  // is not changed, so the variable is not written again.
+  //
+  StringPtr = StrStr (Results + 1, L"&GUID=");
+  if (StringPtr != NULL) {
+    *StringPtr = L'\0';
+  }
+
+  PERF_INMODULE_BEGIN ("RouteConfig");
+  HiiConfigRouting->RouteConfig (HiiConfigRouting, Results, &Progress);
+  PERF_INMODULE_END ("RouteConfig");
+  FreePool (Results);
+}
+
 /**
   Main entry for this driver.
 
@@ -2195,6 +2252,13 @@ DriverSampleInit (
     FormBrowserEx->RegisterHotKey (&HotKey, BROWSER_ACTION_DEFAULT, EFI_HII_DEFAULT_CLASS_STANDARD, NewString);
   }
 
+  //
+  // Measure the HII ConfigRouting of the forms when the performance is measured.
+  //
+  PERF_CODE (
+    DriverSampleMeasureConfigRouting (HiiConfigRouting);
+    );
+
   //
   // In default, this driver is built into Flash device image,
   // the following code doesn't run.
@@ -41,6 +41,7 @@ Revision History
 #include <Library/DevicePathLib.h>
 #include <Library/PrintLib.h>
 #include <Library/UefiLib.h>
+#include <Library/PerformanceLib.h>
 
 #include "NVDataStruc.h"
 
@@ -1574,6 +1574,9 @@ BlockArrayCheck (
 /**
   Get form package data from data base.
 
+  The form packages are exported once and kept in the package list until they
+  are changed, so the returned buffer must not be freed by the caller.
+
   @param  DataBaseRecord         The DataBaseRecord instance contains the found Hii handle and package.
   @param  HiiFormPackage         The buffer saves the package data.
   @param  PackageSize            The buffer size of the package data.
@@ -1594,6 +1597,12 @@ GetFormPackageData (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (DataBaseRecord->PackageList->FormPackageData != NULL) {
+    *HiiFormPackage = DataBaseRecord->PackageList->FormPackageData;
+    *PackageSize    = DataBaseRecord->PackageList->FormPackageSize;
+    return EFI_SUCCESS;
+  }
+
   Size       = 0;
   ResultSize = 0;
   //
@@ -1634,11 +1643,15 @@ GetFormPackageData (
                  );
   if (EFI_ERROR (Status)) {
     FreePool (*HiiFormPackage);
+    return Status;
   }
 
   *PackageSize = Size;
 
-  return Status;
+  DataBaseRecord->PackageList->FormPackageData = *HiiFormPackage;
+  DataBaseRecord->PackageList->FormPackageSize = Size;
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -1775,10 +1788,6 @@ GetVarStoreType (
   }
 
 Done:
-  if (HiiFormPackage != NULL) {
-    FreePool (HiiFormPackage);
-  }
-
   return Status;
 }
 
@@ -2007,10 +2016,6 @@ IsThisPackageList (
   }
 
 Done:
-  if (HiiFormPackage != NULL) {
-    FreePool (HiiFormPackage);
-  }
-
   if (VarStoreName != NULL) {
     FreePool (VarStoreName);
   }
@@ -4114,6 +4119,174 @@ GenerateAltConfigResp (
   return EFI_SUCCESS;
 }
 
+/**
+  Free the full ConfigRequest and AltCfgResp strings kept for a varstore.
+
+  @param  StringCache            The strings to free.
+
+**/
+VOID
+FreeConfigStringCache (
+  IN HII_CONFIG_STRING_CACHE  *StringCache
+  )
+{
+  if (StringCache->DevicePath != NULL) {
+    FreePool (StringCache->DevicePath);
+  }
+
+  if (StringCache->ConfigHdr != NULL) {
+    FreePool (StringCache->ConfigHdr);
+  }
+
+  if (StringCache->Language != NULL) {
+    FreePool (StringCache->Language);
+  }
+
+  if (StringCache->ConfigRequest != NULL) {
+    FreePool (StringCache->ConfigRequest);
+  }
+
+  if (StringCache->AltCfgResp != NULL) {
+    FreePool (StringCache->AltCfgResp);
+  }
+
+  FreePool (StringCache);
+}
+
+/**
+  Free the form packages and the strings kept by ConfigRouting for a package
+  list, when its form or string packages are changed.
+
+  @param  PackageList            The package list whose packages are changed.
+
+**/
+VOID
+InvalidateFormPackageCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList
+  )
+{
+  HII_CONFIG_STRING_CACHE  *StringCache;
+
+  if (PackageList->FormPackageData != NULL) {
+    FreePool (PackageList->FormPackageData);
+    PackageList->FormPackageData = NULL;
+    PackageList->FormPackageSize = 0;
+  }
+
+  while (!IsListEmpty (&PackageList->ConfigStringCache)) {
+    StringCache = HII_CONFIG_STRING_CACHE_FROM_LINK (PackageList->ConfigStringCache.ForwardLink);
+    RemoveEntryList (&StringCache->Entry);
+    FreeConfigStringCache (StringCache);
+  }
+}
+
+/**
+  Find the full ConfigRequest and AltCfgResp strings kept for a varstore.
+
+  @param  PackageList            The package list of the form packages.
+  @param  DevicePath             Device path of the driver handle.
+  @param  ConfigHdr              The request <ConfigHdr>, or NULL for the first varstore.
+  @param  Language               The current platform language, or NULL if not set.
+
+  @return The strings kept for the varstore, or NULL if not found.
+
+**/
+HII_CONFIG_STRING_CACHE *
+FindConfigStringCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList,
+  IN EFI_DEVICE_PATH_PROTOCOL            *DevicePath,
+  IN EFI_STRING                          ConfigHdr OPTIONAL,
+  IN CHAR8                               *Language OPTIONAL
+  )
+{
+  LIST_ENTRY               *Link;
+  HII_CONFIG_STRING_CACHE  *StringCache;
+  UINTN                    DevicePathSize;
+
+  DevicePathSize = GetDevicePathSize (DevicePath);
+  for (Link = PackageList->ConfigStringCache.ForwardLink; Link != &PackageList->ConfigStringCache; Link = Link->ForwardLink) {
+    StringCache = HII_CONFIG_STRING_CACHE_FROM_LINK (Link);
+    if ((GetDevicePathSize (StringCache->DevicePath) != DevicePathSize) ||
+        (CompareMem (StringCache->DevicePath, DevicePath, DevicePathSize) != 0))
+    {
+      continue;
+    }
+
+    if ((StringCache->ConfigHdr == NULL) ? (ConfigHdr != NULL) : ((ConfigHdr == NULL) || (StrCmp (StringCache->ConfigHdr, ConfigHdr) != 0))) {
+      continue;
+    }
+
+    if ((StringCache->Language == NULL) ? (Language != NULL) : ((Language == NULL) || (AsciiStrCmp (StringCache->Language, Language) != 0))) {
+      continue;
+    }
+
+    return StringCache;
+  }
+
+  return NULL;
+}
+
+/**
+  Keep the full ConfigRequest and AltCfgResp strings generated for a varstore.
+  If there is not enough memory, they are simply generated again next time.
+
+  @param  PackageList            The package list of the form packages.
+  @param  DevicePath             Device path of the driver handle.
+  @param  ConfigHdr              The request <ConfigHdr>, or NULL for the first varstore.
+  @param  Language               The current platform language, or NULL if not set.
+  @param  ConfigRequest          The full ConfigRequest, or NULL if the varstore
+                                 has no question.
+  @param  AltCfgResp             The default AltCfgResp, or NULL if none.
+
+**/
+VOID
+AddConfigStringCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList,
+  IN EFI_DEVICE_PATH_PROTOCOL            *DevicePath,
+  IN EFI_STRING                          ConfigHdr OPTIONAL,
+  IN CHAR8                               *Language OPTIONAL,
+  IN EFI_STRING                          ConfigRequest OPTIONAL,
+  IN EFI_STRING                          AltCfgResp OPTIONAL
+  )
+{
+  HII_CONFIG_STRING_CACHE  *StringCache;
+
+  StringCache = AllocateZeroPool (sizeof (HII_CONFIG_STRING_CACHE));
+  if (StringCache == NULL) {
+    return;
+  }
+
+  StringCache->Signature  = HII_CONFIG_STRING_CACHE_SIGNATURE;
+  StringCache->DevicePath = DuplicateDevicePath (DevicePath);
+  if (ConfigHdr != NULL) {
+    StringCache->ConfigHdr = AllocateCopyPool (StrSize (ConfigHdr), ConfigHdr);
+  }
+
+  if (Language != NULL) {
+    StringCache->Language = AllocateCopyPool (AsciiStrSize (Language), Language);
+  }
+
+  if (ConfigRequest != NULL) {
+    StringCache->ConfigRequest = AllocateCopyPool (StrSize (ConfigRequest), ConfigRequest);
+  }
+
+  if (AltCfgResp != NULL) {
+    StringCache->AltCfgResp = AllocateCopyPool (StrSize (AltCfgResp), AltCfgResp);
+  }
+
+  if ((StringCache->DevicePath == NULL) ||
+      ((ConfigHdr != NULL) && (StringCache->ConfigHdr == NULL)) ||
+      ((Language != NULL) && (StringCache->Language == NULL)) ||
+      ((ConfigRequest != NULL) && (StringCache->ConfigRequest == NULL)) ||
+      ((AltCfgResp != NULL) && (StringCache->AltCfgResp == NULL)))
+  {
+    FreeConfigStringCache (StringCache);
+    return;
+  }
+
+  InsertTailList (&PackageList->ConfigStringCache, &StringCache->Entry);
+}
+
 /**
   This function gets the full request string and full default value string by
   parsing IFR data in HII form packages.
@@ -4167,19 +4340,22 @@ GetFullStringFromHiiFormPackages (
   OUT    EFI_STRING                *PointerProgress OPTIONAL
   )
 {
-  EFI_STATUS           Status;
-  UINT8                *HiiFormPackage;
-  UINTN                PackageSize;
-  IFR_BLOCK_DATA       *RequestBlockArray;
-  IFR_BLOCK_DATA       *BlockData;
-  IFR_DEFAULT_DATA     *DefaultValueData;
-  IFR_DEFAULT_DATA     *DefaultId;
-  IFR_DEFAULT_DATA     *DefaultIdArray;
-  IFR_VARSTORAGE_DATA  *VarStorageData;
-  EFI_STRING           DefaultAltCfgResp;
-  EFI_STRING           ConfigHdr;
-  EFI_STRING           StringPtr;
-  EFI_STRING           Progress;
+  EFI_STATUS               Status;
+  UINT8                    *HiiFormPackage;
+  UINTN                    PackageSize;
+  IFR_BLOCK_DATA           *RequestBlockArray;
+  IFR_BLOCK_DATA           *BlockData;
+  IFR_DEFAULT_DATA         *DefaultValueData;
+  IFR_DEFAULT_DATA         *DefaultId;
+  IFR_DEFAULT_DATA         *DefaultIdArray;
+  IFR_VARSTORAGE_DATA      *VarStorageData;
+  EFI_STRING               DefaultAltCfgResp;
+  EFI_STRING               ConfigHdr;
+  EFI_STRING               StringPtr;
+  EFI_STRING               Progress;
+  HII_CONFIG_STRING_CACHE  *StringCache;
+  EFI_STRING               RequestHdr;
+  CHAR8                    *Language;
 
   if ((DataBaseRecord == NULL) || (DevicePath == NULL) || (Request == NULL) || (AltCfgResp == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -4196,6 +4372,8 @@ GetFullStringFromHiiFormPackages (
   HiiFormPackage    = NULL;
   PackageSize       = 0;
   Progress          = *Request;
+  RequestHdr        = NULL;
+  Language          = NULL;
 
   Status = GetFormPackageData (DataBaseRecord, &HiiFormPackage, &PackageSize);
   if (EFI_ERROR (Status)) {
@@ -4265,6 +4443,58 @@ GetFullStringFromHiiFormPackages (
     }
   }
 
+  //
+  // The strings for a whole varstore only depend on the form and string packages
+  // and the platform language, so they are kept in the package list once generated.
+  //
+  if (RequestBlockArray == NULL) {
+    GetEfiGlobalVariable2 (L"PlatformLang", (VOID **)&Language, NULL);
+    StringCache = FindConfigStringCache (DataBaseRecord->PackageList, DevicePath, *Request, Language);
+    if (StringCache != NULL) {
+      Status = EFI_SUCCESS;
+      if (StringCache->ConfigRequest == NULL) {
+        goto Done;
+      }
+
+      StringPtr = AllocateCopyPool (StrSize (StringCache->ConfigRequest), StringCache->ConfigRequest);
+      if (StringPtr == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto Done;
+      }
+
+      if (*Request != NULL) {
+        FreePool (*Request);
+      }
+
+      *Request = StringPtr;
+
+      if (StringCache->AltCfgResp != NULL) {
+        DefaultAltCfgResp = AllocateCopyPool (StrSize (StringCache->AltCfgResp), StringCache->AltCfgResp);
+        if (DefaultAltCfgResp == NULL) {
+          Status = EFI_OUT_OF_RESOURCES;
+          goto Done;
+        }
+      }
+
+      if ((*AltCfgResp != NULL) && (DefaultAltCfgResp != NULL)) {
+        Status = MergeDefaultString (AltCfgResp, DefaultAltCfgResp);
+        FreePool (DefaultAltCfgResp);
+      } else if (*AltCfgResp == NULL) {
+        *AltCfgResp = DefaultAltCfgResp;
+      }
+
+      goto Done;
+    }
+
+    if (*Request != NULL) {
+      RequestHdr = AllocateCopyPool (StrSize (*Request), *Request);
+      if (RequestHdr == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto Done;
+      }
+    }
+  }
+
   //
   // Initialize DefaultIdArray to store the map between DeaultId and DefaultName
   //
@@ -4312,6 +4542,10 @@ GetFullStringFromHiiFormPackages (
   // No requested varstore in IFR data and directly return
   //
   if ((VarStorageData->Type == 0) && (VarStorageData->Name == NULL)) {
+    if (RequestBlockArray == NULL) {
+      AddConfigStringCache (DataBaseRecord->PackageList, DevicePath, RequestHdr, Language, NULL, NULL);
+    }
+
     Status = EFI_SUCCESS;
     goto Done;
   }
@@ -4326,6 +4560,10 @@ GetFullStringFromHiiFormPackages (
 
   if (RequestBlockArray == NULL) {
     if (!GenerateConfigRequest (ConfigHdr, VarStorageData, &Status, Request)) {
+      if (!EFI_ERROR (Status)) {
+        AddConfigStringCache (DataBaseRecord->PackageList, DevicePath, RequestHdr, Language, NULL, NULL);
+      }
+
       goto Done;
     }
   }
@@ -4340,6 +4578,10 @@ GetFullStringFromHiiFormPackages (
     goto Done;
   }
 
+  if (RequestBlockArray == NULL) {
+    AddConfigStringCache (DataBaseRecord->PackageList, DevicePath, RequestHdr, Language, *Request, DefaultAltCfgResp);
+  }
+
   //
   // 5. Merge string into the input AltCfgResp if the input *AltCfgResp is not NULL.
   //
@@ -4419,11 +4661,12 @@ Done:
     FreePool (ConfigHdr);
   }
 
-  //
-  // Free Package data
-  //
-  if (HiiFormPackage != NULL) {
-    FreePool (HiiFormPackage);
+  if (RequestHdr != NULL) {
+    FreePool (RequestHdr);
+  }
+
+  if (Language != NULL) {
+    FreePool (Language);
   }
 
   if (PointerProgress != NULL) {
@@ -5175,6 +5418,564 @@ Done:
   return Status;
 }
 
+//
+// The <MultiConfigAltResp> fragments of the ConfigAccess driver handles, kept
+// by HiiExportChangedConfig() between the exports of the ConfigResp string.
+//
+LIST_ENTRY  mConfigRespFragmentList = INITIALIZE_LIST_HEAD_VARIABLE (mConfigRespFragmentList);
+UINTN       mConfigRespExportCount  = 0;
+
+/**
+  Find the package list record in the HII database whose device path package
+  matches the device path of a ConfigAccess driver handle.
+
+  This is a internal function.
+
+  @param  Private                Hii database private data.
+  @param  DevicePath             The device path of the driver handle.
+
+  @return The package list record, or NULL if not found.
+
+**/
+HII_DATABASE_RECORD *
+GetDatabaseRecordByDevicePath (
+  IN HII_DATABASE_PRIVATE_DATA  *Private,
+  IN EFI_DEVICE_PATH_PROTOCOL   *DevicePath OPTIONAL
+  )
+{
+  LIST_ENTRY           *Link;
+  HII_DATABASE_RECORD  *Database;
+  UINT8                *DevicePathPkg;
+  UINT8                *CurrentDevicePath;
+
+  if (DevicePath == NULL) {
+    return NULL;
+  }
+
+  for (Link = Private->DatabaseList.ForwardLink;
+       Link != &Private->DatabaseList;
+       Link = Link->ForwardLink
+       )
+  {
+    Database = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    if ((DevicePathPkg = Database->PackageList->DevicePathPkg) != NULL) {
+      CurrentDevicePath = DevicePathPkg + sizeof (EFI_HII_PACKAGE_HEADER);
+      if (CompareMem (
+            DevicePath,
+            CurrentDevicePath,
+            GetDevicePathSize ((EFI_DEVICE_PATH_PROTOCOL *)CurrentDevicePath)
+            ) == 0)
+      {
+        return Database;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Get the current configuration of one ConfigAccess driver handle, with the
+  default values from its form packages merged in.
+
+  This is a internal function.
+
+  @param  Database               The package list record of the driver handle, or
+                                 NULL if it has none.
+  @param  DevicePath             The device path of the driver handle.
+  @param  ConfigAccess           The ConfigAccess protocol of the driver handle.
+  @param  AccessResults          Null-terminated Unicode string in
+                                 <MultiConfigAltResp> format. String to be
+                                 allocated by the called function.
+
+  @retval EFI_SUCCESS            The AccessResults string is returned.
+  @retval Others                 The driver handle has no configuration to export.
+
+**/
+EFI_STATUS
+ExportConfigOfDriverHandle (
+  IN  HII_DATABASE_RECORD             *Database OPTIONAL,
+  IN  EFI_DEVICE_PATH_PROTOCOL        *DevicePath OPTIONAL,
+  IN  EFI_HII_CONFIG_ACCESS_PROTOCOL  *ConfigAccess,
+  OUT EFI_STRING                      *AccessResults
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STRING  Progress;
+  EFI_STRING  StringPtr;
+  EFI_STRING  ConfigRequest;
+  EFI_STRING  DefaultResults;
+  BOOLEAN     IfrDataParsedFlag;
+
+  IfrDataParsedFlag = FALSE;
+  Progress          = NULL;
+  DefaultResults    = NULL;
+  ConfigRequest     = NULL;
+  *AccessResults    = NULL;
+
+  Status = ConfigAccess->ExtractConfig (
+                           ConfigAccess,
+                           NULL,
+                           &Progress,
+                           AccessResults
+                           );
+  if (EFI_ERROR (Status)) {
+    //
+    // Update AccessResults by getting default setting from IFR when HiiPackage is registered to HiiHandle
+    //
+    if ((Database != NULL) && (DevicePath != NULL)) {
+      IfrDataParsedFlag = TRUE;
+      Status            = GetFullStringFromHiiFormPackages (Database, DevicePath, &ConfigRequest, &DefaultResults, NULL);
+      //
+      // Get the full request string to get the Current setting again.
+      //
+      if (!EFI_ERROR (Status) && (ConfigRequest != NULL)) {
+        Status = ConfigAccess->ExtractConfig (
+                                 ConfigAccess,
+                                 ConfigRequest,
+                                 &Progress,
+                                 AccessResults
+                                 );
+        FreePool (ConfigRequest);
+      } else {
+        Status = EFI_NOT_FOUND;
+      }
+    }
+  }
+
+  if (EFI_ERROR (Status)) {
+    if (DefaultResults != NULL) {
+      FreePool (DefaultResults);
+    }
+
+    return Status;
+  }
+
+  //
+  // Update AccessResults by getting default setting from IFR when HiiPackage is registered to HiiHandle
+  //
+  if (!IfrDataParsedFlag && (Database != NULL) && (DevicePath != NULL)) {
+    StringPtr = StrStr (*AccessResults, L"&GUID=");
+    if (StringPtr != NULL) {
+      *StringPtr = 0;
+    }
+
+    if (GetElementsFromRequest (*AccessResults)) {
+      Status = GetFullStringFromHiiFormPackages (Database, DevicePath, AccessResults, &DefaultResults, NULL);
+      ASSERT_EFI_ERROR (Status);
+    }
+
+    if (StringPtr != NULL) {
+      *StringPtr = L'&';
+    }
+  }
+
+  //
+  // Merge the default sting from IFR code into the got setting from driver.
+  //
+  if (DefaultResults != NULL) {
+    Status = MergeDefaultString (AccessResults, DefaultResults);
+    ASSERT_EFI_ERROR (Status);
+    FreePool (DefaultResults);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the CRC32 of the data of the variable of an efi varstore.
+
+  This is a internal function.
+
+  @param  Guid                   The guid of the variable.
+  @param  Name                   The name of the variable.
+
+  @return The CRC32 of the variable data, or 0 if the variable can't be read.
+
+**/
+UINT32
+GetEfiVarStoreCrc (
+  IN EFI_GUID  *Guid,
+  IN CHAR16    *Name
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Data;
+  UINTN       DataSize;
+  UINT32      Crc;
+
+  Crc    = 0;
+  Status = GetVariable2 (Name, Guid, &Data, &DataSize);
+  if (EFI_ERROR (Status)) {
+    return 0;
+  }
+
+  gBS->CalculateCrc32 (Data, DataSize, &Crc);
+  FreePool (Data);
+
+  return Crc;
+}
+
+/**
+  Free the efi varstores recorded for a ConfigAccess driver handle.
+
+  This is a internal function.
+
+  @param  Fragment               The fragment of the driver handle.
+
+**/
+VOID
+FreeConfigRespEfiVarStore (
+  IN HII_CONFIG_RESP_FRAGMENT  *Fragment
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Fragment->EfiVarStoreCount; Index++) {
+    FreePool (Fragment->EfiVarStore[Index].Name);
+  }
+
+  if (Fragment->EfiVarStore != NULL) {
+    FreePool (Fragment->EfiVarStore);
+  }
+
+  Fragment->EfiVarStore      = NULL;
+  Fragment->EfiVarStoreCount = 0;
+}
+
+/**
+  Record the efi varstores of the form packages of a ConfigAccess driver
+  handle, with the CRC32 of their variable data.
+
+  This is a internal function.
+
+  @param  Database               The package list record of the driver handle, or
+                                 NULL if it has none.
+  @param  Fragment               The fragment of the driver handle.
+
+**/
+VOID
+GetConfigRespEfiVarStore (
+  IN HII_DATABASE_RECORD       *Database OPTIONAL,
+  IN HII_CONFIG_RESP_FRAGMENT  *Fragment
+  )
+{
+  LIST_ENTRY                    *Link;
+  HII_IFR_PACKAGE_INSTANCE      *FormPackage;
+  UINTN                         PackageLength;
+  UINTN                         IfrOffset;
+  EFI_IFR_OP_HEADER             *IfrOpHdr;
+  EFI_IFR_VARSTORE_EFI          *IfrEfiVarStore;
+  HII_CONFIG_RESP_EFI_VARSTORE  *EfiVarStore;
+  CHAR16                        *VarStoreName;
+  UINTN                         NameSize;
+
+  FreeConfigRespEfiVarStore (Fragment);
+
+  if (Database == NULL) {
+    return;
+  }
+
+  for (Link = Database->PackageList->FormPkgHdr.ForwardLink;
+       Link != &Database->PackageList->FormPkgHdr;
+       Link = Link->ForwardLink
+       )
+  {
+    FormPackage   = CR (Link, HII_IFR_PACKAGE_INSTANCE, IfrEntry, HII_IFR_PACKAGE_SIGNATURE);
+    PackageLength = FormPackage->FormPkgHdr.Length - sizeof (EFI_HII_PACKAGE_HEADER);
+    for (IfrOffset = 0; IfrOffset < PackageLength; IfrOffset += IfrOpHdr->Length) {
+      IfrOpHdr = (EFI_IFR_OP_HEADER *)(FormPackage->IfrData + IfrOffset);
+      //
+      // The old efi varstore definition has no name, skip it.
+      //
+      if ((IfrOpHdr->OpCode != EFI_IFR_VARSTORE_EFI_OP) || (IfrOpHdr->Length < sizeof (EFI_IFR_VARSTORE_EFI))) {
+        continue;
+      }
+
+      IfrEfiVarStore = (EFI_IFR_VARSTORE_EFI *)IfrOpHdr;
+      NameSize       = AsciiStrSize ((CHAR8 *)IfrEfiVarStore->Name);
+      VarStoreName   = AllocateZeroPool (NameSize * sizeof (CHAR16));
+      if (VarStoreName == NULL) {
+        return;
+      }
+
+      EfiVarStore = ReallocatePool (
+                      Fragment->EfiVarStoreCount * sizeof (HII_CONFIG_RESP_EFI_VARSTORE),
+                      (Fragment->EfiVarStoreCount + 1) * sizeof (HII_CONFIG_RESP_EFI_VARSTORE),
+                      Fragment->EfiVarStore
+                      );
+      if (EfiVarStore == NULL) {
+        FreePool (VarStoreName);
+        return;
+      }
+
+      AsciiStrToUnicodeStrS ((CHAR8 *)IfrEfiVarStore->Name, VarStoreName, NameSize);
+      CopyGuid (&EfiVarStore[Fragment->EfiVarStoreCount].Guid, &IfrEfiVarStore->Guid);
+      EfiVarStore[Fragment->EfiVarStoreCount].Name = VarStoreName;
+      EfiVarStore[Fragment->EfiVarStoreCount].Crc  = GetEfiVarStoreCrc (&IfrEfiVarStore->Guid, VarStoreName);
+      Fragment->EfiVarStore                        = EfiVarStore;
+      Fragment->EfiVarStoreCount++;
+    }
+  }
+}
+
+/**
+  Check whether the variable of any efi varstore recorded for a ConfigAccess
+  driver handle is written since the last export.
+
+  This is a internal function.
+
+  @param  Fragment               The fragment of the driver handle.
+
+  @retval TRUE                   The data of a variable is changed.
+  @retval FALSE                  No variable is changed.
+
+**/
+BOOLEAN
+IsConfigRespEfiVarStoreChanged (
+  IN HII_CONFIG_RESP_FRAGMENT  *Fragment
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Fragment->EfiVarStoreCount; Index++) {
+    if (GetEfiVarStoreCrc (&Fragment->EfiVarStore[Index].Guid, Fragment->EfiVarStore[Index].Name) != Fragment->EfiVarStore[Index].Crc) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Mark the configuration of a ConfigAccess driver handle as changed, so that
+  HiiExportChangedConfig() asks the driver handle for it again.
+
+  This is a internal function.
+
+  @param  DriverHandle           The driver handle the configuration is routed to.
+
+**/
+VOID
+MarkConfigRespChanged (
+  IN EFI_HANDLE  DriverHandle
+  )
+{
+  LIST_ENTRY                *Link;
+  HII_CONFIG_RESP_FRAGMENT  *Fragment;
+
+  for (Link = GetFirstNode (&mConfigRespFragmentList);
+       !IsNull (&mConfigRespFragmentList, Link);
+       Link = GetNextNode (&mConfigRespFragmentList, Link)
+       )
+  {
+    Fragment = HII_CONFIG_RESP_FRAGMENT_FROM_LINK (Link);
+    if (Fragment->DriverHandle == DriverHandle) {
+      Fragment->Changed = TRUE;
+      return;
+    }
+  }
+}
+
+/**
+  Export the current configuration for the entirety of the current HII database
+  as HiiConfigRoutingExportConfig() does, but only ask the ConfigAccess driver
+  handles whose form packages, configuration or efi varstore variables are
+  changed since the last call for their configuration. The others are taken
+  from the last call.
+
+  @param  Private                Hii database private data.
+  @param  Results                Null-terminated Unicode string in
+                                 <MultiConfigAltResp> format. String to be
+                                 allocated by the called function. De-allocation
+                                 is up to the caller.
+
+  @retval EFI_SUCCESS            The Results string is returned.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to store the results.
+
+**/
+EFI_STATUS
+HiiExportChangedConfig (
+  IN  HII_DATABASE_PRIVATE_DATA  *Private,
+  OUT EFI_STRING                 *Results
+  )
+{
+  EFI_STATUS                      Status;
+  EFI_HII_CONFIG_ACCESS_PROTOCOL  *ConfigAccess;
+  EFI_STRING                      AccessResults;
+  UINTN                           Index;
+  EFI_HANDLE                      *ConfigAccessHandles;
+  UINTN                           NumberConfigAccessHandles;
+  EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
+  EFI_HII_HANDLE                  HiiHandle;
+  HII_DATABASE_RECORD             *Database;
+  HII_CONFIG_RESP_FRAGMENT        *Fragment;
+  LIST_ENTRY                      *Link;
+  LIST_ENTRY                      *NextLink;
+  UINTN                           Length;
+  UINTN                           ExportedCount;
+  EFI_STRING                      StringPtr;
+
+  NumberConfigAccessHandles = 0;
+  Status                    = gBS->LocateHandleBuffer (
+                                     ByProtocol,
+                                     &gEfiHiiConfigAccessProtocolGuid,
+                                     NULL,
+                                     &NumberConfigAccessHandles,
+                                     &ConfigAccessHandles
+                                     );
+  if (EFI_ERROR (Status)) {
+    ConfigAccessHandles       = NULL;
+    NumberConfigAccessHandles = 0;
+  }
+
+  mConfigRespExportCount++;
+  ExportedCount = 0;
+
+  for (Index = 0; Index < NumberConfigAccessHandles; Index++) {
+    Status = gBS->HandleProtocol (
+                    ConfigAccessHandles[Index],
+                    &gEfiHiiConfigAccessProtocolGuid,
+                    (VOID **)&ConfigAccess
+                    );
+    if (EFI_ERROR (Status)) {
+      continue;
+    }
+
+    DevicePath = DevicePathFromHandle (ConfigAccessHandles[Index]);
+    Database   = GetDatabaseRecordByDevicePath (Private, DevicePath);
+    HiiHandle  = (Database != NULL) ? Database->Handle : NULL;
+
+    Fragment = NULL;
+    for (Link = GetFirstNode (&mConfigRespFragmentList);
+         !IsNull (&mConfigRespFragmentList, Link);
+         Link = GetNextNode (&mConfigRespFragmentList, Link)
+         )
+    {
+      Fragment = HII_CONFIG_RESP_FRAGMENT_FROM_LINK (Link);
+      if (Fragment->DriverHandle == ConfigAccessHandles[Index]) {
+        break;
+      }
+
+      Fragment = NULL;
+    }
+
+    if (Fragment == NULL) {
+      Fragment = AllocateZeroPool (sizeof (HII_CONFIG_RESP_FRAGMENT));
+      if (Fragment == NULL) {
+        FreePool (ConfigAccessHandles);
+        return EFI_OUT_OF_RESOURCES;
+      }
+
+      Fragment->Signature    = HII_CONFIG_RESP_FRAGMENT_SIGNATURE;
+      Fragment->DriverHandle = ConfigAccessHandles[Index];
+      Fragment->Changed      = TRUE;
+      InsertTailList (&mConfigRespFragmentList, &Fragment->Link);
+    }
+
+    //
+    // Ask the driver handle again if the protocol is reinstalled, the package
+    // list is registered or unregistered, its form packages are changed, or
+    // the variable of one of its efi varstores is written.
+    //
+    if ((Fragment->ConfigAccess != ConfigAccess) ||
+        (Fragment->HiiHandle != HiiHandle) ||
+        ((Database != NULL) && Database->PackageList->ConfigRespChanged) ||
+        IsConfigRespEfiVarStoreChanged (Fragment))
+    {
+      Fragment->Changed = TRUE;
+    }
+
+    if (Fragment->Changed) {
+      if (Fragment->ConfigAltResp != NULL) {
+        FreePool (Fragment->ConfigAltResp);
+        Fragment->ConfigAltResp = NULL;
+      }
+
+      GetConfigRespEfiVarStore (Database, Fragment);
+      Status = ExportConfigOfDriverHandle (Database, DevicePath, ConfigAccess, &AccessResults);
+      if (!EFI_ERROR (Status)) {
+        Fragment->ConfigAltResp = AccessResults;
+      }
+
+      Fragment->ConfigAccess = ConfigAccess;
+      Fragment->HiiHandle    = HiiHandle;
+      Fragment->Changed      = FALSE;
+      ExportedCount++;
+    }
+
+    Fragment->ExportCount = mConfigRespExportCount;
+
+    //
+    // Keep the fragments in the order of the handles, as ExportConfig() does.
+    //
+    RemoveEntryList (&Fragment->Link);
+    InsertTailList (&mConfigRespFragmentList, &Fragment->Link);
+  }
+
+  if (ConfigAccessHandles != NULL) {
+    FreePool (ConfigAccessHandles);
+  }
+
+  for (Link = Private->DatabaseList.ForwardLink; Link != &Private->DatabaseList; Link = Link->ForwardLink) {
+    Database                                 = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
+    Database->PackageList->ConfigRespChanged = FALSE;
+  }
+
+  //
+  // Drop the fragments of the driver handles which are gone, and join the
+  // others into a <MultiConfigAltResp> separated by '&'.
+  //
+  Length = 0;
+  for (Link = GetFirstNode (&mConfigRespFragmentList); !IsNull (&mConfigRespFragmentList, Link); Link = NextLink) {
+    NextLink = GetNextNode (&mConfigRespFragmentList, Link);
+    Fragment = HII_CONFIG_RESP_FRAGMENT_FROM_LINK (Link);
+    if (Fragment->ExportCount != mConfigRespExportCount) {
+      RemoveEntryList (&Fragment->Link);
+      if (Fragment->ConfigAltResp != NULL) {
+        FreePool (Fragment->ConfigAltResp);
+      }
+
+      FreeConfigRespEfiVarStore (Fragment);
+      FreePool (Fragment);
+      continue;
+    }
+
+    if (Fragment->ConfigAltResp != NULL) {
+      Length += StrLen (Fragment->ConfigAltResp) + 1;
+    }
+  }
+
+  *Results = AllocateZeroPool ((Length + 1) * sizeof (CHAR16));
+  if (*Results == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  StringPtr = *Results;
+  for (Link = GetFirstNode (&mConfigRespFragmentList);
+       !IsNull (&mConfigRespFragmentList, Link);
+       Link = GetNextNode (&mConfigRespFragmentList, Link)
+       )
+  {
+    Fragment = HII_CONFIG_RESP_FRAGMENT_FROM_LINK (Link);
+    if (Fragment->ConfigAltResp == NULL) {
+      continue;
+    }
+
+    if (StringPtr != *Results) {
+      *StringPtr++ = L'&';
+    }
+
+    Length = StrLen (Fragment->ConfigAltResp);
+    CopyMem (StringPtr, Fragment->ConfigAltResp, Length * sizeof (CHAR16));
+    StringPtr += Length;
+  }
+
+  DEBUG ((DEBUG_VERBOSE, "[HiiDatabase]: ConfigResp exported, %d of the driver handles asked again.\n", ExportedCount));
+
+  return EFI_SUCCESS;
+}
+
 /**
   This function allows the caller to request the current configuration for the
   entirety of the current HII database and returns the data in a
@@ -5207,22 +6008,13 @@ HiiConfigRoutingExportConfig (
   EFI_STATUS                      Status;
   EFI_HII_CONFIG_ACCESS_PROTOCOL  *ConfigAccess;
   EFI_STRING                      AccessResults;
-  EFI_STRING                      Progress;
-  EFI_STRING                      StringPtr;
-  EFI_STRING                      ConfigRequest;
   UINTN                           Index;
   EFI_HANDLE                      *ConfigAccessHandles;
   UINTN                           NumberConfigAccessHandles;
   BOOLEAN                         FirstElement;
   EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
-  EFI_HII_HANDLE                  HiiHandle;
-  EFI_STRING                      DefaultResults;
   HII_DATABASE_PRIVATE_DATA       *Private;
-  LIST_ENTRY                      *Link;
   HII_DATABASE_RECORD             *Database;
-  UINT8                           *DevicePathPkg;
-  UINT8                           *CurrentDevicePath;
-  BOOLEAN                         IfrDataParsedFlag;
 
   if ((This == NULL) || (Results == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -5264,97 +6056,13 @@ HiiConfigRoutingExportConfig (
     }
 
     //
-    // Get DevicePath and HiiHandle for this ConfigAccess driver handle
+    // Get DevicePath and the package list for this ConfigAccess driver handle
     //
-    IfrDataParsedFlag = FALSE;
-    Progress          = NULL;
-    HiiHandle         = NULL;
-    DefaultResults    = NULL;
-    Database          = NULL;
-    ConfigRequest     = NULL;
-    DevicePath        = DevicePathFromHandle (ConfigAccessHandles[Index]);
-    if (DevicePath != NULL) {
-      for (Link = Private->DatabaseList.ForwardLink;
-           Link != &Private->DatabaseList;
-           Link = Link->ForwardLink
-           )
-      {
-        Database = CR (Link, HII_DATABASE_RECORD, DatabaseEntry, HII_DATABASE_RECORD_SIGNATURE);
-        if ((DevicePathPkg = Database->PackageList->DevicePathPkg) != NULL) {
-          CurrentDevicePath = DevicePathPkg + sizeof (EFI_HII_PACKAGE_HEADER);
-          if (CompareMem (
-                DevicePath,
-                CurrentDevicePath,
-                GetDevicePathSize ((EFI_DEVICE_PATH_PROTOCOL *)CurrentDevicePath)
-                ) == 0)
-          {
-            HiiHandle = Database->Handle;
-            break;
-          }
-        }
-      }
-    }
-
-    Status = ConfigAccess->ExtractConfig (
-                             ConfigAccess,
-                             NULL,
-                             &Progress,
-                             &AccessResults
-                             );
-    if (EFI_ERROR (Status)) {
-      //
-      // Update AccessResults by getting default setting from IFR when HiiPackage is registered to HiiHandle
-      //
-      if ((HiiHandle != NULL) && (DevicePath != NULL)) {
-        IfrDataParsedFlag = TRUE;
-        Status            = GetFullStringFromHiiFormPackages (Database, DevicePath, &ConfigRequest, &DefaultResults, NULL);
-        //
-        // Get the full request string to get the Current setting again.
-        //
-        if (!EFI_ERROR (Status) && (ConfigRequest != NULL)) {
-          Status = ConfigAccess->ExtractConfig (
-                                   ConfigAccess,
-                                   ConfigRequest,
-                                   &Progress,
-                                   &AccessResults
-                                   );
-          FreePool (ConfigRequest);
-        } else {
-          Status = EFI_NOT_FOUND;
-        }
-      }
-    }
+    DevicePath = DevicePathFromHandle (ConfigAccessHandles[Index]);
+    Database   = GetDatabaseRecordByDevicePath (Private, DevicePath);
 
+    Status = ExportConfigOfDriverHandle (Database, DevicePath, ConfigAccess, &AccessResults);
     if (!EFI_ERROR (Status)) {
-      //
-      // Update AccessResults by getting default setting from IFR when HiiPackage is registered to HiiHandle
-      //
-      if (!IfrDataParsedFlag && (HiiHandle != NULL) && (DevicePath != NULL)) {
-        StringPtr = StrStr (AccessResults, L"&GUID=");
-        if (StringPtr != NULL) {
-          *StringPtr = 0;
-        }
-
-        if (GetElementsFromRequest (AccessResults)) {
-          Status = GetFullStringFromHiiFormPackages (Database, DevicePath, &AccessResults, &DefaultResults, NULL);
-          ASSERT_EFI_ERROR (Status);
-        }
-
-        if (StringPtr != NULL) {
-          *StringPtr = L'&';
-        }
-      }
-
-      //
-      // Merge the default sting from IFR code into the got setting from driver.
-      //
-      if (DefaultResults != NULL) {
-        Status = MergeDefaultString (&AccessResults, DefaultResults);
-        ASSERT_EFI_ERROR (Status);
-        FreePool (DefaultResults);
-        DefaultResults = NULL;
-      }
-
       //
       // Attach this <ConfigAltResp> to a <MultiConfigAltResp>. There is a '&'
       // which separates the first <ConfigAltResp> and the following ones.
@@ -5582,6 +6290,12 @@ HiiConfigRoutingRouteConfig (
       return Status;
     }
 
+    //
+    // The driver handle has to be asked for its configuration again when the
+    // ConfigResp string is exported next time.
+    //
+    MarkConfigRespChanged (DriverHandle);
+
     FreePool (ConfigResp);
     ConfigResp = NULL;
 
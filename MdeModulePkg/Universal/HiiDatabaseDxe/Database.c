@@ -73,8 +73,10 @@ GenerateHiiDatabaseRecord (
   InitializeListHead (&PackageList->StringPkgHdr);
   InitializeListHead (&PackageList->FontPkgHdr);
   InitializeListHead (&PackageList->SimpleFontPkgHdr);
-  PackageList->ImagePkg      = NULL;
-  PackageList->DevicePathPkg = NULL;
+  InitializeListHead (&PackageList->ConfigStringCache);
+  PackageList->ImagePkg          = NULL;
+  PackageList->DevicePathPkg     = NULL;
+  PackageList->ConfigRespChanged = TRUE;
 
   //
   // Create a new hii handle
@@ -1306,6 +1308,8 @@ RemoveFormPackages (
     PackageList->PackageListHdr.PackageLength -= Package->FormPkgHdr.Length;
     FreePool (Package->IfrData);
     FreePool (Package);
+    PackageList->ConfigRespChanged = TRUE;
+    InvalidateFormPackageCache (PackageList);
     //
     // If Hii runtime support feature is enabled,
     // will export Hii info for runtime use after ReadyToBoot event triggered.
@@ -1442,6 +1446,7 @@ InsertStringPackage (
   //
   InsertTailList (&PackageList->StringPkgHdr, &StringPackage->StringEntry);
   *Package = StringPackage;
+  InvalidateFormPackageCache (PackageList);
 
   if (NotifyType == EFI_HII_DATABASE_NOTIFY_ADD_PACK) {
     PackageList->PackageListHdr.PackageLength += StringPackage->StringPkgHdr->Header.Length;
@@ -1536,6 +1541,7 @@ AdjustStringPackage (
       // Append a EFI_HII_SIBT_END block to the end.
       //
       *BlockPtr = EFI_HII_SIBT_END;
+      FreeStringBlockIndex (StringPackage);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = StringBlock;
       StringPackage->StringPkgHdr->Header.Length += Skip2BlockSize;
@@ -1676,6 +1682,8 @@ RemoveStringPackages (
 
     RemoveEntryList (&Package->StringEntry);
     PackageList->PackageListHdr.PackageLength -= Package->StringPkgHdr->Header.Length;
+    InvalidateFormPackageCache (PackageList);
+    FreeStringBlockIndex (Package);
     FreePool (Package->StringBlock);
     FreePool (Package->StringPkgHdr);
     //
@@ -3064,6 +3072,9 @@ AddPackages (
           return Status;
         }
 
+        DatabaseRecord->PackageList->ConfigRespChanged = TRUE;
+        InvalidateFormPackageCache (DatabaseRecord->PackageList);
+
         Status = InvokeRegisteredFunction (
                    Private,
                    NotifyType,
@@ -3415,9 +3426,11 @@ HiiGetConfigRespInfo (
   Private = HII_DATABASE_DATABASE_PRIVATE_DATA_FROM_THIS (This);
 
   //
-  // Get ConfigResp string
+  // Get ConfigResp string. Only the driver handles whose form packages,
+  // configuration or efi varstore variables are changed since the last
+  // export are asked again.
   //
-  Status = HiiConfigRoutingExportConfig (&Private->ConfigRouting, &ConfigAltResp);
+  Status = HiiExportChangedConfig (Private, &ConfigAltResp);
 
   if (!EFI_ERROR (Status)) {
     ConfigSize = StrSize (ConfigAltResp);
@@ -3755,6 +3768,7 @@ HiiRemovePackageList (
 
       HiiHandle->Signature = 0;
       FreePool (HiiHandle);
+      InvalidateFormPackageCache (Node->PackageList);
       FreePool (Node->PackageList);
       FreePool (Node);
 
@@ -150,6 +150,15 @@ typedef struct {
 // String Package definitions
 //
 #define HII_STRING_PACKAGE_SIGNATURE  SIGNATURE_32 ('h','i','s','p')
+
+//
+// The string block which contains a string id, and the first string id of the block.
+//
+typedef struct {
+  UINT32           BlockOffset;
+  EFI_STRING_ID    StartStringId;
+} HII_STRING_BLOCK_INDEX;
+
 typedef struct _HII_STRING_PACKAGE_INSTANCE {
   UINTN                         Signature;
   EFI_HII_STRING_PACKAGE_HDR    *StringPkgHdr;
@@ -158,6 +167,8 @@ typedef struct _HII_STRING_PACKAGE_INSTANCE {
   LIST_ENTRY                    FontInfoList;          // local font info list
   UINT8                         FontId;
   EFI_STRING_ID                 MaxStringId;           // record StringId
+  HII_STRING_BLOCK_INDEX        *StringIndex;          // string block of each StringId, built on lookup
+  EFI_STRING_ID                 StringIndexCount;      // number of StringIds in StringIndex
 } HII_STRING_PACKAGE_INSTANCE;
 
 //
@@ -268,6 +279,18 @@ typedef struct _HII_DATABASE_PACKAGE_LIST_INSTANCE {
   HII_IMAGE_PACKAGE_INSTANCE     *ImagePkg;
   LIST_ENTRY                     SimpleFontPkgHdr;
   UINT8                          *DevicePathPkg;
+  //
+  // TRUE if the form packages are added, updated or removed since the last
+  // export of the ConfigResp string.
+  //
+  BOOLEAN                        ConfigRespChanged;
+  //
+  // The form packages exported for ConfigRouting and the strings generated from
+  // them, kept until the form or string packages are changed.
+  //
+  UINT8                          *FormPackageData;
+  UINTN                          FormPackageSize;
+  LIST_ENTRY                     ConfigStringCache;
 } HII_DATABASE_PACKAGE_LIST_INSTANCE;
 
 #define HII_HANDLE_SIGNATURE  SIGNATURE_32 ('h','i','h','l')
@@ -288,6 +311,56 @@ typedef struct _HII_DATABASE_RECORD {
   LIST_ENTRY                            DatabaseEntry;
 } HII_DATABASE_RECORD;
 
+#define HII_CONFIG_STRING_CACHE_SIGNATURE  SIGNATURE_32 ('h','c','s','c')
+
+//
+// The full ConfigRequest and the default AltCfgResp of a whole varstore, as
+// generated from the form packages by GetFullStringFromHiiFormPackages().
+//
+typedef struct {
+  UINTN                       Signature;
+  LIST_ENTRY                  Entry;
+  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+  EFI_STRING                  ConfigHdr;      ///< The request <ConfigHdr>, NULL for the first varstore
+  CHAR8                       *Language;      ///< The platform language of the strings, NULL if not set
+  EFI_STRING                  ConfigRequest;  ///< NULL if the varstore has no question
+  EFI_STRING                  AltCfgResp;
+} HII_CONFIG_STRING_CACHE;
+
+#define HII_CONFIG_STRING_CACHE_FROM_LINK(a)  CR (a, HII_CONFIG_STRING_CACHE, Entry, HII_CONFIG_STRING_CACHE_SIGNATURE)
+
+//
+// An efi varstore of the form packages of a ConfigAccess driver handle. Its
+// variable may be written with SetVariable() without going through RouteConfig,
+// so the CRC32 of the variable data is checked on each export.
+//
+typedef struct {
+  EFI_GUID    Guid;
+  CHAR16      *Name;
+  UINT32      Crc;  ///< 0 if the variable does not exist
+} HII_CONFIG_RESP_EFI_VARSTORE;
+
+#define HII_CONFIG_RESP_FRAGMENT_SIGNATURE  SIGNATURE_32 ('h','c','r','f')
+
+//
+// The <MultiConfigAltResp> of one ConfigAccess driver handle, kept from the last
+// export of the ConfigResp string so that only the changed ones are exported again.
+//
+typedef struct {
+  UINTN                             Signature;
+  LIST_ENTRY                        Link;
+  EFI_HANDLE                        DriverHandle;
+  EFI_HII_CONFIG_ACCESS_PROTOCOL    *ConfigAccess;
+  EFI_HII_HANDLE                    HiiHandle;
+  EFI_STRING                        ConfigAltResp;     ///< NULL if the driver handle has nothing to export
+  BOOLEAN                           Changed;           ///< The configuration is routed to the driver handle
+  UINTN                             ExportCount;       ///< The last export which saw the driver handle
+  HII_CONFIG_RESP_EFI_VARSTORE      *EfiVarStore;      ///< The efi varstores of the form packages
+  UINTN                             EfiVarStoreCount;
+} HII_CONFIG_RESP_FRAGMENT;
+
+#define HII_CONFIG_RESP_FRAGMENT_FROM_LINK(a)  CR (a, HII_CONFIG_RESP_FRAGMENT, Link, HII_CONFIG_RESP_FRAGMENT_SIGNATURE)
+
 #define HII_DATABASE_NOTIFY_SIGNATURE  SIGNATURE_32 ('h','i','d','n')
 
 typedef struct _HII_DATABASE_NOTIFY {
@@ -535,6 +608,18 @@ FindStringBlock (
   OUT EFI_STRING_ID                *StartStringId OPTIONAL
   );
 
+/**
+  Free the string block index of a string package. The index is built again
+  on the next lookup of a string.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+FreeStringBlockIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  );
+
 /**
   Parse all glyph blocks to find a glyph block specified by CharValue.
   If CharValue = (CHAR16) (-1), collect all default character cell information
@@ -1898,6 +1983,41 @@ HiiConfigRoutingExportConfig (
   OUT EFI_STRING                             *Results
   );
 
+/**
+  Export the current configuration for the entirety of the current HII database
+  as HiiConfigRoutingExportConfig() does, but only ask the ConfigAccess driver
+  handles whose form packages, configuration or efi varstore variables are
+  changed since the last call for their configuration. The others are taken
+  from the last call.
+
+  @param  Private                 Hii database private data.
+  @param  Results                 Null-terminated Unicode string in
+                                  <MultiConfigAltResp> format. String to be
+                                  allocated by the called function. De-allocation
+                                  is up to the caller.
+
+  @retval EFI_SUCCESS             The Results string is returned.
+  @retval EFI_OUT_OF_RESOURCES    Not enough memory to store the results.
+
+**/
+EFI_STATUS
+HiiExportChangedConfig (
+  IN  HII_DATABASE_PRIVATE_DATA  *Private,
+  OUT EFI_STRING                 *Results
+  );
+
+/**
+  Free the form packages and the strings kept by ConfigRouting for a package
+  list, when its form or string packages are changed.
+
+  @param  PackageList             The package list whose packages are changed.
+
+**/
+VOID
+InvalidateFormPackageCache (
+  IN HII_DATABASE_PACKAGE_LIST_INSTANCE  *PackageList
+  );
+
 /**
   This function processes the results of processing forms and routes it to the
   appropriate handlers or storage.
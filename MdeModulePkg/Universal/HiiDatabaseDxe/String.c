@@ -225,6 +225,266 @@ GetStringFontInfo (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Free the string block index of a string package. The index is built again
+  on the next lookup of a string.
+
+  @param  StringPackage           Hii string package instance.
+
+**/
+VOID
+FreeStringBlockIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  if (StringPackage->StringIndex != NULL) {
+    FreePool (StringPackage->StringIndex);
+    StringPackage->StringIndex = NULL;
+  }
+
+  StringPackage->StringIndexCount = 0;
+}
+
+/**
+  Parse all string blocks once to record the string block of each string id,
+  so that a string can be found without parsing the blocks in front of it.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+
+  @retval EFI_SUCCESS             The string block index is built.
+  @retval EFI_NOT_FOUND           The string package has no string.
+  @retval EFI_UNSUPPORTED         The string blocks can not be parsed.
+  @retval EFI_OUT_OF_RESOURCES    The system is out of resources to accomplish the
+                                  task.
+
+**/
+EFI_STATUS
+BuildStringBlockIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage
+  )
+{
+  HII_STRING_BLOCK_INDEX   *StringIndex;
+  UINT8                    *BlockHdr;
+  UINTN                    BlockSize;
+  UINTN                    StringSize;
+  UINTN                    Index;
+  UINTN                    CurrentStringId;
+  UINTN                    StartStringId;
+  UINT16                   IdCount;
+  UINT8                    Length8;
+  UINT32                   Length32;
+  EFI_HII_SIBT_EXT2_BLOCK  Ext2;
+
+  FreeStringBlockIndex (StringPackage);
+
+  if (StringPackage->MaxStringId == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  StringIndex = AllocateZeroPool (StringPackage->MaxStringId * sizeof (HII_STRING_BLOCK_INDEX));
+  if (StringIndex == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  BlockHdr        = StringPackage->StringBlock;
+  CurrentStringId = 1;
+  while (*BlockHdr != EFI_HII_SIBT_END) {
+    IdCount   = 0;
+    BlockSize = 0;
+    switch (*BlockHdr) {
+      case EFI_HII_SIBT_STRING_SCSU:
+        BlockSize = sizeof (EFI_HII_STRING_BLOCK);
+        BlockSize = BlockSize + AsciiStrSize ((CHAR8 *)(BlockHdr + BlockSize));
+        IdCount   = 1;
+        break;
+
+      case EFI_HII_SIBT_STRING_SCSU_FONT:
+        BlockSize = sizeof (EFI_HII_SIBT_STRING_SCSU_FONT_BLOCK) - sizeof (UINT8);
+        BlockSize = BlockSize + AsciiStrSize ((CHAR8 *)(BlockHdr + BlockSize));
+        IdCount   = 1;
+        break;
+
+      case EFI_HII_SIBT_STRINGS_SCSU:
+        CopyMem (&IdCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        BlockSize = sizeof (EFI_HII_SIBT_STRINGS_SCSU_BLOCK) - sizeof (UINT8);
+        for (Index = 0; Index < IdCount; Index++) {
+          BlockSize += AsciiStrSize ((CHAR8 *)(BlockHdr + BlockSize));
+        }
+
+        break;
+
+      case EFI_HII_SIBT_STRINGS_SCSU_FONT:
+        CopyMem (&IdCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+        BlockSize = sizeof (EFI_HII_SIBT_STRINGS_SCSU_FONT_BLOCK) - sizeof (UINT8);
+        for (Index = 0; Index < IdCount; Index++) {
+          BlockSize += AsciiStrSize ((CHAR8 *)(BlockHdr + BlockSize));
+        }
+
+        break;
+
+      case EFI_HII_SIBT_STRING_UCS2:
+        BlockSize = sizeof (EFI_HII_STRING_BLOCK);
+        GetUnicodeStringTextOrSize (NULL, BlockHdr + BlockSize, &StringSize);
+        BlockSize += StringSize;
+        IdCount    = 1;
+        break;
+
+      case EFI_HII_SIBT_STRING_UCS2_FONT:
+        BlockSize = sizeof (EFI_HII_SIBT_STRING_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+        GetUnicodeStringTextOrSize (NULL, BlockHdr + BlockSize, &StringSize);
+        BlockSize += StringSize;
+        IdCount    = 1;
+        break;
+
+      case EFI_HII_SIBT_STRINGS_UCS2:
+        CopyMem (&IdCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        BlockSize = sizeof (EFI_HII_SIBT_STRINGS_UCS2_BLOCK) - sizeof (CHAR16);
+        for (Index = 0; Index < IdCount; Index++) {
+          GetUnicodeStringTextOrSize (NULL, BlockHdr + BlockSize, &StringSize);
+          BlockSize += StringSize;
+        }
+
+        break;
+
+      case EFI_HII_SIBT_STRINGS_UCS2_FONT:
+        CopyMem (&IdCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT16));
+        BlockSize = sizeof (EFI_HII_SIBT_STRINGS_UCS2_FONT_BLOCK) - sizeof (CHAR16);
+        for (Index = 0; Index < IdCount; Index++) {
+          GetUnicodeStringTextOrSize (NULL, BlockHdr + BlockSize, &StringSize);
+          BlockSize += StringSize;
+        }
+
+        break;
+
+      case EFI_HII_SIBT_DUPLICATE:
+        BlockSize = sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
+        IdCount   = 1;
+        break;
+
+      case EFI_HII_SIBT_SKIP1:
+        BlockSize = sizeof (EFI_HII_SIBT_SKIP1_BLOCK);
+        IdCount   = *(BlockHdr + sizeof (EFI_HII_STRING_BLOCK));
+        break;
+
+      case EFI_HII_SIBT_SKIP2:
+        BlockSize = sizeof (EFI_HII_SIBT_SKIP2_BLOCK);
+        CopyMem (&IdCount, BlockHdr + sizeof (EFI_HII_STRING_BLOCK), sizeof (UINT16));
+        break;
+
+      case EFI_HII_SIBT_EXT1:
+        CopyMem (&Length8, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT8));
+        BlockSize = Length8;
+        break;
+
+      case EFI_HII_SIBT_EXT2:
+        CopyMem (&Ext2, BlockHdr, sizeof (EFI_HII_SIBT_EXT2_BLOCK));
+        BlockSize = Ext2.Length;
+        break;
+
+      case EFI_HII_SIBT_EXT4:
+        CopyMem (&Length32, BlockHdr + sizeof (EFI_HII_STRING_BLOCK) + sizeof (UINT8), sizeof (UINT32));
+        BlockSize = Length32;
+        break;
+
+      default:
+        break;
+    }
+
+    if (BlockSize == 0) {
+      //
+      // An unknown or broken block, leave the lookup to FindStringBlock().
+      //
+      FreePool (StringIndex);
+      return EFI_UNSUPPORTED;
+    }
+
+    StartStringId = CurrentStringId;
+    for (Index = 0; (Index < IdCount) && (CurrentStringId <= StringPackage->MaxStringId); Index++) {
+      StringIndex[CurrentStringId - 1].BlockOffset   = (UINT32)(BlockHdr - StringPackage->StringBlock);
+      StringIndex[CurrentStringId - 1].StartStringId = (EFI_STRING_ID)StartStringId;
+      CurrentStringId++;
+    }
+
+    BlockHdr += BlockSize;
+  }
+
+  StringPackage->StringIndex      = StringIndex;
+  StringPackage->StringIndexCount = (EFI_STRING_ID)(CurrentStringId - 1);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the string block of a string id from the string block index, and build
+  the index first if it does not exist.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+  @param  StringId                The string's id, which is unique within
+                                  PackageList.
+  @param  BlockOffset             Output the offset of the string block in the
+                                  string blocks of the package.
+  @param  StartStringId           Output the first string id of the string block.
+
+  @retval TRUE                    The string block is found in the index.
+  @retval FALSE                   The string id is not in the index.
+
+**/
+BOOLEAN
+LookupStringBlockIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage,
+  IN     EFI_STRING_ID                StringId,
+  OUT    UINTN                        *BlockOffset,
+  OUT    EFI_STRING_ID                *StartStringId
+  )
+{
+  if (StringPackage->StringIndex == NULL) {
+    if (EFI_ERROR (BuildStringBlockIndex (StringPackage))) {
+      return FALSE;
+    }
+  }
+
+  if ((StringId == 0) || (StringId > StringPackage->StringIndexCount)) {
+    return FALSE;
+  }
+
+  *BlockOffset   = StringPackage->StringIndex[StringId - 1].BlockOffset;
+  *StartStringId = StringPackage->StringIndex[StringId - 1].StartStringId;
+
+  return TRUE;
+}
+
+/**
+  Move the string blocks at or behind an offset in the string block index,
+  after the string blocks in front of them are resized.
+
+  This is a internal function.
+
+  @param  StringPackage           Hii string package instance.
+  @param  Offset                  The offset of the first string block to move,
+                                  before the string blocks are resized.
+  @param  Delta                   The number of bytes to move the string blocks.
+
+**/
+VOID
+MoveStringBlockIndex (
+  IN OUT HII_STRING_PACKAGE_INSTANCE  *StringPackage,
+  IN     UINTN                        Offset,
+  IN     INTN                         Delta
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < StringPackage->StringIndexCount; Index++) {
+    if (StringPackage->StringIndex[Index].BlockOffset >= Offset) {
+      StringPackage->StringIndex[Index].BlockOffset = (UINT32)(StringPackage->StringIndex[Index].BlockOffset + Delta);
+    }
+  }
+}
+
 /**
   Parse all string blocks to find a String block specified by StringId.
   If StringId = (EFI_STRING_ID) (-1), find out all EFI_HII_SIBT_FONT blocks
@@ -311,6 +571,19 @@ FindStringBlock (
   BlockHdr  = StringPackage->StringBlock;
   BlockSize = 0;
   Offset    = 0;
+
+  //
+  // Start from the string block which contains StringId, if it is in the index.
+  //
+  if ((StringId != (EFI_STRING_ID)(-1)) && (StringId != 0) &&
+      LookupStringBlockIndex (StringPackage, StringId, &BlockSize, &CurrentStringId))
+  {
+    BlockHdr += BlockSize;
+    if (StartStringId != NULL) {
+      *StartStringId = CurrentStringId;
+    }
+  }
+
   while (*BlockHdr != EFI_HII_SIBT_END) {
     switch (*BlockHdr) {
       case EFI_HII_SIBT_STRING_SCSU:
@@ -460,6 +733,7 @@ FindStringBlock (
           ASSERT (StringId != CurrentStringId);
           CurrentStringId = 1;
           BlockSize       = 0;
+          LookupStringBlockIndex (StringPackage, StringId, &BlockSize, &CurrentStringId);
         } else {
           BlockSize += sizeof (EFI_HII_SIBT_DUPLICATE_BLOCK);
           CurrentStringId++;
@@ -746,6 +1020,9 @@ InsertLackStringBlock (
   UINT32  NewUCSBlockLen;
   UINT8   *OldStringAddr;
   UINT32  IdCount;
+  UINTN   SkipOffset;
+  UINTN   NewOffset;
+  UINTN   Index;
 
   FrontSkipNum  = 0;
   SkipLen       = 0;
@@ -853,6 +1130,23 @@ InsertLackStringBlock (
     *BlockType = EFI_HII_SIBT_STRING_UCS2;
   }
 
+  //
+  // Move the string blocks behind the skip block in the index, and point the
+  // string ids from StringId on to the new block and the skip block behind it.
+  //
+  SkipOffset = OldStringAddr - StringPackage->StringBlock;
+  NewOffset  = *StringBlockAddr - StringBlock;
+  MoveStringBlockIndex (StringPackage, SkipOffset + SkipLen, (INTN)NewBlockSize - (INTN)OldBlockSize);
+  for (Index = StringId; (Index < StartStringId + IdCount) && (Index <= StringPackage->StringIndexCount); Index++) {
+    if (Index == StringId) {
+      StringPackage->StringIndex[Index - 1].BlockOffset   = (UINT32)NewOffset;
+      StringPackage->StringIndex[Index - 1].StartStringId = StringId;
+    } else {
+      StringPackage->StringIndex[Index - 1].BlockOffset   = (UINT32)(NewOffset + NewUCSBlockLen);
+      StringPackage->StringIndex[Index - 1].StartStringId = (EFI_STRING_ID)(StringId + 1);
+    }
+  }
+
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock                  = StringBlock;
   StringPackage->StringPkgHdr->Header.Length += NewBlockSize - OldBlockSize;
@@ -1000,7 +1294,7 @@ SetStringWorker (
     case EFI_HII_SIBT_STRING_SCSU_FONT:
     case EFI_HII_SIBT_STRINGS_SCSU:
     case EFI_HII_SIBT_STRINGS_SCSU_FONT:
-      BlockSize  = OldBlockSize + StrLen (String);
+      BlockSize  = OldBlockSize + StrLen (String) + sizeof (CHAR8);
       BlockSize -= AsciiStrSize ((CHAR8 *)StringTextPtr);
       Block      = AllocateZeroPool (BlockSize);
       if (Block == NULL) {
@@ -1023,6 +1317,7 @@ SetStringWorker (
         TmpSize
         );
 
+      MoveStringBlockIndex (StringPackage, StringTextPtr - StringPackage->StringBlock, (INTN)BlockSize - (INTN)OldBlockSize);
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = Block;
@@ -1057,6 +1352,7 @@ SetStringWorker (
         OldBlockSize - (StringTextPtr - StringPackage->StringBlock) - StringSize
         );
 
+      MoveStringBlockIndex (StringPackage, StringTextPtr - StringPackage->StringBlock, (INTN)BlockSize - (INTN)OldBlockSize);
       ZeroMem (StringPackage->StringBlock, OldBlockSize);
       FreePool (StringPackage->StringBlock);
       StringPackage->StringBlock                  = Block;
@@ -1109,6 +1405,7 @@ SetStringWorker (
 
   CopyMem (BlockPtr, StringPackage->StringBlock, OldBlockSize);
 
+  MoveStringBlockIndex (StringPackage, 0, Ext2.Length);
   ZeroMem (StringPackage->StringBlock, OldBlockSize);
   FreePool (StringPackage->StringBlock);
   StringPackage->StringBlock                  = Block;
@@ -1224,6 +1521,11 @@ HiiNewString (
 
   EfiAcquireLock (&mHiiDatabaseLock);
 
+  //
+  // The strings generated by ConfigRouting may refer to the string.
+  //
+  InvalidateFormPackageCache (PackageListNode);
+
   Status                  = EFI_SUCCESS;
   NewStringPackageCreated = FALSE;
   NewStringId             = 0;
@@ -1237,6 +1539,10 @@ HiiNewString (
   {
     StringPackage = CR (Link, HII_STRING_PACKAGE_INSTANCE, StringEntry, HII_STRING_PACKAGE_SIGNATURE);
     //
+    // A new string id is added to all the string packages, so their index is built again.
+    //
+    FreeStringBlockIndex (StringPackage);
+    //
     // Create a string block and corresponding font block if exists, then append them
     // to the end of the string package.
     //
@@ -1802,6 +2108,7 @@ HiiSetString (
         }
 
         PackageListNode->PackageListHdr.PackageLength += StringPackage->StringPkgHdr->Header.Length - OldPackageLen;
+        InvalidateFormPackageCache (PackageListNode);
         //
         // Check whether need to get the contents of HiiDataBase.
         // Only after ReadyToBoot to do the export.
@@ -315,6 +315,294 @@ ConstructNonTestedMemoryRange (
   return EFI_SUCCESS;
 }
 
+/**
+  Get the time elapsed since a value of the performance counter.
+
+  @param[in] Begin  The value of the performance counter at the beginning.
+
+  @return The time elapsed in nanoseconds.
+
+**/
+UINT64
+GetMemoryTestElapsedTime (
+  IN UINT64  Begin
+  )
+{
+  UINT64  End;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Ticks;
+
+  End = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+
+  if (CounterStart < CounterEnd) {
+    //
+    // The counter counts up
+    //
+    if (End >= Begin) {
+      Ticks = End - Begin;
+    } else {
+      Ticks = (CounterEnd - Begin) + (End - CounterStart);
+    }
+  } else {
+    //
+    // The counter counts down
+    //
+    if (Begin >= End) {
+      Ticks = Begin - End;
+    } else {
+      Ticks = (Begin - CounterEnd) + (CounterStart - End);
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
+/**
+  Get the bandwidth of the memory test.
+
+  @param[in] Bytes  The bytes tested.
+  @param[in] Time   The time spent on them in nanoseconds.
+
+  @return The bandwidth in MB per second, or 0 if Time is 0.
+
+**/
+UINT64
+GetMemoryTestBandwidth (
+  IN UINT64  Bytes,
+  IN UINT64  Time
+  )
+{
+  if (Time == 0) {
+    return 0;
+  }
+
+  return DivU64x64Remainder (MultU64x32 (RShiftU64 (Bytes, 20), 1000000000), Time, NULL);
+}
+
+/**
+  Write the memory test pattern into a range of physical memory on the
+  current processor.
+
+  If the pattern covers the whole range and repeats every 8 bytes, the range
+  is filled by SetMem64(), which the BaseMemoryLib instance for SSE2 capable
+  processors implements with non-temporal stores, so that the memory test
+  does not pollute the cache.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+**/
+VOID
+WriteMemoryRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+
+  if ((Private->CoverageSpan == Private->MonoTestSize) &&
+      ((Start & (sizeof (UINT64) - 1)) == 0) &&
+      (CompareMem (
+         Private->MonoPattern,
+         (UINT8 *)Private->MonoPattern + sizeof (UINT64),
+         Private->MonoTestSize - sizeof (UINT64)
+         ) == 0))
+  {
+    SetMem64 (
+      (VOID *)(UINTN)Start,
+      (UINTN)ALIGN_VALUE (Size, Private->MonoTestSize),
+      ReadUnaligned64 (Private->MonoPattern)
+      );
+    return;
+  }
+
+  Address = Start;
+  while (Address < (Start + Size)) {
+    CopyMem ((VOID *)(UINTN)Address, Private->MonoPattern, Private->MonoTestSize);
+    Address += Private->CoverageSpan;
+  }
+}
+
+/**
+  Verify the memory test pattern in a range of physical memory on the current
+  processor.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+  @param[in] Start    The memory range's start address.
+  @param[in] Size     The memory range's size.
+
+  @return The address of the first pattern mis-compared, or MAX_UINT64 if
+          no error is found.
+
+**/
+EFI_PHYSICAL_ADDRESS
+VerifyMemoryRange (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  EFI_PHYSICAL_ADDRESS         Start,
+  IN  UINT64                       Size
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Address;
+
+  Address = Start;
+  while (Address < (Start + Size)) {
+    if (CompareMemWithoutCheckArgument (
+          (VOID *)(UINTN)(Address),
+          Private->MonoPattern,
+          Private->MonoTestSize
+          ) != 0)
+    {
+      return Address;
+    }
+
+    Address += Private->CoverageSpan;
+  }
+
+  return MAX_UINT64;
+}
+
+/**
+  Get the range of physical memory covered by a memory test task.
+
+  @param[in]  Context    The context of the memory test tasks.
+  @param[in]  TaskIndex  The index of the task.
+  @param[out] Start      The start address of the task's range.
+  @param[out] Size       The size of the task's range.
+
+**/
+VOID
+GetMemoryTestTaskRange (
+  IN  MEMORY_TEST_TASK_CONTEXT  *Context,
+  IN  UINTN                     TaskIndex,
+  OUT EFI_PHYSICAL_ADDRESS      *Start,
+  OUT UINT64                    *Size
+  )
+{
+  UINT64  Offset;
+
+  Offset = MultU64x64 (MEMORY_TEST_TASK_SIZE, TaskIndex);
+  *Start = Context->Start + Offset;
+  *Size  = MIN (MEMORY_TEST_TASK_SIZE, Context->Size - Offset);
+}
+
+/**
+  The memory test task that writes the pattern into its range of memory.
+
+  @param[in] TaskIndex  The index of the task.
+  @param[in] Context    The context of the memory test tasks.
+
+**/
+VOID
+EFIAPI
+WriteMemoryTask (
+  IN UINTN  TaskIndex,
+  IN VOID   *Context
+  )
+{
+  MEMORY_TEST_TASK_CONTEXT  *TaskContext;
+  EFI_PHYSICAL_ADDRESS      Start;
+  UINT64                    Size;
+
+  TaskContext = (MEMORY_TEST_TASK_CONTEXT *)Context;
+  GetMemoryTestTaskRange (TaskContext, TaskIndex, &Start, &Size);
+
+  WriteMemoryRange (TaskContext->Private, Start, Size);
+
+  //
+  // The CPU arch protocol may only be used on the BSP, so each processor
+  // writes back and invalidates its own range of the cache.
+  //
+  WriteBackInvalidateDataCacheRange ((VOID *)(UINTN)Start, (UINTN)Size);
+}
+
+/**
+  The memory test task that verifies the pattern in its range of memory, and
+  records the lowest address mis-compared in the context.
+
+  @param[in] TaskIndex  The index of the task.
+  @param[in] Context    The context of the memory test tasks.
+
+**/
+VOID
+EFIAPI
+VerifyMemoryTask (
+  IN UINTN  TaskIndex,
+  IN VOID   *Context
+  )
+{
+  MEMORY_TEST_TASK_CONTEXT  *TaskContext;
+  EFI_PHYSICAL_ADDRESS      Start;
+  UINT64                    Size;
+  EFI_PHYSICAL_ADDRESS      ErrorAddress;
+  UINT64                    LowestAddress;
+
+  TaskContext = (MEMORY_TEST_TASK_CONTEXT *)Context;
+  GetMemoryTestTaskRange (TaskContext, TaskIndex, &Start, &Size);
+
+  ErrorAddress = VerifyMemoryRange (TaskContext->Private, Start, Size);
+
+  do {
+    LowestAddress = TaskContext->ErrorAddress;
+    if (ErrorAddress >= LowestAddress) {
+      break;
+    }
+  } while (InterlockedCompareExchange64 (&TaskContext->ErrorAddress, LowestAddress, ErrorAddress) != LowestAddress);
+}
+
+/**
+  Run the tasks that write or verify a range of physical memory on all the
+  processors.
+
+  @param[in]      Procedure  The memory test task to run.
+  @param[in, out] Context    The context of the memory test tasks.
+
+  @retval TRUE    The tasks are done on all the processors.
+  @retval FALSE   The tasks are not run, and the range is to be tested on the
+                  BSP only.
+
+**/
+BOOLEAN
+RunMemoryTestTasks (
+  IN     EDKII_MP_TASK_PROCEDURE   Procedure,
+  IN OUT MEMORY_TEST_TASK_CONTEXT  *Context
+  )
+{
+  GENERIC_MEMORY_TEST_PRIVATE  *Private;
+  UINT64                       TaskCount;
+  EFI_STATUS                   Status;
+
+  Private = Context->Private;
+
+  //
+  // Each task must start on a pattern boundary, and the APs are only worth
+  // waking up if the pattern covers the whole range.
+  //
+  if ((Private->MpTaskQueue == NULL) ||
+      (Private->CoverageSpan != Private->MonoTestSize) ||
+      (Context->Size <= MEMORY_TEST_TASK_SIZE))
+  {
+    return FALSE;
+  }
+
+  TaskCount = DivU64x32 (Context->Size + MEMORY_TEST_TASK_SIZE - 1, MEMORY_TEST_TASK_SIZE);
+  Status    = Private->MpTaskQueue->RunTasks (
+                                      Private->MpTaskQueue,
+                                      Procedure,
+                                      (UINTN)TaskCount,
+                                      Context
+                                      );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: %r, test the range on the BSP\n", __FUNCTION__, Status));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
   Write the memory test pattern into a range of physical memory.
 
@@ -333,9 +621,7 @@ WriteMemory (
   IN  UINT64                       Size
   )
 {
-  EFI_PHYSICAL_ADDRESS  Address;
-
-  Address = Start;
+  MEMORY_TEST_TASK_CONTEXT  Context;
 
   //
   // Add 4G memory address check for IA32 platform
@@ -345,11 +631,19 @@ WriteMemory (
     return EFI_SUCCESS;
   }
 
-  while (Address < (Start + Size)) {
-    CopyMem ((VOID *)(UINTN)Address, Private->MonoPattern, Private->MonoTestSize);
-    Address += Private->CoverageSpan;
+  Context.Private      = Private;
+  Context.Start        = Start;
+  Context.Size         = Size;
+  Context.ErrorAddress = MAX_UINT64;
+  if (RunMemoryTestTasks (WriteMemoryTask, &Context)) {
+    //
+    // The tasks have written back and invalidated their ranges of the cache
+    //
+    return EFI_SUCCESS;
   }
 
+  WriteMemoryRange (Private, Start, Size);
+
   //
   // bug bug: we may need GCD service to make the code cache and data uncache,
   // if GCD do not support it or return fail, then just flush the whole cache.
@@ -382,11 +676,9 @@ VerifyMemory (
   IN  UINT64                       Size
   )
 {
-  EFI_PHYSICAL_ADDRESS            Address;
-  INTN                            ErrorFound;
+  MEMORY_TEST_TASK_CONTEXT        Context;
   EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
 
-  Address           = Start;
   ExtendedErrorData = NULL;
 
   //
@@ -402,48 +694,113 @@ VerifyMemory (
   // error here. If there is miscompare error here then check if generic
   // memory test driver can disable the bad DIMM.
   //
-  while (Address < (Start + Size)) {
-    ErrorFound = CompareMemWithoutCheckArgument (
-                   (VOID *)(UINTN)(Address),
-                   Private->MonoPattern,
-                   Private->MonoTestSize
-                   );
-    if (ErrorFound != 0) {
-      //
-      // Report uncorrectable errors
-      //
-      ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
-      if (ExtendedErrorData == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
-      ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
-      ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
-      ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
-      ExtendedErrorData->Syndrome              = 0x0;
-      ExtendedErrorData->Address               = Address;
-      ExtendedErrorData->Resolution            = 0x40;
-
-      REPORT_STATUS_CODE_EX (
-        EFI_ERROR_CODE,
-        EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
-        0,
-        &gEfiGenericMemTestProtocolGuid,
-        NULL,
-        (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
-        ExtendedErrorData->DataHeader.Size
-        );
+  Context.Private      = Private;
+  Context.Start        = Start;
+  Context.Size         = Size;
+  Context.ErrorAddress = MAX_UINT64;
+  if (!RunMemoryTestTasks (VerifyMemoryTask, &Context)) {
+    Context.ErrorAddress = VerifyMemoryRange (Private, Start, Size);
+  }
 
-      return EFI_DEVICE_ERROR;
+  if (Context.ErrorAddress != MAX_UINT64) {
+    //
+    // Report uncorrectable errors
+    //
+    ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
+    if (ExtendedErrorData == NULL) {
+      return EFI_OUT_OF_RESOURCES;
     }
 
-    Address += Private->CoverageSpan;
+    ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
+    ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+    ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
+    ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
+    ExtendedErrorData->Syndrome              = 0x0;
+    ExtendedErrorData->Address               = Context.ErrorAddress;
+    ExtendedErrorData->Resolution            = 0x40;
+
+    REPORT_STATUS_CODE_EX (
+      EFI_ERROR_CODE,
+      EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+      0,
+      &gEfiGenericMemTestProtocolGuid,
+      NULL,
+      (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
+      ExtendedErrorData->DataHeader.Size
+      );
+
+    return EFI_DEVICE_ERROR;
   }
 
   return EFI_SUCCESS;
 }
 
+/**
+  Prepare to test the memory on all the processors, through the MP task queue
+  protocol if it is produced by the CPU driver.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+**/
+VOID
+InitializeMemoryTestTasks (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  )
+{
+  EFI_STATUS                    Status;
+  EDKII_MP_TASK_QUEUE_PROTOCOL  *MpTaskQueue;
+  EFI_MP_SERVICES_PROTOCOL      *MpServices;
+  UINTN                         NumberOfProcessors;
+  UINTN                         NumberOfEnabledProcessors;
+
+  Status = gBS->LocateProtocol (
+                  &gEdkiiMpTaskQueueProtocolGuid,
+                  NULL,
+                  (VOID **)&MpTaskQueue
+                  );
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  Status = gBS->LocateProtocol (
+                  &gEfiMpServiceProtocolGuid,
+                  NULL,
+                  (VOID **)&MpServices
+                  );
+  if (!EFI_ERROR (Status)) {
+    Status = MpServices->GetNumberOfProcessors (
+                           MpServices,
+                           &NumberOfProcessors,
+                           &NumberOfEnabledProcessors
+                           );
+  }
+
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return;
+  }
+
+  //
+  // Make the BDS block large enough to keep all the processors busy, and to
+  // balance the tasks among them.
+  //
+  Private->MpTaskQueue    = MpTaskQueue;
+  Private->ProcessorCount = NumberOfEnabledProcessors;
+  Private->BdsBlockSize   = MAX (
+                              TEST_BLOCK_SIZE,
+                              MultU64x32 (
+                                MEMORY_TEST_TASK_SIZE,
+                                (UINT32)(NumberOfEnabledProcessors * MEMORY_TEST_TASKS_PER_PROCESSOR)
+                                )
+                              );
+
+  DEBUG ((
+    DEBUG_INFO,
+    "GenericMemoryTest: Test the memory on %d processors in blocks of 0x%lx bytes\n",
+    NumberOfEnabledProcessors,
+    Private->BdsBlockSize
+    ));
+}
+
 /**
   Initialize the generic memory test.
 
@@ -522,6 +879,18 @@ InitializeMemoryTest (
       break;
   }
 
+  //
+  // The memory is only worth testing on all the processors if the pattern
+  // covers all of it.
+  //
+  Private->MpTaskQueue    = NULL;
+  Private->ProcessorCount = 1;
+  Private->TestedBytes    = 0;
+  Private->TestTime       = 0;
+  if (PcdGetBool (PcdMemoryTestOnAllProcessors) && (Private->CoverageSpan == Private->MonoTestSize)) {
+    InitializeMemoryTestTasks (Private);
+  }
+
   //
   // This is the first time we construct the non-tested memory range, if no
   // extended memory found, we know the system have not any extended memory
@@ -572,6 +941,8 @@ GenPerformMemoryTest (
   GENERIC_MEMORY_TEST_PRIVATE     *Private;
   EFI_MEMORY_RANGE_EXTENDED_DATA  *RangeData;
   UINT64                          BlockBoundary;
+  UINT64                          Begin;
+  UINT64                          Time;
 
   Private       = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
   *ErrorOut     = FALSE;
@@ -621,6 +992,8 @@ GenPerformMemoryTest (
       // The software memory test (R/W/V) perform here. It will detect the
       // memory mis-compare error.
       //
+      Begin = GetPerformanceCounter ();
+
       WriteMemory (Private, mCurrentAddress, BlockBoundary);
 
       Status = VerifyMemory (Private, mCurrentAddress, BlockBoundary);
@@ -632,6 +1005,20 @@ GenPerformMemoryTest (
         *ErrorOut = TRUE;
         return EFI_DEVICE_ERROR;
       }
+
+      Time                  = GetMemoryTestElapsedTime (Begin);
+      Private->TestedBytes += BlockBoundary;
+      Private->TestTime    += Time;
+
+      DEBUG ((
+        DEBUG_VERBOSE,
+        "GenericMemoryTest: 0x%lx - 0x%lx tested, %ld of %ld MB, %ld MB/s\n",
+        mCurrentAddress,
+        mCurrentAddress + BlockBoundary - 1,
+        RShiftU64 (mTestedSystemMemory + BlockBoundary, 20),
+        RShiftU64 (Private->BaseMemorySize + mNonTestedSystemMemory, 20),
+        GetMemoryTestBandwidth (BlockBoundary, Time)
+        ));
     }
 
     mTestedSystemMemory += BlockBoundary;
@@ -689,6 +1076,17 @@ GenMemoryTestFinished (
 
   Private = GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS (This);
 
+  if (Private->TestTime != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "GenericMemoryTest: %ld MB tested in %ld ms on %d processors, %ld MB/s\n",
+      RShiftU64 (Private->TestedBytes, 20),
+      DivU64x32 (Private->TestTime, 1000000),
+      Private->ProcessorCount,
+      GetMemoryTestBandwidth (Private->TestedBytes, Private->TestTime)
+      ));
+  }
+
   //
   // Perform Data and Address line test only if not ignore memory test
   //
@@ -868,7 +1266,11 @@ GENERIC_MEMORY_TEST_PRIVATE  mGenericMemoryTestPrivate = {
   {
     NULL,
     NULL
-  }
+  },
+  NULL,
+  1,
+  0,
+  0
 };
 
 /**
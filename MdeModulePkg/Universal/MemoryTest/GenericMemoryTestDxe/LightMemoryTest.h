@@ -13,6 +13,8 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Protocol/GenericMemoryTest.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MpService.h>
+#include <Protocol/MpTaskQueue.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -23,6 +25,10 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/CacheMaintenanceLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
 
 //
 // Some global define
@@ -43,6 +49,14 @@
 #define QUICK_SPAN_SIZE   (TEST_BLOCK_SIZE >> 2)
 #define SPARSE_SPAN_SIZE  (TEST_BLOCK_SIZE >> 4)
 
+//
+// When the memory is tested on all the processors, the BDS block is split in
+// tasks of MEMORY_TEST_TASK_SIZE bytes, and is made large enough to give each
+// processor MEMORY_TEST_TASKS_PER_PROCESSOR tasks.
+//
+#define MEMORY_TEST_TASK_SIZE            (TEST_BLOCK_SIZE >> 3)
+#define MEMORY_TEST_TASKS_PER_PROCESSOR  4
+
 //
 // This structure records every nontested memory range parsed through GCD
 // service.
@@ -108,6 +122,19 @@ typedef struct {
   // memory range list
   //
   LIST_ENTRY                          NonTestedMemRanList;
+
+  //
+  // MP task queue protocol's pointer, NULL if the memory is tested on the BSP
+  // only, and the number of processors testing the memory
+  //
+  EDKII_MP_TASK_QUEUE_PROTOCOL        *MpTaskQueue;
+  UINTN                               ProcessorCount;
+
+  //
+  // the bytes written and verified, and the time spent on them in nanoseconds
+  //
+  UINT64                              TestedBytes;
+  UINT64                              TestTime;
 } GENERIC_MEMORY_TEST_PRIVATE;
 
 #define GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS(a) \
@@ -118,6 +145,17 @@ typedef struct {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE \
   )
 
+//
+// The context of the tasks that write or verify a range of memory on all the
+// processors. Each task covers MEMORY_TEST_TASK_SIZE bytes of the range.
+//
+typedef struct {
+  GENERIC_MEMORY_TEST_PRIVATE    *Private;
+  EFI_PHYSICAL_ADDRESS           Start;
+  UINT64                         Size;
+  volatile UINT64                ErrorAddress;  ///< The lowest address failed, MAX_UINT64 if none
+} MEMORY_TEST_TASK_CONTEXT;
+
 //
 // Function Prototypes
 //
@@ -36,6 +36,10 @@ PEI_PCD_DATABASE  *mPeiPcdDbBinary = NULL;
 UINTN             mDxePcdDbSize    = 0;
 DXE_PCD_DATABASE  *mDxePcdDbBinary = NULL;
 
+UINT32  *mExTokenIndexBuckets    = NULL;
+UINT32  *mExTokenIndexLinks      = NULL;
+UINT32  mExTokenIndexBucketCount = 0;
+
 /**
   Get Local Token Number by Token Number.
 
@@ -842,6 +846,96 @@ UpdatePcdDatabase (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Get the hash of a DynamicEx PCD for the hash index of the DynamicEx mapping
+  tables.
+
+  @param  Guid            Token space guid of the PCD.
+  @param  ExTokenNumber   Dynamic-ex token number of the PCD.
+
+  @return The hash of the PCD.
+**/
+UINT32
+GetExTokenHash (
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           ExTokenNumber
+  )
+{
+  return (UINT32)ExTokenNumber ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+}
+
+/**
+  Get a DynamicEx mapping by its index in the PEI and DXE mapping tables,
+  the PEI mappings being the first ones.
+
+  @param  Index       The index of the mapping.
+  @param  GuidTable   Return the guid table of the database of the mapping.
+
+  @return The DynamicEx mapping.
+**/
+DYNAMICEX_MAPPING *
+GetExMappingByIndex (
+  IN  UINTN     Index,
+  OUT EFI_GUID  **GuidTable
+  )
+{
+  if (Index < mPcdDatabase.PeiDb->ExTokenCount) {
+    *GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->GuidTableOffset);
+    return (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset) + Index;
+  }
+
+  Index     -= mPcdDatabase.PeiDb->ExTokenCount;
+  *GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->GuidTableOffset);
+  return (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.DxeDb + mPcdDatabase.DxeDb->ExMapTableOffset) + Index;
+}
+
+/**
+  Build the hash index of the PEI and DXE DynamicEx mapping tables, so that
+  the token number of a DynamicEx PCD is found without scanning the tables.
+
+**/
+VOID
+BuildExTokenIndex (
+  VOID
+  )
+{
+  UINTN              ExTokenCount;
+  UINT32             BucketCount;
+  UINT32             Bucket;
+  UINTN              Index;
+  DYNAMICEX_MAPPING  *ExMap;
+  EFI_GUID           *GuidTable;
+
+  ExTokenCount = mPcdDatabase.PeiDb->ExTokenCount + mPcdDatabase.DxeDb->ExTokenCount;
+  if (ExTokenCount == 0) {
+    return;
+  }
+
+  BucketCount          = MIN (GetPowerOfTwo32 ((UINT32)ExTokenCount) << 1, PCD_EX_TOKEN_INDEX_MAX_BUCKETS);
+  mExTokenIndexBuckets = AllocateZeroPool ((BucketCount + ExTokenCount) * sizeof (UINT32));
+  if (mExTokenIndexBuckets == NULL) {
+    return;
+  }
+
+  mExTokenIndexLinks       = mExTokenIndexBuckets + BucketCount;
+  mExTokenIndexBucketCount = BucketCount;
+
+  //
+  // Insert the mappings in reverse order, so that each bucket lists them in
+  // the order of the mapping tables, and the PEI mappings are found first.
+  //
+  for (Index = ExTokenCount; Index > 0; Index--) {
+    ExMap                         = GetExMappingByIndex (Index - 1, &GuidTable);
+    Bucket                        = GetExTokenHash (&GuidTable[ExMap->ExGuidIndex], ExMap->ExTokenNumber) & (BucketCount - 1);
+    mExTokenIndexLinks[Index - 1] = mExTokenIndexBuckets[Bucket];
+    mExTokenIndexBuckets[Bucket]  = (UINT32)Index;
+  }
+}
+
 /**
   Initialize the PCD database in DXE phase.
 
@@ -945,6 +1039,8 @@ BuildPcdDxeDataBase (
   for (Index = 0; Index + 1 < mPcdTotalTokenCount + 1; Index++) {
     InitializeListHead (&mCallbackFnTable[Index]);
   }
+
+  BuildExTokenIndex ();
 }
 
 /**
@@ -1588,6 +1684,23 @@ GetExPcdTokenNumber (
   EFI_GUID           *MatchGuid;
   UINTN              MatchGuidIdx;
 
+  if (mExTokenIndexBuckets != NULL) {
+    Index = mExTokenIndexBuckets[GetExTokenHash (Guid, ExTokenNumber) & (mExTokenIndexBucketCount - 1)];
+    for ( ; Index != 0; Index = mExTokenIndexLinks[Index - 1]) {
+      ExMap = GetExMappingByIndex (Index - 1, &GuidTable);
+      if ((ExTokenNumber == ExMap->ExTokenNumber) &&
+          CompareGuid (&GuidTable[ExMap->ExGuidIndex], Guid))
+      {
+        return ExMap->TokenNumber;
+      }
+    }
+
+    DEBUG ((DEBUG_ERROR, "%a: Failed to find PCD with GUID: %g and token number: %d\n", __FUNCTION__, Guid, ExTokenNumber));
+    ASSERT (FALSE);
+
+    return 0;
+  }
+
   if (!mPeiDatabaseEmpty) {
     ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->ExMapTableOffset);
     GuidTable = (EFI_GUID *)((UINT8 *)mPcdDatabase.PeiDb + mPcdDatabase.PeiDb->GuidTableOffset);
@@ -42,6 +42,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   #error "Please make sure the version of PCD DXE Service and the generated PCD DXE Database match."
 #endif
 
+//
+// The buckets of the hash index of the DynamicEx mapping tables are limited
+// to PCD_EX_TOKEN_INDEX_MAX_BUCKETS.
+//
+#define PCD_EX_TOKEN_INDEX_MAX_BUCKETS  1024
+
 extern UINTN  mVpdBaseAddress;
 
 /**
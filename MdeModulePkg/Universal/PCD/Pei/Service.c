@@ -411,6 +411,195 @@ LocateExPcdBinary (
   return PcdDb;
 }
 
+/**
+  Get the hash of a DynamicEx PCD for the hash index of the DynamicEx mapping
+  table.
+
+  @param  Guid            Token space guid of the PCD.
+  @param  ExTokenNumber   Dynamic-ex token number of the PCD.
+
+  @return The hash of the PCD.
+**/
+UINT32
+GetExTokenHash (
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           ExTokenNumber
+  )
+{
+  return (UINT32)ExTokenNumber ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 1) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 2) ^
+         ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+}
+
+/**
+  Get the next GUID HOB of this PEIM that holds a structure of the given
+  signature. The callback table HOB, which is the first GUID HOB of this
+  PEIM, is skipped.
+
+  @param  Signature   The signature of the structure.
+  @param  GuidHob     The GUID HOB to search after, or NULL to search from the
+                      first one.
+
+  @return The GUID HOB found, or NULL if not found.
+**/
+EFI_HOB_GUID_TYPE *
+GetNextPcdPeimHob (
+  IN UINT32             Signature,
+  IN EFI_HOB_GUID_TYPE  *GuidHob  OPTIONAL
+  )
+{
+  if (GuidHob == NULL) {
+    GuidHob = GetFirstGuidHob (&gEfiCallerIdGuid);
+    if (GuidHob == NULL) {
+      return NULL;
+    }
+  }
+
+  for (GuidHob = GetNextGuidHob (&gEfiCallerIdGuid, GET_NEXT_HOB (GuidHob));
+       GuidHob != NULL;
+       GuidHob = GetNextGuidHob (&gEfiCallerIdGuid, GET_NEXT_HOB (GuidHob)))
+  {
+    if (ReadUnaligned32 ((UINT32 *)GET_GUID_HOB_DATA (GuidHob)) == Signature) {
+      return GuidHob;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Build the hash index of the DynamicEx mapping table, so that the token
+  number of a DynamicEx PCD is found without scanning the whole table.
+
+  @param  Database  Pointer to PCD database.
+**/
+VOID
+BuildExTokenIndex (
+  IN PEI_PCD_DATABASE  *Database
+  )
+{
+  PCD_PEI_EX_TOKEN_INDEX  *ExTokenIndex;
+  DYNAMICEX_MAPPING       *ExMap;
+  EFI_GUID                *GuidTable;
+  UINT16                  *Buckets;
+  UINT16                  *Links;
+  UINT32                  BucketCount;
+  UINT32                  Bucket;
+  UINTN                   Index;
+
+  if (Database->ExTokenCount == 0) {
+    return;
+  }
+
+  BucketCount  = MIN (GetPowerOfTwo32 (Database->ExTokenCount) << 1, PCD_EX_TOKEN_INDEX_MAX_BUCKETS);
+  ExTokenIndex = BuildGuidHob (
+                   &gEfiCallerIdGuid,
+                   sizeof (PCD_PEI_EX_TOKEN_INDEX) + (BucketCount + Database->ExTokenCount) * sizeof (UINT16)
+                   );
+  if (ExTokenIndex == NULL) {
+    return;
+  }
+
+  ExTokenIndex->Signature   = PCD_PEI_EX_TOKEN_INDEX_SIGNATURE;
+  ExTokenIndex->BucketCount = BucketCount;
+
+  Buckets = (UINT16 *)(ExTokenIndex + 1);
+  Links   = Buckets + BucketCount;
+  ZeroMem (Buckets, BucketCount * sizeof (UINT16));
+
+  ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)Database + Database->ExMapTableOffset);
+  GuidTable = (EFI_GUID *)((UINT8 *)Database + Database->GuidTableOffset);
+
+  //
+  // Insert the mappings in reverse order, so that each bucket lists them in
+  // the order of the mapping table.
+  //
+  for (Index = Database->ExTokenCount; Index > 0; Index--) {
+    Bucket           = GetExTokenHash (&GuidTable[ExMap[Index - 1].ExGuidIndex], ExMap[Index - 1].ExTokenNumber) & (BucketCount - 1);
+    Links[Index - 1] = Buckets[Bucket];
+    Buckets[Bucket]  = (UINT16)Index;
+  }
+}
+
+/**
+  Find a variable read for HII type PCDs before.
+
+  @param  VariableGuid   The Variable GUID.
+  @param  VariableName   The Variable Name.
+
+  @return The variable found, or NULL if not found.
+**/
+PCD_PEI_HII_VARIABLE_CACHE *
+FindHiiVariableCache (
+  IN CONST EFI_GUID  *VariableGuid,
+  IN UINT16          *VariableName
+  )
+{
+  EFI_HOB_GUID_TYPE           *GuidHob;
+  PCD_PEI_HII_VARIABLE_CACHE  *Cache;
+  UINTN                       NameSize;
+
+  NameSize = StrSize (VariableName);
+
+  for (GuidHob = GetNextPcdPeimHob (PCD_PEI_HII_VARIABLE_CACHE_SIGNATURE, NULL);
+       GuidHob != NULL;
+       GuidHob = GetNextPcdPeimHob (PCD_PEI_HII_VARIABLE_CACHE_SIGNATURE, GuidHob))
+  {
+    Cache = (PCD_PEI_HII_VARIABLE_CACHE *)GET_GUID_HOB_DATA (GuidHob);
+    if ((Cache->NameSize == NameSize) &&
+        CompareGuid (&Cache->Guid, VariableGuid) &&
+        (CompareMem (Cache + 1, VariableName, NameSize) == 0))
+    {
+      return Cache;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Create the HOB to keep a variable read for HII type PCDs. The HOB only
+  becomes valid when its signature is set after the data is read into it.
+
+  @param  VariableGuid   The Variable GUID.
+  @param  VariableName   The Variable Name.
+  @param  DataSize       The size of the variable.
+
+  @return The variable cache created, or NULL if the variable is too large.
+**/
+PCD_PEI_HII_VARIABLE_CACHE *
+CreateHiiVariableCache (
+  IN CONST EFI_GUID  *VariableGuid,
+  IN UINT16          *VariableName,
+  IN UINTN           DataSize
+  )
+{
+  PCD_PEI_HII_VARIABLE_CACHE  *Cache;
+  UINTN                       NameSize;
+  UINTN                       CacheSize;
+
+  NameSize  = StrSize (VariableName);
+  CacheSize = sizeof (PCD_PEI_HII_VARIABLE_CACHE) + NameSize + DataSize;
+  if (CacheSize > (0xFFF8 - sizeof (EFI_HOB_GUID_TYPE))) {
+    return NULL;
+  }
+
+  Cache = BuildGuidHob (&gEfiCallerIdGuid, CacheSize);
+  if (Cache == NULL) {
+    return NULL;
+  }
+
+  Cache->Signature = 0;
+  Cache->NameSize  = (UINT32)NameSize;
+  Cache->DataSize  = (UINT32)DataSize;
+  CopyGuid (&Cache->Guid, VariableGuid);
+  CopyMem (Cache + 1, VariableName, NameSize);
+
+  return Cache;
+}
+
 /**
   The function builds the PCD database.
 
@@ -450,6 +639,8 @@ BuildPcdDatabase (
 
   ZeroMem (CallbackFnTable, SizeOfCallbackFnTable);
 
+  BuildExTokenIndex (Database);
+
   return Database;
 }
 
@@ -477,6 +668,14 @@ GetHiiVariable (
   EFI_STATUS                       Status;
   VOID                             *Buffer;
   EFI_PEI_READ_ONLY_VARIABLE2_PPI  *VariablePpi;
+  PCD_PEI_HII_VARIABLE_CACHE       *Cache;
+
+  Cache = FindHiiVariableCache (VariableGuid, VariableName);
+  if (Cache != NULL) {
+    *VariableSize = Cache->DataSize;
+    *VariableData = (UINT8 *)(Cache + 1) + Cache->NameSize;
+    return EFI_SUCCESS;
+  }
 
   Status = PeiServicesLocatePpi (&gEfiPeiReadOnlyVariable2PpiGuid, 0, NULL, (VOID **)&VariablePpi);
   ASSERT_EFI_ERROR (Status);
@@ -492,8 +691,16 @@ GetHiiVariable (
                           );
 
   if (Status == EFI_BUFFER_TOO_SMALL) {
-    Status = PeiServicesAllocatePool (Size, &Buffer);
-    ASSERT_EFI_ERROR (Status);
+    //
+    // Read the variable into its cache HOB, so that it is not read again.
+    //
+    Cache = CreateHiiVariableCache (VariableGuid, VariableName, Size);
+    if (Cache != NULL) {
+      Buffer = (UINT8 *)(Cache + 1) + Cache->NameSize;
+    } else {
+      Status = PeiServicesAllocatePool (Size, &Buffer);
+      ASSERT_EFI_ERROR (Status);
+    }
 
     Status = VariablePpi->GetVariable (
                             VariablePpi,
@@ -505,6 +712,10 @@ GetHiiVariable (
                             );
     ASSERT_EFI_ERROR (Status);
 
+    if ((Cache != NULL) && !EFI_ERROR (Status)) {
+      Cache->Signature = PCD_PEI_HII_VARIABLE_CACHE_SIGNATURE;
+    }
+
     *VariableSize = Size;
     *VariableData = Buffer;
 
@@ -969,7 +1180,7 @@ GetWorker (
   @param Guid            Token space guid for dynamic-ex PCD entry.
   @param ExTokenNumber   Dynamic-ex PCD token number.
 
-  @return Token Number for dynamic-ex PCD.
+  @return Token Number for dynamic-ex PCD, or PCD_INVALID_TOKEN_NUMBER if it is not found.
 
 **/
 UINTN
@@ -978,18 +1189,44 @@ GetExPcdTokenNumber (
   IN UINTN           ExTokenNumber
   )
 {
-  UINT32             Index;
-  DYNAMICEX_MAPPING  *ExMap;
-  EFI_GUID           *GuidTable;
-  EFI_GUID           *MatchGuid;
-  UINTN              MatchGuidIdx;
-  PEI_PCD_DATABASE   *PeiPcdDb;
+  UINT32                  Index;
+  DYNAMICEX_MAPPING       *ExMap;
+  EFI_GUID                *GuidTable;
+  EFI_GUID                *MatchGuid;
+  UINTN                   MatchGuidIdx;
+  PEI_PCD_DATABASE        *PeiPcdDb;
+  EFI_HOB_GUID_TYPE       *GuidHob;
+  PCD_PEI_EX_TOKEN_INDEX  *ExTokenIndex;
+  UINT16                  *Links;
 
   PeiPcdDb = GetPcdDatabase ();
 
   ExMap     = (DYNAMICEX_MAPPING *)((UINT8 *)PeiPcdDb + PeiPcdDb->ExMapTableOffset);
   GuidTable = (EFI_GUID *)((UINT8 *)PeiPcdDb + PeiPcdDb->GuidTableOffset);
 
+  GuidHob = GetNextPcdPeimHob (PCD_PEI_EX_TOKEN_INDEX_SIGNATURE, NULL);
+  if (GuidHob != NULL) {
+    ExTokenIndex = (PCD_PEI_EX_TOKEN_INDEX *)GET_GUID_HOB_DATA (GuidHob);
+    Links        = (UINT16 *)(ExTokenIndex + 1) + ExTokenIndex->BucketCount;
+
+    Index = ((UINT16 *)(ExTokenIndex + 1))[GetExTokenHash (Guid, ExTokenNumber) & (ExTokenIndex->BucketCount - 1)];
+    for ( ; Index != 0; Index = Links[Index - 1]) {
+      if ((ExTokenNumber == ExMap[Index - 1].ExTokenNumber) &&
+          CompareGuid (&GuidTable[ExMap[Index - 1].ExGuidIndex], Guid))
+      {
+        return ExMap[Index - 1].TokenNumber;
+      }
+    }
+
+    //
+    // The callers report a DynamicEx PCD that is not found as EFI_NOT_FOUND,
+    // so do not ASSERT here.
+    //
+    DEBUG ((DEBUG_ERROR, "%a: Failed to find PCD with GUID: %g and token number: %d\n", __FUNCTION__, Guid, (UINT32)ExTokenNumber));
+
+    return PCD_INVALID_TOKEN_NUMBER;
+  }
+
   MatchGuid = ScanGuid (GuidTable, PeiPcdDb->GuidTableCount * sizeof (EFI_GUID), Guid);
   //
   // We need to ASSERT here. If GUID can't be found in GuidTable, this is a
@@ -1007,6 +1244,8 @@ GetExPcdTokenNumber (
     }
   }
 
+  DEBUG ((DEBUG_ERROR, "%a: Failed to find PCD with GUID: %g and token number: %d\n", __FUNCTION__, Guid, (UINT32)ExTokenNumber));
+
   return PCD_INVALID_TOKEN_NUMBER;
 }
 
@@ -40,6 +40,38 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
   #error "Please make sure the version of PCD PEIM Service and the generated PCD PEI Database match."
 #endif
 
+//
+// The hash index of the DynamicEx mapping table and the variables read for
+// the HII type PCDs are kept in the GUID HOBs of this PEIM that follow its
+// callback table HOB, so that they are writable and move to the permanent
+// memory with the PCD database.
+//
+#define PCD_PEI_EX_TOKEN_INDEX_SIGNATURE      SIGNATURE_32 ('P', 'E', 'X', 'I')
+#define PCD_PEI_HII_VARIABLE_CACHE_SIGNATURE  SIGNATURE_32 ('P', 'H', 'V', 'C')
+#define PCD_EX_TOKEN_INDEX_MAX_BUCKETS        1024
+
+///
+/// The hash index of the DynamicEx mapping table. It is followed by the
+/// UINT16 heads of the buckets and the UINT16 links of the mappings. Both
+/// hold the index of a mapping plus 1, or 0 at the end of a bucket.
+///
+typedef struct {
+  UINT32    Signature;
+  UINT32    BucketCount;    ///< A power of 2
+} PCD_PEI_EX_TOKEN_INDEX;
+
+///
+/// A variable read for HII type PCDs. As the variables can not be changed in
+/// PEI phase, each one is only read once. It is followed by the name and the
+/// data of the variable.
+///
+typedef struct {
+  UINT32      Signature;
+  UINT32      NameSize;
+  UINT32      DataSize;
+  EFI_GUID    Guid;
+} PCD_PEI_HII_VARIABLE_CACHE;
+
 /**
   Retrieve additional information associated with a PCD token in the default token space.
 
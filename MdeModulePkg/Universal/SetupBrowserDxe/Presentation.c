@@ -1684,6 +1684,55 @@ ProcessUserInput (
   return Status;
 }
 
+/**
+  Get the form title and the prompt, help and option strings of all statements
+  in the form, as the form display does when it renders the form, and measure
+  the time for the boot performance log.
+
+  @param  FormSet                The form set of the form.
+  @param  Form                   The form to be rendered.
+
+**/
+VOID
+MeasureFormStrings (
+  IN FORM_BROWSER_FORMSET  *FormSet,
+  IN FORM_BROWSER_FORM     *Form
+  )
+{
+  LIST_ENTRY              *Link;
+  LIST_ENTRY              *OptionLink;
+  FORM_BROWSER_STATEMENT  *Statement;
+  QUESTION_OPTION         *Option;
+
+  PERF_INMODULE_BEGIN ("FormStrings");
+
+  FreePool (GetToken (Form->FormTitle, FormSet->HiiHandle));
+
+  Link = GetFirstNode (&Form->StatementListHead);
+  while (!IsNull (&Form->StatementListHead, Link)) {
+    Statement = FORM_BROWSER_STATEMENT_FROM_LINK (Link);
+    Link      = GetNextNode (&Form->StatementListHead, Link);
+
+    if (Statement->Prompt != 0) {
+      FreePool (GetToken (Statement->Prompt, FormSet->HiiHandle));
+    }
+
+    if (Statement->Help != 0) {
+      FreePool (GetToken (Statement->Help, FormSet->HiiHandle));
+    }
+
+    OptionLink = GetFirstNode (&Statement->OptionListHead);
+    while (!IsNull (&Statement->OptionListHead, OptionLink)) {
+      Option     = QUESTION_OPTION_FROM_LINK (OptionLink);
+      OptionLink = GetNextNode (&Statement->OptionListHead, OptionLink);
+
+      FreePool (GetToken (Option->Text, FormSet->HiiHandle));
+    }
+  }
+
+  PERF_INMODULE_END ("FormStrings");
+}
+
 /**
 
   Display form and wait for user to select one menu option, then return it.
@@ -1740,6 +1789,10 @@ DisplayForm (
 
   UpdateDisplayFormData ();
 
+  PERF_CODE (
+    MeasureFormStrings (gCurrentSelection->FormSet, gCurrentSelection->Form);
+    );
+
   ASSERT (gDisplayFormData.BrowserStatus == BROWSER_SUCCESS);
   Status = mFormDisplay->FormDisplay (&gDisplayFormData, &UserInput);
   if (EFI_ERROR (Status)) {
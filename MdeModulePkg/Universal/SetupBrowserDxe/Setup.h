@@ -44,6 +44,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PcdLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/UefiLib.h>
+#include <Library/PerformanceLib.h>
 
 //
 // This is the generated header file which includes whatever needs to be exported (strings + IFR)
@@ -75,6 +75,20 @@
 ///
 #define HTTP_HEADER_ACCEPT_RANGES  "Accept-Ranges"
 
+///
+/// Range Request Header
+/// The Range request-header field asks the server to transfer only
+/// the given byte ranges of the selected representation.
+///
+#define HTTP_HEADER_RANGE  "Range"
+
+///
+/// Content-Range Response Header
+/// The Content-Range header field is sent in a 206 (Partial Content)
+/// response to indicate the range of the representation enclosed.
+///
+#define HTTP_HEADER_CONTENT_RANGE  "Content-Range"
+
 ///
 /// Accept-Encoding Request Header
 /// The Accept-Encoding request-header field is similar to Accept,
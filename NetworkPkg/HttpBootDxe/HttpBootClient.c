@@ -597,21 +597,22 @@ HttpBootHttpIoCallback (
 }
 
 /**
-  Create a HttpIo instance for the file download.
+  Create and configure a HttpIo instance with the station address of the driver.
 
   @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to create.
 
   @retval EFI_SUCCESS          Successfully created.
   @retval Others               Failed to create HttpIo.
 
 **/
 EFI_STATUS
-HttpBootCreateHttpIo (
-  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
   )
 {
   HTTP_IO_CONFIG_DATA  ConfigData;
-  EFI_STATUS           Status;
   EFI_HANDLE           ImageHandle;
   UINT32               TimeoutValue;
 
@@ -636,15 +637,36 @@ HttpBootCreateHttpIo (
     ImageHandle = Private->Ip6Nic->ImageHandle;
   }
 
-  Status = HttpIoCreateIo (
-             ImageHandle,
-             Private->Controller,
-             Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
-             &ConfigData,
-             HttpBootHttpIoCallback,
-             (VOID *)Private,
-             &Private->HttpIo
-             );
+  return HttpIoCreateIo (
+           ImageHandle,
+           Private->Controller,
+           Private->UsingIpv6 ? IP_VERSION_6 : IP_VERSION_4,
+           &ConfigData,
+           HttpBootHttpIoCallback,
+           (VOID *)Private,
+           HttpIo
+           );
+}
+
+/**
+  Create a HttpIo instance for the file download.
+
+  @param[in]    Private        The pointer to the driver's private data.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIo (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private
+  )
+{
+  EFI_STATUS  Status;
+
+  ASSERT (Private != NULL);
+
+  Status = HttpBootCreateHttpIoInstance (Private, &Private->HttpIo);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -951,6 +973,9 @@ HttpBootGetBootFile (
   CHAR16                   *Url;
   BOOLEAN                  IdentityMode;
   UINTN                    ReceivedSize;
+  EFI_HTTP_HEADER          *Header;
+  BOOLEAN                  RequestReported;
+  HTTP_IO_CALLBACK         Callback;
 
   ASSERT (Private != NULL);
   ASSERT (Private->HttpCreated);
@@ -973,12 +998,30 @@ HttpBootGetBootFile (
   }
 
   AsciiStrToUnicodeStrS (Private->BootFileUri, Url, UrlSize);
+  RequestReported = FALSE;
   if (!HeaderOnly && (Buffer != NULL)) {
     Status = HttpBootGetFileFromCache (Private, Url, BufferSize, Buffer, ImageType);
     if (Status != EFI_NOT_FOUND) {
       FreePool (Url);
       return Status;
     }
+
+    //
+    // Download a large file over several connections if the server
+    // accepts byte ranges, fall back to a single GET if not possible.
+    //
+    if ((Private->BootFileSize != 0) && (*BufferSize >= Private->BootFileSize)) {
+      Status = HttpBootGetBootFileByRange (Private, Url, Private->BootFileSize, Buffer, &RequestReported);
+      if (Status != EFI_UNSUPPORTED) {
+        if (!EFI_ERROR (Status)) {
+          *BufferSize = Private->BootFileSize;
+          *ImageType  = Private->ImageType;
+        }
+
+        FreePool (Url);
+        return Status;
+      }
+    }
   }
 
   //
@@ -1083,9 +1126,15 @@ HttpBootGetBootFile (
   }
 
   //
-  // 2.4 Send out the request to HTTP server.
+  // 2.4 Send out the request to HTTP server. The request is not reported again
+  //     if the range download reported it before falling back.
   //
-  HttpIo = &Private->HttpIo;
+  HttpIo   = &Private->HttpIo;
+  Callback = HttpIo->Callback;
+  if (RequestReported) {
+    HttpIo->Callback = NULL;
+  }
+
   Status = HttpIoSendRequest (
              HttpIo,
              RequestData,
@@ -1094,6 +1143,7 @@ HttpBootGetBootFile (
              0,
              NULL
              );
+  HttpIo->Callback = Callback;
   if (EFI_ERROR (Status)) {
     goto ERROR_4;
   }
@@ -1140,6 +1190,14 @@ HttpBootGetBootFile (
     goto ERROR_5;
   }
 
+  //
+  // Remember whether the server accepts byte range requests for the file.
+  //
+  if (HeaderOnly) {
+    Header                = HttpFindHeader (ResponseData->HeaderCount, ResponseData->Headers, HTTP_HEADER_ACCEPT_RANGES);
+    Private->AcceptRanges = (BOOLEAN)((Header != NULL) && (AsciiStriCmp (Header->FieldValue, "bytes") == 0));
+  }
+
   //
   // 3.2 Cache the response header.
   //
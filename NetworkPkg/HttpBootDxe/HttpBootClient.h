@@ -12,6 +12,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTP_BOOT_BLOCK_SIZE           1500
 #define HTTP_USER_AGENT_EFI_HTTP_BOOT  "UefiHttpBoot/1.0"
+#define HTTP_BOOT_RANGE_MAX_RETRY      3
 
 //
 // Record the data length and start address of a data block.
@@ -57,6 +58,49 @@ typedef struct {
   HTTP_BOOT_PRIVATE_DATA     *Private;
 } HTTP_BOOT_CALLBACK_DATA;
 
+//
+// State of a connection used to download the boot file in byte ranges.
+//
+typedef enum {
+  HttpBootRangeStateIdle,
+  HttpBootRangeStateSendRequest,
+  HttpBootRangeStateRecvHeader,
+  HttpBootRangeStateRecvBody
+} HTTP_BOOT_RANGE_STATE;
+
+//
+// A connection used to download the boot file in byte ranges.
+//
+typedef struct {
+  HTTP_IO                   HttpIo;
+  BOOLEAN                   HttpCreated;
+  HTTP_IO_HEADER            *HttpIoHeader;
+  HTTP_BOOT_RANGE_STATE     State;
+  EFI_HTTP_RESPONSE_DATA    Response;
+
+  //
+  // The chunk of the file currently assigned to this connection.
+  // Length is zero if no chunk is assigned.
+  //
+  UINTN                     Offset;
+  UINTN                     Length;
+  UINTN                     Received;
+  UINTN                     Retry;
+} HTTP_BOOT_RANGE_WORKER;
+
+//
+// Shared state of a boot file download in byte ranges.
+//
+typedef struct {
+  HTTP_BOOT_PRIVATE_DATA    *Private;
+  EFI_HTTP_REQUEST_DATA     RequestData;
+  UINT8                     *Buffer;
+  UINTN                     FileSize;
+  UINTN                     ChunkSize;
+  UINTN                     NextOffset;
+  BOOLEAN                   RequestReported;
+} HTTP_BOOT_RANGE_CONTEXT;
+
 /**
   Discover all the boot information for boot file.
 
@@ -71,6 +115,22 @@ HttpBootDiscoverBootInfo (
   IN OUT HTTP_BOOT_PRIVATE_DATA  *Private
   );
 
+/**
+  Create and configure a HttpIo instance with the station address of the driver.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIo         The HttpIo instance to create.
+
+  @retval EFI_SUCCESS          Successfully created.
+  @retval Others               Failed to create HttpIo.
+
+**/
+EFI_STATUS
+HttpBootCreateHttpIoInstance (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO                 *HttpIo
+  );
+
 /**
   Create a HttpIo instance for the file download.
 
@@ -118,6 +178,41 @@ HttpBootGetBootFile (
   OUT HTTP_BOOT_IMAGE_TYPE       *ImageType
   );
 
+/**
+  Download the boot file over several HTTP connections with byte range requests.
+
+  The file is split into PcdHttpBootRangeChunkSize chunks that are fetched
+  concurrently over PcdHttpBootRangeConnections HTTP instances, each chunk is
+  received directly into its place in Buffer. A chunk that fails is retried on
+  a new connection from where it stopped.
+
+  If the server doesn't serve a range properly, all the connections are
+  aborted and EFI_UNSUPPORTED is returned, even in the middle of the download.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       FileSize        The size of the boot file in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the file to, at
+                                   least FileSize bytes.
+  @param[out]      RequestReported TRUE if the request was reported to the HttpIo
+                                   callback, so the caller must not report it again.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The range download is disabled, not worthwhile for
+                                   this file, or the server doesn't serve byte ranges.
+                                   The caller should download the file in a single request.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRange (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN     UINTN                   FileSize,
+  OUT UINT8                      *Buffer,
+  OUT BOOLEAN                    *RequestReported
+  );
+
 /**
   Clean up all cached data.
 
@@ -0,0 +1,577 @@
+/** @file
+  Download the boot file over several connections with HTTP range requests.
+
+  One TCP connection rarely fills a fast link, so a large boot file such as
+  a RAM disk image is split into chunks that are fetched concurrently over
+  several HTTP instances. Each chunk is received directly into its place in
+  the caller's buffer.
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "HttpBootDxe.h"
+
+/**
+  Build the request headers of a range connection. The Range header is
+  added before each request is sent.
+
+  @param[in]    Private        The pointer to the driver's private data.
+  @param[out]   HttpIoHeader   The created request headers.
+
+  @retval EFI_SUCCESS          The headers are built.
+  @retval Others               Failed to build the headers.
+
+**/
+EFI_STATUS
+HttpBootRangeCreateHeader (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  OUT    HTTP_IO_HEADER          **HttpIoHeader
+  )
+{
+  EFI_STATUS      Status;
+  HTTP_IO_HEADER  *Header;
+  CHAR8           *HostName;
+
+  Header = HttpIoCreateHeader (4);
+  if (Header == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  HostName = NULL;
+  Status   = HttpUrlGetHostName (
+               Private->BootFileUri,
+               Private->BootFileUriParser,
+               &HostName
+               );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_HOST, HostName);
+  FreePool (HostName);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_ACCEPT, "*/*");
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = HttpIoSetHeader (Header, HTTP_HEADER_USER_AGENT, HTTP_USER_AGENT_EFI_HTTP_BOOT);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  *HttpIoHeader = Header;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  HttpIoFreeHeader (Header);
+  return Status;
+}
+
+/**
+  Abort the pending tokens of a range connection and destroy its HTTP instance.
+
+  @param[in, out]  Worker      The range connection.
+
+**/
+VOID
+HttpBootRangeDestroyWorker (
+  IN OUT HTTP_BOOT_RANGE_WORKER  *Worker
+  )
+{
+  EFI_HTTP_MESSAGE  *Message;
+
+  if (!Worker->HttpCreated) {
+    return;
+  }
+
+  if (Worker->State != HttpBootRangeStateIdle) {
+    gBS->SetTimer (Worker->HttpIo.TimeoutEvent, TimerCancel, 0);
+    Worker->HttpIo.Http->Cancel (Worker->HttpIo.Http, NULL);
+  }
+
+  //
+  // Free the headers of a response that was received but not processed yet.
+  //
+  Message = Worker->HttpIo.RspToken.Message;
+  if ((Message != NULL) && (Message->Headers != NULL)) {
+    HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+    Message->Headers     = NULL;
+    Message->HeaderCount = 0;
+  }
+
+  HttpIoDestroyIo (&Worker->HttpIo);
+  Worker->HttpCreated = FALSE;
+  Worker->State       = HttpBootRangeStateIdle;
+}
+
+/**
+  Send the request for the rest of the chunk assigned to a range connection.
+
+  @param[in]       Context     The range download context.
+  @param[in, out]  Worker      The range connection.
+
+  @retval EFI_SUCCESS          The request is queued.
+  @retval Others               Failed to queue the request.
+
+**/
+EFI_STATUS
+HttpBootRangeSendRequest (
+  IN     HTTP_BOOT_RANGE_CONTEXT  *Context,
+  IN OUT HTTP_BOOT_RANGE_WORKER   *Worker
+  )
+{
+  EFI_STATUS  Status;
+  HTTP_IO     *HttpIo;
+  CHAR8       Range[64];
+
+  AsciiSPrint (
+    Range,
+    sizeof (Range),
+    "bytes=%lu-%lu",
+    (UINT64)(Worker->Offset + Worker->Received),
+    (UINT64)(Worker->Offset + Worker->Length - 1)
+    );
+  Status = HttpIoSetHeader (Worker->HttpIoHeader, HTTP_HEADER_RANGE, Range);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HttpIo                                 = &Worker->HttpIo;
+  HttpIo->ReqToken.Status                = EFI_NOT_READY;
+  HttpIo->ReqToken.Message->Data.Request = &Context->RequestData;
+  HttpIo->ReqToken.Message->HeaderCount  = Worker->HttpIoHeader->HeaderCount;
+  HttpIo->ReqToken.Message->Headers      = Worker->HttpIoHeader->Headers;
+  HttpIo->ReqToken.Message->BodyLength   = 0;
+  HttpIo->ReqToken.Message->Body         = NULL;
+
+  HttpIo->IsTxDone = FALSE;
+  Status           = HttpIo->Http->Request (HttpIo->Http, &HttpIo->ReqToken);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Worker->State = HttpBootRangeStateSendRequest;
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a response token on a range connection, either for the response
+  header or for the rest of the chunk body.
+
+  @param[in]       Context        The range download context.
+  @param[in, out]  Worker         The range connection.
+  @param[in]       RecvMsgHeader  TRUE to receive the response header.
+
+  @retval EFI_SUCCESS          The response token is queued.
+  @retval Others               Failed to queue the response token.
+
+**/
+EFI_STATUS
+HttpBootRangeRecvResponse (
+  IN     HTTP_BOOT_RANGE_CONTEXT  *Context,
+  IN OUT HTTP_BOOT_RANGE_WORKER   *Worker,
+  IN     BOOLEAN                  RecvMsgHeader
+  )
+{
+  EFI_STATUS  Status;
+  HTTP_IO     *HttpIo;
+
+  HttpIo                  = &Worker->HttpIo;
+  HttpIo->RspToken.Status = EFI_NOT_READY;
+  if (RecvMsgHeader) {
+    HttpIo->RspToken.Message->Data.Response = &Worker->Response;
+    HttpIo->RspToken.Message->BodyLength    = 0;
+    HttpIo->RspToken.Message->Body          = NULL;
+  } else {
+    HttpIo->RspToken.Message->Data.Response = NULL;
+    HttpIo->RspToken.Message->BodyLength    = Worker->Length - Worker->Received;
+    HttpIo->RspToken.Message->Body          = (CHAR8 *)Context->Buffer + Worker->Offset + Worker->Received;
+  }
+
+  HttpIo->RspToken.Message->HeaderCount = 0;
+  HttpIo->RspToken.Message->Headers     = NULL;
+
+  HttpIo->IsRxDone = FALSE;
+  Status           = gBS->SetTimer (HttpIo->TimeoutEvent, TimerRelative, HttpIo->Timeout * TICKS_PER_MS);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = HttpIo->Http->Response (HttpIo->Http, &HttpIo->RspToken);
+  if (EFI_ERROR (Status)) {
+    gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+    return Status;
+  }
+
+  Worker->State = RecvMsgHeader ? HttpBootRangeStateRecvHeader : HttpBootRangeStateRecvBody;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check that the response header describes the requested range.
+
+  @param[in]    Worker         The range connection.
+
+  @retval EFI_SUCCESS          The server sends the requested range.
+  @retval EFI_UNSUPPORTED      The server ignored the Range header, or doesn't
+                               describe the requested range in its response.
+
+**/
+EFI_STATUS
+HttpBootRangeCheckResponse (
+  IN     HTTP_BOOT_RANGE_WORKER  *Worker
+  )
+{
+  EFI_HTTP_MESSAGE  *Message;
+  EFI_HTTP_HEADER   *Header;
+  EFI_STATUS        Status;
+  UINTN             ContentLength;
+  UINTN             RangeStart;
+
+  Message = Worker->HttpIo.RspToken.Message;
+
+  if (Worker->Response.StatusCode != HTTP_STATUS_206_PARTIAL_CONTENT) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = HttpIoGetContentLength (Message->HeaderCount, Message->Headers, &ContentLength);
+  if (EFI_ERROR (Status) || (ContentLength != Worker->Length - Worker->Received)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The Content-Range is "bytes first-last/complete-length".
+  //
+  Header = HttpFindHeader (Message->HeaderCount, Message->Headers, HTTP_HEADER_CONTENT_RANGE);
+  if ((Header == NULL) || (AsciiStrnCmp (Header->FieldValue, "bytes ", 6) != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = AsciiStrDecimalToUintnS (Header->FieldValue + 6, NULL, &RangeStart);
+  if (EFI_ERROR (Status) || (RangeStart != Worker->Offset + Worker->Received)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Advance the state of a range connection.
+
+  A connection without a chunk takes the next one. Transport failures are
+  retried on a new HTTP instance, up to HTTP_BOOT_RANGE_MAX_RETRY times per
+  chunk, resuming from the last byte received.
+
+  @param[in, out]  Context     The range download context.
+  @param[in, out]  Worker      The range connection.
+
+  @retval EFI_SUCCESS          The connection is working or has no more chunk.
+  @retval EFI_UNSUPPORTED      The server doesn't serve the requested range, with
+                               an error status or another response.
+  @retval Others               The download failed or is aborted.
+
+**/
+EFI_STATUS
+HttpBootRangePollWorker (
+  IN OUT HTTP_BOOT_RANGE_CONTEXT  *Context,
+  IN OUT HTTP_BOOT_RANGE_WORKER   *Worker
+  )
+{
+  EFI_STATUS                       Status;
+  HTTP_IO                          *HttpIo;
+  EFI_HTTP_MESSAGE                 *Message;
+  EFI_HTTP_BOOT_CALLBACK_PROTOCOL  *HttpBootCallback;
+
+  HttpIo           = &Worker->HttpIo;
+  Message          = HttpIo->RspToken.Message;
+  HttpBootCallback = Context->Private->HttpBootCallback;
+
+  switch (Worker->State) {
+    case HttpBootRangeStateIdle:
+      if (Worker->Length == 0) {
+        if (Context->NextOffset >= Context->FileSize) {
+          return EFI_SUCCESS;
+        }
+
+        Worker->Offset       = Context->NextOffset;
+        Worker->Length       = MIN (Context->ChunkSize, Context->FileSize - Context->NextOffset);
+        Worker->Received     = 0;
+        Worker->Retry        = 0;
+        Context->NextOffset += Worker->Length;
+      }
+
+      Status = HttpBootRangeSendRequest (Context, Worker);
+      if (!EFI_ERROR (Status) && (Worker->Offset == 0) && (Worker->Retry == 0) && (HttpIo->Callback != NULL)) {
+        //
+        // Report the download once, as a single GET request would do.
+        //
+        Status = HttpIo->Callback (HttpIoRequest, HttpIo->ReqToken.Message, HttpIo->Context);
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+
+        Context->RequestReported = TRUE;
+      }
+
+      break;
+
+    case HttpBootRangeStateSendRequest:
+      if (!HttpIo->IsTxDone) {
+        return EFI_SUCCESS;
+      }
+
+      Status = HttpIo->ReqToken.Status;
+      if (!EFI_ERROR (Status)) {
+        Status = HttpBootRangeRecvResponse (Context, Worker, TRUE);
+      }
+
+      break;
+
+    case HttpBootRangeStateRecvHeader:
+    case HttpBootRangeStateRecvBody:
+      if (!HttpIo->IsRxDone) {
+        if (EFI_ERROR (gBS->CheckEvent (HttpIo->TimeoutEvent))) {
+          return EFI_SUCCESS;
+        }
+
+        Status = EFI_TIMEOUT;
+        break;
+      }
+
+      gBS->SetTimer (HttpIo->TimeoutEvent, TimerCancel, 0);
+      Status = HttpIo->RspToken.Status;
+
+      if (Worker->State == HttpBootRangeStateRecvHeader) {
+        //
+        // The response header of a range only describes the range, so it
+        // is not reported to the callback. An error status is left to the
+        // single GET request the caller falls back to, which reports it.
+        //
+        if (Status == EFI_HTTP_ERROR) {
+          Status = EFI_UNSUPPORTED;
+        } else if (!EFI_ERROR (Status)) {
+          Status = HttpBootRangeCheckResponse (Worker);
+        }
+
+        if (Message->Headers != NULL) {
+          HttpFreeHeaderFields (Message->Headers, Message->HeaderCount);
+          Message->Headers     = NULL;
+          Message->HeaderCount = 0;
+        }
+
+        if (Status == EFI_UNSUPPORTED) {
+          DEBUG ((
+            DEBUG_INFO,
+            "HttpBootRangePollWorker: range at %lu not served, status code %d\n",
+            (UINT64)(Worker->Offset + Worker->Received),
+            Worker->Response.StatusCode
+            ));
+          return Status;
+        }
+
+        if (!EFI_ERROR (Status)) {
+          Status = HttpBootRangeRecvResponse (Context, Worker, FALSE);
+        }
+
+        break;
+      }
+
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      if (HttpBootCallback != NULL) {
+        Status = HttpBootCallback->Callback (
+                                     HttpBootCallback,
+                                     HttpBootHttpEntityBody,
+                                     TRUE,
+                                     (UINT32)Message->BodyLength,
+                                     Message->Body
+                                     );
+        if (EFI_ERROR (Status)) {
+          return Status;
+        }
+      }
+
+      Worker->Received += Message->BodyLength;
+      if (Worker->Received < Worker->Length) {
+        Status = HttpBootRangeRecvResponse (Context, Worker, FALSE);
+        break;
+      }
+
+      //
+      // The chunk is complete, the connection is kept alive for the next one.
+      //
+      Worker->Length = 0;
+      Worker->State  = HttpBootRangeStateIdle;
+      return EFI_SUCCESS;
+
+    default:
+      ASSERT (FALSE);
+      return EFI_DEVICE_ERROR;
+  }
+
+  if (!EFI_ERROR (Status)) {
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Retry the rest of the chunk on a new connection.
+  //
+  if (Worker->Retry >= HTTP_BOOT_RANGE_MAX_RETRY) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "HttpBootRangePollWorker: range at %lu failed - %r\n",
+      (UINT64)(Worker->Offset + Worker->Received),
+      Status
+      ));
+    return Status;
+  }
+
+  Worker->Retry++;
+  HttpBootRangeDestroyWorker (Worker);
+  Status = HttpBootCreateHttpIoInstance (Context->Private, &Worker->HttpIo);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Worker->HttpCreated = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Download the boot file over several HTTP connections with byte range requests.
+
+  The file is split into PcdHttpBootRangeChunkSize chunks that are fetched
+  concurrently over PcdHttpBootRangeConnections HTTP instances, each chunk is
+  received directly into its place in Buffer. A chunk that fails is retried on
+  a new connection from where it stopped.
+
+  If the server doesn't serve a range properly, all the connections are
+  aborted and EFI_UNSUPPORTED is returned, even in the middle of the download.
+
+  @param[in]       Private         The pointer to the driver's private data.
+  @param[in]       Url             The URL of the boot file.
+  @param[in]       FileSize        The size of the boot file in bytes.
+  @param[out]      Buffer          The memory buffer to transfer the file to, at
+                                   least FileSize bytes.
+  @param[out]      RequestReported TRUE if the request was reported to the HttpIo
+                                   callback, so the caller must not report it again.
+
+  @retval EFI_SUCCESS              The file was loaded.
+  @retval EFI_UNSUPPORTED          The range download is disabled, not worthwhile for
+                                   this file, or the server doesn't serve byte ranges.
+                                   The caller should download the file in a single request.
+  @retval Others                   Unexpected error happened.
+
+**/
+EFI_STATUS
+HttpBootGetBootFileByRange (
+  IN     HTTP_BOOT_PRIVATE_DATA  *Private,
+  IN     CHAR16                  *Url,
+  IN     UINTN                   FileSize,
+  OUT UINT8                      *Buffer,
+  OUT BOOLEAN                    *RequestReported
+  )
+{
+  EFI_STATUS               Status;
+  HTTP_BOOT_RANGE_CONTEXT  Context;
+  HTTP_BOOT_RANGE_WORKER   *Workers;
+  HTTP_BOOT_RANGE_WORKER   *Worker;
+  UINTN                    Connections;
+  UINTN                    Count;
+  UINTN                    Index;
+  BOOLEAN                  Active;
+
+  *RequestReported = FALSE;
+
+  Connections = PcdGet8 (PcdHttpBootRangeConnections);
+  if ((Connections < 2) || !Private->AcceptRanges) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ZeroMem (&Context, sizeof (Context));
+  Context.Private            = Private;
+  Context.RequestData.Method = HttpMethodGet;
+  Context.RequestData.Url    = Url;
+  Context.Buffer             = Buffer;
+  Context.FileSize           = FileSize;
+  Context.ChunkSize          = PcdGet32 (PcdHttpBootRangeChunkSize);
+  if ((Context.ChunkSize == 0) || (FileSize <= Context.ChunkSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Connections = MIN (Connections, (FileSize - 1) / Context.ChunkSize + 1);
+  Workers     = AllocateZeroPool (Connections * sizeof (HTTP_BOOT_RANGE_WORKER));
+  if (Workers == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Open as many connections as possible, the download is still worthwhile
+  // with at least two of them.
+  //
+  for (Count = 0; Count < Connections; Count++) {
+    Worker = &Workers[Count];
+    Status = HttpBootRangeCreateHeader (Private, &Worker->HttpIoHeader);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Status = HttpBootCreateHttpIoInstance (Private, &Worker->HttpIo);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Worker->HttpCreated = TRUE;
+  }
+
+  if (Count < 2) {
+    Status = EFI_UNSUPPORTED;
+    goto ON_EXIT;
+  }
+
+  DEBUG ((DEBUG_INFO, "HttpBootGetBootFileByRange: %lu bytes over %lu connections\n", (UINT64)FileSize, (UINT64)Count));
+
+  do {
+    Active = FALSE;
+    for (Index = 0; Index < Count; Index++) {
+      Worker = &Workers[Index];
+      if (Worker->State != HttpBootRangeStateIdle) {
+        Worker->HttpIo.Http->Poll (Worker->HttpIo.Http);
+      }
+
+      Status = HttpBootRangePollWorker (&Context, Worker);
+      if (EFI_ERROR (Status)) {
+        goto ON_EXIT;
+      }
+
+      if (Worker->State != HttpBootRangeStateIdle) {
+        Active = TRUE;
+      }
+    }
+  } while (Active);
+
+  Status = EFI_SUCCESS;
+
+ON_EXIT:
+  //
+  // Abort all the connections before the caller falls back to a single GET.
+  //
+  for (Index = 0; Index < Connections; Index++) {
+    HttpBootRangeDestroyWorker (&Workers[Index]);
+    if (Workers[Index].HttpIoHeader != NULL) {
+      HttpIoFreeHeader (Workers[Index].HttpIoHeader);
+    }
+  }
+
+  FreePool (Workers);
+  *RequestReported = Context.RequestReported;
+  return Status;
+}
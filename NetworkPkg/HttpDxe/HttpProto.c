@@ -1086,6 +1086,11 @@ HttpConfigureTcp4 (
   Tcp4Option->EnableNagle       = TRUE;
   Tcp4CfgData->ControlOption    = Tcp4Option;
 
+  //
+  // SACK keeps large downloads from stalling one RTT per lost segment.
+  //
+  Tcp4Option->EnableSelectiveAck = TRUE;
+
   Status = HttpInstance->Tcp4->Configure (HttpInstance->Tcp4, Tcp4CfgData);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "HttpConfigureTcp4 - %r\n", Status));
@@ -1156,6 +1161,11 @@ HttpConfigureTcp6 (
   Tcp6Option->KeepAliveInterval = HTTP_KEEP_ALIVE_INTERVAL;
   Tcp6Option->EnableNagle       = TRUE;
 
+  //
+  // SACK keeps large downloads from stalling one RTT per lost segment.
+  //
+  Tcp6Option->EnableSelectiveAck = TRUE;
+
   Status = HttpInstance->Tcp6->Configure (HttpInstance->Tcp6, Tcp6CfgData);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "HttpConfigureTcp6 - %r\n", Status));
@@ -9,6 +9,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "HttpDriver.h"
 
+//
+// TLS sessions cached for resumption, most recently used first.
+//
+LIST_ENTRY  mHttpsSessionCache      = INITIALIZE_LIST_HEAD_VARIABLE (mHttpsSessionCache);
+UINTN       mHttpsSessionCacheCount = 0;
+
 /**
   Returns the first occurrence of a Null-terminated ASCII sub-string in a Null-terminated
   ASCII string and ignore case during the search process.
@@ -1132,6 +1138,157 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Find the TLS session cached for a remote host and port.
+
+  @param[in]  RemoteHost         The remote host name or address string.
+  @param[in]  RemotePort         The remote port.
+
+  @return  The cache entry, or NULL if no session is cached for this server.
+
+**/
+HTTPS_SESSION_CACHE_ENTRY *
+HttpsFindSessionCacheEntry (
+  IN  CHAR8   *RemoteHost,
+  IN  UINT16  RemotePort
+  )
+{
+  LIST_ENTRY                 *Entry;
+  HTTPS_SESSION_CACHE_ENTRY  *CacheEntry;
+
+  if (RemoteHost == NULL) {
+    return NULL;
+  }
+
+  NET_LIST_FOR_EACH (Entry, &mHttpsSessionCache) {
+    CacheEntry = NET_LIST_USER_STRUCT (Entry, HTTPS_SESSION_CACHE_ENTRY, Link);
+    if ((CacheEntry->RemotePort == RemotePort) &&
+        (AsciiStriCmp (CacheEntry->RemoteHost, RemoteHost) == 0))
+    {
+      return CacheEntry;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Offer the TLS session cached for the remote host and port of the HTTP
+  instance, if any, so that the next handshake can resume it.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            A cached session was offered to the TLS driver.
+  @retval EFI_NOT_FOUND          No session is cached for this server.
+  @retval Others                 The TLS driver refused the session.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsResumeSession (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  HTTPS_SESSION_CACHE_ENTRY  *CacheEntry;
+
+  CacheEntry = HttpsFindSessionCacheEntry (HttpInstance->RemoteHost, HttpInstance->RemotePort);
+  if (CacheEntry == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  return HttpInstance->Tls->SetSessionData (
+                              HttpInstance->Tls,
+                              EfiTlsSessionID,
+                              &CacheEntry->SessionId,
+                              sizeof (EFI_TLS_SESSION_ID)
+                              );
+}
+
+/**
+  Remember the TLS session just established by the HTTP instance, keyed by
+  its remote host and port.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The session is cached.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSaveSession (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_TLS_SESSION_ID         SessionId;
+  UINTN                      SessionIdSize;
+  HTTPS_SESSION_CACHE_ENTRY  *CacheEntry;
+  HTTPS_SESSION_CACHE_ENTRY  *Victim;
+
+  if (HttpInstance->RemoteHost == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SessionIdSize = sizeof (EFI_TLS_SESSION_ID);
+  Status        = HttpInstance->Tls->GetSessionData (
+                                       HttpInstance->Tls,
+                                       EfiTlsSessionID,
+                                       &SessionId,
+                                       &SessionIdSize
+                                       );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((SessionId.Length == 0) || (SessionId.Length > sizeof (SessionId.Data))) {
+    return EFI_NOT_FOUND;
+  }
+
+  CacheEntry = HttpsFindSessionCacheEntry (HttpInstance->RemoteHost, HttpInstance->RemotePort);
+  if (CacheEntry != NULL) {
+    if ((CacheEntry->SessionId.Length == SessionId.Length) &&
+        (CompareMem (CacheEntry->SessionId.Data, SessionId.Data, SessionId.Length) == 0))
+    {
+      DEBUG ((DEBUG_INFO, "TlsSaveSession: resumed TLS session with %a:%d.\n", HttpInstance->RemoteHost, HttpInstance->RemotePort));
+    }
+
+    RemoveEntryList (&CacheEntry->Link);
+    mHttpsSessionCacheCount--;
+  } else {
+    CacheEntry = AllocateZeroPool (sizeof (HTTPS_SESSION_CACHE_ENTRY));
+    if (CacheEntry == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    CacheEntry->RemoteHost = AllocateCopyPool (AsciiStrSize (HttpInstance->RemoteHost), HttpInstance->RemoteHost);
+    if (CacheEntry->RemoteHost == NULL) {
+      FreePool (CacheEntry);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    CacheEntry->RemotePort = HttpInstance->RemotePort;
+
+    //
+    // Evict the least recently used session.
+    //
+    if (mHttpsSessionCacheCount >= HTTPS_SESSION_CACHE_MAX) {
+      Victim = NET_LIST_TAIL (&mHttpsSessionCache, HTTPS_SESSION_CACHE_ENTRY, Link);
+      RemoveEntryList (&Victim->Link);
+      mHttpsSessionCacheCount--;
+      FreePool (Victim->RemoteHost);
+      FreePool (Victim);
+    }
+  }
+
+  CopyMem (&CacheEntry->SessionId, &SessionId, sizeof (EFI_TLS_SESSION_ID));
+  InsertHeadList (&mHttpsSessionCache, &CacheEntry->Link);
+  mHttpsSessionCacheCount++;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Connect one TLS session by finishing the TLS handshake process.
 
@@ -1182,6 +1339,12 @@ TlsConnectSession (
     return Status;
   }
 
+  //
+  // Try to resume an earlier session with the same server. A full handshake
+  // is done if there is none or the server declines to resume it.
+  //
+  TlsResumeSession (HttpInstance);
+
   //
   // Create ClientHello
   //
@@ -1380,6 +1543,8 @@ TlsConnectSession (
 
   if (HttpInstance->TlsSessionState != EfiTlsSessionDataTransferring) {
     Status = EFI_ABORTED;
+  } else {
+    TlsSaveSession (HttpInstance);
   }
 
   return Status;
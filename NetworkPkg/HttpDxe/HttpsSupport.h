@@ -13,6 +13,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define HTTPS_FLAG  "https://"
 
+//
+// Maximum number of TLS sessions remembered for resumption.
+//
+#define HTTPS_SESSION_CACHE_MAX  16
+
+///
+/// TLS session remembered for one remote host and port, so that later
+/// connections to the same server can resume it with an abbreviated handshake.
+///
+typedef struct {
+  LIST_ENTRY            Link;
+  CHAR8                 *RemoteHost;
+  UINT16                RemotePort;
+  EFI_TLS_SESSION_ID    SessionId;
+} HTTPS_SESSION_CACHE_ENTRY;
+
 /**
   Check whether the Url is from Https.
 
@@ -171,6 +187,55 @@ TlsReceiveOnePdu (
   IN     EFI_EVENT      Timeout
   );
 
+/**
+  Find the TLS session cached for a remote host and port.
+
+  @param[in]  RemoteHost         The remote host name or address string.
+  @param[in]  RemotePort         The remote port.
+
+  @return  The cache entry, or NULL if no session is cached for this server.
+
+**/
+HTTPS_SESSION_CACHE_ENTRY *
+HttpsFindSessionCacheEntry (
+  IN  CHAR8   *RemoteHost,
+  IN  UINT16  RemotePort
+  );
+
+/**
+  Offer the TLS session cached for the remote host and port of the HTTP
+  instance, if any, so that the next handshake can resume it.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            A cached session was offered to the TLS driver.
+  @retval EFI_NOT_FOUND          No session is cached for this server.
+  @retval Others                 The TLS driver refused the session.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsResumeSession (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  );
+
+/**
+  Remember the TLS session just established by the HTTP instance, keyed by
+  its remote host and port.
+
+  @param[in]  HttpInstance       The HTTP instance private data.
+
+  @retval EFI_SUCCESS            The session is cached.
+  @retval EFI_OUT_OF_RESOURCES   Can't allocate memory resources.
+  @retval Others                 Other error as indicated.
+
+**/
+EFI_STATUS
+EFIAPI
+TlsSaveSession (
+  IN  HTTP_PROTOCOL  *HttpInstance
+  );
+
 /**
   Connect one TLS session by finishing the TLS handshake process.
 
@@ -410,6 +410,8 @@ Ip4CleanService (
 
   IpSb->State = IP4_SERVICE_DESTROY;
 
+  DEBUG ((DEBUG_NET, "Ip4CleanService: %lu bytes copied on receive.\n", IpSb->RxCopiedBytes));
+
   if (IpSb->Timer != NULL) {
     gBS->SetTimer (IpSb->Timer, TimerCancel, 0);
     gBS->CloseEvent (IpSb->Timer);
@@ -216,6 +216,11 @@ struct _IP4_SERVICE {
 
   UINT32                             MaxPacketSize;
   UINT32                             OldMaxPacketSize; ///< The MTU before IPsec enable.
+
+  //
+  // Bytes copied when delivering a packet shared by several instances.
+  //
+  UINT64                             RxCopiedBytes;
 };
 
 #define IP4_INSTANCE_FROM_PROTOCOL(Ip4) \
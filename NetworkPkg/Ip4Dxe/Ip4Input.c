@@ -1285,16 +1285,22 @@ Ip4InstanceDeliverPacket (
       RemoveEntryList (&Packet->List);
     } else {
       //
-      // Create a duplicated packet if this packet is shared
+      // The packet is shared. A raw instance gets the whole datagram,
+      // header included, so it needs its own copy. Otherwise only the
+      // IP head is converted in place, so reference the payload and
+      // give this instance a private head.
       //
-      if (IpInstance->ConfigData.RawData) {
-        HeadLen = 0;
+      if (IpInstance->ConfigData.RawData || (Packet->TotalSize == 0)) {
+        HeadLen = IpInstance->ConfigData.RawData ? 0 : IP4_MAX_HEADLEN;
+        Dup     = NetbufDuplicate (Packet, NULL, HeadLen);
+
+        if (Dup != NULL) {
+          IpInstance->Service->RxCopiedBytes += Packet->TotalSize;
+        }
       } else {
-        HeadLen = IP4_MAX_HEADLEN;
+        Dup = NetbufGetFragment (Packet, 0, Packet->TotalSize, IP4_MAX_HEADLEN);
       }
 
-      Dup = NetbufDuplicate (Packet, NULL, HeadLen);
-
       if (Dup == NULL) {
         return EFI_OUT_OF_RESOURCES;
       }
@@ -152,6 +152,8 @@ Ip6CleanService (
 
   IpSb->State = IP6_SERVICE_DESTROY;
 
+  DEBUG ((DEBUG_NET, "Ip6CleanService: %lu bytes copied on receive.\n", IpSb->RxCopiedBytes));
+
   if (IpSb->Timer != NULL) {
     gBS->SetTimer (IpSb->Timer, TimerCancel, 0);
     gBS->CloseEvent (IpSb->Timer);
@@ -238,6 +238,11 @@ struct _IP6_SERVICE {
   CHAR16                             *MacString;
   UINT32                             MaxPacketSize;
   UINT32                             OldMaxPacketSize;
+
+  //
+  // Bytes copied when delivering a packet shared by several instances.
+  //
+  UINT64                             RxCopiedBytes;
 };
 
 /**
@@ -1492,9 +1492,14 @@ Ip6InstanceDeliverPacket (
       RemoveEntryList (&Packet->List);
     } else {
       //
-      // Create a duplicated packet if this packet is shared
+      // The packet is shared. Only the IP head is converted in place,
+      // so reference the payload and give this instance a private head.
       //
-      Dup = NetbufDuplicate (Packet, NULL, sizeof (EFI_IP6_HEADER));
+      if (Packet->TotalSize == 0) {
+        Dup = NetbufDuplicate (Packet, NULL, sizeof (EFI_IP6_HEADER));
+      } else {
+        Dup = NetbufGetFragment (Packet, 0, Packet->TotalSize, sizeof (EFI_IP6_HEADER));
+      }
 
       if (Dup == NULL) {
         return EFI_OUT_OF_RESOURCES;
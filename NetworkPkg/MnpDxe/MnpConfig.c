@@ -316,6 +316,7 @@ MnpAllocTxBuf (
   TxBufWrap        = NET_LIST_USER_STRUCT_S (Entry, MNP_TX_BUF_WRAP, WrapEntry, MNP_TX_BUF_WRAP_SIGNATURE);
   TxBufWrap->InUse = TRUE;
   TxBuf            = TxBufWrap->TxBuf;
+  MnpDeviceData->TxBufInUse++;
 
 ON_EXIT:
   gBS->RestoreTPL (OldTpl);
@@ -365,6 +366,7 @@ MnpFreeTxBuf (
   OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
   InsertTailList (&MnpDeviceData->FreeTxBufList, &TxBufWrap->WrapEntry);
   TxBufWrap->InUse = FALSE;
+  MnpDeviceData->TxBufInUse--;
   gBS->RestoreTPL (OldTpl);
 }
 
@@ -511,10 +513,13 @@ MnpInitializeDeviceData (
   InitializeListHead (&MnpDeviceData->FreeTxBufList);
   InitializeListHead (&MnpDeviceData->AllTxBufList);
   MnpDeviceData->TxBufCount = 0;
+  MnpDeviceData->TxBufInUse = 0;
 
   //
   // Create the system poll timer.
   //
+  MnpDeviceData->PollInterval = MNP_SYS_POLL_INTERVAL;
+
   Status = gBS->CreateEvent (
                   EVT_NOTIFY_SIGNAL | EVT_TIMER,
                   TPL_CALLBACK,
@@ -622,6 +627,8 @@ MnpDestroyDeviceData (
 
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
 
+  DEBUG ((DEBUG_NET, "MnpDestroyDeviceData: %lu bytes copied on receive.\n", MnpDeviceData->RxCopiedBytes));
+
   //
   // Free Vlan Config variable name string
   //
@@ -1265,7 +1272,8 @@ MnpStart (
     //
     TimerOpType = EnableSystemPoll ? TimerPeriodic : TimerCancel;
 
-    Status = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MNP_SYS_POLL_INTERVAL);
+    MnpDeviceData->PollInterval = MNP_SYS_POLL_INTERVAL;
+    Status                      = gBS->SetTimer (MnpDeviceData->PollTimer, TimerOpType, MnpDeviceData->PollInterval);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "MnpStart: gBS->SetTimer for PollTimer failed, %r.\n", Status));
 
@@ -63,12 +63,17 @@ typedef struct {
   LIST_ENTRY                     FreeTxBufList;
   LIST_ENTRY                     AllTxBufList;
   UINT32                         TxBufCount;
+  UINT32                         TxBufInUse;
 
   NET_BUF_QUEUE                  FreeNbufQue;
   INTN                           NbufCnt;
 
   EFI_EVENT                      PollTimer;
   BOOLEAN                        EnableSystemPoll;
+  //
+  // The period of PollTimer, adjusted to the receive traffic.
+  //
+  UINT64                         PollInterval;
 
   EFI_EVENT                      TimeoutCheckTimer;
   EFI_EVENT                      MediaDetectTimer;
@@ -85,6 +90,12 @@ typedef struct {
   UINT32                         BufferLength;
   UINT32                         PaddingSize;
   NET_BUF                        *RxNbufCache;
+
+  //
+  // Bytes copied on receive to give each instance sharing a frame
+  // its own writable copy.
+  //
+  UINT64                         RxCopiedBytes;
 } MNP_DEVICE_DATA;
 
 #define MNP_DEVICE_DATA_FROM_THIS(a) \
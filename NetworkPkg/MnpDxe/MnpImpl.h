@@ -14,6 +14,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define NET_ETHER_FCS_SIZE  4
 
 #define MNP_SYS_POLL_INTERVAL        (10 * TICKS_PER_MS)    // 10 milliseconds
+#define MNP_SYS_POLL_MIN_INTERVAL    (1 * TICKS_PER_MS)     // 1 millisecond
+#define MNP_RX_POLL_BUDGET           32                     // Packets received in one poll at most
 #define MNP_TIMEOUT_CHECK_INTERVAL   (50 * TICKS_PER_MS)    // 50 milliseconds
 #define MNP_MEDIA_DETECT_INTERVAL    (500 * TICKS_PER_MS)   // 500 milliseconds
 #define MNP_TX_TIMEOUT_TIME          (500 * TICKS_PER_MS)   // 500 milliseconds
@@ -430,6 +432,26 @@ MnpReceivePacket (
   IN OUT MNP_DEVICE_DATA  *MnpDeviceData
   );
 
+/**
+  Receive and deliver the packets from Snp, until there is no more packet
+  or the budget is used up.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             The number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                The status of MnpReceivePacket() when no packet
+                                is received.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Budget,
+  OUT    UINT32           *Received
+  );
+
 /**
   Allocate a free NET_BUF from MnpDeviceData->FreeNbufQue. If there is none
   in the queue, first try to allocate some and add them into the queue, then
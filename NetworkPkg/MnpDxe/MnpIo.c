@@ -343,6 +343,8 @@ MnpInstanceDeliverPacket (
     // Duplicate the net buffer.
     //
     NetbufDuplicate (RxDataWrap->Nbuf, DupNbuf, 0);
+    MnpDeviceData->RxCopiedBytes += RxDataWrap->Nbuf->TotalSize;
+
     MnpFreeNbuf (MnpDeviceData, RxDataWrap->Nbuf);
     RxDataWrap->Nbuf = DupNbuf;
   }
@@ -985,6 +987,72 @@ EXIT:
   return Status;
 }
 
+/**
+  Receive and deliver the packets from Snp, until there is no more packet
+  or the budget is used up.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Budget               The maximum number of packets to receive.
+  @param[out]      Received             The number of packets received.
+
+  @retval EFI_SUCCESS           At least one packet is received.
+  @retval Others                The status of MnpReceivePacket() when no packet
+                                is received.
+
+**/
+EFI_STATUS
+MnpReceivePackets (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Budget,
+  OUT    UINT32           *Received
+  )
+{
+  EFI_STATUS  Status;
+
+  *Received = 0;
+  do {
+    Status = MnpReceivePacket (MnpDeviceData);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    (*Received)++;
+  } while (*Received < Budget);
+
+  return (*Received != 0) ? EFI_SUCCESS : Status;
+}
+
+/**
+  Adjust the period of the system poll timer to the traffic: poll faster
+  while the receive budget is used up in each poll, and back off to
+  MNP_SYS_POLL_INTERVAL when nothing is received.
+
+  @param[in, out]  MnpDeviceData        Pointer to the mnp device context data.
+  @param[in]       Received             The number of packets received in the last poll.
+
+**/
+VOID
+MnpAdjustPollInterval (
+  IN OUT MNP_DEVICE_DATA  *MnpDeviceData,
+  IN     UINT32           Received
+  )
+{
+  UINT64  PollInterval;
+
+  PollInterval = MnpDeviceData->PollInterval;
+  if (Received >= MNP_RX_POLL_BUDGET) {
+    PollInterval = MAX (PollInterval / 2, MNP_SYS_POLL_MIN_INTERVAL);
+  } else if (Received == 0) {
+    PollInterval = MIN (PollInterval * 2, MNP_SYS_POLL_INTERVAL);
+  }
+
+  if ((PollInterval != MnpDeviceData->PollInterval) && MnpDeviceData->EnableSystemPoll) {
+    if (!EFI_ERROR (gBS->SetTimer (MnpDeviceData->PollTimer, TimerPeriodic, PollInterval))) {
+      MnpDeviceData->PollInterval = PollInterval;
+    }
+  }
+}
+
 /**
   Remove the received packets if timeout occurs.
 
@@ -1099,6 +1167,7 @@ MnpSystemPoll (
   )
 {
   MNP_DEVICE_DATA  *MnpDeviceData;
+  UINT32           Received;
 
   MnpDeviceData = (MNP_DEVICE_DATA *)Context;
   NET_CHECK_SIGNATURE (MnpDeviceData, MNP_DEVICE_DATA_SIGNATURE);
@@ -1106,7 +1175,19 @@ MnpSystemPoll (
   //
   // Try to receive packets from Snp.
   //
-  MnpReceivePacket (MnpDeviceData);
+  MnpReceivePackets (MnpDeviceData, MNP_RX_POLL_BUDGET, &Received);
+
+  //
+  // Take the transmitted buffers back from Snp, so that the transmit path
+  // doesn't need to wait for them.
+  //
+  if (MnpDeviceData->TxBufInUse != 0) {
+    MnpRecycleTxBuf (MnpDeviceData);
+  }
+
+  if (Event != NULL) {
+    MnpAdjustPollInterval (MnpDeviceData, Received);
+  }
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -756,6 +756,7 @@ MnpPoll (
   EFI_STATUS         Status;
   MNP_INSTANCE_DATA  *Instance;
   EFI_TPL            OldTpl;
+  UINT32             Received;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -773,7 +774,7 @@ MnpPoll (
   //
   // Try to receive packets.
   //
-  Status = MnpReceivePacket (Instance->MnpServiceData->MnpDeviceData);
+  Status = MnpReceivePackets (Instance->MnpServiceData->MnpDeviceData, MNP_RX_POLL_BUDGET, &Received);
 
   //
   // Dispatch the DPC queued by the NotifyFunction of rx token's events.
@@ -218,6 +218,8 @@ SockSetTcpRxData (
     RcvdBytes               -= CopyBytes;
     OffSet                  += CopyBytes;
   }
+
+  Sock->RcvCopiedBytes += OffSet;
 }
 
 /**
@@ -844,6 +846,8 @@ SockDestroy (
     Sock->Parent = NULL;
   }
 
+  DEBUG ((DEBUG_NET, "SockDestroy: %lu bytes copied on receive.\n", Sock->RcvCopiedBytes));
+
   FreePool (Sock);
 }
 
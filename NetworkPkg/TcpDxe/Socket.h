@@ -472,6 +472,7 @@ struct _TCP_SOCKET {
   SOCK_BUFFER                 RcvBuffer;    ///< Receive buffer of received data
   EFI_STATUS                  SockError;    ///< The error returned by low layer protocol
   BOOLEAN                     InDestroy;
+  UINT64                      RcvCopiedBytes; ///< Bytes copied to application's receive buffers
 
   //
   // Fields used to manage the connection request
@@ -0,0 +1,299 @@
+/** @file
+  TCP congestion control algorithms.
+
+  The loss detection and the fast recovery are common to all algorithms and
+  live in TcpInput.c. The routines here only decide how the congestion window
+  grows when new data is acknowledged, and where the slow start threshold is
+  set when a loss is detected.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "TcpMain.h"
+
+//
+// CUBIC constants of RFC8312, C = 0.4 and Beta = 0.7. Time is
+// measured in TCP heartbeats, so C is turned into 2 / 625 per
+// cubed heartbeat with TCP_TICK_HZ of 5.
+//
+// The heartbeat is the finest clock TCP has, and the RTT is kept
+// in heartbeats too. The epoch, K and the RTT are therefore rounded
+// to 200ms, and the target window only moves once per heartbeat.
+// An RTT below 200ms counts as one heartbeat, so on such paths the
+// target is taken one heartbeat ahead and the TCP friendly window
+// grows as it would on a 200ms path.
+//
+#define TCP_CUBIC_BETA_NUM    7
+#define TCP_CUBIC_BETA_DEN    10
+#define TCP_CUBIC_C_NUM       2
+#define TCP_CUBIC_C_DEN       625
+#define TCP_CUBIC_TIME_LIMIT  (TCP_TICK_HZ * 60 * 10)
+
+/**
+  Initialize the NewReno congestion control state.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpRenoInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+}
+
+/**
+  Open the congestion window as specified in RFC5681: one SMSS per ACK in
+  slow start, about one SMSS per RTT in congestion avoidance.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpRenoOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+  } else {
+    Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
+  }
+}
+
+/**
+  Compute the NewReno slow start threshold, that is half of the data in
+  flight, as specified in RFC5681.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold in bytes.
+
+**/
+UINT32
+TcpRenoSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  FlightSize;
+
+  FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
+
+  return MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+}
+
+/**
+  Compute the integer cube root of a value.
+
+  @param[in]  Value   The value to compute the cube root of.
+
+  @return The largest integer whose cube is not greater than Value.
+
+**/
+UINT32
+TcpCubicRoot (
+  IN UINT64  Value
+  )
+{
+  UINT64  Root;
+  UINT64  Trial;
+  INTN    Shift;
+
+  Root = 0;
+
+  for (Shift = 63; Shift >= 0; Shift -= 3) {
+    Root  = LShiftU64 (Root, 1);
+    Trial = MultU64x64 (MultU64x64 (3, Root), Root + 1) + 1;
+
+    if (RShiftU64 (Value, Shift) >= Trial) {
+      Value -= LShiftU64 (Trial, Shift);
+      Root++;
+    }
+  }
+
+  return (UINT32)Root;
+}
+
+/**
+  Initialize the CUBIC congestion control state.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+VOID
+TcpCubicInit (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  Tcb->CubicWMax    = 0;
+  Tcb->CubicOrigin  = 0;
+  Tcb->CubicK       = 0;
+  Tcb->CubicEpoch   = 0;
+  Tcb->CubicEpochOn = FALSE;
+}
+
+/**
+  Open the congestion window as specified in RFC8312. The slow start is the
+  same as NewReno. In congestion avoidance the window follows the cubic
+  function of the time elapsed since the last reduction, but never grows
+  slower than the TCP friendly estimate.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes newly acknowledged.
+
+**/
+VOID
+TcpCubicOnAck (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  )
+{
+  UINT32  Elapsed;
+  UINT32  Rtt;
+  INT64   Delta;
+  INT64   Offset;
+  UINT64  Target;
+  UINT64  Friendly;
+  UINT64  Increase;
+
+  if (Tcb->CWnd < Tcb->Ssthresh) {
+    Tcb->CWnd += Tcb->SndMss;
+    return;
+  }
+
+  //
+  // Start a new avoidance epoch with the first ACK after a
+  // reduction. K is the time to grow back to the origin point.
+  //
+  if (!Tcb->CubicEpochOn) {
+    Tcb->CubicEpochOn = TRUE;
+    Tcb->CubicEpoch   = mTcpTick;
+
+    if (Tcb->CubicWMax <= Tcb->CWnd) {
+      Tcb->CubicK      = 0;
+      Tcb->CubicOrigin = Tcb->CWnd;
+    } else {
+      Tcb->CubicK = TcpCubicRoot (
+                      DivU64x32 (
+                        MultU64x32 (Tcb->CubicWMax - Tcb->CWnd, TCP_CUBIC_C_DEN),
+                        TCP_CUBIC_C_NUM * Tcb->SndMss
+                        )
+                      );
+      Tcb->CubicOrigin = Tcb->CubicWMax;
+    }
+  }
+
+  Rtt = MAX (Tcb->SRtt >> TCP_RTT_SHIFT, 1);
+
+  //
+  // Target the window of one RTT later: W(t) = C * (t - K)^3 + Origin.
+  //
+  Elapsed = TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch) + Rtt;
+  Delta   = (INT64)Elapsed - (INT64)Tcb->CubicK;
+  Delta   = MIN (MAX (Delta, -TCP_CUBIC_TIME_LIMIT), TCP_CUBIC_TIME_LIMIT);
+
+  Offset = MultS64x64 (MultS64x64 (Delta, Delta), Delta);
+  Offset = DivS64x64Remainder (
+             MultS64x64 (Offset, TCP_CUBIC_C_NUM * Tcb->SndMss),
+             TCP_CUBIC_C_DEN,
+             NULL
+             );
+
+  if (Offset < -(INT64)Tcb->CubicOrigin) {
+    Target = 0;
+  } else {
+    Target = (UINT64)((INT64)Tcb->CubicOrigin + Offset);
+  }
+
+  //
+  // TCP friendly region: W_est(t) = WMax * Beta + 3 * (1 - Beta) / (1 + Beta) * t / RTT.
+  //
+  Friendly = DivU64x32 (MultU64x32 (Tcb->CubicWMax, TCP_CUBIC_BETA_NUM), TCP_CUBIC_BETA_DEN) +
+             DivU64x32 (MultU64x32 (TCP_SUB_TIME (mTcpTick, Tcb->CubicEpoch), 9 * Tcb->SndMss), 17 * Rtt);
+
+  Target = MAX (Target, Friendly);
+
+  //
+  // Grow by (Target - CWnd) / CWnd per acknowledged SMSS, but
+  // at most by half of the data acknowledged as RFC8312 does.
+  // Above the target, grow slowly to probe for more bandwidth.
+  //
+  if (Target > Tcb->CWnd) {
+    Increase = DivU64x32 (MultU64x32 (Target - Tcb->CWnd, Acked), Tcb->CWnd);
+    Increase = MIN (Increase, Acked / 2);
+  } else {
+    Increase = DivU64x32 (MultU64x32 (Tcb->SndMss, Acked), 100 * Tcb->CWnd);
+  }
+
+  Tcb->CWnd += MAX ((UINT32)Increase, 1);
+}
+
+/**
+  Compute the CUBIC slow start threshold, that is Beta times the window on
+  loss, and remember the window for the next epoch. With fast convergence,
+  a flow that lost before reaching its previous maximum releases bandwidth
+  to the others.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold in bytes.
+
+**/
+UINT32
+TcpCubicSsthresh (
+  IN OUT TCP_CB  *Tcb
+  )
+{
+  UINT32  CWnd;
+
+  CWnd = MIN (Tcb->CWnd, TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna));
+  CWnd = MAX (CWnd, Tcb->SndMss);
+
+  if (CWnd < Tcb->CubicWMax) {
+    Tcb->CubicWMax = (UINT32)DivU64x32 (
+                               MultU64x32 (CWnd, TCP_CUBIC_BETA_DEN + TCP_CUBIC_BETA_NUM),
+                               2 * TCP_CUBIC_BETA_DEN
+                               );
+  } else {
+    Tcb->CubicWMax = CWnd;
+  }
+
+  Tcb->CubicEpochOn = FALSE;
+
+  return MAX (
+           (UINT32)DivU64x32 (MultU64x32 (CWnd, TCP_CUBIC_BETA_NUM), TCP_CUBIC_BETA_DEN),
+           (UINT32)(2 * Tcb->SndMss)
+           );
+}
+
+GLOBAL_REMOVE_IF_UNREFERENCED CONST TCP_CONGESTION_OPS  mTcpCongestionOps[] = {
+  { TcpRenoInit,  TcpRenoOnAck,  TcpRenoSsthresh  },
+  { TcpCubicInit, TcpCubicOnAck, TcpCubicSsthresh }
+};
+
+/**
+  Get the congestion control algorithm.
+
+  @param[in]  Algorithm   The algorithm, such as TCP_CONGEST_ALGO_CUBIC.
+
+  @return Pointer to the congestion control algorithm. NewReno is used
+          if the algorithm is not supported.
+
+**/
+CONST TCP_CONGESTION_OPS *
+TcpGetCongestionOps (
+  IN UINT8  Algorithm
+  )
+{
+  if (Algorithm >= ARRAY_SIZE (mTcpCongestionOps)) {
+    DEBUG ((DEBUG_WARN, "TcpGetCongestionOps: algorithm %d not supported, use NewReno\n", Algorithm));
+    Algorithm = TCP_CONGEST_ALGO_NEWRENO;
+  }
+
+  return &mTcpCongestionOps[Algorithm];
+}
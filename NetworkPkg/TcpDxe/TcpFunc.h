@@ -359,6 +359,21 @@ TcpRetransmit (
   IN TCP_SEQNO  Seq
   );
 
+/**
+  Retransmit the first hole of the SACK scoreboard that has not been
+  retransmitted in the current fast recovery.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @retval 0       The retransmission succeeded, or no hole needs to be repaired.
+  @retval -1      An error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN TCP_CB  *Tcb
+  );
+
 /**
   Check whether to send data/SYN/FIN and piggyback an ACK.
 
@@ -588,6 +603,24 @@ TcpSetKeepaliveTimer (
   IN OUT TCP_CB  *Tcb
   );
 
+//
+// Functions in TcpCongestion.c
+//
+
+/**
+  Get the congestion control algorithm.
+
+  @param[in]  Algorithm   The algorithm, such as TCP_CONGEST_ALGO_CUBIC.
+
+  @return Pointer to the congestion control algorithm. NewReno is used
+          if the algorithm is not supported.
+
+**/
+CONST TCP_CONGESTION_OPS *
+TcpGetCongestionOps (
+  IN UINT8  Algorithm
+  );
+
 //
 // Functions in TcpIo.c
 //
@@ -29,6 +29,179 @@ TcpSeqAcceptable (
           TCP_SEQ_LT (Seg->Seq, Tcb->RcvWl2 + Tcb->RcvWnd));
 }
 
+/**
+  Insert a SACKed range into the scoreboard, merging it with the ranges
+  it overlaps or adjoins. The scoreboard is kept in sequence order.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Left     The first sequence number of the range.
+  @param[in]       Right    The sequence number of the last byte + 1.
+
+**/
+VOID
+TcpSackInsertBlock (
+  IN OUT TCP_CB     *Tcb,
+  IN     TCP_SEQNO  Left,
+  IN     TCP_SEQNO  Right
+  )
+{
+  TCP_SACK_BLOCK  *Block;
+  UINT8           Index;
+  UINT8           Last;
+
+  Block = Tcb->SackBlock;
+
+  //
+  // Find the first range that ends at or after Left.
+  //
+  for (Index = 0; Index < Tcb->SackBlockNum; Index++) {
+    if (TCP_SEQ_GEQ (Block[Index].Right, Left)) {
+      break;
+    }
+  }
+
+  //
+  // Merge all the ranges that start at or before Right.
+  //
+  for (Last = Index; Last < Tcb->SackBlockNum; Last++) {
+    if (TCP_SEQ_GT (Block[Last].Left, Right)) {
+      break;
+    }
+
+    if (TCP_SEQ_LT (Block[Last].Left, Left)) {
+      Left = Block[Last].Left;
+    }
+
+    if (TCP_SEQ_GT (Block[Last].Right, Right)) {
+      Right = Block[Last].Right;
+    }
+  }
+
+  if (Last == Index) {
+    //
+    // A new range. When the scoreboard is full, forget the
+    // highest range, it is the last one needed by recovery.
+    //
+    if (Tcb->SackBlockNum == TCP_SACK_SCOREBOARD_MAX) {
+      if (Index == TCP_SACK_SCOREBOARD_MAX) {
+        return;
+      }
+
+      Tcb->SackBlockNum--;
+    }
+
+    CopyMem (
+      &Block[Index + 1],
+      &Block[Index],
+      (Tcb->SackBlockNum - Index) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackBlockNum++;
+  } else if (Last > Index + 1) {
+    CopyMem (
+      &Block[Index + 1],
+      &Block[Last],
+      (Tcb->SackBlockNum - Last) * sizeof (TCP_SACK_BLOCK)
+      );
+    Tcb->SackBlockNum = (UINT8)(Tcb->SackBlockNum - (Last - Index - 1));
+  }
+
+  Block[Index].Left  = Left;
+  Block[Index].Right = Right;
+}
+
+/**
+  Update the SACK scoreboard with the acknowledgment and the SACK blocks
+  carried by an incoming segment, as defined in RFC2018 and RFC6675.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Ack      The acknowledgment number of the segment.
+  @param[in]       Option   Pointer to the options of the segment.
+
+**/
+VOID
+TcpSackUpdate (
+  IN OUT TCP_CB      *Tcb,
+  IN     TCP_SEQNO   Ack,
+  IN     TCP_OPTION  *Option
+  )
+{
+  TCP_SEQNO  Left;
+  TCP_SEQNO  Right;
+  UINT8      Index;
+  UINT8      Num;
+
+  //
+  // Remove the ranges, or the part of them, cumulatively acknowledged.
+  //
+  Num = 0;
+  for (Index = 0; Index < Tcb->SackBlockNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Ack)) {
+      continue;
+    }
+
+    Tcb->SackBlock[Num].Left  = Tcb->SackBlock[Index].Left;
+    Tcb->SackBlock[Num].Right = Tcb->SackBlock[Index].Right;
+
+    if (TCP_SEQ_LT (Tcb->SackBlock[Num].Left, Ack)) {
+      Tcb->SackBlock[Num].Left = Ack;
+    }
+
+    Num++;
+  }
+
+  Tcb->SackBlockNum = Num;
+
+  if (!TCP_FLG_ON (Option->Flag, TCP_OPTION_RCVD_SACK)) {
+    return;
+  }
+
+  for (Index = 0; Index < Option->SackBlockNum; Index++) {
+    Left  = Option->SackBlock[Index].Left;
+    Right = Option->SackBlock[Index].Right;
+
+    //
+    // Ignore the blocks that are malformed, already acknowledged
+    // or beyond the data sent. D-SACK blocks fall in the second case.
+    //
+    if (TCP_SEQ_GEQ (Left, Right) ||
+        TCP_SEQ_LEQ (Right, Ack) ||
+        TCP_SEQ_GT (Right, Tcb->SndNxt))
+    {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Left, Ack)) {
+      Left = Ack;
+    }
+
+    TcpSackInsertBlock (Tcb, Left, Right);
+  }
+}
+
+/**
+  Get the amount of data SACKed by the peer above SndUna.
+
+  @param[in]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The number of bytes SACKed.
+
+**/
+UINT32
+TcpSackedBytes (
+  IN TCP_CB  *Tcb
+  )
+{
+  UINT32  Sacked;
+  UINT8   Index;
+
+  Sacked = 0;
+  for (Index = 0; Index < Tcb->SackBlockNum; Index++) {
+    Sacked += TCP_SUB_SEQ (Tcb->SackBlock[Index].Right, Tcb->SackBlock[Index].Left);
+  }
+
+  return Sacked;
+}
+
 /**
   NewReno fast recovery defined in RFC3782.
 
@@ -52,9 +225,7 @@ TcpFastRecover (
     //
     // Step 1A: Invoking fast retransmission.
     //
-    FlightSize = TCP_SUB_SEQ (Tcb->SndNxt, Tcb->SndUna);
-
-    Tcb->Ssthresh = MAX (FlightSize >> 1, (UINT32)(2 * Tcb->SndMss));
+    Tcb->Ssthresh = Tcb->CongestOps->Ssthresh (Tcb);
     Tcb->Recover  = Tcb->SndNxt;
 
     Tcb->CongestState = TCP_CONGEST_RECOVER;
@@ -64,7 +235,8 @@ TcpFastRecover (
     // Step 2: Entering fast retransmission
     //
     TcpRetransmit (Tcb, Tcb->SndUna);
-    Tcb->CWnd = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->CWnd        = Tcb->Ssthresh + 3 * Tcb->SndMss;
+    Tcb->SackHighRxt = Tcb->SndUna + Tcb->SndMss;
 
     DEBUG (
       (DEBUG_NET,
@@ -88,6 +260,13 @@ TcpFastRecover (
     // by TcpToSendData
     //
     Tcb->CWnd += Tcb->SndMss;
+
+    //
+    // With SACK, each duplicated ACK also repairs the next
+    // hole in the scoreboard as suggested by RFC6675, rather
+    // than waiting one RTT per lost segment.
+    //
+    TcpSackRetransmit (Tcb);
     DEBUG (
       (DEBUG_NET,
        "TcpFastRecover: received another duplicated ACK (%d) for TCB %p\n",
@@ -119,9 +298,19 @@ TcpFastRecover (
       //
       // Step 5 - Partial ACK:
       // fast retransmit the first unacknowledge field
-      // , then deflate the CWnd
+      // , then deflate the CWnd. With SACK, retransmit
+      // the first hole not yet retransmitted instead.
       //
-      TcpRetransmit (Tcb, Seg->Ack);
+      if (TCP_SEQ_LT (Tcb->SackHighRxt, Seg->Ack)) {
+        Tcb->SackHighRxt = Seg->Ack;
+      }
+
+      if (Tcb->SackBlockNum == 0) {
+        TcpRetransmit (Tcb, Seg->Ack);
+      } else {
+        TcpSackRetransmit (Tcb);
+      }
+
       Acked = TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna);
 
       //
@@ -563,6 +752,12 @@ TcpQueueData (
   Seg  = TCPSEG_NETBUF (Nbuf);
   Head = &Tcb->RcvQue;
 
+  //
+  // RFC2018 requires the first SACK block to report
+  // the most recently received data.
+  //
+  Tcb->RcvSackSeq = Seg->Seq;
+
   //
   // Fast path to process normal case. That is,
   // no out-of-order segments are received.
@@ -1202,6 +1397,13 @@ TcpInput (
     TcpSetTimer (Tcb, TCP_TIMER_REXMIT, Tcb->Rto);
   }
 
+  //
+  // Update the SACK scoreboard before it's used by the loss recovery.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    TcpSackUpdate (Tcb, Seg->Ack, &Option);
+  }
+
   //
   // Count duplicate acks.
   //
@@ -1215,6 +1417,20 @@ TcpInput (
     Tcb->DupAck = 0;
   }
 
+  //
+  // RFC6675: the first unacknowledged segment is also deemed lost
+  // once more than (DupThresh - 1) * SMSS bytes above it are SACKed,
+  // even if some of the duplicated ACKs were lost or not counted.
+  //
+  if ((Tcb->CongestState == TCP_CONGEST_OPEN) &&
+      (Tcb->DupAck < 3) &&
+      (Seg->Ack == Tcb->SndUna) &&
+      (Tcb->SndUna != Tcb->SndNxt) &&
+      (TcpSackedBytes (Tcb) > (UINT32)(2 * Tcb->SndMss)))
+  {
+    Tcb->DupAck = 3;
+  }
+
   //
   // Congestion avoidance, fast recovery and fast retransmission.
   //
@@ -1222,11 +1438,7 @@ TcpInput (
       (Tcb->CongestState == TCP_CONGEST_LOSS))
   {
     if (TCP_SEQ_GT (Seg->Ack, Tcb->SndUna)) {
-      if (Tcb->CWnd < Tcb->Ssthresh) {
-        Tcb->CWnd += Tcb->SndMss;
-      } else {
-        Tcb->CWnd += MAX (Tcb->SndMss * Tcb->SndMss / Tcb->CWnd, 1);
-      }
+      Tcb->CongestOps->OnAck (Tcb, TCP_SUB_SEQ (Seg->Ack, Tcb->SndUna));
 
       Tcb->CWnd = MIN (Tcb->CWnd, TCP_MAX_WIN << Tcb->SndWndScale);
     }
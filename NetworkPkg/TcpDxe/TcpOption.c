@@ -160,6 +160,28 @@ TcpSynBuildOption (
     TcpPutUint32 (Data, TCP_OPTION_WS_FAST | TcpComputeScale (Tcb));
   }
 
+  //
+  // Build SACK permitted option, only when configured
+  // to use SACK, and either we are doing active open
+  // or we have received SACK permitted option from peer.
+  //
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_NO_SACK) &&
+      (!TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_ACK) ||
+       TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_RCVD_SACK))
+      )
+  {
+    Data = NetbufAllocSpace (
+             Nbuf,
+             TCP_OPTION_SACK_PERM_ALIGNED_LEN,
+             NET_BUF_HEAD
+             );
+
+    ASSERT (Data != NULL);
+
+    Len += TCP_OPTION_SACK_PERM_ALIGNED_LEN;
+    TcpPutUint32 (Data, TCP_OPTION_SACK_PERM_FAST);
+  }
+
   //
   // Build the MSS option.
   //
@@ -172,6 +194,119 @@ TcpSynBuildOption (
   return Len;
 }
 
+/**
+  Get the next range of contiguous out-of-order data on the RcvQue.
+
+  @param[in]       Tcb     Pointer to the TCP_CB of this TCP instance.
+  @param[in, out]  Entry   On input, the RcvQue entry to start from. On output,
+                           the entry following the returned range.
+  @param[out]      Left    The first sequence number of the range.
+  @param[out]      Right   The sequence number of the last byte + 1.
+
+  @retval TRUE             A range is returned.
+  @retval FALSE            No more out-of-order data.
+
+**/
+BOOLEAN
+TcpGetSackRange (
+  IN     TCP_CB      *Tcb,
+  IN OUT LIST_ENTRY  **Entry,
+  OUT    TCP_SEQNO   *Left,
+  OUT    TCP_SEQNO   *Right
+  )
+{
+  LIST_ENTRY  *Cur;
+  TCP_SEG     *Seg;
+
+  Seg = NULL;
+
+  for (Cur = *Entry; Cur != &Tcb->RcvQue; Cur = Cur->ForwardLink) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Cur, NET_BUF, List));
+
+    if (TCP_SEQ_GT (Seg->Seq, Tcb->RcvNxt)) {
+      break;
+    }
+  }
+
+  if (Cur == &Tcb->RcvQue) {
+    *Entry = Cur;
+    return FALSE;
+  }
+
+  *Left  = Seg->Seq;
+  *Right = Seg->End;
+
+  //
+  // The segments on RcvQue are sorted and never overlap,
+  // merge the adjacent ones into one range.
+  //
+  for (Cur = Cur->ForwardLink; Cur != &Tcb->RcvQue; Cur = Cur->ForwardLink) {
+    Seg = TCPSEG_NETBUF (NET_LIST_USER_STRUCT (Cur, NET_BUF, List));
+
+    if (Seg->Seq != *Right) {
+      break;
+    }
+
+    *Right = Seg->End;
+  }
+
+  *Entry = Cur;
+  return TRUE;
+}
+
+/**
+  Collect the SACK blocks to report to the peer. As required by RFC2018,
+  the first block holds the most recently received out-of-order data, the
+  others follow in sequence order.
+
+  @param[in]   Tcb       Pointer to the TCP_CB of this TCP instance.
+  @param[out]  Block     Pointer to the array to store the SACK blocks.
+  @param[in]   MaxBlock  The maximum number of blocks to collect.
+
+  @return The number of blocks collected.
+
+**/
+UINT8
+TcpBuildSackBlock (
+  IN  TCP_CB          *Tcb,
+  OUT TCP_SACK_BLOCK  *Block,
+  IN  UINT8           MaxBlock
+  )
+{
+  LIST_ENTRY  *Entry;
+  TCP_SEQNO   Left;
+  TCP_SEQNO   Right;
+  BOOLEAN     Found;
+  UINT8       Num;
+
+  Num   = 0;
+  Found = FALSE;
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while ((MaxBlock > 0) && TcpGetSackRange (Tcb, &Entry, &Left, &Right)) {
+    if (TCP_SEQ_LEQ (Left, Tcb->RcvSackSeq) && TCP_SEQ_LT (Tcb->RcvSackSeq, Right)) {
+      Block[0].Left  = Left;
+      Block[0].Right = Right;
+      Num            = 1;
+      Found          = TRUE;
+      break;
+    }
+  }
+
+  Entry = Tcb->RcvQue.ForwardLink;
+  while ((Num < MaxBlock) && TcpGetSackRange (Tcb, &Entry, &Left, &Right)) {
+    if (Found && (Left == Block[0].Left)) {
+      continue;
+    }
+
+    Block[Num].Left  = Left;
+    Block[Num].Right = Right;
+    Num++;
+  }
+
+  return Num;
+}
+
 /**
   Build the TCP option in synchronized states.
 
@@ -187,11 +322,17 @@ TcpBuildOption (
   IN NET_BUF  *Nbuf
   )
 {
-  UINT8   *Data;
-  UINT16  Len;
+  UINT8           *Data;
+  UINT16          Len;
+  UINT32          DataLen;
+  TCP_SACK_BLOCK  Block[TCP_OPTION_MAX_SACK_BLOCK];
+  UINT8           MaxBlock;
+  UINT8           BlockNum;
+  UINT8           Index;
 
   ASSERT ((Tcb != NULL) && (Nbuf != NULL) && (Nbuf->Tcp == NULL));
-  Len = 0;
+  Len     = 0;
+  DataLen = Nbuf->TotalSize;
 
   //
   // Build the Timestamp option.
@@ -214,6 +355,43 @@ TcpBuildOption (
     TcpPutUint32 (Data + 8, Tcb->TsRecent);
   }
 
+  //
+  // Build the SACK option to report the out-of-order data
+  // queued on RcvQue. It must fit in the 40 bytes option
+  // space, and must not push a data segment over SndMss.
+  //
+  if (TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK) &&
+      !TCP_FLG_ON (TCPSEG_NETBUF (Nbuf)->Flag, TCP_FLG_RST) &&
+      !IsListEmpty (&Tcb->RcvQue)
+      )
+  {
+    MaxBlock = (UINT8)MIN ((40 - Len - 4) / TCP_OPTION_SACK_BLOCK_LEN, TCP_OPTION_MAX_SACK_BLOCK);
+
+    while ((MaxBlock > 0) && (DataLen + 4 + MaxBlock * TCP_OPTION_SACK_BLOCK_LEN > Tcb->SndMss)) {
+      MaxBlock--;
+    }
+
+    BlockNum = TcpBuildSackBlock (Tcb, Block, MaxBlock);
+
+    if (BlockNum > 0) {
+      Data = NetbufAllocSpace (
+               Nbuf,
+               4 + BlockNum * TCP_OPTION_SACK_BLOCK_LEN,
+               NET_BUF_HEAD
+               );
+
+      ASSERT (Data != NULL);
+      Len += 4 + BlockNum * TCP_OPTION_SACK_BLOCK_LEN;
+
+      TcpPutUint32 (Data, TCP_OPTION_SACK_FAST | (2 + BlockNum * TCP_OPTION_SACK_BLOCK_LEN));
+
+      for (Index = 0; Index < BlockNum; Index++) {
+        TcpPutUint32 (Data + 4 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Left);
+        TcpPutUint32 (Data + 8 + Index * TCP_OPTION_SACK_BLOCK_LEN, Block[Index].Right);
+      }
+    }
+  }
+
   return Len;
 }
 
@@ -239,6 +417,7 @@ TcpParseOption (
   UINT8  Cur;
   UINT8  Type;
   UINT8  Len;
+  UINT8  Index;
 
   ASSERT ((Tcp != NULL) && (Option != NULL));
 
@@ -297,6 +476,39 @@ TcpParseOption (
         Cur += TCP_OPTION_WS_LEN;
         break;
 
+      case TCP_OPTION_SACK_PERM:
+        Len = Head[Cur + 1];
+
+        if ((Len != TCP_OPTION_SACK_PERM_LEN) || (TotalLen - Cur < TCP_OPTION_SACK_PERM_LEN)) {
+          return -1;
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK_PERM);
+
+        Cur += TCP_OPTION_SACK_PERM_LEN;
+        break;
+
+      case TCP_OPTION_SACK:
+        Len = Head[Cur + 1];
+
+        if ((TotalLen - Cur < Len) || (Len < 2 + TCP_OPTION_SACK_BLOCK_LEN) ||
+            ((Len - 2) % TCP_OPTION_SACK_BLOCK_LEN != 0))
+        {
+          return -1;
+        }
+
+        Option->SackBlockNum = (UINT8)MIN ((Len - 2) / TCP_OPTION_SACK_BLOCK_LEN, TCP_OPTION_MAX_SACK_BLOCK);
+
+        for (Index = 0; Index < Option->SackBlockNum; Index++) {
+          Option->SackBlock[Index].Left  = TcpGetUint32 (&Head[Cur + 2 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+          Option->SackBlock[Index].Right = TcpGetUint32 (&Head[Cur + 6 + Index * TCP_OPTION_SACK_BLOCK_LEN]);
+        }
+
+        TCP_SET_FLG (Option->Flag, TCP_OPTION_RCVD_SACK);
+
+        Cur = (UINT8)(Cur + Len);
+        break;
+
       case TCP_OPTION_TS:
         Len = Head[Cur + 1];
 
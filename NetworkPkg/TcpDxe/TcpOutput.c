@@ -712,6 +712,63 @@ OnError:
   return -1;
 }
 
+/**
+  Retransmit the first hole of the SACK scoreboard that has not been
+  retransmitted in the current fast recovery, as suggested by RFC6675.
+
+  @param[in]  Tcb     Pointer to the TCP_CB of this TCP instance.
+
+  @retval 0       Retransmission succeeded, or no hole needs to be repaired.
+  @retval -1      Error condition occurred.
+
+**/
+INTN
+TcpSackRetransmit (
+  IN TCP_CB  *Tcb
+  )
+{
+  TCP_SEQNO  Seq;
+  UINT32     Len;
+  UINT8      Index;
+
+  if (!TCP_FLG_ON (Tcb->CtrlFlag, TCP_CTRL_SND_SACK)) {
+    return 0;
+  }
+
+  Seq = Tcb->SndUna;
+  if (TCP_SEQ_GT (Tcb->SackHighRxt, Seq)) {
+    Seq = Tcb->SackHighRxt;
+  }
+
+  //
+  // Only the data below a SACKed range is deemed lost, the
+  // data above the highest range may still be in flight.
+  //
+  for (Index = 0; Index < Tcb->SackBlockNum; Index++) {
+    if (TCP_SEQ_LEQ (Tcb->SackBlock[Index].Right, Seq)) {
+      continue;
+    }
+
+    if (TCP_SEQ_LT (Seq, Tcb->SackBlock[Index].Left)) {
+      Len              = MIN (TCP_SUB_SEQ (Tcb->SackBlock[Index].Left, Seq), Tcb->SndMss);
+      Tcb->SackHighRxt = Seq + Len;
+
+      DEBUG (
+        (DEBUG_NET,
+         "TcpSackRetransmit: retransmit hole at %d for TCB %p\n",
+         Seq,
+         Tcb)
+        );
+
+      return TcpRetransmit (Tcb, Seq);
+    }
+
+    Seq = Tcb->SackBlock[Index].Right;
+  }
+
+  return 0;
+}
+
 /**
   Verify that all the segments in SndQue are in good shape.
 
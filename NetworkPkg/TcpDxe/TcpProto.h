@@ -70,6 +70,17 @@
 #define TCP_CTRL_TIMER_ON      0x1000   ///< At least one of the timer is on.
 #define TCP_CTRL_RTT_ON        0x2000   ///< The RTT measurement is on.
 #define TCP_CTRL_ACK_NOW       0x4000   ///< Send the ACK now, don't delay.
+#define TCP_CTRL_NO_SACK       0x8000   ///< Disable Selective Acknowledgment option.
+#define TCP_CTRL_RCVD_SACK     0x10000  ///< Received a SACK-permitted option in syn.
+#define TCP_CTRL_SND_SACK      0x20000  ///< Exchange SACK blocks with remote.
+
+//
+// Congestion control algorithms, as selected by PcdTcpCongestionControl.
+//
+#define TCP_CONGEST_ALGO_NEWRENO  0     ///< RFC5681 and RFC6582 NewReno.
+#define TCP_CONGEST_ALGO_CUBIC    1     ///< RFC8312 CUBIC.
+
+#define TCP_SACK_SCOREBOARD_MAX  16     ///< SACKed ranges remembered by the sender.
 
 //
 // Timer related values
@@ -224,8 +235,68 @@ typedef struct _TCP_PEER {
   TCP_PORTNO        Port; ///< Port number, in network byte order.
 } TCP_PEER;
 
+///
+/// A range of contiguous data, used by the Selective Acknowledgment (RFC2018).
+///
+typedef struct _TCP_SACK_BLOCK {
+  TCP_SEQNO    Left;  ///< The first sequence number of the block.
+  TCP_SEQNO    Right; ///< The sequence number of the last byte + 1.
+} TCP_SACK_BLOCK;
+
 typedef struct _TCP_CONTROL_BLOCK TCP_CB;
 
+/**
+  Initialize the congestion control state of a connection.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+**/
+typedef
+VOID
+(*TCP_CONGESTION_INIT) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+/**
+  Open the congestion window when new data is acknowledged outside of the
+  fast recovery.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+  @param[in]       Acked    The number of bytes newly acknowledged.
+
+**/
+typedef
+VOID
+(*TCP_CONGESTION_ON_ACK) (
+  IN OUT TCP_CB  *Tcb,
+  IN     UINT32  Acked
+  );
+
+/**
+  Compute the slow start threshold after a loss is detected, either by the
+  duplicate ACKs or by the retransmission timeout.
+
+  @param[in, out]  Tcb      Pointer to the TCP_CB of this TCP instance.
+
+  @return The new slow start threshold in bytes.
+
+**/
+typedef
+UINT32
+(*TCP_CONGESTION_SSTHRESH) (
+  IN OUT TCP_CB  *Tcb
+  );
+
+///
+/// Congestion control algorithm. The loss detection and recovery are shared,
+/// only the window growth and the reduction on loss are algorithm specific.
+///
+typedef struct _TCP_CONGESTION_OPS {
+  TCP_CONGESTION_INIT        Init;
+  TCP_CONGESTION_ON_ACK      OnAck;
+  TCP_CONGESTION_SSTHRESH    Ssthresh;
+} TCP_CONGESTION_OPS;
+
 ///
 /// TCP control block: it includes various states.
 ///
@@ -306,6 +377,25 @@ struct _TCP_CONTROL_BLOCK {
   UINT8               LossTimes;    ///< Number of retxmit timeouts in a row.
   TCP_SEQNO           LossRecover;  ///< Recover point for retxmit.
 
+  //
+  // RFC2018 and RFC6675 variables.
+  // Selective Acknowledgment and SACK based loss recovery.
+  //
+  TCP_SACK_BLOCK      SackBlock[TCP_SACK_SCOREBOARD_MAX]; ///< SACKed ranges above SndUna, in order.
+  UINT8               SackBlockNum;                       ///< Number of ranges in SackBlock.
+  TCP_SEQNO           SackHighRxt;                        ///< Next seq to retxmit in SACK recovery.
+  TCP_SEQNO           RcvSackSeq;                         ///< Seq of the latest out-of-order data.
+
+  //
+  // Pluggable congestion control, and the RFC8312 CUBIC state.
+  //
+  CONST TCP_CONGESTION_OPS    *CongestOps;  ///< The congestion control algorithm.
+  UINT32                      CubicWMax;    ///< CWnd before the last reduction.
+  UINT32                      CubicOrigin;  ///< Origin point of the cubic function.
+  UINT32                      CubicK;       ///< Time to reach CubicOrigin in heartbeats.
+  UINT32                      CubicEpoch;   ///< When the current avoidance epoch started.
+  BOOLEAN                     CubicEpochOn; ///< If TRUE, the avoidance epoch is started.
+
   //
   // RFC7323
   // Addressing Window Retraction for TCP Window Scale Option.
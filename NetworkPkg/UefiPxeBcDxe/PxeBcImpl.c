@@ -218,6 +218,11 @@ EfiPxeBcStart (
     Private->BlockSize = (UINTN)PcdGet64 (PcdTftpBlockSize);
   }
 
+  //
+  // Start with the largest TFTP window, and adapt it to the loss later.
+  //
+  Private->TftpWindowSize = MAX ((UINTN)PcdGet64 (PcdPxeTftpWindowSize), 1);
+
   //
   // Create event for UdpRead/UdpWrite timeout since they are both blocking API.
   //
@@ -759,6 +764,52 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Back off after a TFTP read timed out, so that it can be retried with fewer
+  packets in flight.
+
+  A timeout is only taken as loss if the server sent part of the file. If it
+  sent nothing, it is down or unreachable, and the read is not retried, as it
+  has already used up the MTFTP retries.
+
+  A timeout with a window of several blocks halves the window used for the
+  following transfers. The read is retried once without
+  a window. If it already had no window, it is retried once with the default
+  block size, in case the large blocks are dropped on the path.
+
+  @param[in, out]  Private        Pointer to PxeBc private data.
+  @param[in, out]  WindowSize     The window size of the failed read.
+  @param[in, out]  BlockSize      The block size of the failed read.
+
+  @retval TRUE     Retry the read with the updated WindowSize and BlockSize.
+  @retval FALSE    No data was received, or there is nothing left to back off.
+
+**/
+BOOLEAN
+PxeBcMtftpBackOff (
+  IN OUT PXEBC_PRIVATE_DATA  *Private,
+  IN OUT UINTN               *WindowSize,
+  IN OUT UINTN               **BlockSize
+  )
+{
+  if (!Private->TftpDataReceived) {
+    return FALSE;
+  }
+
+  if (*WindowSize > 1) {
+    Private->TftpWindowSize = MAX (*WindowSize / 2, 1);
+    *WindowSize             = 1;
+    return TRUE;
+  }
+
+  if ((*BlockSize != NULL) && (**BlockSize > PXE_MTFTP_DEFAULT_BLOCK_SIZE)) {
+    *BlockSize = NULL;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
 /**
   Used to perform TFTP and MTFTP services.
 
@@ -845,6 +896,7 @@ EfiPxeBcMtftp (
   EFI_STATUS                   Status;
   EFI_PXE_BASE_CODE_IP_FILTER  IpFilter;
   UINTN                        WindowSize;
+  UINT64                       RequestedSize;
 
   if ((This == NULL) ||
       (Filename == NULL) ||
@@ -871,9 +923,10 @@ EfiPxeBcMtftp (
   Mode    = Private->PxeBc.Mode;
 
   //
-  // Get PcdPxeTftpWindowSize.
+  // Use the window size adapted by the previous transfers.
   //
-  WindowSize = (UINTN)PcdGet64 (PcdPxeTftpWindowSize);
+  WindowSize    = Private->TftpWindowSize;
+  RequestedSize = *BufferSize;
 
   if (Mode->UsingIpv6) {
     if (!NetIp6IsValidUnicast (&ServerIp->v6)) {
@@ -941,16 +994,20 @@ EfiPxeBcMtftp (
       //
       // Send TFTP request to read file.
       //
-      Status = PxeBcTftpReadFile (
-                 Private,
-                 Config,
-                 Filename,
-                 BlockSize,
-                 (WindowSize > 1) ? &WindowSize : NULL,
-                 BufferPtr,
-                 BufferSize,
-                 DontUseBuffer
-                 );
+      do {
+        *BufferSize               = RequestedSize;
+        Private->TftpDataReceived = FALSE;
+        Status                    = PxeBcTftpReadFile (
+                                      Private,
+                                      Config,
+                                      Filename,
+                                      BlockSize,
+                                      (WindowSize > 1) ? &WindowSize : NULL,
+                                      BufferPtr,
+                                      BufferSize,
+                                      DontUseBuffer
+                                      );
+      } while ((Status == EFI_TIMEOUT) && PxeBcMtftpBackOff (Private, &WindowSize, &BlockSize));
 
       break;
 
@@ -974,16 +1031,20 @@ EfiPxeBcMtftp (
       //
       // Send TFTP request to read directory.
       //
-      Status = PxeBcTftpReadDirectory (
-                 Private,
-                 Config,
-                 Filename,
-                 BlockSize,
-                 (WindowSize > 1) ? &WindowSize : NULL,
-                 BufferPtr,
-                 BufferSize,
-                 DontUseBuffer
-                 );
+      do {
+        *BufferSize               = RequestedSize;
+        Private->TftpDataReceived = FALSE;
+        Status                    = PxeBcTftpReadDirectory (
+                                      Private,
+                                      Config,
+                                      Filename,
+                                      BlockSize,
+                                      (WindowSize > 1) ? &WindowSize : NULL,
+                                      BufferPtr,
+                                      BufferSize,
+                                      DontUseBuffer
+                                      );
+      } while ((Status == EFI_TIMEOUT) && PxeBcMtftpBackOff (Private, &WindowSize, &BlockSize));
 
       break;
 
@@ -1004,6 +1065,18 @@ EfiPxeBcMtftp (
     Mode->IcmpErrorReceived = TRUE;
   }
 
+  //
+  // Open the window again by one block after each read succeeded with the
+  // full window, up to PcdPxeTftpWindowSize.
+  //
+  if (!EFI_ERROR (Status) &&
+      (WindowSize == Private->TftpWindowSize) &&
+      (WindowSize < PcdGet64 (PcdPxeTftpWindowSize)) &&
+      ((Operation == EFI_PXE_BASE_CODE_TFTP_READ_FILE) || (Operation == EFI_PXE_BASE_CODE_TFTP_READ_DIRECTORY)))
+  {
+    Private->TftpWindowSize++;
+  }
+
   //
   // Reconfigure the UDP instance with the default configuration.
   //
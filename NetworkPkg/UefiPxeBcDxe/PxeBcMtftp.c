@@ -52,6 +52,13 @@ PxeBcMtftp6CheckPacket (
   Callback = Private->PxeBcCallback;
   Status   = EFI_SUCCESS;
 
+  if ((NTOHS (Packet->OpCode) == EFI_MTFTP6_OPCODE_DATA) || (NTOHS (Packet->OpCode) == EFI_MTFTP6_OPCODE_DATA8)) {
+    //
+    // Tell a lossy path from a server that never answers if the read times out.
+    //
+    Private->TftpDataReceived = TRUE;
+  }
+
   if (Packet->OpCode == EFI_MTFTP6_OPCODE_ERROR) {
     //
     // Store the tftp error message into mode data and set the received flag.
@@ -530,6 +537,13 @@ PxeBcMtftp4CheckPacket (
   Callback = Private->PxeBcCallback;
   Status   = EFI_SUCCESS;
 
+  if ((NTOHS (Packet->OpCode) == EFI_MTFTP4_OPCODE_DATA) || (NTOHS (Packet->OpCode) == EFI_MTFTP4_OPCODE_DATA8)) {
+    //
+    // Tell a lossy path from a server that never answers if the read times out.
+    //
+    Private->TftpDataReceived = TRUE;
+  }
+
   if (Packet->OpCode == EFI_MTFTP4_OPCODE_ERROR) {
     //
     // Store the tftp error message into mode data and set the received flag.
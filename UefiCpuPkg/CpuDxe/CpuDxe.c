@@ -21,6 +21,22 @@ UINT64      mValidMtrrAddressMask;
 UINT64      mValidMtrrBitsMask;
 UINT64      mTimerPeriod = 0;
 
+//
+// MTRR settings calculated by CpuSetMemoryAttributes() for a request, keyed
+// by the request and the MTRR settings it was applied to.
+//
+typedef struct {
+  BOOLEAN                   Valid;
+  EFI_PHYSICAL_ADDRESS      BaseAddress;
+  UINT64                    Length;
+  MTRR_MEMORY_CACHE_TYPE    CacheType;
+  MTRR_SETTINGS             Original;
+  MTRR_SETTINGS             Result;
+} MTRR_SETTINGS_CACHE_ENTRY;
+
+MTRR_SETTINGS_CACHE_ENTRY  mMtrrSettingsCache[4];
+UINTN                      mMtrrSettingsCacheNext = 0;
+
 FIXED_MTRR  mFixedMtrrTable[] = {
   {
     MSR_IA32_MTRR_FIX64K_00000,
@@ -339,6 +355,67 @@ SetMtrrsFromBuffer (
   MtrrSetAllMtrrs (Buffer);
 }
 
+/**
+  Calculate the MTRR settings that set the cache type of a memory range.
+
+  The settings calculated for the recent requests are kept, so that the same
+  request on the same MTRR settings, e.g. a frame buffer switched between the
+  UC and WC types, does not go through the MTRR calculation again.
+
+  @param[in, out] MtrrSettings  On input, the current MTRR settings.
+                                On output, the MTRR settings to program.
+  @param[in]      BaseAddress   The physical address that is the start address of the range.
+  @param[in]      Length        The size in bytes of the range.
+  @param[in]      CacheType     The cache type to set for the range.
+
+  @return The status returned by MtrrSetMemoryAttributeInMtrrSettings().
+
+**/
+RETURN_STATUS
+CalculateMtrrSettings (
+  IN OUT MTRR_SETTINGS           *MtrrSettings,
+  IN     EFI_PHYSICAL_ADDRESS    BaseAddress,
+  IN     UINT64                  Length,
+  IN     MTRR_MEMORY_CACHE_TYPE  CacheType
+  )
+{
+  RETURN_STATUS              Status;
+  UINTN                      Index;
+  MTRR_SETTINGS_CACHE_ENTRY  *Entry;
+
+  for (Index = 0; Index < ARRAY_SIZE (mMtrrSettingsCache); Index++) {
+    Entry = &mMtrrSettingsCache[Index];
+    if (Entry->Valid &&
+        (Entry->BaseAddress == BaseAddress) &&
+        (Entry->Length == Length) &&
+        (Entry->CacheType == CacheType) &&
+        (CompareMem (&Entry->Original, MtrrSettings, sizeof (MTRR_SETTINGS)) == 0))
+    {
+      CopyMem (MtrrSettings, &Entry->Result, sizeof (MTRR_SETTINGS));
+      return RETURN_SUCCESS;
+    }
+  }
+
+  Entry        = &mMtrrSettingsCache[mMtrrSettingsCacheNext];
+  Entry->Valid = FALSE;
+  CopyMem (&Entry->Original, MtrrSettings, sizeof (MTRR_SETTINGS));
+
+  Status = MtrrSetMemoryAttributeInMtrrSettings (MtrrSettings, BaseAddress, Length, CacheType);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Entry->BaseAddress = BaseAddress;
+  Entry->Length      = Length;
+  Entry->CacheType   = CacheType;
+  CopyMem (&Entry->Result, MtrrSettings, sizeof (MTRR_SETTINGS));
+  Entry->Valid = TRUE;
+
+  mMtrrSettingsCacheNext = (mMtrrSettingsCacheNext + 1) % ARRAY_SIZE (mMtrrSettingsCache);
+
+  return Status;
+}
+
 /**
   Implementation of SetMemoryAttributes() service of CPU Architecture Protocol.
 
@@ -378,6 +455,7 @@ CpuSetMemoryAttributes (
   EFI_STATUS                MpStatus;
   EFI_MP_SERVICES_PROTOCOL  *MpService;
   MTRR_SETTINGS             MtrrSettings;
+  MTRR_SETTINGS             OriginalMtrrSettings;
   UINT64                    CacheAttributes;
   UINT64                    MemoryAttributes;
   MTRR_MEMORY_CACHE_TYPE    CurrentCacheType;
@@ -448,15 +526,19 @@ CpuSetMemoryAttributes (
     CurrentCacheType = MtrrGetMemoryAttribute (BaseAddress);
     if (CurrentCacheType != CacheType) {
       //
-      // call MTRR library function
+      // Calculate the MTRR settings once in a buffer, and program the same
+      // settings to the BSP and all APs. Nothing is programmed if the range
+      // already has the cache type.
       //
-      Status = MtrrSetMemoryAttribute (
-                 BaseAddress,
-                 Length,
-                 CacheType
-                 );
+      MtrrGetAllMtrrs (&MtrrSettings);
+      CopyMem (&OriginalMtrrSettings, &MtrrSettings, sizeof (MtrrSettings));
+      Status = CalculateMtrrSettings (&MtrrSettings, BaseAddress, Length, CacheType);
+
+      if (!RETURN_ERROR (Status) &&
+          (CompareMem (&MtrrSettings, &OriginalMtrrSettings, sizeof (MtrrSettings)) != 0))
+      {
+        MtrrSetAllMtrrs (&MtrrSettings);
 
-      if (!RETURN_ERROR (Status)) {
         MpStatus = gBS->LocateProtocol (
                           &gEfiMpServiceProtocolGuid,
                           NULL,
@@ -466,7 +548,6 @@ CpuSetMemoryAttributes (
         // Synchronize the update with all APs
         //
         if (!EFI_ERROR (MpStatus)) {
-          MtrrGetAllMtrrs (&MtrrSettings);
           MpStatus = MpService->StartupAllAPs (
                                   MpService,          // This
                                   SetMtrrsFromBuffer, // Procedure
@@ -22,6 +22,12 @@ EFI_MP_SERVICES_PROTOCOL  mMpServicesTemplate = {
   WhoAmI
 };
 
+EDKII_MP_TASK_QUEUE_PROTOCOL  mMpTaskQueue = {
+  EDKII_MP_TASK_QUEUE_PROTOCOL_REVISION,
+  RunTasks,
+  GetTaskStatistics
+};
+
 /**
   This service retrieves the number of logical processor in the platform
   and the number of those logical processors that are enabled on this boot.
@@ -512,6 +518,74 @@ WhoAmI (
   return MpInitLibWhoAmI (ProcessorNumber);
 }
 
+/**
+  Implementation of RunTasks() service of MP Task Queue Protocol.
+
+  Run the tasks on all the enabled processors and wait for them to finish.
+  This service may only be called from the BSP.
+
+  @param[in]  This              Pointer to the EDKII_MP_TASK_QUEUE_PROTOCOL instance.
+  @param[in]  Procedure         The procedure of the tasks.
+  @param[in]  TaskCount         The number of tasks.
+  @param[in]  Context           The context passed to each task.
+
+  @retval EFI_SUCCESS           All the tasks are done.
+  @retval EFI_INVALID_PARAMETER Procedure is NULL, or TaskCount is 0 or greater than MAX_UINT32.
+  @retval EFI_DEVICE_ERROR      The caller is an AP.
+  @retval EFI_NOT_READY         Some enabled APs are busy.
+
+**/
+EFI_STATUS
+EFIAPI
+RunTasks (
+  IN EDKII_MP_TASK_QUEUE_PROTOCOL  *This,
+  IN EDKII_MP_TASK_PROCEDURE       Procedure,
+  IN UINTN                         TaskCount,
+  IN VOID                          *Context OPTIONAL
+  )
+{
+  return MpInitLibRunTasks ((MP_TASK_PROCEDURE)Procedure, TaskCount, Context);
+}
+
+/**
+  Implementation of GetStatistics() service of MP Task Queue Protocol.
+
+  @param[in]  This              Pointer to the EDKII_MP_TASK_QUEUE_PROTOCOL instance.
+  @param[in]  ProcessorNumber   The handle number of the processor.
+  @param[out] Statistics        The utilization of the processor.
+
+  @retval EFI_SUCCESS           The statistics are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+  @retval EFI_NOT_FOUND         The processor does not exist.
+
+**/
+EFI_STATUS
+EFIAPI
+GetTaskStatistics (
+  IN  EDKII_MP_TASK_QUEUE_PROTOCOL  *This,
+  IN  UINTN                         ProcessorNumber,
+  OUT EDKII_MP_TASK_STATISTICS      *Statistics
+  )
+{
+  EFI_STATUS          Status;
+  MP_TASK_STATISTICS  TaskStatistics;
+
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = MpInitLibGetTaskStatistics (ProcessorNumber, &TaskStatistics);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Statistics->TaskCount       = TaskStatistics.TaskCount;
+  Statistics->StolenTaskCount = TaskStatistics.StolenTaskCount;
+  Statistics->BusyTime        = TaskStatistics.BusyTime;
+  Statistics->TotalTime       = TaskStatistics.TotalTime;
+  return EFI_SUCCESS;
+}
+
 /**
   Collects BIST data from HOB.
 
@@ -846,6 +920,8 @@ InitializeMpSupport (
                   &mMpServiceHandle,
                   &gEfiMpServiceProtocolGuid,
                   &mMpServicesTemplate,
+                  &gEdkiiMpTaskQueueProtocolGuid,
+                  &mMpTaskQueue,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
@@ -466,4 +466,50 @@ WhoAmI (
   OUT UINTN                    *ProcessorNumber
   );
 
+/**
+  Implementation of RunTasks() service of MP Task Queue Protocol.
+
+  Run the tasks on all the enabled processors and wait for them to finish.
+  This service may only be called from the BSP.
+
+  @param[in]  This              Pointer to the EDKII_MP_TASK_QUEUE_PROTOCOL instance.
+  @param[in]  Procedure         The procedure of the tasks.
+  @param[in]  TaskCount         The number of tasks.
+  @param[in]  Context           The context passed to each task.
+
+  @retval EFI_SUCCESS           All the tasks are done.
+  @retval EFI_INVALID_PARAMETER Procedure is NULL, or TaskCount is 0 or greater than MAX_UINT32.
+  @retval EFI_DEVICE_ERROR      The caller is an AP.
+  @retval EFI_NOT_READY         Some enabled APs are busy.
+
+**/
+EFI_STATUS
+EFIAPI
+RunTasks (
+  IN EDKII_MP_TASK_QUEUE_PROTOCOL  *This,
+  IN EDKII_MP_TASK_PROCEDURE       Procedure,
+  IN UINTN                         TaskCount,
+  IN VOID                          *Context OPTIONAL
+  );
+
+/**
+  Implementation of GetStatistics() service of MP Task Queue Protocol.
+
+  @param[in]  This              Pointer to the EDKII_MP_TASK_QUEUE_PROTOCOL instance.
+  @param[in]  ProcessorNumber   The handle number of the processor.
+  @param[out] Statistics        The utilization of the processor.
+
+  @retval EFI_SUCCESS           The statistics are returned.
+  @retval EFI_INVALID_PARAMETER Statistics is NULL.
+  @retval EFI_NOT_FOUND         The processor does not exist.
+
+**/
+EFI_STATUS
+EFIAPI
+GetTaskStatistics (
+  IN  EDKII_MP_TASK_QUEUE_PROTOCOL  *This,
+  IN  UINTN                         ProcessorNumber,
+  OUT EDKII_MP_TASK_STATISTICS      *Statistics
+  );
+
 #endif // _CPU_MP_H_
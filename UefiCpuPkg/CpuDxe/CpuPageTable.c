@@ -60,6 +60,8 @@
 #define MAX_DEBUG_MESSAGE_LENGTH  0x100
 #define IA32_PF_EC_ID             BIT4
 
+#define MAX_FREE_PAGE_TABLE_COUNT  64
+
 typedef enum {
   PageNone,
   Page4K,
@@ -90,6 +92,20 @@ BOOLEAN                        mPageTablePoolLock = FALSE;
 PAGE_TABLE_LIB_PAGING_CONTEXT  mPagingContext;
 EFI_SMM_BASE2_PROTOCOL         *mSmmBase2 = NULL;
 
+//
+// Page tables released by merging split pages back into large pages. They are
+// retired until the TLB is flushed, and then become free for SplitPage() again.
+//
+VOID   *mRetiredPageTables[MAX_FREE_PAGE_TABLE_COUNT];
+UINTN  mRetiredPageTableCount = 0;
+VOID   *mFreePageTables[MAX_FREE_PAGE_TABLE_COUNT];
+UINTN  mFreePageTableCount = 0;
+
+//
+// Record the counts of split and merged pages.
+//
+PAGE_TABLE_LIB_STATISTICS  mPageTableStatistics;
+
 //
 // Record the page fault exception count for one instruction execution.
 //
@@ -366,6 +382,91 @@ GetPageTableEntry (
   return &L1PageTable[Index1];
 }
 
+/**
+  Return the page directory entry that maps the address, whether it maps a large
+  page or points to a page table.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  Address           The address to be checked.
+  @param[in]  PageAttribute     Page2M for the page directory entry, or Page1G for
+                                the page directory pointer table entry.
+
+  @return The page directory entry, or NULL if it is not present.
+**/
+UINT64 *
+GetPageDirectoryEntry (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
+  IN  PHYSICAL_ADDRESS               Address,
+  IN  PAGE_ATTRIBUTE                 PageAttribute
+  )
+{
+  UINTN   Index2;
+  UINTN   Index3;
+  UINTN   Index4;
+  UINTN   Index5;
+  UINT64  *L2PageTable;
+  UINT64  *L3PageTable;
+  UINT64  *L4PageTable;
+  UINT64  *L5PageTable;
+  UINT64  AddressEncMask;
+
+  ASSERT (PagingContext != NULL);
+  ASSERT (PageAttribute == Page2M || PageAttribute == Page1G);
+
+  Index5 = ((UINTN)RShiftU64 (Address, 48)) & PAGING_PAE_INDEX_MASK;
+  Index4 = ((UINTN)RShiftU64 (Address, 39)) & PAGING_PAE_INDEX_MASK;
+  Index3 = ((UINTN)Address >> 30) & PAGING_PAE_INDEX_MASK;
+  Index2 = ((UINTN)Address >> 21) & PAGING_PAE_INDEX_MASK;
+
+  // Make sure AddressEncMask is contained to smallest supported address field.
+  //
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+
+  if (PagingContext->MachineType == IMAGE_FILE_MACHINE_X64) {
+    if ((PagingContext->ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_5_LEVEL) != 0) {
+      L5PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.X64.PageTableBase;
+      if (L5PageTable[Index5] == 0) {
+        return NULL;
+      }
+
+      L4PageTable = (UINT64 *)(UINTN)(L5PageTable[Index5] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+    } else {
+      L4PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.X64.PageTableBase;
+    }
+
+    if (L4PageTable[Index4] == 0) {
+      return NULL;
+    }
+
+    L3PageTable = (UINT64 *)(UINTN)(L4PageTable[Index4] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  } else {
+    ASSERT ((PagingContext->ContextData.Ia32.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAE) != 0);
+    L3PageTable = (UINT64 *)(UINTN)PagingContext->ContextData.Ia32.PageTableBase;
+  }
+
+  if (L3PageTable[Index3] == 0) {
+    return NULL;
+  }
+
+  if (PageAttribute == Page1G) {
+    return &L3PageTable[Index3];
+  }
+
+  if ((L3PageTable[Index3] & IA32_PG_PS) != 0) {
+    //
+    // Mapped by a 1G page, no page directory.
+    //
+    return NULL;
+  }
+
+  L2PageTable = (UINT64 *)(UINTN)(L3PageTable[Index3] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  if (L2PageTable[Index2] == 0) {
+    return NULL;
+  }
+
+  return &L2PageTable[Index2];
+}
+
 /**
   Return memory attributes of page entry.
 
@@ -581,6 +682,7 @@ SplitPage (
       }
 
       (*PageEntry) = (UINT64)(UINTN)NewPageEntry | AddressEncMask | ((*PageEntry) & PAGE_ATTRIBUTE_BITS);
+      mPageTableStatistics.SplitCount++;
       return RETURN_SUCCESS;
     } else {
       return RETURN_UNSUPPORTED;
@@ -604,6 +706,7 @@ SplitPage (
       }
 
       (*PageEntry) = (UINT64)(UINTN)NewPageEntry | AddressEncMask | ((*PageEntry) & PAGE_ATTRIBUTE_BITS);
+      mPageTableStatistics.SplitCount++;
       return RETURN_SUCCESS;
     } else {
       return RETURN_UNSUPPORTED;
@@ -613,6 +716,101 @@ SplitPage (
   }
 }
 
+/**
+  This function merges the page table that one page entry points to back into
+  one large page, if all of its entries map contiguous memory with the same
+  attributes. It is the reverse of SplitPage().
+
+  @param[in, out] PageEntry       The page entry to be merged.
+  @param[in]      PageAttribute   The page attribute of the merged page entry.
+  @param[out]     PageTable       Return the page table released by the merge.
+
+  @retval TRUE    The page entry is merged.
+  @retval FALSE   The page entry does not point to a page table, or the entries
+                  of the page table cannot be merged.
+**/
+BOOLEAN
+MergePage (
+  IN OUT UINT64          *PageEntry,
+  IN     PAGE_ATTRIBUTE  PageAttribute,
+  OUT    UINT64          **PageTable
+  )
+{
+  UINT64  *Table;
+  UINT64  AddressEncMask;
+  UINT64  AddressMask;
+  UINT64  EntryLength;
+  UINT64  EntryBits;
+  UINT64  BaseAddress;
+  UINT64  EncryptionBits;
+  UINT64  Attributes;
+  UINT64  AccessBits;
+  UINTN   Index;
+
+  ASSERT (PageAttribute == Page2M || PageAttribute == Page1G);
+
+  if (((*PageEntry & IA32_PG_P) == 0) || ((*PageEntry & IA32_PG_PS) != 0)) {
+    return FALSE;
+  }
+
+  // Make sure AddressEncMask is contained to smallest supported address field.
+  //
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+
+  if (PageAttribute == Page2M) {
+    //
+    // Merge 4K to 2M
+    //
+    AddressMask = PAGING_4K_ADDRESS_MASK_64;
+    EntryLength = SIZE_4KB;
+    EntryBits   = 0;
+  } else {
+    //
+    // Merge 2M to 1G
+    // The page tables of the 2M pages must have been merged first.
+    //
+    AddressMask = PAGING_2M_ADDRESS_MASK_64;
+    EntryLength = SIZE_2MB;
+    EntryBits   = IA32_PG_PS;
+  }
+
+  Table          = (UINT64 *)(UINTN)(*PageEntry & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64);
+  BaseAddress    = Table[0] & ~AddressEncMask & AddressMask;
+  EncryptionBits = Table[0] & AddressEncMask;
+  Attributes     = Table[0] & (IA32_PG_NX | IA32_PG_U | IA32_PG_RW | IA32_PG_P);
+  AccessBits     = 0;
+  if ((BaseAddress & (PageAttributeToLength (PageAttribute) - 1)) != 0) {
+    return FALSE;
+  }
+
+  for (Index = 0; Index < SIZE_4KB / sizeof (UINT64); Index++) {
+    //
+    // Only the entries like those set up by SplitPage() can be merged: the pages
+    // of the same size, without caching or other bits than PAGE_PROGATE_BITS,
+    // and with the same attributes. The accessed and dirty bits are combined.
+    //
+    if (((Table[Index] & ~AddressEncMask & ~AddressMask & ~PAGE_PROGATE_BITS) != EntryBits) ||
+        ((Table[Index] & ~AddressEncMask & AddressMask) != BaseAddress + EntryLength * Index) ||
+        ((Table[Index] & AddressEncMask) != EncryptionBits) ||
+        ((Table[Index] & (IA32_PG_NX | IA32_PG_U | IA32_PG_RW | IA32_PG_P)) != Attributes))
+    {
+      return FALSE;
+    }
+
+    AccessBits |= Table[Index] & (IA32_PG_D | IA32_PG_A);
+  }
+
+  //
+  // The access rights of the page entry apply to all the pages of its page table.
+  //
+  Attributes &= (*PageEntry & (IA32_PG_U | IA32_PG_RW | IA32_PG_P)) | IA32_PG_NX;
+  Attributes |= *PageEntry & IA32_PG_NX;
+
+  *PageTable = Table;
+  *PageEntry = BaseAddress | EncryptionBits | IA32_PG_PS | Attributes | AccessBits;
+  return TRUE;
+}
+
 /**
  Check the WP status in CR0 register. This bit is used to lock or unlock write
  access to pages marked as read-only.
@@ -874,6 +1072,218 @@ Done:
   return Status;
 }
 
+/**
+  Release one page of page table memory, which is no longer referenced by the
+  page table.
+
+  The page is retired until the TLB is flushed, because the processor might
+  still cache the translations through it.
+
+  @param[in]  PageTable   The page of page table memory to release.
+**/
+VOID
+ReleasePageTableMemory (
+  IN VOID  *PageTable
+  )
+{
+  //
+  // The page stays in the page table pool, unused, if there is no room to
+  // record it.
+  //
+  if (mRetiredPageTableCount < MAX_FREE_PAGE_TABLE_COUNT) {
+    mRetiredPageTables[mRetiredPageTableCount] = PageTable;
+    mRetiredPageTableCount++;
+  }
+}
+
+/**
+  Make the retired pages of page table memory free for reuse, after the TLB is
+  flushed.
+**/
+VOID
+RecycleRetiredPageTableMemory (
+  VOID
+  )
+{
+  while ((mRetiredPageTableCount > 0) && (mFreePageTableCount < MAX_FREE_PAGE_TABLE_COUNT)) {
+    mRetiredPageTableCount--;
+    mFreePageTables[mFreePageTableCount] = mRetiredPageTables[mRetiredPageTableCount];
+    mFreePageTableCount++;
+  }
+
+  mRetiredPageTableCount = 0;
+}
+
+/**
+  This function merges the split pages in the memory region specified by
+  BaseAddress and Length back into large pages, wherever all the pages of a
+  large page have the same attributes again.
+
+  Caller should make sure the page table is writable, and flush the TLB if the
+  page table is modified.
+
+  @param[in]  PagingContext     The paging context.
+  @param[in]  BaseAddress       The physical address that is the start address of a memory region.
+  @param[in]  Length            The size in bytes of the memory region.
+  @param[out] IsModified        TRUE means page table modified. FALSE means page table not modified.
+**/
+VOID
+MergeMemoryPageAttributes (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext,
+  IN  PHYSICAL_ADDRESS               BaseAddress,
+  IN  UINT64                         Length,
+  OUT BOOLEAN                        *IsModified
+  )
+{
+  PHYSICAL_ADDRESS  Address;
+  PHYSICAL_ADDRESS  EndAddress;
+  UINT64            *PageEntry;
+  UINT64            *PageTable;
+  UINT32            *PageAttributes;
+
+  *IsModified = FALSE;
+
+  //
+  // Merge 4K pages to 2M pages first, which may then be merged to 1G pages.
+  //
+  EndAddress = ALIGN_VALUE (BaseAddress + Length, SIZE_2MB);
+  for (Address = BaseAddress & ~(UINT64)PAGING_2M_MASK; Address < EndAddress; Address += SIZE_2MB) {
+    PageEntry = GetPageDirectoryEntry (PagingContext, Address, Page2M);
+    if ((PageEntry != NULL) && MergePage (PageEntry, Page2M, &PageTable)) {
+      ReleasePageTableMemory (PageTable);
+      mPageTableStatistics.MergeCount++;
+      *IsModified = TRUE;
+    }
+  }
+
+  GetPagingDetails (&PagingContext->ContextData, NULL, &PageAttributes);
+  if ((PagingContext->MachineType != IMAGE_FILE_MACHINE_X64) ||
+      ((*PageAttributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAGE_1G_SUPPORT) == 0))
+  {
+    return;
+  }
+
+  EndAddress = ALIGN_VALUE (BaseAddress + Length, SIZE_1GB);
+  for (Address = BaseAddress & ~(UINT64)PAGING_1G_MASK; Address < EndAddress; Address += SIZE_1GB) {
+    PageEntry = GetPageDirectoryEntry (PagingContext, Address, Page1G);
+    if ((PageEntry != NULL) && MergePage (PageEntry, Page1G, &PageTable)) {
+      ReleasePageTableMemory (PageTable);
+      mPageTableStatistics.MergeCount++;
+      *IsModified = TRUE;
+    }
+  }
+}
+
+/**
+  This function assigns the page attributes for several memory regions, each of
+  them specified by BaseAddress and Length, from their current attributes to the
+  attributes specified by Attributes.
+
+  On the current paging context, the split pages of the regions are merged back
+  into large pages wherever their attributes become uniform again, and the TLB
+  is flushed once after all the regions are updated.
+
+  Caller should make sure BaseAddress and Length of each region is at page boundary.
+
+  Caller need guarantee the TPL <= TPL_NOTIFY, if there is split page request.
+
+  @param[in]  PagingContext     The paging context. NULL means get page table from current CPU context.
+  @param[in]  Updates           The memory regions and the attributes to set for them.
+  @param[in]  UpdateCount       The number of memory regions in Updates.
+  @param[in]  AllocatePagesFunc If page split is needed, this function is used to allocate more pages.
+                                NULL mean page split is unsupported.
+
+  @retval RETURN_SUCCESS           The attributes were assigned for all the memory regions.
+  @retval RETURN_INVALID_PARAMETER Updates is NULL and UpdateCount is not zero.
+  @retval Others                   The attributes of a memory region could not be assigned, as
+                                   returned by AssignMemoryPageAttributes(). The regions before
+                                   it are updated.
+**/
+RETURN_STATUS
+EFIAPI
+AssignMemoryPageAttributesBatch (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT    *PagingContext OPTIONAL,
+  IN  PAGE_TABLE_LIB_ATTRIBUTE_UPDATE  *Updates,
+  IN  UINTN                            UpdateCount,
+  IN  PAGE_TABLE_LIB_ALLOCATE_PAGES    AllocatePagesFunc OPTIONAL
+  )
+{
+  PAGE_TABLE_LIB_PAGING_CONTEXT  CurrentPagingContext;
+  RETURN_STATUS                  Status;
+  UINTN                          Index;
+  UINTN                          Count;
+  BOOLEAN                        IsModified;
+  BOOLEAN                        IsSplitted;
+  BOOLEAN                        IsMerged;
+  BOOLEAN                        IsWpEnabled;
+  BOOLEAN                        NeedFlush;
+
+  if ((Updates == NULL) && (UpdateCount != 0)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  Status    = RETURN_SUCCESS;
+  NeedFlush = FALSE;
+  for (Count = 0; Count < UpdateCount; Count++) {
+    Status = ConvertMemoryPageAttributes (
+               PagingContext,
+               Updates[Count].BaseAddress,
+               Updates[Count].Length,
+               Updates[Count].Attributes,
+               PageActionAssign,
+               AllocatePagesFunc,
+               &IsSplitted,
+               &IsModified
+               );
+    if (RETURN_ERROR (Status)) {
+      break;
+    }
+
+    if (IsModified) {
+      NeedFlush = TRUE;
+    }
+  }
+
+  //
+  // The pages are only merged on the current paging context, the TLB of which
+  // is flushed below. The callers passing their own paging context, like the
+  // #PF handler, keep the page entries they get after the call.
+  //
+  if ((PagingContext == NULL) && NeedFlush) {
+    GetCurrentPagingContext (&CurrentPagingContext);
+
+    IsWpEnabled = IsReadOnlyPageWriteProtected ();
+    if (IsWpEnabled) {
+      DisableReadOnlyPageWriteProtect ();
+    }
+
+    for (Index = 0; Index < Count; Index++) {
+      MergeMemoryPageAttributes (
+        &CurrentPagingContext,
+        Updates[Index].BaseAddress,
+        Updates[Index].Length,
+        &IsMerged
+        );
+    }
+
+    if (IsWpEnabled) {
+      EnableReadOnlyPageWriteProtect ();
+    }
+
+    //
+    // Flush TLB as last step.
+    //
+    // Note: Since APs will always init CR3 register in HLT loop mode or do
+    // TLB flush in MWAIT loop mode, there's no need to flush TLB for them
+    // here.
+    //
+    CpuFlushTlb ();
+    RecycleRetiredPageTableMemory ();
+  }
+
+  return Status;
+}
+
 /**
   This function assigns the page attributes for the memory region specified by BaseAddress and
   Length from their current attributes to the attributes specified by Attributes.
@@ -912,26 +1322,13 @@ AssignMemoryPageAttributes (
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES  AllocatePagesFunc OPTIONAL
   )
 {
-  RETURN_STATUS  Status;
-  BOOLEAN        IsModified;
-  BOOLEAN        IsSplitted;
+  PAGE_TABLE_LIB_ATTRIBUTE_UPDATE  Update;
 
   //  DEBUG((DEBUG_INFO, "AssignMemoryPageAttributes: 0x%lx - 0x%lx (0x%lx)\n", BaseAddress, Length, Attributes));
-  Status = ConvertMemoryPageAttributes (PagingContext, BaseAddress, Length, Attributes, PageActionAssign, AllocatePagesFunc, &IsSplitted, &IsModified);
-  if (!EFI_ERROR (Status)) {
-    if ((PagingContext == NULL) && IsModified) {
-      //
-      // Flush TLB as last step.
-      //
-      // Note: Since APs will always init CR3 register in HLT loop mode or do
-      // TLB flush in MWAIT loop mode, there's no need to flush TLB for them
-      // here.
-      //
-      CpuFlushTlb ();
-    }
-  }
-
-  return Status;
+  Update.BaseAddress = BaseAddress;
+  Update.Length      = Length;
+  Update.Attributes  = Attributes;
+  return AssignMemoryPageAttributesBatch (PagingContext, &Update, 1, AllocatePagesFunc);
 }
 
 /**
@@ -1212,6 +1609,14 @@ AllocatePageTableMemory (
     return NULL;
   }
 
+  //
+  // Reuse the page tables released by merging large pages, if any.
+  //
+  if ((Pages == 1) && (mFreePageTableCount > 0)) {
+    mFreePageTableCount--;
+    return mFreePageTables[mFreePageTableCount];
+  }
+
   //
   // Renew the pool if necessary.
   //
@@ -1389,6 +1794,140 @@ PageFaultExceptionHandler (
   }
 }
 
+/**
+  Count the pages mapped by one page table and its child page tables.
+
+  @param[in]      PageTable       The page table.
+  @param[in]      EntryCount      The number of entries in the page table.
+  @param[in]      Level           The level of the page table, 1 for the page tables
+                                  of 4K pages.
+  @param[in]      AddressEncMask  The address encryption mask of the page entries.
+  @param[in, out] Statistics      The statistics to update.
+**/
+VOID
+CountPageTableEntries (
+  IN     UINT64                     *PageTable,
+  IN     UINTN                      EntryCount,
+  IN     UINTN                      Level,
+  IN     UINT64                     AddressEncMask,
+  IN OUT PAGE_TABLE_LIB_STATISTICS  *Statistics
+  )
+{
+  UINTN  Index;
+
+  Statistics->PageTablePages++;
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (PageTable[Index] == 0) {
+      continue;
+    }
+
+    if (Level == 1) {
+      Statistics->Page4KCount++;
+    } else if ((Level == 2) && ((PageTable[Index] & IA32_PG_PS) != 0)) {
+      Statistics->Page2MCount++;
+    } else if ((Level == 3) && ((PageTable[Index] & IA32_PG_PS) != 0)) {
+      Statistics->Page1GCount++;
+    } else if ((PageTable[Index] & IA32_PG_P) != 0) {
+      CountPageTableEntries (
+        (UINT64 *)(UINTN)(PageTable[Index] & ~AddressEncMask & PAGING_4K_ADDRESS_MASK_64),
+        SIZE_4KB / sizeof (UINT64),
+        Level - 1,
+        AddressEncMask,
+        Statistics
+        );
+    }
+  }
+}
+
+/**
+  Get the statistics of the page table.
+
+  @param[in]  PagingContext     The paging context. NULL means get page table from current CPU context.
+  @param[out] Statistics        Return the statistics of the page table.
+**/
+VOID
+GetPageTableStatistics (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext OPTIONAL,
+  OUT PAGE_TABLE_LIB_STATISTICS      *Statistics
+  )
+{
+  PAGE_TABLE_LIB_PAGING_CONTEXT  CurrentPagingContext;
+  UINT64                         AddressEncMask;
+
+  if (PagingContext == NULL) {
+    GetCurrentPagingContext (&CurrentPagingContext);
+  } else {
+    CopyMem (&CurrentPagingContext, PagingContext, sizeof (CurrentPagingContext));
+  }
+
+  ZeroMem (Statistics, sizeof (*Statistics));
+  Statistics->SplitCount = mPageTableStatistics.SplitCount;
+  Statistics->MergeCount = mPageTableStatistics.MergeCount;
+
+  // Make sure AddressEncMask is contained to smallest supported address field.
+  //
+  AddressEncMask = PcdGet64 (PcdPteMemoryEncryptionAddressOrMask) & PAGING_1G_ADDRESS_MASK_64;
+
+  if (CurrentPagingContext.MachineType == IMAGE_FILE_MACHINE_X64) {
+    if (CurrentPagingContext.ContextData.X64.PageTableBase == 0) {
+      return;
+    }
+
+    CountPageTableEntries (
+      (UINT64 *)(UINTN)CurrentPagingContext.ContextData.X64.PageTableBase,
+      SIZE_4KB / sizeof (UINT64),
+      ((CurrentPagingContext.ContextData.X64.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_5_LEVEL) != 0) ? 5 : 4,
+      AddressEncMask,
+      Statistics
+      );
+  } else {
+    if ((CurrentPagingContext.ContextData.Ia32.PageTableBase == 0) ||
+        ((CurrentPagingContext.ContextData.Ia32.Attributes & PAGE_TABLE_LIB_PAGING_CONTEXT_IA32_X64_ATTRIBUTES_PAE) == 0))
+    {
+      return;
+    }
+
+    //
+    // The page directory pointer table of PAE paging has 4 entries.
+    //
+    CountPageTableEntries (
+      (UINT64 *)(UINTN)CurrentPagingContext.ContextData.Ia32.PageTableBase,
+      4,
+      3,
+      AddressEncMask,
+      Statistics
+      );
+  }
+}
+
+/**
+  Report the statistics of the page table, at ready to boot.
+
+  @param[in]  Event     The event signaled.
+  @param[in]  Context   The event context, not used.
+**/
+VOID
+EFIAPI
+ReportPageTableStatistics (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  PAGE_TABLE_LIB_STATISTICS  Statistics;
+
+  GetPageTableStatistics (NULL, &Statistics);
+  DEBUG ((
+    DEBUG_INFO,
+    "Paging: %lu page table pages, %lu 4K pages, %lu 2M pages, %lu 1G pages (%lu split, %lu merged)\r\n",
+    (UINT64)Statistics.PageTablePages,
+    Statistics.Page4KCount,
+    Statistics.Page2MCount,
+    Statistics.Page1GCount,
+    Statistics.SplitCount,
+    Statistics.MergeCount
+    ));
+}
+
 /**
   Initialize the Page Table lib.
 **/
@@ -1425,6 +1964,17 @@ InitializePageTableLib (
     ASSERT (mLastPFEntryPointer != NULL);
   }
 
+  DEBUG_CODE_BEGIN ();
+  EFI_EVENT  ReadyToBootEvent;
+
+  EfiCreateEventReadyToBootEx (
+    TPL_CALLBACK,
+    ReportPageTableStatistics,
+    NULL,
+    &ReadyToBootEvent
+    );
+  DEBUG_CODE_END ();
+
   DEBUG ((DEBUG_INFO, "CurrentPagingContext:\n"));
   DEBUG ((DEBUG_INFO, "  MachineType   - 0x%x\n", CurrentPagingContext.MachineType));
   DEBUG ((DEBUG_INFO, "  PageTableBase - 0x%Lx\n", (UINT64)*PageTableBase));
@@ -57,6 +57,27 @@ typedef struct {
   UINTN    FreePages;
 } PAGE_TABLE_POOL;
 
+///
+/// One memory region of a batched page attribute update.
+///
+typedef struct {
+  PHYSICAL_ADDRESS    BaseAddress;
+  UINT64              Length;
+  UINT64              Attributes;
+} PAGE_TABLE_LIB_ATTRIBUTE_UPDATE;
+
+///
+/// Statistics of the page table.
+///
+typedef struct {
+  UINTN     PageTablePages;     ///< Pages used by the page table structures
+  UINT64    Page4KCount;        ///< 4KB pages mapped, present or not
+  UINT64    Page2MCount;        ///< 2MB pages mapped, present or not
+  UINT64    Page1GCount;        ///< 1GB pages mapped, present or not
+  UINT64    SplitCount;         ///< Large pages split since the driver started
+  UINT64    MergeCount;         ///< Page tables merged back into large pages
+} PAGE_TABLE_LIB_STATISTICS;
+
 /**
   Allocates one or more 4KB pages for page table.
 
@@ -109,6 +130,52 @@ AssignMemoryPageAttributes (
   IN  PAGE_TABLE_LIB_ALLOCATE_PAGES  AllocatePagesFunc OPTIONAL
   );
 
+/**
+  This function assigns the page attributes for several memory regions, each of
+  them specified by BaseAddress and Length, from their current attributes to the
+  attributes specified by Attributes.
+
+  On the current paging context, the split pages of the regions are merged back
+  into large pages wherever their attributes become uniform again, and the TLB
+  is flushed once after all the regions are updated.
+
+  Caller should make sure BaseAddress and Length of each region is at page boundary.
+
+  Caller need guarantee the TPL <= TPL_NOTIFY, if there is split page request.
+
+  @param  PagingContext     The paging context. NULL means get page table from current CPU context.
+  @param  Updates           The memory regions and the attributes to set for them.
+  @param  UpdateCount       The number of memory regions in Updates.
+  @param  AllocatePagesFunc If page split is needed, this function is used to allocate more pages.
+                            NULL mean page split is unsupported.
+
+  @retval RETURN_SUCCESS           The attributes were assigned for all the memory regions.
+  @retval RETURN_INVALID_PARAMETER Updates is NULL and UpdateCount is not zero.
+  @retval Others                   The attributes of a memory region could not be assigned, as
+                                   returned by AssignMemoryPageAttributes(). The regions before
+                                   it are updated.
+**/
+RETURN_STATUS
+EFIAPI
+AssignMemoryPageAttributesBatch (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT    *PagingContext OPTIONAL,
+  IN  PAGE_TABLE_LIB_ATTRIBUTE_UPDATE  *Updates,
+  IN  UINTN                            UpdateCount,
+  IN  PAGE_TABLE_LIB_ALLOCATE_PAGES    AllocatePagesFunc OPTIONAL
+  );
+
+/**
+  Get the statistics of the page table.
+
+  @param  PagingContext     The paging context. NULL means get page table from current CPU context.
+  @param  Statistics        Return the statistics of the page table.
+**/
+VOID
+GetPageTableStatistics (
+  IN  PAGE_TABLE_LIB_PAGING_CONTEXT  *PagingContext OPTIONAL,
+  OUT PAGE_TABLE_LIB_STATISTICS      *Statistics
+  );
+
 /**
   Initialize the Page Table lib.
 **/
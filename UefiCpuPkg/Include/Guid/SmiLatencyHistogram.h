@@ -0,0 +1,69 @@
+/** @file
+  Defines the GUID and the data structures of the SMI latency histogram.
+
+  The SMM CPU driver records how long each SMI takes to rendezvous all the
+  processors, to run the SMI handlers and to release the processors. The
+  histograms are read or reset through the communication buffer of the SMI
+  handler registered with this GUID.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _SMI_LATENCY_HISTOGRAM_H_
+#define _SMI_LATENCY_HISTOGRAM_H_
+
+#define EDKII_SMI_LATENCY_HISTOGRAM_GUID \
+  { \
+    0x6d8b1c3e, 0x4f27, 0x4a5d, { 0x9b, 0x62, 0x3c, 0x1e, 0x7f, 0x45, 0xa9, 0xd0 } \
+  }
+
+extern EFI_GUID  gEdkiiSmiLatencyHistogramGuid;
+
+#define SMI_LATENCY_COMMAND_GET    1
+#define SMI_LATENCY_COMMAND_RESET  2
+
+#define SMI_LATENCY_HISTOGRAM_BUCKETS  32
+
+///
+/// The histogram of one phase of the SMIs. Bucket 0 counts the latencies below
+/// 1 microsecond, and bucket N counts those from 2^(N-1) up to 2^N microseconds.
+/// The last bucket also counts all the longer latencies.
+///
+typedef struct {
+  UINT64    Count;
+  UINT64    TotalNs;
+  UINT64    MaxNs;
+  UINT64    Bucket[SMI_LATENCY_HISTOGRAM_BUCKETS];
+} SMI_LATENCY_HISTOGRAM;
+
+typedef struct {
+  ///
+  /// From the BSP entering the SMI to all the processors synchronized for the
+  /// SMI handlers. In the relaxed sync mode the APs are not waited for here.
+  ///
+  SMI_LATENCY_HISTOGRAM    Arrival;
+  ///
+  /// The SMI handlers run by the SMM core.
+  ///
+  SMI_LATENCY_HISTOGRAM    Handler;
+  ///
+  /// From the SMI handlers returned to all the processors released to exit.
+  ///
+  SMI_LATENCY_HISTOGRAM    Exit;
+} SMI_LATENCY_STATISTICS;
+
+///
+/// The communication buffer of the SMI handler. Command is one of the
+/// SMI_LATENCY_COMMAND_* values, and the statistics are returned on
+/// SMI_LATENCY_COMMAND_GET.
+///
+typedef struct {
+  UINT32                    Command;
+  UINT32                    Reserved;
+  UINT64                    ReturnStatus;
+  SMI_LATENCY_STATISTICS    Statistics;
+} SMI_LATENCY_COMMUNICATE;
+
+#endif
@@ -378,4 +378,75 @@ MpInitLibStartupAllCPUs (
   IN  VOID              *ProcedureArgument      OPTIONAL
   );
 
+/**
+  The procedure of a task run by MpInitLibRunTasks().
+
+  @param[in]  TaskIndex   The index of the task, from 0 to the number of tasks minus 1.
+  @param[in]  Context     The context passed to MpInitLibRunTasks().
+
+**/
+typedef
+VOID
+(EFIAPI *MP_TASK_PROCEDURE)(
+  IN UINTN  TaskIndex,
+  IN VOID   *Context
+  );
+
+///
+/// The utilization of a processor by the tasks of MpInitLibRunTasks().
+///
+typedef struct {
+  UINT64    TaskCount;        ///< The number of tasks run by the processor
+  UINT64    StolenTaskCount;  ///< The tasks taken from the share of other processors
+  UINT64    BusyTime;         ///< The time spent in the tasks, in nanoseconds
+  UINT64    TotalTime;        ///< The time spent in MpInitLibRunTasks(), in nanoseconds
+} MP_TASK_STATISTICS;
+
+/**
+  This service runs a number of tasks on all enabled CPUs.
+
+  The APs are woken up once for all the tasks. Each enabled CPU, the BSP
+  included, runs the tasks of its own contiguous share first, and then takes
+  the tasks left in the shares of the other CPUs, until all of them are done.
+
+  @param[in]  Procedure               The procedure of the tasks.
+  @param[in]  TaskCount               The number of tasks.
+  @param[in]  Context                 The context passed to each task.
+
+  @retval EFI_SUCCESS             All the tasks are done.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_NOT_READY           MP Initialize Library is not initialized.
+  @retval EFI_INVALID_PARAMETER   Procedure is NULL, or TaskCount is 0 or
+                                  greater than MAX_UINT32.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibRunTasks (
+  IN  MP_TASK_PROCEDURE  Procedure,
+  IN  UINTN              TaskCount,
+  IN  VOID               *Context      OPTIONAL
+  );
+
+/**
+  This service gets the utilization of a CPU by the tasks of
+  MpInitLibRunTasks(), accumulated since MP initialization.
+
+  @param[in]  ProcessorNumber         The handle number of the processor.
+  @param[out] Statistics              The utilization of the processor.
+
+  @retval EFI_SUCCESS             The statistics are returned.
+  @retval EFI_INVALID_PARAMETER   Statistics is NULL.
+  @retval EFI_NOT_FOUND           The processor with the handle specified by
+                                  ProcessorNumber does not exist.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibGetTaskStatistics (
+  IN  UINTN               ProcessorNumber,
+  OUT MP_TASK_STATISTICS  *Statistics
+  );
+
 #endif
@@ -152,6 +152,15 @@ typedef struct {
   UINT64                    MicrocodeEntryAddr;
   UINT32                    MicrocodeRevision;
   SEV_ES_SAVE_AREA          *SevEsSaveArea;
+  //
+  // The share of the tasks of MpInitLibRunTasks(), and the utilization of
+  // the processor by the tasks
+  //
+  volatile UINT32           NextTask;
+  UINT32                    LastTask;
+  UINT64                    TaskTicks;
+  UINT64                    RunTicks;
+  MP_TASK_STATISTICS        TaskStatistics;
 } CPU_AP_DATA;
 
 //
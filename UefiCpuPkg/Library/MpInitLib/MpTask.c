@@ -0,0 +1,297 @@
+/** @file
+  Run many small tasks on all the enabled processors.
+
+  Copyright (c) 2026, agent. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "MpLib.h"
+
+//
+// The context of MpInitLibRunTasks() shared by all the processors
+//
+typedef struct {
+  CPU_MP_DATA          *CpuMpData;
+  MP_TASK_PROCEDURE    Procedure;
+  VOID                 *Context;
+} MP_TASK_RUN_CONTEXT;
+
+/**
+  Take the next task left in the share of a processor.
+
+  The processor that owns the share and the processors that steal from it
+  take the tasks in the same way, so a task is never taken twice.
+
+  @param[in]  CpuData     The pointer to CPU_AP_DATA of the processor that owns the share.
+  @param[out] TaskIndex   The index of the task taken.
+
+  @retval TRUE    A task is taken.
+  @retval FALSE   No task is left in the share.
+**/
+BOOLEAN
+TakeTask (
+  IN  CPU_AP_DATA  *CpuData,
+  OUT UINT32       *TaskIndex
+  )
+{
+  UINT32  NextTask;
+
+  do {
+    NextTask = CpuData->NextTask;
+    if (NextTask >= CpuData->LastTask) {
+      return FALSE;
+    }
+  } while (InterlockedCompareExchange32 (&CpuData->NextTask, NextTask, NextTask + 1) != NextTask);
+
+  *TaskIndex = NextTask;
+  return TRUE;
+}
+
+/**
+  Run the tasks on the calling processor, its own share first and then the
+  tasks left in the shares of the other processors.
+
+  The time is measured with the time stamp counter, which is also valid on
+  the APs, and converted to nanoseconds by MpInitLibRunTasks() on the BSP.
+
+  @param[in]  Buffer      The pointer to MP_TASK_RUN_CONTEXT.
+**/
+VOID
+EFIAPI
+RunTasksOnProcessor (
+  IN VOID  *Buffer
+  )
+{
+  MP_TASK_RUN_CONTEXT  *Run;
+  CPU_MP_DATA          *CpuMpData;
+  CPU_AP_DATA          *CpuData;
+  UINTN                ProcessorNumber;
+  UINTN                Offset;
+  UINT32               TaskIndex;
+  UINT64               RunBegin;
+  UINT64               TaskBegin;
+
+  Run       = (MP_TASK_RUN_CONTEXT *)Buffer;
+  CpuMpData = Run->CpuMpData;
+  if (EFI_ERROR (GetProcessorNumber (CpuMpData, &ProcessorNumber))) {
+    return;
+  }
+
+  CpuData  = &CpuMpData->CpuData[ProcessorNumber];
+  RunBegin = AsmReadTsc ();
+  for (Offset = 0; Offset < CpuMpData->CpuCount; Offset++) {
+    while (TakeTask (&CpuMpData->CpuData[(ProcessorNumber + Offset) % CpuMpData->CpuCount], &TaskIndex)) {
+      TaskBegin = AsmReadTsc ();
+      Run->Procedure (TaskIndex, Run->Context);
+      CpuData->TaskTicks += AsmReadTsc () - TaskBegin;
+
+      CpuData->TaskStatistics.TaskCount++;
+      if (Offset != 0) {
+        CpuData->TaskStatistics.StolenTaskCount++;
+      }
+    }
+  }
+
+  CpuData->RunTicks = AsmReadTsc () - RunBegin;
+}
+
+/**
+  Convert time stamp counter ticks to nanoseconds.
+
+  @param[in]  Ticks         The ticks to convert.
+  @param[in]  TicksPerUs    The time stamp counter ticks per microsecond.
+
+  @return The nanoseconds.
+**/
+UINT64
+TscTicksToNanoSeconds (
+  IN UINT64  Ticks,
+  IN UINT64  TicksPerUs
+  )
+{
+  if (TicksPerUs == 0) {
+    return 0;
+  }
+
+  return DivU64x64Remainder (MultU64x32 (Ticks, 1000), TicksPerUs, NULL);
+}
+
+/**
+  This service runs a number of tasks on all enabled CPUs.
+
+  The APs are woken up once for all the tasks. Each enabled CPU, the BSP
+  included, runs the tasks of its own contiguous share first, and then takes
+  the tasks left in the shares of the other CPUs, until all of them are done.
+
+  @param[in]  Procedure               The procedure of the tasks.
+  @param[in]  TaskCount               The number of tasks.
+  @param[in]  Context                 The context passed to each task.
+
+  @retval EFI_SUCCESS             All the tasks are done.
+  @retval EFI_DEVICE_ERROR        Caller processor is AP.
+  @retval EFI_NOT_READY           Any enabled APs are busy.
+  @retval EFI_NOT_READY           MP Initialize Library is not initialized.
+  @retval EFI_INVALID_PARAMETER   Procedure is NULL, or TaskCount is 0 or
+                                  greater than MAX_UINT32.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibRunTasks (
+  IN  MP_TASK_PROCEDURE  Procedure,
+  IN  UINTN              TaskCount,
+  IN  VOID               *Context      OPTIONAL
+  )
+{
+  EFI_STATUS           Status;
+  CPU_MP_DATA          *CpuMpData;
+  CPU_AP_DATA          *CpuData;
+  MP_TASK_RUN_CONTEXT  Run;
+  UINTN                CallerNumber;
+  UINTN                ProcessorNumber;
+  UINTN                EnabledCount;
+  UINTN                EnabledIndex;
+  UINT32               FirstTask;
+  UINT64               TscBegin;
+  UINT64               TscTicks;
+  UINT64               PerformanceBegin;
+  UINT64               PerformanceEnd;
+  UINT64               Start;
+  UINT64               End;
+  UINT64               ElapsedUs;
+  UINT64               TicksPerUs;
+
+  if ((Procedure == NULL) || (TaskCount == 0) || (TaskCount > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CpuMpData = GetCpuMpData ();
+
+  //
+  // Check whether caller processor is BSP
+  //
+  MpInitLibWhoAmI (&CallerNumber);
+  if (CallerNumber != CpuMpData->BspNumber) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Split the tasks into contiguous shares of the enabled processors.
+  //
+  EnabledCount = 0;
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    if ((ProcessorNumber == CpuMpData->BspNumber) ||
+        (CpuMpData->CpuData[ProcessorNumber].State != CpuStateDisabled))
+    {
+      EnabledCount++;
+    }
+  }
+
+  FirstTask    = 0;
+  EnabledIndex = 0;
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    CpuData            = &CpuMpData->CpuData[ProcessorNumber];
+    CpuData->NextTask  = FirstTask;
+    CpuData->TaskTicks = 0;
+    CpuData->RunTicks  = 0;
+    if ((ProcessorNumber == CpuMpData->BspNumber) ||
+        (CpuData->State != CpuStateDisabled))
+    {
+      FirstTask += (UINT32)(TaskCount / EnabledCount);
+      if (EnabledIndex < TaskCount % EnabledCount) {
+        FirstTask++;
+      }
+
+      EnabledIndex++;
+    }
+
+    CpuData->LastTask = FirstTask;
+  }
+
+  ASSERT (FirstTask == TaskCount);
+
+  Run.CpuMpData = CpuMpData;
+  Run.Procedure = Procedure;
+  Run.Context   = Context;
+
+  TscBegin         = AsmReadTsc ();
+  PerformanceBegin = GetPerformanceCounter ();
+  Status           = StartupAllCPUsWorker (
+                       RunTasksOnProcessor,
+                       FALSE,
+                       FALSE,
+                       NULL,
+                       0,
+                       &Run,
+                       NULL
+                       );
+  PerformanceEnd = GetPerformanceCounter ();
+  TscTicks       = AsmReadTsc () - TscBegin;
+
+  if (EFI_ERROR (Status)) {
+    for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+      CpuMpData->CpuData[ProcessorNumber].NextTask = 0;
+      CpuMpData->CpuData[ProcessorNumber].LastTask = 0;
+    }
+
+    return Status;
+  }
+
+  //
+  // Calibrate the time stamp counter against the performance counter over the
+  // run, and add the time of each processor to its statistics.
+  //
+  GetPerformanceCounterProperties (&Start, &End);
+  if (Start > End) {
+    ElapsedUs = PerformanceBegin - PerformanceEnd;
+  } else {
+    ElapsedUs = PerformanceEnd - PerformanceBegin;
+  }
+
+  ElapsedUs  = DivU64x32 (GetTimeInNanoSecond (ElapsedUs), 1000);
+  TicksPerUs = (ElapsedUs == 0) ? 0 : DivU64x64Remainder (TscTicks, ElapsedUs, NULL);
+
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    CpuData                           = &CpuMpData->CpuData[ProcessorNumber];
+    CpuData->TaskStatistics.BusyTime  += TscTicksToNanoSeconds (CpuData->TaskTicks, TicksPerUs);
+    CpuData->TaskStatistics.TotalTime += TscTicksToNanoSeconds (CpuData->RunTicks, TicksPerUs);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This service gets the utilization of a CPU by the tasks of
+  MpInitLibRunTasks(), accumulated since MP initialization.
+
+  @param[in]  ProcessorNumber         The handle number of the processor.
+  @param[out] Statistics              The utilization of the processor.
+
+  @retval EFI_SUCCESS             The statistics are returned.
+  @retval EFI_INVALID_PARAMETER   Statistics is NULL.
+  @retval EFI_NOT_FOUND           The processor with the handle specified by
+                                  ProcessorNumber does not exist.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibGetTaskStatistics (
+  IN  UINTN               ProcessorNumber,
+  OUT MP_TASK_STATISTICS  *Statistics
+  )
+{
+  CPU_MP_DATA  *CpuMpData;
+
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CpuMpData = GetCpuMpData ();
+  if (ProcessorNumber >= CpuMpData->CpuCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  CopyMem (Statistics, &CpuMpData->CpuData[ProcessorNumber].TaskStatistics, sizeof (MP_TASK_STATISTICS));
+  return EFI_SUCCESS;
+}
@@ -10,6 +10,7 @@
 #include <Ppi/SecPlatformInformation.h>
 #include <Protocol/MpService.h>
 #include <Library/DebugLib.h>
+#include <Library/MpInitLib.h>
 #include <Library/LocalApicLib.h>
 #include <Library/HobLib.h>
 
@@ -444,3 +445,72 @@ MpInitLibStartupAllCPUs (
 
   return EFI_SUCCESS;
 }
+
+/**
+  This service runs a number of tasks on all enabled CPUs.
+
+  @param[in]  Procedure               The procedure of the tasks.
+  @param[in]  TaskCount               The number of tasks.
+  @param[in]  Context                 The context passed to each task.
+
+  @retval EFI_SUCCESS             All the tasks are done.
+  @retval EFI_INVALID_PARAMETER   Procedure is NULL, or TaskCount is 0 or
+                                  greater than MAX_UINT32.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibRunTasks (
+  IN  MP_TASK_PROCEDURE  Procedure,
+  IN  UINTN              TaskCount,
+  IN  VOID               *Context      OPTIONAL
+  )
+{
+  UINTN  TaskIndex;
+
+  if ((Procedure == NULL) || (TaskCount == 0) || (TaskCount > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (TaskIndex = 0; TaskIndex < TaskCount; TaskIndex++) {
+    Procedure (TaskIndex, Context);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This service gets the utilization of a CPU by the tasks of
+  MpInitLibRunTasks(). The utilization is not collected on uniprocessor
+  platforms, so all the statistics are zero.
+
+  @param[in]  ProcessorNumber         The handle number of the processor.
+  @param[out] Statistics              The utilization of the processor.
+
+  @retval EFI_SUCCESS             The statistics are returned.
+  @retval EFI_INVALID_PARAMETER   Statistics is NULL.
+  @retval EFI_NOT_FOUND           The processor with the handle specified by
+                                  ProcessorNumber does not exist.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibGetTaskStatistics (
+  IN  UINTN               ProcessorNumber,
+  OUT MP_TASK_STATISTICS  *Statistics
+  )
+{
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (ProcessorNumber != 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  Statistics->TaskCount       = 0;
+  Statistics->StolenTaskCount = 0;
+  Statistics->BusyTime        = 0;
+  Statistics->TotalTime       = 0;
+  return EFI_SUCCESS;
+}
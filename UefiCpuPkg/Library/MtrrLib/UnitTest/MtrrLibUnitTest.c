@@ -299,6 +299,109 @@ UnitTestMtrrSetMemoryAttributesInMtrrSettings (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Benchmark of MtrrLib service MtrrSetMemoryAttributesInMtrrSettings()
+
+  Time the calculation of the MTRR settings for random memory ranges, and
+  check that the same ranges always result in the same settings.
+
+  @param[in]  Context    Pointer to MTRR_LIB_SYSTEM_PARAMETER.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnitTestMtrrSetMemoryAttributesInMtrrSettingsPerformance (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST MTRR_LIB_SYSTEM_PARAMETER  *SystemParameter;
+  RETURN_STATUS                    Status;
+  UINT32                           UcCount;
+  UINT32                           WtCount;
+  UINT32                           WbCount;
+  UINT32                           WpCount;
+  UINT32                           WcCount;
+
+  UINTN          Index;
+  UINT8          *Scratch;
+  UINTN          ScratchSize;
+  MTRR_SETTINGS  FirstMtrrs;
+  MTRR_SETTINGS  LocalMtrrs;
+  clock_t        Begin;
+  clock_t        Elapsed;
+
+  MTRR_MEMORY_RANGE  RawMtrrRange[MTRR_NUMBER_OF_VARIABLE_MTRR];
+  MTRR_MEMORY_RANGE  ExpectedMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN              ExpectedMemoryRangesCount;
+
+  SystemParameter = (MTRR_LIB_SYSTEM_PARAMETER *)Context;
+  GenerateRandomMemoryTypeCombination (
+    SystemParameter->VariableMtrrCount - PatchPcdGet32 (PcdCpuNumberOfReservedVariableMtrrs),
+    &UcCount,
+    &WtCount,
+    &WbCount,
+    &WpCount,
+    &WcCount
+    );
+  GenerateValidAndConfigurableMtrrPairs (
+    SystemParameter->PhysicalAddressBits,
+    RawMtrrRange,
+    UcCount,
+    WtCount,
+    WbCount,
+    WpCount,
+    WcCount
+    );
+
+  ExpectedMemoryRangesCount = ARRAY_SIZE (ExpectedMemoryRanges);
+  GetEffectiveMemoryRanges (
+    SystemParameter->DefaultCacheType,
+    SystemParameter->PhysicalAddressBits,
+    RawMtrrRange,
+    UcCount + WtCount + WbCount + WpCount + WcCount,
+    ExpectedMemoryRanges,
+    &ExpectedMemoryRangesCount
+    );
+
+  ScratchSize = SCRATCH_BUFFER_SIZE;
+  Scratch     = calloc (ScratchSize, sizeof (UINT8));
+  Elapsed     = 0;
+  for (Index = 0; Index < MTRR_LIB_BENCHMARK_ITERATIONS; Index++) {
+    ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+    LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+
+    Begin  = clock ();
+    Status = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, ExpectedMemoryRanges, ExpectedMemoryRangesCount);
+    if (Status == RETURN_BUFFER_TOO_SMALL) {
+      Scratch = realloc (Scratch, ScratchSize);
+      Status  = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, ExpectedMemoryRanges, ExpectedMemoryRangesCount);
+    }
+
+    Elapsed += clock () - Begin;
+    UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+
+    if (Index == 0) {
+      CopyMem (&FirstMtrrs, &LocalMtrrs, sizeof (LocalMtrrs));
+    } else {
+      UT_ASSERT_MEM_EQUAL (&LocalMtrrs, &FirstMtrrs, sizeof (LocalMtrrs));
+    }
+  }
+
+  free (Scratch);
+
+  UT_LOG_INFO (
+    "%d memory ranges: %d us per calculation\n",
+    ExpectedMemoryRangesCount,
+    (UINT32)((UINT64)Elapsed * 1000000 / CLOCKS_PER_SEC / MTRR_LIB_BENCHMARK_ITERATIONS)
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Test routine to check whether invalid base/size can be rejected.
 
@@ -1142,6 +1245,8 @@ UnitTestingEntry (
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributeInMtrrSettings", "MtrrSetMemoryAttributeInMtrrSettings", UnitTestMtrrSetMemoryAttributeInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributesInMtrrSettings", UnitTestMtrrSetMemoryAttributesInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
     }
+
+    AddTestCase (MtrrApiTests, "Benchmark MtrrSetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributesInMtrrSettingsPerformance", UnitTestMtrrSetMemoryAttributesInMtrrSettingsPerformance, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
   }
 
   //
@@ -34,6 +34,11 @@
 
 #define SCRATCH_BUFFER_SIZE  SIZE_16KB
 
+//
+// The number of times the same memory ranges are calculated in the benchmark.
+//
+#define MTRR_LIB_BENCHMARK_ITERATIONS  100
+
 typedef struct {
   UINT8                     PhysicalAddressBits;
   BOOLEAN                   MtrrSupported;
@@ -299,6 +299,7 @@ SmmCpuUpdate (
   for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
     if (gSmmCpuPrivate->Operation[Index] == SmmCpuAdd) {
       gSmmCpuPrivate->Operation[Index] = SmmCpuNone;
+      SetPackageRunSemaphore (Index);
       mNumberOfCpus++;
     }
   }
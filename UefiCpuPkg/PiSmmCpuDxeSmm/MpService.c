@@ -19,6 +19,7 @@ SMM_DISPATCHER_MP_SYNC_DATA  *mSmmMpSyncData = NULL;
 UINTN                        mSmmMpSyncDataSize;
 SMM_CPU_SEMAPHORES           mSmmCpuSemaphores;
 UINTN                        mSemaphoreSize;
+UINTN                        mPackageCount;
 SPIN_LOCK                    *mPFLock = NULL;
 SMM_CPU_SYNC_MODE            mCpuSmmSyncMode;
 BOOLEAN                      mMachineCheckSupported = FALSE;
@@ -121,6 +122,9 @@ LockdownSemaphore (
 /**
   Wait all APs to performs an atomic compare exchange operation to release semaphore.
 
+  The APs signal the BSP through the semaphores of their packages, so the BSP
+  sweeps the package semaphores and takes the signals released in each of them.
+
   @param   NumberOfAPs      AP number
 
 **/
@@ -129,11 +133,28 @@ WaitForAllAPs (
   IN      UINTN  NumberOfAPs
   )
 {
-  UINTN  BspIndex;
+  volatile UINT32  *Sem;
+  UINTN            PackageIndex;
+  UINT32           Value;
+  UINT32           Taken;
+
+  PackageIndex = 0;
+  while (NumberOfAPs > 0) {
+    Sem   = (UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.PackageRun + mSemaphoreSize * PackageIndex);
+    Value = *Sem;
+    if (Value != 0) {
+      Taken = (UINT32)MIN (Value, NumberOfAPs);
+      if (InterlockedCompareExchange32 ((UINT32 *)Sem, Value, Value - Taken) == Value) {
+        NumberOfAPs -= Taken;
+        continue;
+      }
+    }
 
-  BspIndex = mSmmMpSyncData->BspIndex;
-  while (NumberOfAPs-- > 0) {
-    WaitForSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    PackageIndex++;
+    if (PackageIndex >= mPackageCount) {
+      PackageIndex = 0;
+      CpuPause ();
+    }
   }
 }
 
@@ -472,9 +493,11 @@ BSPHandler (
   UINTN          ApCount;
   BOOLEAN        ClearTopLevelSmiResult;
   UINTN          PresentCount;
+  UINT64         Timer;
 
   ASSERT (CpuIndex == mSmmMpSyncData->BspIndex);
   ApCount = 0;
+  Timer   = StartSyncTimer ();
 
   //
   // Flag BSP's presence
@@ -564,6 +587,8 @@ BSPHandler (
     }
   }
 
+  RecordSmiLatency (&mSmiLatency.Arrival, Timer);
+
   //
   // The BUSY lock is initialized to Acquired state
   //
@@ -577,7 +602,10 @@ BSPHandler (
   //
   // Invoke SMM Foundation EntryPoint with the processor information context.
   //
+  Timer = StartSyncTimer ();
   gSmmCpuPrivate->SmmCoreEntry (&gSmmCpuPrivate->SmmCoreEntryContext);
+  RecordSmiLatency (&mSmiLatency.Handler, Timer);
+  Timer = StartSyncTimer ();
 
   //
   // Make sure all APs have completed their pending none-block tasks
@@ -673,6 +701,8 @@ BSPHandler (
   //
   WaitForAllAPs (ApCount);
 
+  RecordSmiLatency (&mSmiLatency.Exit, Timer);
+
   //
   // Reset the tokens buffer.
   //
@@ -781,7 +811,7 @@ APHandler (
     //
     // Notify BSP of arrival at this point
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].PackageRun);
   }
 
   if (SmmCpuFeaturesNeedConfigureMtrrs ()) {
@@ -798,7 +828,7 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].PackageRun);
 
     //
     // Wait for BSP's signal to program MTRRs
@@ -813,7 +843,7 @@ APHandler (
     //
     // Signal BSP the completion of this AP
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].PackageRun);
   }
 
   while (TRUE) {
@@ -860,7 +890,7 @@ APHandler (
     //
     // Notify BSP the readiness of this AP to program MTRRs
     //
-    ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+    ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].PackageRun);
 
     //
     // Wait for the signal from BSP to program MTRRs
@@ -877,7 +907,7 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to Reset states/semaphore for this processor
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].PackageRun);
 
   //
   // Wait for the signal from BSP to Reset states/semaphore for this processor
@@ -892,7 +922,7 @@ APHandler (
   //
   // Notify BSP the readiness of this AP to exit SMM
   //
-  ReleaseSemaphore (mSmmMpSyncData->CpuData[BspIndex].Run);
+  ReleaseSemaphore (mSmmMpSyncData->CpuData[CpuIndex].PackageRun);
 }
 
 /**
@@ -1834,12 +1864,14 @@ InitializeSmmCpuSemaphores (
                  = (SPIN_LOCK *)SemaphoreAddr;
   SemaphoreAddr += SemaphoreSize;
 
-  SemaphoreAddr                          = (UINTN)SemaphoreBlock + GlobalSemaphoresSize;
-  mSmmCpuSemaphores.SemaphoreCpu.Busy    = (SPIN_LOCK *)SemaphoreAddr;
-  SemaphoreAddr                         += ProcessorCount * SemaphoreSize;
-  mSmmCpuSemaphores.SemaphoreCpu.Run     = (UINT32 *)SemaphoreAddr;
-  SemaphoreAddr                         += ProcessorCount * SemaphoreSize;
-  mSmmCpuSemaphores.SemaphoreCpu.Present = (BOOLEAN *)SemaphoreAddr;
+  SemaphoreAddr                             = (UINTN)SemaphoreBlock + GlobalSemaphoresSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Busy       = (SPIN_LOCK *)SemaphoreAddr;
+  SemaphoreAddr                            += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Run        = (UINT32 *)SemaphoreAddr;
+  SemaphoreAddr                            += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.Present    = (BOOLEAN *)SemaphoreAddr;
+  SemaphoreAddr                            += ProcessorCount * SemaphoreSize;
+  mSmmCpuSemaphores.SemaphoreCpu.PackageRun = (UINT32 *)SemaphoreAddr;
 
   mPFLock                       = mSmmCpuSemaphores.SemaphoreGlobal.PFLock;
   mConfigSmmCodeAccessCheckLock = mSmmCpuSemaphores.SemaphoreGlobal.CodeAccessCheckLock;
@@ -1847,6 +1879,52 @@ InitializeSmmCpuSemaphores (
   mSemaphoreSize = SemaphoreSize;
 }
 
+/**
+  Assign the package semaphore, through which the processor signals the BSP.
+
+  The processors of the same package share one semaphore, so that the signals
+  of all the processors are not contending on one cache line.
+
+  @param   CpuIndex      The index of the processor.
+
+**/
+VOID
+SetPackageRunSemaphore (
+  IN UINTN  CpuIndex
+  )
+{
+  EFI_PROCESSOR_INFORMATION  *ProcessorInfo;
+  SMM_CPU_DATA_BLOCK         *CpuData;
+  UINTN                      Index;
+
+  ProcessorInfo = gSmmCpuPrivate->ProcessorInfo;
+  CpuData       = mSmmMpSyncData->CpuData;
+
+  //
+  // Share the semaphore of another processor in the same package, if any.
+  //
+  for (Index = 0; Index < mMaxNumberOfCpus; Index++) {
+    if ((Index != CpuIndex) && (CpuData[Index].PackageRun != NULL) &&
+        (ProcessorInfo[Index].ProcessorId != INVALID_APIC_ID) &&
+        (ProcessorInfo[Index].Location.Package == ProcessorInfo[CpuIndex].Location.Package))
+    {
+      CpuData[CpuIndex].PackageRun = CpuData[Index].PackageRun;
+      return;
+    }
+  }
+
+  //
+  // Otherwise take a new one, unless the processor has one already. Any of the
+  // package semaphores works, since the BSP sweeps all of them.
+  //
+  if (CpuData[CpuIndex].PackageRun == NULL) {
+    ASSERT (mPackageCount < gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus);
+    CpuData[CpuIndex].PackageRun =
+      (UINT32 *)((UINTN)mSmmCpuSemaphores.SemaphoreCpu.PackageRun + mSemaphoreSize * mPackageCount);
+    mPackageCount++;
+  }
+}
+
 /**
   Initialize un-cacheable data.
 
@@ -1898,6 +1976,17 @@ InitializeMpSyncData (
       *(mSmmMpSyncData->CpuData[CpuIndex].Run)     = 0;
       *(mSmmMpSyncData->CpuData[CpuIndex].Present) = FALSE;
     }
+
+    //
+    // Group the processors by package for signaling the BSP.
+    //
+    mPackageCount = 0;
+    for (CpuIndex = 0; CpuIndex < gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus; CpuIndex++) {
+      if (gSmmCpuPrivate->ProcessorInfo[CpuIndex].ProcessorId != INVALID_APIC_ID) {
+        SetPackageRunSemaphore (CpuIndex);
+        *(mSmmMpSyncData->CpuData[CpuIndex].PackageRun) = 0;
+      }
+    }
   }
 }
 
@@ -1070,6 +1070,12 @@ PiCpuSmmEntry (
   Status = InitializeSmmCpuServices (mSmmCpuHandle);
   ASSERT_EFI_ERROR (Status);
 
+  //
+  // Register the SMI handler of the SMI latency histograms
+  //
+  Status = InitializeSmiLatency ();
+  ASSERT_EFI_ERROR (Status);
+
   //
   // register SMM Ready To Lock Protocol notification
   //
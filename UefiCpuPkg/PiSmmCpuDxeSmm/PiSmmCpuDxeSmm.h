@@ -25,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Guid/AcpiS3Context.h>
 #include <Guid/MemoryAttributesTable.h>
 #include <Guid/PiSmmMemoryAttributesTable.h>
+#include <Guid/SmiLatencyHistogram.h>
 
 #include <Library/BaseLib.h>
 #include <Library/IoLib.h>
@@ -36,6 +37,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MtrrLib.h>
 #include <Library/SmmCpuPlatformHookLib.h>
 #include <Library/SmmServicesTableLib.h>
+#include <Library/SmmMemLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -404,6 +406,7 @@ typedef struct {
   volatile EFI_AP_PROCEDURE2    Procedure;
   volatile VOID                 *Parameter;
   volatile UINT32               *Run;
+  volatile UINT32               *PackageRun;
   volatile BOOLEAN              *Present;
   PROCEDURE_TOKEN               *Token;
   EFI_STATUS                    *Status;
@@ -451,6 +454,7 @@ typedef struct {
 typedef struct {
   SPIN_LOCK           *Busy;
   volatile UINT32     *Run;
+  volatile UINT32     *PackageRun;
   volatile BOOLEAN    *Present;
   SPIN_LOCK           *Token;
 } SMM_CPU_SEMAPHORE_CPU;
@@ -478,6 +482,7 @@ extern IA32_DESCRIPTOR               gcSmiInitGdtr;
 extern SMM_CPU_SEMAPHORES            mSmmCpuSemaphores;
 extern UINTN                         mSemaphoreSize;
 extern SPIN_LOCK                     *mPFLock;
+extern SMI_LATENCY_STATISTICS        mSmiLatency;
 extern SPIN_LOCK                     *mConfigSmmCodeAccessCheckLock;
 extern EFI_SMRAM_DESCRIPTOR          *mSmmCpuSmramRanges;
 extern UINTN                         mSmmCpuSmramRangeCount;
@@ -546,6 +551,19 @@ IsSyncTimerTimeout (
   IN      UINT64  Timer
   );
 
+/**
+  Get the ticks of the performance counter elapsed since the timer started.
+
+  @param Timer  The start timer from the begin.
+
+  @return The ticks elapsed.
+
+**/
+UINT64
+GetSyncTimerElapsed (
+  IN      UINT64  Timer
+  );
+
 /**
   Initialize IDT for SMM Stack Guard.
 
@@ -727,6 +745,45 @@ InitializeMpSyncData (
   VOID
   );
 
+/**
+  Assign the package semaphore, through which the processor signals the BSP.
+
+  The processors of the same package share one semaphore, so that the signals
+  of all the processors are not contending on one cache line.
+
+  @param   CpuIndex      The index of the processor.
+
+**/
+VOID
+SetPackageRunSemaphore (
+  IN UINTN  CpuIndex
+  );
+
+/**
+  Record the latency of one phase of the SMI in its histogram.
+
+  @param[in, out] Histogram     The histogram of the phase.
+  @param[in]      Timer         The start timer of the phase.
+
+**/
+VOID
+RecordSmiLatency (
+  IN OUT SMI_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 Timer
+  );
+
+/**
+  Register the SMI handler that reports the SMI latency histograms.
+
+  @retval EFI_SUCCESS    The SMI handler is registered.
+  @retval Others         The SMI handler could not be registered.
+
+**/
+EFI_STATUS
+InitializeSmiLatency (
+  VOID
+  );
+
 /**
 
   Find out SMRAM information including SMRR base and SMRR size.
@@ -0,0 +1,132 @@
+/** @file
+SMI latency histogram support
+
+Copyright (c) 2026, agent. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCpuDxeSmm.h"
+
+//
+// The latency histograms of the SMI phases, only updated by the BSP.
+//
+SMI_LATENCY_STATISTICS  mSmiLatency;
+
+/**
+  Record the latency of one phase of the SMI in its histogram.
+
+  @param[in, out] Histogram     The histogram of the phase.
+  @param[in]      Timer         The start timer of the phase.
+
+**/
+VOID
+RecordSmiLatency (
+  IN OUT SMI_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 Timer
+  )
+{
+  UINT64  Latency;
+  UINT64  Microseconds;
+  UINTN   Bucket;
+
+  Latency      = GetTimeInNanoSecond (GetSyncTimerElapsed (Timer));
+  Microseconds = DivU64x32 (Latency, 1000);
+  if (Microseconds == 0) {
+    Bucket = 0;
+  } else {
+    Bucket = MIN ((UINTN)HighBitSet64 (Microseconds) + 1, SMI_LATENCY_HISTOGRAM_BUCKETS - 1);
+  }
+
+  Histogram->Count++;
+  Histogram->TotalNs += Latency;
+  Histogram->MaxNs    = MAX (Histogram->MaxNs, Latency);
+  Histogram->Bucket[Bucket]++;
+}
+
+/**
+  Dispatch function for the SMI latency histogram requests.
+
+  Caution: This function may receive untrusted input.
+  Communicate buffer and buffer size are external input, so this function will do basic validation.
+
+  @param DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
+  @param Context         Points to an optional handler context which was specified when the
+                         handler was registered.
+  @param CommBuffer      A pointer to a collection of data in memory that will
+                         be conveyed from a non-SMM environment into an SMM environment.
+  @param CommBufferSize  The size of the CommBuffer.
+
+  @retval EFI_SUCCESS    Command is handled successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+SmiLatencyHandler (
+  IN EFI_HANDLE  DispatchHandle,
+  IN CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID    *CommBuffer      OPTIONAL,
+  IN OUT UINTN   *CommBufferSize  OPTIONAL
+  )
+{
+  SMI_LATENCY_COMMUNICATE  *Communicate;
+
+  //
+  // If input is invalid, stop processing this SMI
+  //
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  if (*CommBufferSize < sizeof (SMI_LATENCY_COMMUNICATE)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyHandler: Communication buffer size invalid!\n"));
+    return EFI_SUCCESS;
+  }
+
+  if (!SmmIsBufferOutsideSmmValid ((UINTN)CommBuffer, sizeof (SMI_LATENCY_COMMUNICATE))) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyHandler: Communication buffer in SMRAM or overflow!\n"));
+    return EFI_SUCCESS;
+  }
+
+  Communicate = (SMI_LATENCY_COMMUNICATE *)CommBuffer;
+  switch (Communicate->Command) {
+    case SMI_LATENCY_COMMAND_GET:
+      CopyMem (&Communicate->Statistics, &mSmiLatency, sizeof (mSmiLatency));
+      Communicate->ReturnStatus = (UINT64)EFI_SUCCESS;
+      break;
+
+    case SMI_LATENCY_COMMAND_RESET:
+      ZeroMem (&mSmiLatency, sizeof (mSmiLatency));
+      Communicate->ReturnStatus = (UINT64)EFI_SUCCESS;
+      break;
+
+    default:
+      Communicate->ReturnStatus = (UINT64)EFI_UNSUPPORTED;
+      break;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Register the SMI handler that reports the SMI latency histograms.
+
+  @retval EFI_SUCCESS    The SMI handler is registered.
+  @retval Others         The SMI handler could not be registered.
+
+**/
+EFI_STATUS
+InitializeSmiLatency (
+  VOID
+  )
+{
+  EFI_HANDLE  DispatchHandle;
+
+  ZeroMem (&mSmiLatency, sizeof (mSmiLatency));
+
+  return gSmst->SmiHandlerRegister (
+                  SmiLatencyHandler,
+                  &gEdkiiSmiLatencyHistogramGuid,
+                  &DispatchHandle
+                  );
+}
@@ -59,14 +59,15 @@ StartSyncTimer (
 }
 
 /**
-  Check if the SMM AP Sync timer is timeout.
+  Get the ticks of the performance counter elapsed since the timer started.
 
   @param Timer  The start timer from the begin.
 
+  @return The ticks elapsed.
+
 **/
-BOOLEAN
-EFIAPI
-IsSyncTimerTimeout (
+UINT64
+GetSyncTimerElapsed (
   IN      UINT64  Timer
   )
 {
@@ -105,5 +106,20 @@ IsSyncTimerTimeout (
     }
   }
 
-  return (BOOLEAN)(Delta >= mTimeoutTicker);
+  return Delta;
+}
+
+/**
+  Check if the SMM AP Sync timer is timeout.
+
+  @param Timer  The start timer from the begin.
+
+**/
+BOOLEAN
+EFIAPI
+IsSyncTimerTimeout (
+  IN      UINT64  Timer
+  )
+{
+  return (BOOLEAN)(GetSyncTimerElapsed (Timer) >= mTimeoutTicker);
 }